@@ -128,6 +128,8 @@ int main(int argc, char * argv[]) {
         process_storage_type = petuum::BoundedDense;
     } else if (FLAGS_process_storage_type == "BoundedSparse") {
         process_storage_type = petuum::BoundedSparse;
+    } else if (FLAGS_process_storage_type == "LockFreeSparse") {
+        process_storage_type = petuum::LockFreeSparse;
     } else {
         LOG(FATAL) << "Unknown process storage type " << FLAGS_process_storage_type;
     }
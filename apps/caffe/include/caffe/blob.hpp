@@ -161,7 +161,9 @@ class Blob {
 
  protected:
   void UpdatePSTable();
-  Dtype* ReadPSTable() const;
+  /// @brief Loads data_ from the PS table; shares the row's memory when the
+  ///        blob fits in one row, else copies the rows into data_.
+  void ReadPSTable() const;
 
   shared_ptr<SyncedMemory> data_;
   shared_ptr<SyncedMemory> diff_;
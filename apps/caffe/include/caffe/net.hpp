@@ -93,8 +93,15 @@ class Net {
 
   /// @brief Updates the network weights based on the diff values computed.
   void Update();
+  /**
+   * @brief Updates one owned parameter: adds the diffs of the parameters
+   *        sharing it into its diff, then updates it.
+   */
+  void UpdateParam(const int param_id);
 
   void SyncWithPS();
+  /// @brief Reads the parameters owned by one layer from the PS.
+  void SyncLayerWithPS(const int layer_id);
   void RegisterNetOutputPSTable(const int num_rows);
 
   /**
@@ -146,6 +153,12 @@ class Net {
   /// @brief returns the parameter learning rate multipliers
   inline vector<float>& params_lr() { return params_lr_; }
   inline vector<float>& params_weight_decay() { return params_weight_decay_; }
+  /// @brief -1 for the parameters a layer owns, else the id of the owner
+  inline const vector<int>& param_owners() const { return param_owners_; }
+  /// @brief (layer id, index in the layer's blobs) of each parameter
+  inline const vector<pair<int, int> >& param_layer_indices() const {
+    return param_layer_indices_;
+  }
   const map<string, int>& param_names_index() { return param_names_index_; }
   /// @brief Input and output blob numbers
   inline int num_inputs() { return net_input_blobs_.size(); }
@@ -159,6 +172,24 @@ class Net {
   bool has_layer(const string& layer_name);
   const shared_ptr<Layer<Dtype> > layer_by_name(const string& layer_name);
 
+  /**
+   * @brief Hook run with a layer id around the layers' passes, e.g. to
+   *        overlap communication with computation.
+   */
+  class Callback {
+   public:
+    virtual ~Callback() {}
+    virtual void run(const int layer_id) = 0;
+  };
+  /// @brief Runs before each layer's forward pass; not owned by the net.
+  void add_before_forward(Callback* value) {
+    before_forward_.push_back(value);
+  }
+  /// @brief Runs after each layer's backward pass; not owned by the net.
+  void add_after_backward(Callback* value) {
+    after_backward_.push_back(value);
+  }
+
   void set_net_id(const int net_id) { net_id_ = net_id; }
   void set_debug_info(const bool value) { debug_info_ = value; }
 
@@ -255,6 +286,8 @@ class Net {
   size_t memory_used_;
   /// Whether to compute and display debug info for the net.
   bool debug_info_;
+  vector<Callback*> before_forward_;
+  vector<Callback*> after_backward_;
   
   ///
   int client_id_;
@@ -46,6 +46,8 @@ class Solver {
   virtual void PreSolve() {}
   // Get the update value for the current iteration.
   virtual void ComputeUpdateValue() = 0;
+  // Get the update value of one param for the current iteration.
+  virtual void ComputeUpdateValue(const int param_id) = 0;
   // The Solver::Snapshot function implements the basic snapshotting utility
   // that stores the learned net. You should implement the SnapshotSolverState()
   // function that produces a SolverState protocol buffer that needs to be
@@ -64,6 +66,30 @@ class Solver {
   void PrintOutputBlobs(shared_ptr<Net<Dtype> >& net, const bool trian, 
       std::ofstream& outfile);
 
+  // Wait-free backprop (SolverParameter.wait_free_backprop): a layer's params
+  // are updated and their oplogs flushed to the bg workers right after the
+  // layer's backward pass, so they are sent while the layers below it
+  // compute; the params are read from the PS right before the layer's
+  // forward pass.
+  class PushLayerCallback : public Net<Dtype>::Callback {
+   public:
+    explicit PushLayerCallback(Solver* solver) : solver_(solver) {}
+    virtual void run(const int layer_id) { solver_->PushLayer(layer_id); }
+   private:
+    Solver* solver_;
+  };
+  class SyncLayerCallback : public Net<Dtype>::Callback {
+   public:
+    explicit SyncLayerCallback(Solver* solver) : solver_(solver) {}
+    virtual void run(const int layer_id) { solver_->SyncLayer(layer_id); }
+   private:
+    Solver* solver_;
+  };
+  void InitWaitFreeBackprop();
+  void PushLayer(const int layer_id);
+  void SyncLayer(const int layer_id);
+  void DisplayCommTimes();
+
   SolverParameter param_;
   int iter_;
   shared_ptr<Net<Dtype> > net_;
@@ -79,6 +105,27 @@ class Solver {
   int num_clients_;
   petuum::HighResolutionTimer total_timer_;
 
+  shared_ptr<PushLayerCallback> push_layer_callback_;
+  shared_ptr<SyncLayerCallback> sync_layer_callback_;
+  // Owned params of each layer, and the params sharing each owned param.
+  vector<vector<int> > layer_owned_params_;
+  vector<vector<int> > param_sharers_;
+  // Whether the whole net was synced this iteration.
+  bool net_synced_;
+  // Seconds since the start of the iteration's ForwardBackward, and of the
+  // first flush in its backward pass (< 0 before it).
+  petuum::HighResolutionTimer iter_timer_;
+  double first_flush_time_;
+  // Communication times, in seconds summed since the last display: reading
+  // params, computing and handing over updates, and Clock() block the
+  // training thread; the overlap is the time from the first flush to the end
+  // of backward, during which the bg workers send while the thread computes.
+  double sync_time_;
+  double push_time_;
+  double clock_time_;
+  double overlap_time_;
+  int num_comm_iters_;
+
   DISABLE_COPY_AND_ASSIGN(Solver);
 };
 
@@ -105,6 +152,8 @@ class SGDSolver : public Solver<Dtype> {
   virtual void PreSolve();
   Dtype GetLearningRate();
   virtual void ComputeUpdateValue();
+  virtual void ComputeUpdateValue(const int param_id);
+  virtual void ComputeUpdateValue(const int param_id, const Dtype rate);
   virtual void SnapshotSolverState(SolverState * state);
   virtual void RestoreSolverState(const SolverState& state);
   // history maintains the historical momentum data.
@@ -129,7 +178,7 @@ class NesterovSolver : public SGDSolver<Dtype> {
       param_file, layer_blobs_global_idx_ptr, thread_id) {}
 
  protected:
-  virtual void ComputeUpdateValue();
+  virtual void ComputeUpdateValue(const int param_id, const Dtype rate);
 
   DISABLE_COPY_AND_ASSIGN(NesterovSolver);
 };
@@ -151,7 +200,7 @@ class AdaGradSolver : public SGDSolver<Dtype> {
   }
 
  protected:
-  virtual void ComputeUpdateValue();
+  virtual void ComputeUpdateValue(const int param_id, const Dtype rate);
   void constructor_sanity_check() {
     CHECK_EQ(0, this->param_.momentum())
         << "Momentum cannot be used with AdaGrad.";
@@ -54,6 +54,11 @@ class SyncedMemory {
   const void* cpu_data();
   void set_cpu_data(void* data);
   void set_cpu_ps_data(void* data);
+  // Points the CPU data at read-only memory kept alive by holder, e.g. a
+  // read view of a PS row, without copying it. The memory is copied into
+  // memory this SyncedMemory owns before it is first written.
+  void set_cpu_shared_data(const void* data,
+      const shared_ptr<const void>& holder);
   //void free_ps_data();
   const void* gpu_data();
   void* mutable_cpu_data();
@@ -65,11 +70,14 @@ class SyncedMemory {
  private:
   void to_cpu();
   void to_gpu();
+  void own_shared_cpu_data(const bool copy);
   void* cpu_ptr_;
   void* gpu_ptr_;
   size_t size_;
   SyncedHead head_;
   bool own_cpu_data_;
+  // Set while cpu_ptr_ points at shared memory (set_cpu_shared_data).
+  shared_ptr<const void> cpu_data_holder_;
 
   DISABLE_COPY_AND_ASSIGN(SyncedMemory);
 };  // class SyncedMemory
@@ -80,6 +80,8 @@ void Blob<Dtype>::CreatePSTable() {
     table_config.process_storage_type = petuum::BoundedDense;
   } else if (process_storage_type == "BoundedSparse") {
     table_config.process_storage_type = petuum::BoundedSparse;
+  } else if (process_storage_type == "LockFreeSparse") {
+    table_config.process_storage_type = petuum::LockFreeSparse;
   } else {
     LOG(FATAL) << "Unknown process storage type " << process_storage_type;
   }
@@ -103,8 +105,7 @@ const Dtype* Blob<Dtype>::cpu_data() const {
   if (blob_mode_ == BlobProto_BlobMode_GLOBAL 
       && data_->head() == SyncedMemory::UNINITIALIZED) {
     // load data from PS table
-    Dtype* data_temp = ReadPSTable();
-    data_->set_cpu_ps_data(data_temp);
+    ReadPSTable();
   }
   CHECK(data_);
   return (const Dtype*)data_->cpu_data();
@@ -145,8 +146,7 @@ Dtype* Blob<Dtype>::mutable_cpu_data() {
   if (blob_mode_ == BlobProto_BlobMode_GLOBAL 
         && data_->head() == SyncedMemory::UNINITIALIZED) {
     // load data from PS table
-    Dtype* data_temp = ReadPSTable();
-    data_->set_cpu_ps_data(data_temp);
+    ReadPSTable();
   }
   CHECK(data_);
   return static_cast<Dtype*>(data_->mutable_cpu_data());
@@ -221,8 +221,7 @@ void Blob<Dtype>::Update() {
 template <typename Dtype>
 void Blob<Dtype>::SyncWithPSTable() {
   CHECK(blob_mode_ == BlobProto_BlobMode_GLOBAL);
-  Dtype* data_temp = ReadPSTable();
-  data_->set_cpu_ps_data(data_temp);
+  ReadPSTable();
 }
 
 // MULTIROW
@@ -230,54 +229,47 @@ template <typename Dtype>
 void Blob<Dtype>::UpdatePSTable() {
   // flush diff_
   const Dtype* update = static_cast<const Dtype*>(diff_->cpu_data());
-  int update_idx = 0;
-  
-  for (int r = 0; r < util::Context::num_rows_per_table(); ++r) {
-    petuum::UpdateBatch<Dtype> update_batch(global_table_row_capacity_);
-    for (int i = 0; i < global_table_row_capacity_; ++i) {
-      update_batch.UpdateSet(i, i, Dtype(-1) * update[update_idx]);
-      ++update_idx;
-      if (update_idx >= count_) { break; }
+  for (int r = 0, offset = 0; offset < count_;
+      ++r, offset += global_table_row_capacity_) {
+    const int num_updates = std::min(global_table_row_capacity_,
+        count_ - offset);
+    petuum::DenseUpdateBatch<Dtype> update_batch(0, num_updates);
+    Dtype* update_vec = static_cast<Dtype*>(update_batch.get_mem());
+    for (int i = 0; i < num_updates; ++i) {
+      update_vec[i] = Dtype(-1) * update[offset + i];
     }
-    global_table_ptr_->BatchInc(r, update_batch);
-    if (update_idx >= count_) { break; }
+    global_table_ptr_->DenseBatchInc(r, update_batch);
   }
 }
 
 // MULTIROW
 template <typename Dtype>
-Dtype* Blob<Dtype>::ReadPSTable() const {
+void Blob<Dtype>::ReadPSTable() const {
   CHECK(global_table_ptr_);
-  
-  void* data_temp;
-  CaffeMallocHost(&data_temp, capacity_ * sizeof(Dtype));
-  Dtype* data = (Dtype*)data_temp;
 
-  vector<vector<Dtype> > row_caches(util::Context::num_rows_per_table());
-  for (int r_idx = 0; r_idx < util::Context::num_rows_per_table(); ++r_idx) {
-    row_caches[r_idx].resize(global_table_row_capacity_);
+  if (global_table_row_capacity_ >= count_) {
     petuum::RowAccessor row_acc;
-    const auto& r = global_table_ptr_->template Get<petuum::DenseRow<Dtype> >(
-        r_idx, &row_acc);
-    r.CopyToVector(&row_caches[r_idx]);
-  }
-
-  int data_idx = 0;
-  for (int r_idx = 0; r_idx < util::Context::num_rows_per_table(); ++r_idx) {
-    for (int i = 0; i < global_table_row_capacity_; ++i) {
-      data[data_idx] = row_caches[r_idx][i];
-      ++data_idx;
-      if (data_idx >= count_) { break; }
+    global_table_ptr_->Get(0, &row_acc);
+    const petuum::DenseRowView<Dtype> view
+        = row_acc.GetView<petuum::DenseRow<Dtype> >();
+    if (view.size() * sizeof(Dtype) >= data_->size()) {
+      // The view stays unchanged until it is dropped at the next read, so
+      // the data can point into it instead of copying it.
+      shared_ptr<const void> holder(new petuum::DenseRowView<Dtype>(view));
+      data_->set_cpu_shared_data(view.data(), holder);
+      return;
     }
-    if (data_idx >= count_) { break; }
-  } 
-
-  for (int r_idx = 0; r_idx < util::Context::num_rows_per_table(); ++r_idx) {
-    vector<Dtype>().swap(row_caches[r_idx]);
   }
-  vector<vector<Dtype> >().swap(row_caches);
 
-  return data;
+  Dtype* data = static_cast<Dtype*>(data_->mutable_cpu_data());
+  for (int r = 0, offset = 0; offset < count_;
+      ++r, offset += global_table_row_capacity_) {
+    petuum::RowAccessor row_acc;
+    const auto& row = global_table_ptr_->template Get<
+        petuum::DenseRow<Dtype> >(r, &row_acc);
+    row.CopyToMem(data + offset,
+        std::min(global_table_row_capacity_, count_ - offset));
+  }
 }
 
 template <> unsigned int Blob<unsigned int>::asum_data() const {
@@ -397,15 +389,15 @@ void Blob<Dtype>::FromProto(const BlobProto& proto, const bool init_ps_table) {
   if (blob_mode_ == BlobProto_BlobMode_GLOBAL) {
     if (init_ps_table) { // initialize ps table
       // update values in ps table
-      Dtype* data_vec = ReadPSTable();
+      ReadPSTable();
+      const Dtype* data_vec = static_cast<const Dtype*>(data_->cpu_data());
+      Dtype* diff_vec = static_cast<Dtype*>(diff_->mutable_cpu_data());
       for (int i = 0; i < count_; ++i) {
-        data_vec[i] = data_vec[i] - proto.data(i);
+        diff_vec[i] = data_vec[i] - proto.data(i);
       }
-      diff_->set_cpu_data(data_vec);
       UpdatePSTable();
       // fetch the newest values
-      data_vec = ReadPSTable();
-      data_->set_cpu_ps_data(data_vec);
+      ReadPSTable();
     }
   } else {
     //copy data
@@ -716,6 +716,9 @@ Dtype Net<Dtype>::ForwardFromTo(int start, int end) {
   CHECK_LT(end, layers_.size());
   Dtype loss = 0;
   for (int i = start; i <= end; ++i) {
+    for (int c = 0; c < before_forward_.size(); ++c) {
+      before_forward_[c]->run(i);
+    }
     layers_[i]->Reshape(bottom_vecs_[i], &top_vecs_[i]);
     Dtype layer_loss = layers_[i]->Forward(bottom_vecs_[i], &top_vecs_[i]);
     loss += layer_loss;
@@ -785,6 +788,9 @@ void Net<Dtype>::BackwardFromTo(int start, int end) {
           top_vecs_[i], bottom_need_backward_[i], &bottom_vecs_[i]);
       if (debug_info_) { BackwardDebugInfo(i); }
     }
+    for (int c = 0; c < after_backward_.size(); ++c) {
+      after_backward_[c]->run(i);
+    }
   }
 }
 
@@ -976,12 +982,22 @@ void Net<Dtype>::ToProto(NetParameter* param, bool write_diff) {
 }
 
 template <typename Dtype>
-void Net<Dtype>::Update() {   
+void Net<Dtype>::Update() {
+  for (int i = 0; i < params_.size(); ++i) {
+    if (param_owners_[i] >= 0) { continue; }
+    UpdateParam(i);
+  }
+}
+
+template <typename Dtype>
+void Net<Dtype>::UpdateParam(const int param_id) {
+  CHECK_LT(param_owners_[param_id], 0) << "Param " << param_id
+      << " is shared; update its owner " << param_owners_[param_id];
   // First, accumulate the diffs of any shared parameters into their owner's
   // diff. (Assumes that the learning rate, weight decay, etc. have already been
   // accounted for in the current diff.)
   for (int i = 0; i < params_.size(); ++i) {
-    if (param_owners_[i] < 0) { continue; }
+    if (param_owners_[i] != param_id) { continue; }
     if (debug_info_) { UpdateDebugInfo(i); }
     const int count = params_[i]->count();
     const Dtype* this_diff;
@@ -989,13 +1005,13 @@ void Net<Dtype>::Update() {
     switch (Caffe::mode()) {
     case Caffe::CPU:
       this_diff = params_[i]->cpu_diff();
-      owner_diff = params_[param_owners_[i]]->mutable_cpu_diff();
+      owner_diff = params_[param_id]->mutable_cpu_diff();
       caffe_add(count, this_diff, owner_diff, owner_diff);
       break;
 #ifndef CPU_ONLY
     case Caffe::GPU:
       this_diff = params_[i]->gpu_diff();
-      owner_diff = params_[param_owners_[i]]->mutable_gpu_diff();
+      owner_diff = params_[param_id]->mutable_gpu_diff();
       caffe_gpu_add(count, this_diff, owner_diff, owner_diff);
       break;
 #else
@@ -1005,18 +1021,26 @@ void Net<Dtype>::Update() {
       LOG(FATAL) << "Unknown caffe mode: " << Caffe::mode();
     }
   }
-  // Now, update the owned parameters.
+  // Now, update the owned parameter.
+  if (debug_info_) { UpdateDebugInfo(param_id); }
+  params_[param_id]->Update();
+}
+
+template <typename Dtype>
+void Net<Dtype>::SyncWithPS() {
   for (int i = 0; i < params_.size(); ++i) {
     if (param_owners_[i] >= 0) { continue; }
-    if (debug_info_) { UpdateDebugInfo(i); }
-    params_[i]->Update();
+    params_[i]->SyncWithPSTable();
   }
 }
 
 template <typename Dtype>
-void Net<Dtype>::SyncWithPS() {
+void Net<Dtype>::SyncLayerWithPS(const int layer_id) {
+  // Parameters shared from a lower layer were synced with their owner.
   for (int i = 0; i < params_.size(); ++i) {
-    if (param_owners_[i] >= 0) { continue; }
+    if (param_owners_[i] >= 0 || param_layer_indices_[i].first != layer_id) {
+      continue;
+    }
     params_[i]->SyncWithPSTable();
   }
 }
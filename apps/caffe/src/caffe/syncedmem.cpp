@@ -28,6 +28,7 @@ inline void SyncedMemory::to_cpu() {
     break;
   case HEAD_AT_GPU:
 #ifndef CPU_ONLY
+    own_shared_cpu_data(false);
     if (cpu_ptr_ == NULL) {
       CaffeMallocHost(&cpu_ptr_, size_);
       own_cpu_data_ = true;
@@ -81,6 +82,7 @@ void SyncedMemory::set_cpu_data(void* data) {
   cpu_ptr_ = data;
   head_ = HEAD_AT_CPU;
   own_cpu_data_ = false;
+  cpu_data_holder_.reset();
 }
 
 void SyncedMemory::set_cpu_ps_data(void* data) {
@@ -88,6 +90,32 @@ void SyncedMemory::set_cpu_ps_data(void* data) {
   own_cpu_data_ = true;
 }
 
+void SyncedMemory::set_cpu_shared_data(const void* data,
+    const shared_ptr<const void>& holder) {
+  CHECK(data);
+  CHECK(holder);
+  if (own_cpu_data_) {
+    CaffeFreeHost(cpu_ptr_);
+  }
+  cpu_ptr_ = const_cast<void*>(data);
+  head_ = HEAD_AT_CPU;
+  own_cpu_data_ = false;
+  cpu_data_holder_ = holder;
+}
+
+inline void SyncedMemory::own_shared_cpu_data(const bool copy) {
+  if (!cpu_data_holder_) {
+    return;
+  }
+  void* shared_data = cpu_ptr_;
+  CaffeMallocHost(&cpu_ptr_, size_);
+  if (copy) {
+    memcpy(cpu_ptr_, shared_data, size_);
+  }
+  own_cpu_data_ = true;
+  cpu_data_holder_.reset();
+}
+
 //void SyncedMemory::free_ps_data() {
 //  CaffeFreeHost(cpu_ptr_);
 //
@@ -109,6 +137,7 @@ const void* SyncedMemory::gpu_data() {
 
 void* SyncedMemory::mutable_cpu_data() {
   to_cpu();
+  own_shared_cpu_data(true);
   head_ = HEAD_AT_CPU;
   return cpu_ptr_;
 }
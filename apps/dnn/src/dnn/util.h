@@ -49,6 +49,13 @@ void activate_logistic(float * x, int dim);
 //multiplication W * a, size of W dim1 * dim2, assume a and b have been allocated
 void matrix_vector_multiply(float ** W, float * a, float * b, int dim1, int dim2);
 void matrix_vector_multiply_colwise(float ** W, float * a, float * b, int dim1, int dim2);
+//cache-blocked matrix multiplications on contiguous row-major matrices, C is accumulated into
+//C(m*n) += A(m*k) * B(k*n)
+void gemm_nn(const float * A, const float * B, float * C, int m, int n, int k);
+//C(m*n) += A(m*k) * B(n*k)^T
+void gemm_nt(const float * A, const float * B, float * C, int m, int n, int k);
+//C(m*n) += A(k*m)^T * B(k*n)
+void gemm_tn(const float * A, const float * B, float * C, int m, int n, int k);
 //copy vectors
 void copy_vec(float * a, float * b, int dim);
 void copy_mat(float ** a, float ** b, int dim1, int dim2);
@@ -62,68 +62,52 @@ dnn::dnn(dnn_paras para,int client_id, int num_worker_threads, int staleness, in
 
 
 
-void dnn::sgd_mini_batch(int * idxes_batch, mat* weights, mat* biases, float *** local_weights, float ** local_biases , float *** delta_weights, float ** delta_biases, float ** z, float ** delta, int ** rand_idxes_weight, int * rand_idxes_bias)
+void dnn::sgd_mini_batch(int * idxes_batch, mat* weights, mat* biases, float ** local_weights, float ** local_biases , float ** delta_weights, float ** delta_biases, float ** z, float ** delta, int ** rand_idxes_weight, int * rand_idxes_bias)
 {
-  //delta_weights accumuluates the gradients of weight matrices, delta_biases accumulates the gradients of bias vectors
-  //set delta_weights and delta_biases buffer to zero
-  for(int l=0;l<num_layers-1;l++){
-    int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
-    for(int i=0;i<dim1;i++)
-      memset(delta_weights[l][i],0,sizeof(float)*dim2);
-  }
-  for(int l=0;l<num_layers-1;l++)
-    memset(delta_biases[l],0,sizeof(float)*num_units_ineach_layer[l+1]);
-  
   //local_weights is the local copy of weight tables, local_biases is the local copy of bias tables
+  //each weight matrix is snapshotted into one contiguous row-major buffer, once per clock
   petuum::RowAccessor row_acc;
   //fetch parameters from PS tables to local parameter buffers
   for(int l=0;l<num_layers-1;l++){
     int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
     for(int j=0;j<dim1;j++){
       int rnd_idx=rand_idxes_weight[l][j];
-  	  const auto& r = weights[l].Get<petuum::DenseRow<float> >(rnd_idx, &row_acc);
-//      weights[l].Get(rnd_idx, &row_acc);
-//      const petuum::DenseRow<float>& r = row_acc.Get<petuum::DenseRow<float> >();
-      for(int i=0;i<dim2;i++)
-        local_weights[l][rnd_idx][i]=r[i];
+      const auto& r = weights[l].Get<petuum::DenseRow<float> >(rnd_idx, &row_acc);
+      r.CopyToMem(local_weights[l]+(size_t)rnd_idx*dim2, dim2);
     }
   }
   for(int l=0;l<num_layers-1;l++){
     int rnd_idx=rand_idxes_bias[l];
     int dim=num_units_ineach_layer[rnd_idx+1];
     const auto& r = biases[rnd_idx].Get<petuum::DenseRow<float> >(0, &row_acc);
-//    biases[rnd_idx].Get(0, &row_acc);
-//    const petuum::DenseRow<float>& r = row_acc.Get<petuum::DenseRow<float> >();
-    for(int j=0;j<dim;j++)
-      local_biases[rnd_idx][j]=r[j];
+    r.CopyToMem(local_biases[rnd_idx], dim);
   }
 
   //compute gradient of the mini batch
-  for(int i=0;i<size_minibatch;i++)
-    compute_gradient_single_data(idxes_batch[i], local_weights,  local_biases, delta_weights, delta_biases, z,  delta );
-
+  compute_gradient_mini_batch(idxes_batch, size_minibatch, local_weights, local_biases, delta_weights, delta_biases, z, delta);
 
-  //update parameters
+  //update parameters, one dense batch per row
   float coeff_update=-stepsize/size_minibatch;
   for(int l=0;l<num_layers-1;l++){
     int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
+    petuum::DenseUpdateBatch<float> update_batch(0, dim2);
+    float * updates=static_cast<float *>(update_batch.get_mem());
     for(int j=0;j<dim1;j++){
-       int rnd_idx=rand_idxes_weight[l][j];
-	petuum::UpdateBatch<float> update_batch;
-	for (int i = 0; i < dim2; ++i) {
-         update_batch.Update(i, coeff_update*delta_weights[l][rnd_idx][i]);
-	}
-       weights[l].BatchInc(rnd_idx, update_batch);
-
+      int rnd_idx=rand_idxes_weight[l][j];
+      const float * grad=delta_weights[l]+(size_t)rnd_idx*dim2;
+      for(int i=0;i<dim2;i++)
+        updates[i]=coeff_update*grad[i];
+      weights[l].DenseBatchInc(rnd_idx, update_batch);
     }
   }
   for(int l=0;l<num_layers-1;l++){
     int rnd_idx=rand_idxes_bias[l];
     int dim=num_units_ineach_layer[rnd_idx+1];
-    petuum::UpdateBatch<float> update_batch;
+    petuum::DenseUpdateBatch<float> update_batch(0, dim);
+    float * updates=static_cast<float *>(update_batch.get_mem());
     for(int j=0;j<dim;j++)
-      update_batch.Update(j, coeff_update*delta_biases[rnd_idx][j]);
-    biases[rnd_idx].BatchInc(0,update_batch);
+      updates[j]=coeff_update*delta_biases[rnd_idx][j];
+    biases[rnd_idx].DenseBatchInc(0, update_batch);
   }
 
 
@@ -131,31 +115,28 @@ void dnn::sgd_mini_batch(int * idxes_batch, mat* weights, mat* biases, float ***
 
 
 
-void dnn::compute_gradient_single_data(int idx_data,float *** local_weights, float ** local_biases, float *** delta_weights, float ** delta_biases, float ** z, float ** delta)
+void dnn::compute_gradient_mini_batch(int * idxes_batch, int num_smps, float ** local_weights, float ** local_biases, float ** delta_weights, float ** delta_biases, float ** z, float ** delta)
 {
-  copy_vec(z[0], input_features[idx_data], num_units_ineach_layer[0]);
-
   //forward propagation
-  for(int i=1;i<num_layers;i++)
-    forward_activation(i-1, local_weights[i-1], local_biases[i-1], z[i-1], z[i]);
-	
+  forward_mini_batch(idxes_batch, num_smps, local_weights, local_biases, z);
+
   //backward propagation
-  compute_error_output_layer(delta[num_layers-2], z[num_layers-1],idx_data);
+  compute_error_output_layer(delta[num_layers-2], z[num_layers-1], idxes_batch, num_smps);
   for(int l=num_layers-3;l>=0;l--)
-    backward_error_computation(l, local_weights[l+1], z[l+1], delta[l], delta[l+1]);
+    backward_error_computation(l, local_weights[l+1], z[l+1], delta[l], delta[l+1], num_smps);
 
-  //accumulate gradient of weights matrices and bias vectors
+  //gradient of weights matrices and bias vectors, summed over the mini batch
+  //delta_weights[l] = delta[l]^T * z[l]
   for(int l=0;l<num_layers-1;l++){
     int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
-    for(int j=0;j<dim1;j++){
-      for(int i=0;i<dim2;i++)
-        delta_weights[l][j][i]+=delta[l][j]*z[l][i];
-    }
+    memset(delta_weights[l],0,sizeof(float)*dim1*dim2);
+    gemm_tn(delta[l], z[l], delta_weights[l], dim1, dim2, num_smps);
   }
-  for(int l=1;l<num_layers;l++){
-    int dim=num_units_ineach_layer[l];
-    for(int j=0;j<dim;j++)
-      delta_biases[l-1][j]+=delta[l-1][j];
+  for(int l=0;l<num_layers-1;l++){
+    int dim=num_units_ineach_layer[l+1];
+    memset(delta_biases[l],0,sizeof(float)*dim);
+    for(int s=0;s<num_smps;s++)
+      add_vector(delta_biases[l], delta[l]+(size_t)s*dim, dim);
   }
 
 }
@@ -163,71 +144,86 @@ void dnn::compute_gradient_single_data(int idx_data,float *** local_weights, flo
 
   
 
-void dnn::forward_activation(int index_lower_layer, float ** local_weights, float * local_bias, float * visible, float * hidden)
+void dnn::forward_mini_batch(int * idxes_batch, int num_smps, float ** local_weights, float ** local_biases, float ** z)
+{
+  int dim=num_units_ineach_layer[0];
+  for(int s=0;s<num_smps;s++)
+    copy_vec(z[0]+(size_t)s*dim, input_features[idxes_batch[s]], dim);
+  for(int i=1;i<num_layers;i++)
+    forward_activation(i-1, local_weights[i-1], local_biases[i-1], z[i-1], z[i], num_smps);
+}
+
+
+void dnn::forward_activation(int index_lower_layer, float * local_weights, float * local_bias, float * visible, float * hidden, int num_smps)
 {
   int num_units_hidden=num_units_ineach_layer[index_lower_layer+1];
   int num_units_visible=num_units_ineach_layer[index_lower_layer];
-  matrix_vector_multiply(local_weights, visible, hidden, num_units_hidden, num_units_visible);
-  add_vector(hidden, local_bias, num_units_hidden);
-  if(index_lower_layer<num_layers-2)	
-    activate_logistic(hidden, num_units_hidden);
-  else if(index_lower_layer==num_layers-2)
-    log2ori(hidden,num_units_hidden );
+  //hidden = visible * W^T + bias, one row per data point
+  for(int s=0;s<num_smps;s++)
+    copy_vec(hidden+(size_t)s*num_units_hidden, local_bias, num_units_hidden);
+  gemm_nt(visible, local_weights, hidden, num_smps, num_units_hidden, num_units_visible);
+  for(int s=0;s<num_smps;s++){
+    float * h=hidden+(size_t)s*num_units_hidden;
+    if(index_lower_layer<num_layers-2)
+      activate_logistic(h, num_units_hidden);
+    else if(index_lower_layer==num_layers-2)
+      log2ori(h,num_units_hidden );
+  }
 
 }
 
 
 //compute error at output layer
-void dnn::compute_error_output_layer(float * error_output_layer, float * activation_output_layer,int idx_data)
+void dnn::compute_error_output_layer(float * error_output_layer, float * activation_output_layer, int * idxes_batch, int num_smps)
 {
   int num_units_output_layer=num_units_ineach_layer[num_layers-1];
-  int label=output_labels[idx_data];
-  for(int k=0;k<num_units_output_layer;k++){
-    if(label==k)
-      error_output_layer[k]=activation_output_layer[k]-1;
-    else
-      error_output_layer[k]=activation_output_layer[k];	
+  for(int s=0;s<num_smps;s++){
+    float * error=error_output_layer+(size_t)s*num_units_output_layer;
+    float * activation=activation_output_layer+(size_t)s*num_units_output_layer;
+    int label=output_labels[idxes_batch[s]];
+    for(int k=0;k<num_units_output_layer;k++){
+      if(label==k)
+        error[k]=activation[k]-1;
+      else
+        error[k]=activation[k];
+    }
   }
 }
 
 
-void dnn::backward_error_computation(int index_lower_index, float ** local_weights, float * activation, float * error_lower_layer, float * error_higher_layer)
+void dnn::backward_error_computation(int index_lower_index, float * local_weights, float * activation, float * error_lower_layer, float * error_higher_layer, int num_smps)
 {
   int num_j=num_units_ineach_layer[index_lower_index+1];
   int num_k=num_units_ineach_layer[index_lower_index+2];
-  memset(error_lower_layer, 0, sizeof(float)* num_j);
-  for(int k=0;k<num_k;k++){
-    for(int j=0;j<num_j;j++)
-      error_lower_layer[j]+=local_weights[k][j]*error_higher_layer[k];
-  }
-  for(int j=0;j<num_j;j++){
+  //error_lower_layer = error_higher_layer * W
+  memset(error_lower_layer, 0, sizeof(float)*num_j*num_smps);
+  gemm_nn(error_higher_layer, local_weights, error_lower_layer, num_smps, num_j, num_k);
+  for(size_t j=0;j<(size_t)num_j*num_smps;j++){
     error_lower_layer[j]*=activation[j]*(1-activation[j]);
   }
 }
 
 void dnn::train(mat * weights, mat * biases)
 {
-  //z stores forward activations, delta stores backward errors
+  //z stores forward activations, delta stores backward errors, one row per data point of the mini batch
   //allocate z and delta buffers
   float ** z=new float*[num_layers];
   for(int i=0;i<num_layers;i++)
-    z[i]=new float[num_units_ineach_layer[i]];
+    z[i]=new float[(size_t)size_minibatch*num_units_ineach_layer[i]];
 
   float ** delta=new float*[num_layers-1]; 
   for(int i=0;i<num_layers-1;i++)
-    delta[i]=new float[num_units_ineach_layer[i+1]];
+    delta[i]=new float[(size_t)size_minibatch*num_units_ineach_layer[i+1]];
 
   //each iteration, we fetch the prameters from the PS table to local parameter buffers
   //local_weights is the local copy of weight matrices and local_biases is the local copy of bias vectors
+  //each weight matrix is stored row-major in one contiguous buffer
   //create parameter buffer
-  float *** local_weights=new float **[num_layers-1];
+  float ** local_weights=new float *[num_layers-1];
   for(int l=0;l<num_layers-1;l++){
-    int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
-    local_weights[l]=new float*[dim1];
-    for(int i=0;i<dim1;i++){
-      local_weights[l][i]=new float[dim2];
-      memset(local_weights[l][i],0,sizeof(float)*dim2);
-    }
+    size_t size=(size_t)num_units_ineach_layer[l+1]*num_units_ineach_layer[l];
+    local_weights[l]=new float[size];
+    memset(local_weights[l],0,sizeof(float)*size);
   }
   float ** local_biases=new float*[num_layers-1];
   for(int l=0;l<num_layers-1;l++){
@@ -236,14 +232,11 @@ void dnn::train(mat * weights, mat * biases)
   }
 
   //delta_weights stores the gradient of weight matrices and delta_biases stores the gradient of bias vectors
-  float *** delta_weights=new float **[num_layers-1];
+  float ** delta_weights=new float *[num_layers-1];
   for(int l=0;l<num_layers-1;l++){
-    int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
-    delta_weights[l]=new float*[dim1];
-    for(int i=0;i<dim1;i++){
-      delta_weights[l][i]=new float[dim2];
-      memset(delta_weights[l][i],0,sizeof(float)*dim2);
-    }
+    size_t size=(size_t)num_units_ineach_layer[l+1]*num_units_ineach_layer[l];
+    delta_weights[l]=new float[size];
+    memset(delta_weights[l],0,sizeof(float)*size);
   }
   float ** delta_biases=new float*[num_layers-1];
   for(int l=0;l<num_layers-1;l++){
@@ -299,22 +292,16 @@ void dnn::train(mat * weights, mat * biases)
          for(int l=0;l<num_layers-1;l++){
            int dim1=num_units_ineach_layer[l+1], dim2=num_units_ineach_layer[l];
            for(int j=0;j<dim1;j++){
-       	     const auto& r = weights[l].Get<petuum::DenseRow<float> >(j, &row_acc);
-//             weights[l].Get(j, &row_acc);
-//             const petuum::DenseRow<float>& r = row_acc.Get<petuum::DenseRow<float> >();
-             for(int i=0;i<dim2;i++)
-               local_weights[l][j][i]=r[i];
-	    }
+             const auto& r = weights[l].Get<petuum::DenseRow<float> >(j, &row_acc);
+             r.CopyToMem(local_weights[l]+(size_t)j*dim2, dim2);
+           }
          }
          for(int l=0;l<num_layers-1;l++){
            int dim=num_units_ineach_layer[l+1];
            const auto& r = biases[l].Get<petuum::DenseRow<float> >(0, &row_acc);
-//		   biases[l].Get(0, &row_acc);
-//           const petuum::DenseRow<float>& r = row_acc.Get<petuum::DenseRow<float> >();
-            for(int j=0;j<dim;j++)
-              local_biases[l][j]=r[j];
+           r.CopyToMem(local_biases[l], dim);
           }
-          float loss=compute_loss(local_weights, local_biases);
+          float loss=compute_loss(local_weights, local_biases, z);
           if(client_id==0&&(*thread_id)==0)
             std::cout<<"client "<<client_id<<" worker "<<(*thread_id)<<" iter "<<it<<" loss is "<<loss<<std::endl;
        }
@@ -331,12 +318,8 @@ void dnn::train(mat * weights, mat * biases)
   delete []z;
 	
   //release parameter buffer
-  for(int l=0;l<num_layers-1;l++){
-    int dim1=num_units_ineach_layer[l+1];
-    for(int i=0;i<dim1;i++)
-      delete []local_weights[l][i];
+  for(int l=0;l<num_layers-1;l++)
     delete[]local_weights[l];
-  }
   delete[]local_weights;
 
   for(int l=0;l<num_layers-1;l++)
@@ -344,42 +327,37 @@ void dnn::train(mat * weights, mat * biases)
   delete []local_biases;
 
   for(int l=0;l<num_layers-1;l++)
-  {
-    int dim1=num_units_ineach_layer[l+1];
-    for(int i=0;i<dim1;i++)
-      delete []delta_weights[l][i];
     delete[]delta_weights[l];
-  }
   delete[]delta_weights;
   for(int l=0;l<num_layers-1;l++)
     delete []delta_biases[l];
   delete []delta_biases;
 }
 
-float dnn::compute_loss(float *** weights, float ** biases)
+float dnn::compute_loss(float ** weights, float ** biases, float ** z)
 {
-  float ** z=new float*[num_layers];
-  for(int i=0;i<num_layers;i++)
-    z[i]=new float[num_units_ineach_layer[i]];
+  //the sampled data points go through the network size_minibatch at a time, using the z buffers of the mini batch
+  int * idxes_batch=new int[size_minibatch];
   double loss=0;
   int cnt=0;
+  int num_smps=0;
   for(int smp=0;smp<num_train_data;smp++)
   {
-    if(((rand()%100000)/100000.0)>(num_smps_evaluate*1.0/num_train_data))
-      continue;
-    //copy the first layer
-    copy_vec(z[0], input_features[smp], num_units_ineach_layer[0]);
-    //forward propagation
-    for(int i=1;i<num_layers;i++)
-      forward_activation(i-1, weights[i-1], biases[i-1], z[i-1], z[i]);
-    //compute cross entropy loss
-    loss+=compute_cross_entropy_loss(z[num_layers-1], smp);
-    cnt++;
+    if(((rand()%100000)/100000.0)<=(num_smps_evaluate*1.0/num_train_data))
+      idxes_batch[num_smps++]=smp;
+    if(num_smps==size_minibatch||(smp==num_train_data-1&&num_smps>0)){
+      //forward propagation
+      forward_mini_batch(idxes_batch, num_smps, weights, biases, z);
+      //compute cross entropy loss
+      int dim=num_units_ineach_layer[num_layers-1];
+      for(int s=0;s<num_smps;s++)
+        loss+=compute_cross_entropy_loss(z[num_layers-1]+(size_t)s*dim, idxes_batch[s]);
+      cnt+=num_smps;
+      num_smps=0;
+    }
   }
   loss/=cnt;
-  for(int i=0;i<num_layers;i++)
-    delete[]z[i];
-  delete[]z;
+  delete[]idxes_batch;
   return loss;
 }
 
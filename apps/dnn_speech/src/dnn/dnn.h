@@ -68,18 +68,20 @@ private :
   int num_smps_evaluate;//when evaluating objective function, randomly sample <num_smps_evaluate> points to evaluate the objective function
   int num_iters_evaluate;//every <num_iters_evaluate> iterations, evaluate the objective function
 
-  //do forward activation
-  void forward_activation(int index_lower_layer, float ** local_weights, float * local_bias, float * visible, float * hidden);
+  //forward propagation of a mini batch; z[l] holds the activations of layer l, one row per data point
+  void forward_mini_batch(int * idxes_batch, int num_smps, float ** local_weights, float ** local_biases, float ** z);
+  //do forward activation of a mini batch, local_weights is row-major of size (units of higher layer) * (units of lower layer)
+  void forward_activation(int index_lower_layer, float * local_weights, float * local_bias, float * visible, float * hidden, int num_smps);
   //compute error in output layer
-  void compute_error_output_layer(float * error_output_layer, float * activation_output_layer,int idx_data);
+  void compute_error_output_layer(float * error_output_layer, float * activation_output_layer, int * idxes_batch, int num_smps);
   //compute backward error
-  void backward_error_computation(int index_lower_index, float ** local_weights, float * activation, float * error_lower_layer, float * error_higher_layer);
-  //compute the gradient of a single data point
-  void compute_gradient_single_data(int idx_data,float *** local_weights, float ** local_biases, float *** delta_weights, float ** delta_biases, float ** z, float ** delta);
+  void backward_error_computation(int index_lower_index, float * local_weights, float * activation, float * error_lower_layer, float * error_higher_layer, int num_smps);
+  //compute the gradient of a mini batch
+  void compute_gradient_mini_batch(int * idxes_batch, int num_smps, float ** local_weights, float ** local_biases, float ** delta_weights, float ** delta_biases, float ** z, float ** delta);
   //stochastic gradient descent on a mini batch
-  void sgd_mini_batch(int * idxes_batch, mat * weights, mat* biases, float *** local_weights, float ** local_biases, float *** delta_weights, float ** delta_biases, float ** z, float ** delta, int ** rand_idxes_weight, int * rand_idxes_bias);
-  //compute loss over the whole batch
-  float compute_loss( float*** weights, float** biases);
+  void sgd_mini_batch(int * idxes_batch, mat * weights, mat* biases, float ** local_weights, float ** local_biases, float ** delta_weights, float ** delta_biases, float ** z, float ** delta, int ** rand_idxes_weight, int * rand_idxes_bias);
+  //compute loss over the whole batch, z is a mini batch activation buffer
+  float compute_loss( float** weights, float** biases, float ** z);
   //compute the cross entropy loss
   float compute_cross_entropy_loss(float * output, int idx_data);
   //train neural network
@@ -36,10 +36,12 @@ void matrix_vector_multiply(mat W, float * a, float * b, int dim1, int dim2){
 
   for(int i=0;i<dim1;i++){
     W.Get(i, &row_acc);
-    const petuum::DenseRow<float>& r = row_acc.Get<petuum::DenseRow<float> >();
+    petuum::DenseRowView<float> r
+        = row_acc.GetView<petuum::DenseRow<float> >();
+    const float * w = r.data();
     float sum=0;
     for(int j=0;j<dim2;j++)
-      sum+=r[j]*a[j];
+      sum+=w[j]*a[j];
     b[i]=sum;
   }	
 }
@@ -47,7 +49,7 @@ void matrix_vector_multiply(mat W, float * a, float * b, int dim1, int dim2){
 void add_vector(float * a, mat b, int dim){
   petuum::RowAccessor row_acc;
   b.Get(0, &row_acc);
-  const petuum::DenseRow<float>& r = row_acc.Get<petuum::DenseRow<float> >();
+  petuum::DenseRowView<float> r = row_acc.GetView<petuum::DenseRow<float> >();
   for(int i=0;i<dim;i++)
     a[i]+=r[i];
 }
@@ -28,9 +28,16 @@
 // POSSIBILITY OF SUCH DAMAGE.
 #include "dnn.h"
 #include "util.h"
+#include <petuum_ps_common/util/dense_kernels.hpp>
+#include <algorithm>
 #include <iostream>
 #include <time.h>
 
+//number of floats of B kept in L2 cache while all rows of A go over them
+static const int gemm_block_size=32*1024;
+//widest column block of B, so that a row of the C block stays in L1 cache
+static const int gemm_block_cols=1024;
+
 int myrandom (int i) 
 { 
   std::srand(std::time(0));
@@ -86,6 +93,54 @@ void matrix_vector_multiply_colwise(float ** W, float * a, float * b, int dim1,
 	}
 }
 
+//C(m*n) += A * B(k*n), where A(i,p) is A[i*a_row_stride+p*a_col_stride]
+//each row of C is built with vectorized axpys over a block of B that stays in cache
+static void gemm_axpy_blocked(const float * A, int a_row_stride, int a_col_stride, const float * B, float * C, int m, int n, int k)
+{
+	int nb=std::min(n, gemm_block_cols);
+	int kb=std::max(1, gemm_block_size/std::max(nb, 1));
+	for(int n0=0;n0<n;n0+=nb)
+	{
+		int ncols=std::min(nb, n-n0);
+		for(int k0=0;k0<k;k0+=kb)
+		{
+			int k1=std::min(k0+kb, k);
+			for(int i=0;i<m;i++)
+			{
+				float * c=C+(size_t)i*n+n0;
+				for(int p=k0;p<k1;p++)
+					petuum::DenseScaledAdd(c, B+(size_t)p*n+n0, A[(size_t)i*a_row_stride+(size_t)p*a_col_stride], ncols);
+			}
+		}
+	}
+}
+//C(m*n) += A(m*k) * B(k*n)
+void gemm_nn(const float * A, const float * B, float * C, int m, int n, int k)
+{
+	gemm_axpy_blocked(A, k, 1, B, C, m, n, k);
+}
+//C(m*n) += A(k*m)^T * B(k*n)
+void gemm_tn(const float * A, const float * B, float * C, int m, int n, int k)
+{
+	gemm_axpy_blocked(A, 1, m, B, C, m, n, k);
+}
+//C(m*n) += A(m*k) * B(n*k)^T
+//every entry is a vectorized dot product of two rows; a block of rows of B stays in cache while all rows of A go over it
+void gemm_nt(const float * A, const float * B, float * C, int m, int n, int k)
+{
+	int nb=std::max(1, gemm_block_size/std::max(k, 1));
+	for(int n0=0;n0<n;n0+=nb)
+	{
+		int n1=std::min(n0+nb, n);
+		for(int i=0;i<m;i++)
+		{
+			const float * a=A+(size_t)i*k;
+			float * c=C+(size_t)i*n;
+			for(int j=n0;j<n1;j++)
+				c[j]+=petuum::DenseDot(a, B+(size_t)j*k, k);
+		}
+	}
+}
 
 //copy vectors
 void copy_vec(float * a, float * b, int dim)
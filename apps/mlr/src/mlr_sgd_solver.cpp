@@ -21,7 +21,9 @@ MLRSGDSolver::MLRSGDSolver(const MLRSGDSolverConfig& config) :
   num_labels_(config.num_labels), w_dim_(feature_dim_ * num_labels_) {
     w_cache_.resize(num_labels_);
     w_delta_.resize(num_labels_);
+    w_row_ids_.resize(num_labels_);
     for (int i = 0; i < num_labels_; ++i) {
+      w_row_ids_[i] = i;
       if (config.sparse_weight) {
         w_cache_[i] = new petuum::ml::SparseFeature<float>(feature_dim_);
         w_delta_[i] = new petuum::ml::SparseFeature<float>(feature_dim_);
@@ -79,6 +81,7 @@ void MLRSGDSolver::RefreshParamsDense() {
   }
 
   // Read w from the PS.
+  w_table_.GetBatch(w_row_ids_);
   for (int i = 0; i < num_labels_; ++i) {
     petuum::RowAccessor row_acc;
     w_table_.Get(i, &row_acc);
@@ -108,6 +111,7 @@ void MLRSGDSolver::RefreshParamsSparse() {
   }
 
   // Read w from the PS.
+  w_table_.GetBatch(w_row_ids_);
   for (int i = 0; i < num_labels_; ++i) {
     petuum::RowAccessor row_acc;
     w_table_.Get(i, &row_acc);
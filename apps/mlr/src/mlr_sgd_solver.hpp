@@ -62,6 +62,8 @@ private:
   // Thread-cache.
   std::vector<petuum::ml::AbstractFeature<float>*> w_cache_;
   std::vector<petuum::ml::AbstractFeature<float>*> w_delta_;
+  // Rows of w_table_, fetched together in RefreshParams().
+  std::vector<int32_t> w_row_ids_;
 
   int32_t feature_dim_; // feature dimension
   int32_t num_labels_; // number of classes/labels
@@ -28,6 +28,7 @@ num_trees=10
 max_depth=0
 num_data_subsample=0
 num_features_subsample=15
+num_bins=256
 compute_importance=true
 
 # Host file
@@ -105,6 +106,7 @@ for ip in $unique_host_list; do
       --max_depth=$max_depth \
       --num_data_subsample=$num_data_subsample \
       --num_features_subsample=$num_features_subsample \
+      --num_bins=$num_bins \
       --num_trees=$num_trees \
 	  --compute_importance=$compute_importance \
       --save_pred=$save_pred \
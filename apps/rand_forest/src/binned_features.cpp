@@ -0,0 +1,73 @@
+#include "binned_features.hpp"
+#include <glog/logging.h>
+#include <algorithm>
+
+namespace tree {
+
+namespace {
+
+// Sparse features only list the non-zero entries.
+void ToDense(const petuum::ml::AbstractFeature<float>& x,
+    std::vector<float>* dense) {
+  std::fill(dense->begin(), dense->end(), 0.);
+  for (int i = 0; i < x.GetNumEntries(); ++i) {
+    (*dense)[x.GetFeatureId(i)] = x.GetFeatureVal(i);
+  }
+}
+
+}  // anonymous namespace
+
+BinnedFeatures::BinnedFeatures(
+    const std::vector<petuum::ml::AbstractFeature<float>*>& features,
+    int32_t feature_dim, int32_t num_bins, int32_t sketch_size) :
+  num_data_(features.size()), upper_bounds_(feature_dim) {
+  CHECK_GT(num_data_, 0);
+  CHECK_GT(num_bins, 1);
+  CHECK_LE(num_bins, kMaxNumBins);
+  CHECK_GT(sketch_size, 0);
+
+  // Quantile sketch: every stride-th data.
+  int32_t stride = std::max(1, num_data_ / sketch_size);
+  std::vector<std::vector<float> > sketch(feature_dim);
+  std::vector<float> x(feature_dim);
+  for (int i = 0; i < num_data_; i += stride) {
+    ToDense(*features[i], &x);
+    for (int j = 0; j < feature_dim; ++j) {
+      sketch[j].push_back(x[j]);
+    }
+  }
+
+  for (int j = 0; j < feature_dim; ++j) {
+    std::vector<float>& values = sketch[j];
+    std::sort(values.begin(), values.end());
+    std::vector<float>& upper_bounds = upper_bounds_[j];
+    // Index of the b/num_bins quantile; it stays in [0, size) even when
+    // the sketch has fewer values than num_bins.
+    for (int b = 1; b <= num_bins; ++b) {
+      float upper_bound = values[
+        (static_cast<int64_t>(values.size()) * b - 1) / num_bins];
+      if (upper_bounds.empty() || upper_bound > upper_bounds.back()) {
+        upper_bounds.push_back(upper_bound);
+      }
+    }
+  }
+
+  // Values above the sketch's max go to the last bin, whose upper bound is
+  // then raised to the max value of the feature.
+  bins_.resize(static_cast<size_t>(feature_dim) * num_data_);
+  for (int i = 0; i < num_data_; ++i) {
+    ToDense(*features[i], &x);
+    for (int j = 0; j < feature_dim; ++j) {
+      std::vector<float>& upper_bounds = upper_bounds_[j];
+      int32_t bin = std::lower_bound(upper_bounds.begin(),
+          upper_bounds.end(), x[j]) - upper_bounds.begin();
+      if (bin == upper_bounds.size()) {
+        --bin;
+        upper_bounds.back() = x[j];
+      }
+      bins_[static_cast<size_t>(j) * num_data_ + i] = bin;
+    }
+  }
+}
+
+}  // namespace tree
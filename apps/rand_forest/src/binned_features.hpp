@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <ml/include/ml.hpp>
+
+namespace tree {
+
+// BinnedFeatures is a column-major copy of the training features in which
+// each value is replaced by the index of its quantile bin. It is built once
+// after the data is loaded and is read-only afterwards, so all trees of all
+// app threads share it.
+//
+// Bin b of a feature holds the values in (GetBinUpperBound(b - 1),
+// GetBinUpperBound(b)], so splitting after bin b is the same as the split
+// "feature <= GetBinUpperBound(b)" on the training data.
+class BinnedFeatures {
+public:
+  static const int32_t kMaxNumBins = 256;
+
+  // Cut points of each feature are the quantiles of (at most) sketch_size
+  // sampled data, giving at most num_bins bins per feature.
+  BinnedFeatures(
+      const std::vector<petuum::ml::AbstractFeature<float>*>& features,
+      int32_t feature_dim, int32_t num_bins, int32_t sketch_size);
+
+  int32_t GetNumData() const {
+    return num_data_;
+  }
+
+  int32_t GetNumBins(int32_t feature_id) const {
+    return upper_bounds_[feature_id].size();
+  }
+
+  // Bins of feature_id for all data, indexed by data idx.
+  const uint8_t* GetBins(int32_t feature_id) const {
+    return &bins_[static_cast<size_t>(feature_id) * num_data_];
+  }
+
+  float GetBinUpperBound(int32_t feature_id, int32_t bin) const {
+    return upper_bounds_[feature_id][bin];
+  }
+
+private:
+  int32_t num_data_;
+
+  // upper_bounds_[feature_id] is ascending; the last one is the max value of
+  // the feature.
+  std::vector<std::vector<float> > upper_bounds_;
+
+  // bins_[feature_id * num_data_ + data_idx].
+  std::vector<uint8_t> bins_;
+};
+
+}  // namespace tree
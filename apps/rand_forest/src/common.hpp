@@ -27,6 +27,8 @@ DECLARE_int32(num_trees);
 DECLARE_int32(max_depth);
 DECLARE_int32(num_data_subsample);
 DECLARE_int32(num_features_subsample);
+DECLARE_int32(num_bins);
+DECLARE_int32(bin_sketch_size);
 
 // Save and Load
 DECLARE_bool(save_pred);
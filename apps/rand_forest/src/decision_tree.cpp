@@ -13,7 +13,7 @@
 
 namespace tree {
 
-DecisionTree::DecisionTree(std::string input): features_(0), labels_(0),
+DecisionTree::DecisionTree(std::string input): binned_features_(0), labels_(0),
   num_data_(0), max_depth_(0), num_data_subsample_(0),
   num_features_subsample_(0), num_labels_(0), feature_dim_(0) {
 
@@ -30,11 +30,11 @@ DecisionTree::DecisionTree(std::string input): features_(0), labels_(0),
 
 void DecisionTree::Init(const DecisionTreeConfig& config) {
   CHECK(!root_) << "Tree is already built.";
-  features_ = config.features;
+  binned_features_ = config.binned_features;
   labels_ = config.labels;
-  CHECK_NOTNULL(features_);
+  CHECK_NOTNULL(binned_features_);
   CHECK_NOTNULL(labels_);
-  num_data_ = features_->size();
+  num_data_ = binned_features_->GetNumData();
   // Tree configs.
   max_depth_ = config.max_depth;
   num_data_subsample_ = config.num_data_subsample;
@@ -92,7 +92,9 @@ std::string DecisionTree::GetSerializedTree(){
 
 TreeNode* DecisionTree::RecursiveBuild(int32_t depth,
     const std::vector<int32_t>& available_data_idx,
-    const std::vector<int32_t>& available_feature_ids, TreeNode* curr_node) {
+    const std::vector<int32_t>& available_feature_ids, TreeNode* curr_node,
+    const Histograms* parent_hists,
+    const std::vector<int32_t>* sibling_data_idx) {
   std::vector<int32_t> sub_data_idx = available_data_idx;
 
   if (curr_node == 0) {
@@ -130,16 +132,20 @@ TreeNode* DecisionTree::RecursiveBuild(int32_t depth,
 
   // Find a split.
   int32_t split_feature_id = 0;
-  float split_feature_val = 0;
+  int32_t split_bin = 0;
   float gain_ratio_val = 0;
-  int32_t split_feature_idx = FindSplit(sub_data_idx,
-      sub_feature_ids, &split_feature_id, &split_feature_val, &gain_ratio_val);
-  curr_node->Split(split_feature_id, split_feature_val, gain_ratio_val);
-
-  // Partition the data by split_feature_val.
+  Histograms hists;
+  int32_t split_feature_idx = FindSplit(sub_data_idx, sub_feature_ids,
+      parent_hists, sibling_data_idx, &hists, &split_feature_id, &split_bin,
+      &gain_ratio_val);
+  curr_node->Split(split_feature_id,
+      binned_features_->GetBinUpperBound(split_feature_id, split_bin),
+      gain_ratio_val);
+
+  // Partition the data by split_bin.
   std::vector<int32_t> left_partition;
   std::vector<int32_t> right_partition;
-  PartitionData(split_feature_id, split_feature_val, sub_data_idx,
+  PartitionData(split_feature_id, split_bin, sub_data_idx,
       &left_partition, &right_partition);
 
   // Remove split_feature_id from available_feature_ids.
@@ -147,45 +153,59 @@ TreeNode* DecisionTree::RecursiveBuild(int32_t depth,
     available_feature_ids_copy[available_feature_ids.size() - 1];
   available_feature_ids_copy.pop_back();
 
-  // Build left subtree (ignore the returned TreeNode*).
+  // Build left subtree (ignore the returned TreeNode*). The smaller child
+  // builds its histograms from its own data, and the larger one subtracts
+  // the smaller one's from hists where it can.
   TreeNode* left_child = curr_node->GetLeftChild();
   TreeNode* right_child = curr_node->GetRightChild();
+  bool left_is_larger = left_partition.size() > right_partition.size();
   if (left_partition.size() == 0) {
     left_child->SetLeafVal(ComputeLeafVal(sub_data_idx));
   } else {
     RecursiveBuild(depth + 1, left_partition, available_feature_ids_copy,
-      left_child);
+      left_child, left_is_larger ? &hists : 0,
+      left_is_larger ? &right_partition : 0);
   }
   if (right_partition.size() == 0) {
     right_child->SetLeafVal(ComputeLeafVal(sub_data_idx));
   } else {
     RecursiveBuild(depth + 1, right_partition, available_feature_ids_copy,
-      right_child);
+      right_child, left_is_larger ? 0 : &hists,
+      left_is_larger ? 0 : &left_partition);
   }
   return curr_node;
 }
 
 int32_t DecisionTree::FindSplit(const std::vector<int32_t>& sub_data_idx,
     const std::vector<int32_t>& sub_feature_ids,
-    int32_t* split_feature_id, float* split_feature_val, float* gain_ratio_val) const {
+    const Histograms* parent_hists,
+    const std::vector<int32_t>* sibling_data_idx, Histograms* hists,
+    int32_t* split_feature_id, int32_t* split_bin, float* gain_ratio_val) const {
   int32_t split_feature_idx = 0;
-  float best_gain_ratio = std::numeric_limits<float>::min();
+  float best_gain_ratio = -1.;
 
   for (int i = 0; i < sub_feature_ids.size(); ++i) {
-    // For each feature, add feature val and label of each sample
-    SplitFinder split_finder(num_labels_);
-    for (int j = 0; j < sub_data_idx.size(); ++j) {
-      split_finder.AddInstance(
-          (*(*features_)[sub_data_idx[j]])[sub_feature_ids[i]],
-          (*labels_)[sub_data_idx[j]]);
+    // For each feature, build the (bin, label) histogram of the samples.
+    int32_t feature_id = sub_feature_ids[i];
+    int32_t num_bins = binned_features_->GetNumBins(feature_id);
+    SplitFinder& split_finder = hists->emplace(feature_id,
+        SplitFinder(num_labels_, num_bins)).first->second;
+    Histograms::const_iterator parent_it;
+    if (parent_hists != 0 &&
+        (parent_it = parent_hists->find(feature_id)) != parent_hists->end()) {
+      SplitFinder sibling_split_finder(num_labels_, num_bins);
+      BuildHistogram(feature_id, *sibling_data_idx, &sibling_split_finder);
+      split_finder.Subtract(parent_it->second, sibling_split_finder);
+    } else {
+      BuildHistogram(feature_id, sub_data_idx, &split_finder);
     }
     // Compute gain ratio of the feature
     float gain_ratio;
-    float split_val = split_finder.FindSplitValue(&gain_ratio);
+    int32_t bin = split_finder.FindSplitBin(&gain_ratio);
     // Compare gain ratio of different features
     if (gain_ratio > best_gain_ratio) {
       best_gain_ratio = gain_ratio;
-      *split_feature_val = split_val;
+      *split_bin = bin;
       split_feature_idx = i;
     }
 
@@ -195,14 +215,23 @@ int32_t DecisionTree::FindSplit(const std::vector<int32_t>& sub_data_idx,
   return split_feature_idx;
 }
 
-void DecisionTree::PartitionData(int32_t feature_id, float feature_val,
+void DecisionTree::BuildHistogram(int32_t feature_id,
+    const std::vector<int32_t>& data_idx, SplitFinder* split_finder) const {
+  const uint8_t* bins = binned_features_->GetBins(feature_id);
+  for (int i = 0; i < data_idx.size(); ++i) {
+    split_finder->AddInstance(bins[data_idx[i]], (*labels_)[data_idx[i]]);
+  }
+}
+
+void DecisionTree::PartitionData(int32_t feature_id, int32_t split_bin,
     const std::vector<int32_t>& data_idx,
     std::vector<int32_t>* left_partition,
     std::vector<int32_t>* right_partition) const {
   left_partition->clear();
   right_partition->clear();
+  const uint8_t* bins = binned_features_->GetBins(feature_id);
   for (int i = 0; i < data_idx.size(); ++i) {
-    if ((*(*features_)[data_idx[i]])[feature_id] <= feature_val) {
+    if (bins[data_idx[i]] <= split_bin) {
       left_partition->push_back(data_idx[i]);
     } else {
       right_partition->push_back(data_idx[i]);
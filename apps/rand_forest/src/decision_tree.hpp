@@ -10,6 +10,8 @@
 #include "utils.hpp"
 #include <random>
 #include <memory>
+#include <unordered_map>
+#include "binned_features.hpp"
 #include "split_finder.hpp"
 #include <string>
 #include <sstream>
@@ -34,13 +36,13 @@ struct DecisionTreeConfig {
   int32_t feature_dim;
 
   // Data
-  std::vector<petuum::ml::AbstractFeature<float>*>* features;
+  const BinnedFeatures* binned_features;
   std::vector<int32_t>* labels;
 };
 
 class DecisionTree {
 public:
-  DecisionTree() : features_(0), labels_(0) { };
+  DecisionTree() : binned_features_(0), labels_(0) { };
   
   // Construct a tree from string of serialized tree
   DecisionTree(std::string input);
@@ -60,22 +62,34 @@ public:
   void Deserialize(TreeNode *p, std::istringstream &in);
 
 private:    // private methods.
-  // Internal build method.
+  // Label histograms of a node, keyed by feature id.
+  typedef std::unordered_map<int32_t, SplitFinder> Histograms;
+
+  // Internal build method. parent_hists and sibling_data_idx are given to
+  // the larger child of a split, which then gets the histograms of the
+  // features its parent also has as parent's minus sibling's.
   TreeNode* RecursiveBuild(int32_t depth,
       const std::vector<int32_t>& available_data_idx,
       const std::vector<int32_t>& available_feature_ids,
-      TreeNode* curr_node = 0);
+      TreeNode* curr_node = 0, const Histograms* parent_hists = 0,
+      const std::vector<int32_t>* sibling_data_idx = 0);
 
-  // Find the feature (among sub_feature_ids) to split and split value using
-  // subset of data (sub_data_idx). Return idx such that sub_feature_ids[idx]
-  // = *split_feature_id.
+  // Find the feature (among sub_feature_ids) to split and split bin using
+  // subset of data (sub_data_idx), and return the histogram of each feature
+  // in hists. Return idx such that sub_feature_ids[idx] = *split_feature_id.
   int32_t FindSplit(const std::vector<int32_t>& sub_data_idx,
       const std::vector<int32_t>& sub_feature_ids,
-      int32_t* split_feature_id, float* split_feature_val, float* gain_ratio) const;
+      const Histograms* parent_hists,
+      const std::vector<int32_t>* sibling_data_idx, Histograms* hists,
+      int32_t* split_feature_id, int32_t* split_bin, float* gain_ratio) const;
+
+  // Add the (bin, label) of 'feature_id' of data_idx to split_finder.
+  void BuildHistogram(int32_t feature_id,
+      const std::vector<int32_t>& data_idx, SplitFinder* split_finder) const;
 
   // Partition 'data_idx' into left_partition (whose 'feature_id' feature
-  // <= feature_val), and right_partition.
-  void PartitionData(int32_t feature_id, float feature_val,
+  // falls in a bin <= split_bin), and right_partition.
+  void PartitionData(int32_t feature_id, int32_t split_bin,
       const std::vector<int32_t>& data_idx,
       std::vector<int32_t>* left_partition,
       std::vector<int32_t>* right_partition) const;
@@ -90,8 +104,8 @@ private:    // private methods.
   void Serialize(TreeNode *p, std::string &out);
 
 private:
-  // Underlying data (features and labels).
-  const std::vector<petuum::ml::AbstractFeature<float>*>* features_;
+  // Underlying data (binned features and labels).
+  const BinnedFeatures* binned_features_;
   const std::vector<int32_t>* labels_;
   int32_t num_data_;
 
@@ -115,6 +115,11 @@ void RandForestEngine::ReadData(std::string type) {
           &train_features_, &train_labels_, feature_one_based_,
           label_one_based_);
     }
+    petuum::HighResolutionTimer bin_timer;
+    binned_features_.reset(new BinnedFeatures(train_features_, feature_dim_,
+          FLAGS_num_bins, FLAGS_bin_sketch_size));
+    LOG(INFO) << "Binned " << train_features_.size() << " train data in "
+      << bin_timer.elapsed() << " seconds.";
   }
   if (type == "test") {
     if (read_format_ == "bin") {
@@ -142,7 +147,7 @@ void RandForestEngine::Start() {
   dt_config.num_features_subsample = FLAGS_num_features_subsample;
   dt_config.num_labels = num_labels_;
   dt_config.feature_dim = feature_dim_;
-  dt_config.features = &train_features_;
+  dt_config.binned_features = binned_features_.get();
   dt_config.labels = &train_labels_;
 
   // Set number of trees assigned to each thread
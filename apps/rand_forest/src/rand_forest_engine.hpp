@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "binned_features.hpp"
 #include "decision_tree.hpp"
 #include "rand_forest.hpp"
 #include <ml/include/ml.hpp>
@@ -11,6 +12,7 @@
 #include <vector>
 #include <cstdint>
 #include <atomic>
+#include <memory>
 #include <utility>
 
 namespace tree {
@@ -92,6 +94,9 @@ private:
   // train_labels_.size() == train_features_.size()
   std::vector<int32_t> train_labels_;
 
+  // Binned copy of train_features_ that the trees are built from.
+  std::unique_ptr<BinnedFeatures> binned_features_;
+
   std::vector<petuum::ml::AbstractFeature<float>*> test_features_;
   std::vector<int32_t> test_labels_;
 
@@ -42,6 +42,10 @@ DEFINE_int32(max_depth, 1, "max depth of each decision tree.");
 DEFINE_int32(num_data_subsample, 100, "# data used in determining each split");
 DEFINE_int32(num_features_subsample, 3, "# of randomly selected features to "
     "consider for a split.");
+DEFINE_int32(num_bins, 256, "Max # of quantile bins of each feature. Splits "
+    "are only considered between bins. At most 256.");
+DEFINE_int32(bin_sketch_size, 100000, "# of train data sampled to compute "
+    "the quantile bins of each feature.");
 
 // Save and Load
 DEFINE_bool(save_pred, false, "Prediction of test set will be saved "
@@ -3,109 +3,78 @@
 
 #include "split_finder.hpp"
 #include "utils.hpp"
-#include <algorithm>
 #include <glog/logging.h>
-#include <limits>
-#include <random>
-#include <math.h>
 
 namespace tree {
 
-SplitFinder::SplitFinder(int32_t num_labels) :
-  num_labels_(num_labels), pre_split_entropy_(0.) { }
+SplitFinder::SplitFinder(int32_t num_labels, int32_t num_bins) :
+  num_labels_(num_labels), num_bins_(num_bins),
+  hist_(num_labels * num_bins) { }
 
-void SplitFinder::AddInstance(float feature_val, int32_t label,
-    float weight) {
-  FeatureEntry new_entry;
-  new_entry.feature_val = feature_val;
-  new_entry.label = label;
-  new_entry.weight = weight;
-  entries_.push_back(new_entry);
-}
-
-void SplitFinder::AddInstanceDedup(float feature_val,
-    int32_t label, float weight) {
-  // To be optimized
-  for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
-    if ((iter->feature_val == feature_val)
-        && (iter->label == label)) {
-      iter->weight += weight;
-      return;
-    }
+void SplitFinder::Subtract(const SplitFinder& parent,
+    const SplitFinder& sibling) {
+  CHECK_EQ(hist_.size(), parent.hist_.size());
+  CHECK_EQ(hist_.size(), sibling.hist_.size());
+  for (int i = 0; i < hist_.size(); ++i) {
+    hist_[i] = parent.hist_[i] - sibling.hist_[i];
   }
-
-  // This is a new feature_val-label combo.
-  AddInstance(feature_val, label, weight);
 }
 
-float SplitFinder::FindSplitValue(float* gain_ratio) {
-  SortEntries();
-  // Compute entropy of label
-  std::vector<float> label_distribution(num_labels_, 0);
-  for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
-    label_distribution[iter->label] += 1;
+int32_t SplitFinder::FindSplitBin(float* gain_ratio) const {
+  // Label counts of all instances, and of the bins <= b as b goes up.
+  std::vector<double> total(num_labels_);
+  for (int b = 0; b < num_bins_; ++b) {
+    for (int k = 0; k < num_labels_; ++k) {
+      total[k] += hist_[b * num_labels_ + k];
+    }
   }
+  std::vector<float> label_distribution(total.begin(), total.end());
   Normalize(&label_distribution);
-  pre_split_entropy_ = ComputeEntropy(label_distribution);
-
-  float min_value = entries_.begin()->feature_val;
-  float max_value = entries_.back().feature_val;
-
-  // Find distinct feature values
-  std::vector<float> feature_value_dist;
-  feature_value_dist.push_back(min_value);
-  if (max_value > min_value) { 
-    for (int i = 1; i < entries_.size(); i++) {
-      if (entries_[i].feature_val > feature_value_dist.back()) {
-        feature_value_dist.push_back(entries_[i].feature_val);
-      }
-    }    
-  }
-
-  std::random_device rd;
-  std::mt19937 mt(rd());
-  std::uniform_real_distribution<float> dist(min_value, max_value);
-
-  float best_gain_ratio = std::numeric_limits<float>::min();
-  float best_split_val = min_value;
-  for (int i = 0; i < feature_value_dist.size(); ++i) {
-      // Randomly generate a split threshold
-      float rand_split = dist(mt);
-      float gain_ratio = ComputeGainRatio(rand_split);
-
-      if (gain_ratio > best_gain_ratio) {
-        best_gain_ratio = gain_ratio;
-        best_split_val = rand_split;
-      }
+  float pre_split_entropy = ComputeEntropy(label_distribution);
+
+  float best_gain_ratio = 0.;
+  int32_t best_split_bin = num_bins_ - 1;
+  std::vector<double> left(num_labels_);
+  std::vector<float> left_count(num_labels_);
+  std::vector<float> right_count(num_labels_);
+  for (int b = 0; b < num_bins_ - 1; ++b) {
+    double left_weight = 0.;
+    double right_weight = 0.;
+    for (int k = 0; k < num_labels_; ++k) {
+      left[k] += hist_[b * num_labels_ + k];
+      left_count[k] = left[k];
+      right_count[k] = total[k] - left[k];
+      left_weight += left[k];
+      right_weight += total[k] - left[k];
+    }
+    if (left_weight == 0. || right_weight == 0.) {
+      continue;
+    }
+    float split_gain_ratio = ComputeGainRatio(pre_split_entropy,
+        left_count, right_count);
+    if (split_gain_ratio > best_gain_ratio) {
+      best_gain_ratio = split_gain_ratio;
+      best_split_bin = b;
     }
+  }
   if (gain_ratio != 0) {
     *gain_ratio = best_gain_ratio;
   }
-  return best_split_val;
+  return best_split_bin;
 }
 
 // ================== Private Functions ===============
 
-void SplitFinder::SortEntries() {
-  std::sort(entries_.begin(), entries_.end(),
-      [] (const FeatureEntry& i, const FeatureEntry& j) {
-      return (i.feature_val < j.feature_val ||
-        (i.feature_val == j.feature_val && i.label < j.label)); });
-}
-
-float SplitFinder::ComputeGainRatio(float split_val) {
-  std::vector<float> left_dist(num_labels_);    // left distribution.
-  std::vector<float> right_dist(num_labels_);
+float SplitFinder::ComputeGainRatio(float pre_split_entropy,
+    const std::vector<float>& left_count,
+    const std::vector<float>& right_count) const {
+  std::vector<float> left_dist = left_count;    // left distribution.
+  std::vector<float> right_dist = right_count;
   float left_dist_weight = 0.;
   float right_dist_weight = 0.;
-  for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
-    if (iter->feature_val <= split_val) {
-      left_dist[iter->label] += iter->weight;
-      left_dist_weight += iter->weight;
-    } else {
-      right_dist[iter->label] += iter->weight;
-      right_dist_weight += iter->weight;
-    }
+  for (int k = 0; k < num_labels_; ++k) {
+    left_dist_weight += left_count[k];
+    right_dist_weight += right_count[k];
   }
 
   // Normalize
@@ -126,7 +95,7 @@ float SplitFinder::ComputeGainRatio(float split_val) {
     split_dist[1] * right_entropy;
 
   // information gain
-  float info_gain = pre_split_entropy_ - cond_entropy;
+  float info_gain = pre_split_entropy - cond_entropy;
   Normalize(&split_dist);
   float splitinfo = ComputeEntropy(split_dist);
   float gain_ratio = info_gain / splitinfo;
@@ -8,48 +8,47 @@
 
 namespace tree {
 
-// a <feature_val, label, weight> triplet.
-struct FeatureEntry {
-  float feature_val;
-  int32_t label;
-  float weight;   // can represent counts as well.
-};
-
-// SplitFinder finds the split of a feature using gain ratio criterion.
+// SplitFinder finds the split of a binned feature (see BinnedFeatures) using
+// gain ratio criterion. It keeps a (bin, label) histogram of the instances,
+// so adding an instance is O(1) and finding the split is
+// O(num_bins * num_labels) regardless of the number of instances.
 class SplitFinder {
 public:
-  SplitFinder(int32_t num_labels);
+  SplitFinder(int32_t num_labels, int32_t num_bins);
 
-  // Add an instance with feature_val (continuous) and label. It will just
-  // append the instance to the entries_.
-  void AddInstance(float feature_val, int32_t label, float weight = 1.);
+  // Add an instance whose feature value falls in bin.
+  void AddInstance(int32_t bin, int32_t label, float weight = 1.) {
+    hist_[bin * num_labels_ + label] += weight;
+  }
 
-  // Add an instance with feature_val (continuous) and label. The entries_
-  // will merge same instances.
-  void AddInstanceDedup(float feature_val, int32_t label, float weight = 1.);
+  // Set the histogram to parent's minus sibling's, i.e., the histogram of
+  // the instances of parent that are not in sibling. All three must have
+  // the same num_labels and num_bins.
+  void Subtract(const SplitFinder& parent, const SplitFinder& sibling);
 
-  // Select a split value to maximize computing gain ratio.
-  // Return best split value for a continuous feature. Optionally return
-  // gain_ratio.
-  float FindSplitValue(float* gain_ratio = 0);
+  // Select the bin to split after (bins <= the returned bin go left) to
+  // maximize gain ratio. Optionally return gain_ratio. If no split separates
+  // the instances, return the last bin and a gain_ratio of 0.
+  int32_t FindSplitBin(float* gain_ratio = 0) const;
 
 private:  // private functions
   friend class SplitFinderTest;
 
-  // Sort entries_ by (feature_val, label) pair (feature_val compared first).
-  void SortEntries();
-
-  // Return the gain ratio for this split_val.
-  float ComputeGainRatio(float split_val);
+  // Return the gain ratio for splitting into the left and right label
+  // counts, given the entropy of label before split.
+  float ComputeGainRatio(float pre_split_entropy,
+      const std::vector<float>& left_count,
+      const std::vector<float>& right_count) const;
 
 private:
-  std::vector<FeatureEntry> entries_;
-
   // # of output labels.
   int32_t num_labels_;
 
-  // Entropy of label (i.e., entropy before split).
-  float pre_split_entropy_;
+  int32_t num_bins_;
+
+  // hist_[bin * num_labels_ + label] is the total weight of the instances in
+  // (bin, label).
+  std::vector<double> hist_;
 };
 
 }  // namespace tree
@@ -0,0 +1,56 @@
+// Output format shared by the ps_bench suite, one result per line:
+//
+//   benchmark <TAB> case <TAB> params <TAB> value <TAB> unit
+//
+// params is a comma-separated list of key=value. Lines starting with '#'
+// are comments. Outputs of several runs can be concatenated and compared
+// line by line on (benchmark, case, params).
+
+#pragma once
+
+#include <stdio.h>
+#include <sstream>
+#include <string>
+
+namespace petuum {
+namespace bench {
+
+inline void PrintHeader(const char *benchmark) {
+  printf("# %s\n# benchmark\tcase\tparams\tvalue\tunit\n", benchmark);
+  fflush(stdout);
+}
+
+inline void Report(const char *benchmark, const std::string &case_name,
+                   const std::string &params, double value,
+                   const char *unit) {
+  printf("%s\t%s\t%s\t%.4f\t%s\n", benchmark, case_name.c_str(),
+         params.c_str(), value, unit);
+  fflush(stdout);
+}
+
+// Builds the params column, e.g. Params().Add("rows", 10).str().
+class Params {
+public:
+  Params():
+      empty_(true) { }
+
+  template<typename T>
+  Params &Add(const char *key, const T &value) {
+    if (!empty_)
+      ss_ << ",";
+    ss_ << key << "=" << value;
+    empty_ = false;
+    return *this;
+  }
+
+  std::string str() const {
+    return ss_.str();
+  }
+
+private:
+  std::stringstream ss_;
+  bool empty_;
+};
+
+}  // namespace bench
+}  // namespace petuum
@@ -0,0 +1,36 @@
+# Benchmarks, built against the ps library.
+#
+#   make dense_kernels_bench
+#   make oplog_select_bench
+#   make ps_bench              (all of the ps_*_bench below; run them with
+#                               benchmarks/run_ps_bench.sh)
+
+BENCHMARKS_DIR = $(PROJECT)/benchmarks
+BENCHMARKS_BIN = $(BIN)/benchmarks
+
+dense_kernels_bench: $(BENCHMARKS_BIN)/dense_kernels_bench
+
+$(BENCHMARKS_BIN)/dense_kernels_bench: \
+		$(BENCHMARKS_DIR)/dense_kernels_bench.cpp $(PS_LIB)
+	mkdir -p $(BENCHMARKS_BIN)
+	$(CXX) $(CXXFLAGS) $(INCFLAGS) $< $(PS_LIB) $(LDFLAGS) -o $@
+
+oplog_select_bench: $(BENCHMARKS_BIN)/oplog_select_bench
+
+$(BENCHMARKS_BIN)/oplog_select_bench: \
+		$(BENCHMARKS_DIR)/oplog_select_bench.cpp $(PS_LIB)
+	mkdir -p $(BENCHMARKS_BIN)
+	$(CXX) $(CXXFLAGS) $(INCFLAGS) $< $(PS_LIB) $(LDFLAGS) -o $@
+
+PS_BENCHMARKS = ps_row_bench ps_oplog_bench ps_server_bench ps_table_bench
+
+ps_bench: $(PS_BENCHMARKS)
+
+$(PS_BENCHMARKS): %: $(BENCHMARKS_BIN)/%
+
+$(BENCHMARKS_BIN)/ps_%_bench: $(BENCHMARKS_DIR)/ps_%_bench.cpp \
+		$(BENCHMARKS_DIR)/bench_report.hpp $(PS_LIB)
+	mkdir -p $(BENCHMARKS_BIN)
+	$(CXX) $(CXXFLAGS) $(INCFLAGS) $< $(PS_LIB) $(LDFLAGS) -o $@
+
+.PHONY: dense_kernels_bench oplog_select_bench ps_bench $(PS_BENCHMARKS)
@@ -0,0 +1,102 @@
+// Microbenchmark of the dense bulk-add kernels against the per-column
+// AddUpdates() path they replace.
+//
+// Usage: dense_kernels_bench [--row_size=N] [--num_reps=N]
+
+#include <petuum_ps_common/util/dense_kernels.hpp>
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <petuum_ps_common/storage/dense_row.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+
+DEFINE_int32(row_size, 0, "Row size; 0 runs 10^4, 10^5 and 10^6.");
+DEFINE_int32(num_reps, 0, "Repetitions per case; 0 picks ~10^9 elements.");
+
+namespace {
+
+const char *TypeName(float) { return "float"; }
+const char *TypeName(double) { return "double"; }
+const char *TypeName(int32_t) { return "int32"; }
+
+void Report(const char *kernel, const char *type, int32_t row_size,
+            int32_t num_reps, size_t elem_size, double seconds) {
+  double num_elems = double(row_size) * num_reps;
+  // Each element reads x and y and writes x.
+  printf("%s\t%s\t%d\t%.3f\t%.3f\n", kernel, type, row_size,
+         num_elems / seconds * 1e-9,
+         num_elems * elem_size * 3 / seconds * 1e-9);
+}
+
+template<typename V>
+void BenchType(int32_t row_size, int32_t num_reps) {
+  std::vector<V> x(row_size, V(1)), y(row_size, V(2));
+  const char *type = TypeName(V());
+  petuum::DenseRow<V> sample_row;
+  // Tables only see the row through a base pointer; keep the compiler from
+  // devirtualizing AddUpdates() here.
+  const petuum::AbstractRow * volatile row_ptr = &sample_row;
+  const petuum::AbstractRow *row = row_ptr;
+
+  petuum::HighResolutionTimer timer;
+  for (int32_t r = 0; r < num_reps; ++r) {
+    for (int32_t i = 0; i < row_size; ++i)
+      row->AddUpdates(i, &x[i], &y[i]);
+  }
+  Report("add_per_column", type, row_size, num_reps, sizeof(V),
+         timer.elapsed());
+
+  timer.restart();
+  for (int32_t r = 0; r < num_reps; ++r)
+    row->AddDenseUpdates(0, x.data(), y.data(), row_size);
+  Report("add_dense", type, row_size, num_reps, sizeof(V), timer.elapsed());
+
+  timer.restart();
+  for (int32_t r = 0; r < num_reps; ++r) {
+    for (int32_t i = 0; i < row_size; ++i)
+      x[i] += V(3) * y[i];
+  }
+  Report("scaled_add_loop", type, row_size, num_reps, sizeof(V),
+         timer.elapsed());
+
+  timer.restart();
+  for (int32_t r = 0; r < num_reps; ++r)
+    petuum::DenseScaledAdd(x.data(), y.data(), V(3), row_size);
+  Report("scaled_add_dense", type, row_size, num_reps, sizeof(V),
+         timer.elapsed());
+
+  // Keep the results alive.
+  volatile V sink = x[row_size / 2];
+  (void) sink;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  std::vector<int32_t> row_sizes;
+  if (FLAGS_row_size > 0) {
+    row_sizes.push_back(FLAGS_row_size);
+  } else {
+    row_sizes.push_back(10000);
+    row_sizes.push_back(100000);
+    row_sizes.push_back(1000000);
+  }
+
+  printf("# isa = %s\n", petuum::GetDenseKernelISA());
+  printf("# kernel\ttype\trow_size\tgelem_per_sec\tgbyte_per_sec\n");
+  for (auto row_size : row_sizes) {
+    int32_t num_reps = FLAGS_num_reps > 0 ? FLAGS_num_reps
+                       : std::max(1, 1000000000 / row_size);
+    BenchType<float>(row_size, num_reps);
+    BenchType<double>(row_size, num_reps);
+    BenchType<int32_t>(row_size, num_reps);
+  }
+  return 0;
+}
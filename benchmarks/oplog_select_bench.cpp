@@ -0,0 +1,210 @@
+// Microbenchmark of picking the next rows to push in update sort policy
+// order, on the client (TableOpLogMeta) and on the server (candidate rows),
+// against the full sorts they replace.
+//
+// Usage: oplog_select_bench [--num_rows=N] [--num_reps=N]
+
+#include <petuum_ps/thread/table_oplog_meta.hpp>
+#include <petuum_ps/server/server_table.hpp>
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <petuum_ps_common/storage/dense_row.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <list>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+DEFINE_int32(num_rows, 0, "Pending rows; 0 runs 10^4, 10^5 and 10^6.");
+DEFINE_int32(num_reps, 3, "Repetitions per case.");
+
+namespace {
+
+typedef std::pair<int32_t, petuum::RowOpLogMeta*> MetaPair;
+
+const char *PolicyName(petuum::UpdateSortPolicy policy) {
+  switch (policy) {
+    case petuum::FIFO: return "FIFO";
+    case petuum::RelativeMagnitude: return "RelativeMagnitude";
+    case petuum::FIFO_N_ReMag: return "FIFO_N_ReMag";
+    default: return "Random";
+  }
+}
+
+bool CompClock(const MetaPair &oplog1, const MetaPair &oplog2) {
+  if (oplog1.second->get_clock() == oplog2.second->get_clock())
+    return oplog1.first < oplog2.first;
+  return oplog1.second->get_clock() < oplog2.second->get_clock();
+}
+
+bool CompImportance(const MetaPair &oplog1, const MetaPair &oplog2) {
+  if (oplog1.second->get_importance() == oplog2.second->get_importance())
+    return oplog1.first < oplog2.first;
+  return oplog1.second->get_importance() > oplog2.second->get_importance();
+}
+
+void MakeMetas(int32_t num_rows, std::vector<petuum::RowOpLogMeta> *metas) {
+  std::mt19937 gen(num_rows);
+  std::exponential_distribution<double> importance(1.0);
+  std::uniform_int_distribution<int32_t> clock(0, 9);
+  metas->resize(num_rows);
+  for (auto &meta : *metas) {
+    meta.set_clock(clock(gen));
+    meta.set_importance(importance(gen));
+  }
+}
+
+// taken_sum adds up the ids of the rows taken, so that the work is not
+// optimized away and methods taking the same rows can be told apart from
+// ones that don't.
+void Report(const char *side, const char *method,
+            petuum::UpdateSortPolicy policy, int32_t num_rows,
+            int32_t num_taken, int32_t num_reps, double seconds,
+            int64_t taken_sum) {
+  printf("%s\t%s\t%s\t%d\t%d\t%.3f\t%ld\n", side, method,
+         PolicyName(policy), num_rows, num_taken, seconds / num_reps * 1e3,
+         long(taken_sum / num_reps));
+}
+
+// The list sort TableOpLogMeta used to do.
+void BenchClientListSort(petuum::UpdateSortPolicy policy,
+                         const std::vector<petuum::RowOpLogMeta> &metas,
+                         int32_t num_taken, int32_t num_reps) {
+  double seconds = 0;
+  int64_t taken_sum = 0;
+  for (int32_t r = 0; r < num_reps; ++r) {
+    std::list<MetaPair> oplog_list;
+    for (size_t i = 0; i < metas.size(); ++i) {
+      oplog_list.push_back(std::make_pair(
+          int32_t(i), new petuum::RowOpLogMeta(metas[i])));
+    }
+
+    petuum::HighResolutionTimer timer;
+    oplog_list.sort(policy == petuum::FIFO ? CompClock : CompImportance);
+    for (int32_t i = 0; i < num_taken; ++i) {
+      taken_sum += oplog_list.front().first;
+      delete oplog_list.front().second;
+      oplog_list.pop_front();
+    }
+    seconds += timer.elapsed();
+
+    for (auto &oplog_pair : oplog_list)
+      delete oplog_pair.second;
+  }
+  Report("client", "list_sort", policy, metas.size(), num_taken, num_reps,
+         seconds, taken_sum);
+}
+
+void BenchClientSelect(petuum::UpdateSortPolicy policy,
+                       const std::vector<petuum::RowOpLogMeta> &metas,
+                       int32_t num_taken, int32_t num_reps) {
+  petuum::DenseRow<float> sample_row;
+  double seconds = 0;
+  int64_t taken_sum = 0;
+  for (int32_t r = 0; r < num_reps; ++r) {
+    petuum::TableOpLogMeta table_oplog_meta(&sample_row, policy);
+    for (size_t i = 0; i < metas.size(); ++i)
+      table_oplog_meta.InsertMergeRowOpLogMeta(i, metas[i]);
+
+    petuum::HighResolutionTimer timer;
+    table_oplog_meta.Sort();
+    for (int32_t i = 0; i < num_taken; ++i)
+      taken_sum += table_oplog_meta.GetAndClearNextInOrder();
+    seconds += timer.elapsed();
+  }
+  Report("client", "select", policy, metas.size(), num_taken, num_reps,
+         seconds, taken_sum);
+}
+
+// The full sort ServerTable::GetPartialTableToSend used to do, reading the
+// importance from the (scattered) server rows, against
+// ServerTable::SortCandidateVectorImportance.
+void BenchServer(petuum::UpdateSortPolicy policy,
+                 const std::vector<petuum::RowOpLogMeta> &metas,
+                 int32_t num_taken, int32_t num_reps) {
+  std::vector<petuum::ServerRow*> server_rows;
+  for (const auto &meta : metas) {
+    server_rows.push_back(new petuum::ServerRow);
+    server_rows.back()->AccumImportance(meta.get_importance());
+  }
+  std::shuffle(server_rows.begin(), server_rows.end(), std::mt19937(1));
+
+  std::vector<petuum::CandidateServerRow> candidates;
+  double sort_seconds = 0, select_seconds = 0;
+  int64_t sort_taken_sum = 0, select_taken_sum = 0;
+  for (int32_t r = 0; r < num_reps; ++r) {
+    candidates.clear();
+    for (size_t i = 0; i < server_rows.size(); ++i)
+      candidates.push_back(petuum::CandidateServerRow(i, server_rows[i]));
+    petuum::HighResolutionTimer timer;
+    std::sort(candidates.begin(), candidates.end(),
+              [] (const petuum::CandidateServerRow &row1,
+                  const petuum::CandidateServerRow &row2) {
+                double importance1 = row1.server_row_ptr->get_importance();
+                double importance2 = row2.server_row_ptr->get_importance();
+                if (importance1 == importance2)
+                  return row1.row_id < row2.row_id;
+                return importance1 > importance2;
+              });
+    sort_seconds += timer.elapsed();
+    for (int32_t i = 0; i < num_taken; ++i)
+      sort_taken_sum += candidates[i].row_id;
+
+    candidates.clear();
+    for (size_t i = 0; i < server_rows.size(); ++i)
+      candidates.push_back(petuum::CandidateServerRow(i, server_rows[i]));
+    timer.restart();
+    petuum::ServerTable::SortCandidateVectorImportance(&candidates,
+                                                       num_taken);
+    select_seconds += timer.elapsed();
+    for (int32_t i = 0; i < num_taken; ++i)
+      select_taken_sum += candidates[i].row_id;
+  }
+  Report("server", "sort", policy, metas.size(), num_taken, num_reps,
+         sort_seconds, sort_taken_sum);
+  Report("server", "select", policy, metas.size(), num_taken, num_reps,
+         select_seconds, select_taken_sum);
+
+  for (auto server_row : server_rows)
+    delete server_row;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  std::vector<int32_t> num_rows_list;
+  if (FLAGS_num_rows > 0) {
+    num_rows_list.push_back(FLAGS_num_rows);
+  } else {
+    num_rows_list.push_back(10000);
+    num_rows_list.push_back(100000);
+    num_rows_list.push_back(1000000);
+  }
+
+  const petuum::UpdateSortPolicy policies[]
+      = { petuum::RelativeMagnitude, petuum::FIFO_N_ReMag, petuum::FIFO };
+
+  printf("# side\tmethod\tpolicy\tnum_rows\tnum_taken\tmillisec"
+         "\ttaken_sum\n");
+  for (auto num_rows : num_rows_list) {
+    std::vector<petuum::RowOpLogMeta> metas;
+    MakeMetas(num_rows, &metas);
+    // A bounded push takes a small fraction of the pending rows.
+    for (int32_t percent_taken : { 1, 10 }) {
+      int32_t num_taken = std::max(1, num_rows / 100 * percent_taken);
+      for (auto policy : policies) {
+        BenchClientListSort(policy, metas, num_taken, FLAGS_num_reps);
+        BenchClientSelect(policy, metas, num_taken, FLAGS_num_reps);
+      }
+      BenchServer(petuum::RelativeMagnitude, metas, num_taken,
+                  FLAGS_num_reps);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,211 @@
+// Microbenchmark of the oplog path between the app threads and the server:
+// accumulating updates into row oplogs, serializing a table's row oplogs the
+// way the bg thread does, parsing them the way the server does, and the
+// OpLogCodec encodings on top.
+//
+// Usage: ps_oplog_bench [--num_rows=N] [--row_capacity=N]
+//                       [--num_nonzeros=N] [--num_reps=N]
+
+#include "bench_report.hpp"
+
+#include <petuum_ps/oplog/create_row_oplog.hpp>
+#include <petuum_ps_common/oplog/oplog_codec.hpp>
+#include <petuum_ps_common/storage/dense_row.hpp>
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+DEFINE_int32(num_rows, 1000, "Row oplogs per table oplog.");
+DEFINE_int32(row_capacity, 10000, "Columns per row.");
+DEFINE_int32(num_nonzeros, 100,
+             "Columns updated per row; the dense oplogs carry all columns.");
+DEFINE_int32(num_reps, 20, "Repetitions per case.");
+
+namespace {
+
+const char kBench[] = "ps_oplog_bench";
+
+typedef std::vector<std::unique_ptr<petuum::AbstractRowOpLog> > RowOpLogs;
+
+// Lays out row oplogs as one table in a bg oplog message: int32 num_rows,
+// then int32 row_id and the serialized row oplog for each row.
+size_t SerializeTable(RowOpLogs *row_oplogs, bool dense,
+                      std::vector<uint8_t> *raw) {
+  size_t size = sizeof(int32_t);
+  for (auto &row_oplog : *row_oplogs) {
+    size += sizeof(int32_t) + (dense ? row_oplog->GetDenseSerializedSize()
+                               : row_oplog->GetSparseSerializedSize());
+  }
+  raw->resize(size);
+
+  uint8_t *mem = raw->data();
+  *reinterpret_cast<int32_t*>(mem) = row_oplogs->size();
+  mem += sizeof(int32_t);
+  for (size_t i = 0; i < row_oplogs->size(); ++i) {
+    *reinterpret_cast<int32_t*>(mem) = i;
+    mem += sizeof(int32_t);
+    mem += dense ? (*row_oplogs)[i]->SerializeDense(mem)
+        : (*row_oplogs)[i]->SerializeSparse(mem);
+  }
+  return size;
+}
+
+// Walks a serialized table the way SerializedOpLogReader does and sums the
+// updates so the values are actually read.
+float ParseTable(const petuum::AbstractRowOpLog *sample_row_oplog, bool dense,
+                 const uint8_t *mem) {
+  int32_t num_rows = *reinterpret_cast<const int32_t*>(mem);
+  mem += sizeof(int32_t);
+  float sum = 0;
+  for (int32_t i = 0; i < num_rows; ++i) {
+    mem += sizeof(int32_t);
+    const int32_t *column_ids;
+    int32_t num_updates;
+    size_t serialized_size;
+    const float *updates = reinterpret_cast<const float*>(dense
+        ? sample_row_oplog->ParseDenseSerializedOpLog(
+            mem, &num_updates, &serialized_size)
+        : sample_row_oplog->ParseSparseSerializedOpLog(
+            mem, &column_ids, &num_updates, &serialized_size));
+    for (int32_t j = 0; j < num_updates; ++j)
+      sum += updates[j];
+    mem += serialized_size;
+  }
+  return sum;
+}
+
+void BenchCodec(const std::string &oplog_params, bool dense,
+                const std::vector<uint8_t> &raw,
+                petuum::OpLogIndexEncoding index_encoding,
+                petuum::OpLogValueEncoding value_encoding, bool compressed) {
+  static const char *kIndexNames[] = {"Raw", "Varint"};
+  static const char *kValueNames[] = {"Raw", "FP16", "BF16", "Q8"};
+
+  petuum::TableInfo table_info;
+  table_info.row_capacity = FLAGS_row_capacity;
+  table_info.oplog_dense_serialized = dense;
+  table_info.dense_row_oplog_capacity = FLAGS_row_capacity;
+  table_info.oplog_index_encoding = index_encoding;
+  table_info.oplog_value_encoding = value_encoding;
+  table_info.oplog_compressed = compressed;
+  petuum::OpLogCodec codec(table_info, sizeof(float));
+
+  std::string params = oplog_params + "," + petuum::bench::Params()
+      .Add("index", kIndexNames[index_encoding])
+      .Add("value", kValueNames[value_encoding])
+      .Add("compressed", compressed).str();
+
+  std::vector<uint8_t> encoded;
+  petuum::HighResolutionTimer timer;
+  for (int32_t r = 0; r < FLAGS_num_reps; ++r) {
+    encoded.resize(codec.Encode(raw.data()));
+    encoded.resize(codec.WriteEncoded(encoded.data()));
+  }
+  petuum::bench::Report(kBench, "encode", params,
+                        raw.size() * FLAGS_num_reps / timer.elapsed() * 1e-6,
+                        "MB/s");
+  petuum::bench::Report(kBench, "encoded_size", params,
+                        double(encoded.size()) / raw.size(), "ratio");
+
+  std::vector<uint8_t> decoded;
+  timer.restart();
+  for (int32_t r = 0; r < FLAGS_num_reps; ++r) {
+    decoded.clear();
+    CHECK_EQ(codec.Decode(encoded.data(), &decoded), encoded.size());
+  }
+  petuum::bench::Report(kBench, "decode", params,
+                        raw.size() * FLAGS_num_reps / timer.elapsed() * 1e-6,
+                        "MB/s");
+}
+
+void BenchOpLog(bool dense) {
+  const int32_t num_rows = FLAGS_num_rows;
+  const int32_t capacity = FLAGS_row_capacity;
+  const int32_t num_nonzeros = std::min(FLAGS_num_nonzeros, capacity);
+
+  std::string params = petuum::bench::Params()
+      .Add("oplog", dense ? "Dense" : "Sparse").Add("rows", num_rows)
+      .Add("capacity", capacity).Add("nonzeros", num_nonzeros).str();
+
+  petuum::DenseRow<float> dense_row;
+  const petuum::AbstractRow &sample_row = dense_row;
+  RowOpLogs row_oplogs(num_rows);
+  for (auto &row_oplog : row_oplogs) {
+    row_oplog.reset(dense
+        ? petuum::CreateRowOpLog::CreateDenseRowOpLog(
+            sizeof(float), &sample_row, capacity)
+        : petuum::CreateRowOpLog::CreateSparseRowOpLog(
+            sizeof(float), &sample_row, capacity));
+  }
+
+  std::mt19937 gen(num_rows);
+  std::vector<int32_t> columns(capacity);
+  for (int32_t i = 0; i < capacity; ++i)
+    columns[i] = i;
+
+  // Each rep applies num_nonzeros updates to every row, as Table::Inc
+  // through the thread oplog would.
+  std::vector<std::vector<int32_t> > row_columns(num_rows);
+  for (auto &cols : row_columns) {
+    std::shuffle(columns.begin(), columns.end(), gen);
+    cols.assign(columns.begin(), columns.begin() + num_nonzeros);
+  }
+  float delta = 0.5;
+  petuum::HighResolutionTimer timer;
+  for (int32_t r = 0; r < FLAGS_num_reps; ++r) {
+    for (int32_t i = 0; i < num_rows; ++i) {
+      petuum::AbstractRowOpLog *row_oplog = row_oplogs[i].get();
+      for (int32_t col : row_columns[i])
+        sample_row.AddUpdates(col, row_oplog->FindCreate(col), &delta);
+    }
+  }
+  petuum::bench::Report(kBench, "oplog_inc", params,
+                        timer.elapsed() / (int64_t(FLAGS_num_reps) * num_rows
+                                           * num_nonzeros) * 1e9,
+                        "ns/update");
+
+  std::vector<uint8_t> raw;
+  size_t raw_size = 0;
+  timer.restart();
+  for (int32_t r = 0; r < FLAGS_num_reps; ++r)
+    raw_size = SerializeTable(&row_oplogs, dense, &raw);
+  petuum::bench::Report(kBench, "serialize", params,
+                        raw_size * FLAGS_num_reps / timer.elapsed() * 1e-6,
+                        "MB/s");
+
+  volatile float sink = 0;
+  timer.restart();
+  for (int32_t r = 0; r < FLAGS_num_reps; ++r)
+    sink = sink + ParseTable(row_oplogs[0].get(), dense, raw.data());
+  petuum::bench::Report(kBench, "parse", params,
+                        raw_size * FLAGS_num_reps / timer.elapsed() * 1e-6,
+                        "MB/s");
+
+  BenchCodec(params, dense, raw, petuum::VarintIndex, petuum::RawValue,
+             false);
+  BenchCodec(params, dense, raw, petuum::VarintIndex, petuum::FP16Value,
+             false);
+  BenchCodec(params, dense, raw, petuum::VarintIndex, petuum::Q8Value,
+             false);
+  BenchCodec(params, dense, raw, petuum::RawIndex, petuum::RawValue, true);
+  BenchCodec(params, dense, raw, petuum::VarintIndex, petuum::FP16Value,
+             true);
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  petuum::bench::PrintHeader(kBench);
+  BenchOpLog(false);
+  BenchOpLog(true);
+  return 0;
+}
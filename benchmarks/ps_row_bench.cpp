@@ -0,0 +1,133 @@
+// Microbenchmark of the update and serialization paths of each row type, as
+// the process cache and the server see them (the *Unsafe variants, no row
+// lock).
+//
+// Usage: ps_row_bench [--row_capacity=N] [--num_nonzeros=N]
+//                     [--batch_size=N] [--num_updates=N]
+
+#include "bench_report.hpp"
+
+#include <petuum_ps_common/storage/dense_row.hpp>
+#include <petuum_ps_common/storage/sparse_row.hpp>
+#include <petuum_ps_common/storage/sorted_vector_map_row.hpp>
+#include <petuum_ps_common/storage/sparse_feature_row.hpp>
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdint.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+DEFINE_int32(row_capacity, 100000, "Columns per row.");
+DEFINE_int32(num_nonzeros, 1000,
+             "Distinct columns updated; also the DenseBatchInc width.");
+DEFINE_int32(batch_size, 100, "Updates per BatchInc.");
+DEFINE_int32(num_updates, 10000000, "Updates per case.");
+
+namespace {
+
+const char kBench[] = "ps_row_bench";
+
+template<typename ROW>
+void BenchRow(const char *row_name) {
+  const int32_t capacity = FLAGS_row_capacity;
+  const int32_t num_nonzeros = std::min(FLAGS_num_nonzeros, capacity);
+  const int32_t batch_size = FLAGS_batch_size;
+  const int64_t num_updates = FLAGS_num_updates;
+
+  std::string params = petuum::bench::Params()
+      .Add("row", row_name).Add("capacity", capacity)
+      .Add("nonzeros", num_nonzeros).str();
+
+  // The columns touched are num_nonzeros distinct ones, visited in random
+  // order.
+  std::mt19937 gen(capacity);
+  std::vector<int32_t> columns(capacity);
+  for (int32_t i = 0; i < capacity; ++i)
+    columns[i] = i;
+  std::shuffle(columns.begin(), columns.end(), gen);
+  columns.resize(num_nonzeros);
+  std::vector<int32_t> column_seq(1 << 16);
+  std::uniform_int_distribution<int32_t> pick(0, num_nonzeros - 1);
+  for (auto &col : column_seq)
+    col = columns[pick(gen)];
+  const size_t seq_mask = column_seq.size() - 1;
+
+  std::vector<float> updates(std::max(batch_size, num_nonzeros), 0.5);
+
+  ROW row;
+  row.Init(capacity);
+
+  petuum::HighResolutionTimer timer;
+  for (int64_t i = 0; i < num_updates; ++i)
+    row.ApplyIncUnsafe(column_seq[i & seq_mask], &updates[0]);
+  petuum::bench::Report(kBench, "inc", params,
+                        timer.elapsed() / num_updates * 1e9, "ns/update");
+
+  // Column ids of BatchInc are sorted, as SparseRowOpLog serializes them.
+  int64_t num_batches = std::max(int64_t(1), num_updates / batch_size);
+  std::vector<std::vector<int32_t> > batches(64);
+  for (auto &batch : batches) {
+    batch = columns;
+    std::shuffle(batch.begin(), batch.end(), gen);
+    batch.resize(std::min(batch_size, num_nonzeros));
+    std::sort(batch.begin(), batch.end());
+  }
+  timer.restart();
+  int64_t num_batch_updates = 0;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    const std::vector<int32_t> &batch = batches[i % batches.size()];
+    row.ApplyBatchIncUnsafe(batch.data(), updates.data(), batch.size());
+    num_batch_updates += batch.size();
+  }
+  petuum::bench::Report(kBench, "batch_inc", params,
+                        timer.elapsed() / num_batch_updates * 1e9,
+                        "ns/update");
+
+  int64_t num_dense_batches = std::max(int64_t(1),
+                                       num_updates / num_nonzeros);
+  timer.restart();
+  for (int64_t i = 0; i < num_dense_batches; ++i)
+    row.ApplyDenseBatchIncUnsafe(updates.data(), 0, num_nonzeros);
+  petuum::bench::Report(kBench, "dense_batch_inc", params,
+                        timer.elapsed() / (num_dense_batches * num_nonzeros)
+                        * 1e9, "ns/update");
+
+  // Serialize and deserialize about as many bytes as the updates above.
+  std::vector<uint8_t> bytes(row.SerializedSize());
+  size_t serialized_size = row.Serialize(bytes.data());
+  int64_t num_reps = std::max(int64_t(1), int64_t(
+      num_updates * sizeof(float) / std::max(serialized_size, size_t(1))));
+
+  timer.restart();
+  for (int64_t i = 0; i < num_reps; ++i)
+    serialized_size = row.Serialize(bytes.data());
+  petuum::bench::Report(kBench, "serialize", params,
+                        serialized_size * num_reps / timer.elapsed() * 1e-6,
+                        "MB/s");
+
+  timer.restart();
+  for (int64_t i = 0; i < num_reps; ++i) {
+    ROW new_row;
+    CHECK(new_row.Deserialize(bytes.data(), serialized_size));
+  }
+  petuum::bench::Report(kBench, "deserialize", params,
+                        serialized_size * num_reps / timer.elapsed() * 1e-6,
+                        "MB/s");
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  petuum::bench::PrintHeader(kBench);
+  BenchRow<petuum::DenseRow<float> >("DenseRow");
+  BenchRow<petuum::SparseRow<float> >("SparseRow");
+  BenchRow<petuum::SortedVectorMapRow<float> >("SortedVectorMapRow");
+  BenchRow<petuum::SparseFeatureRow<float> >("SparseFeatureRow");
+  return 0;
+}
@@ -0,0 +1,168 @@
+// Microbenchmark of one server thread: applying row oplogs to a ServerTable
+// and packing the dirty rows into the per-client push buffers, for each
+// server storage, oplog serialization and server update rule.
+//
+// Usage: ps_server_bench [--num_rows=N] [--row_capacity=N]
+//                        [--num_nonzeros=N] [--num_clients=N] [--num_reps=N]
+
+#include "bench_report.hpp"
+
+#include <petuum_ps/server/server_table.hpp>
+#include <petuum_ps/thread/context.hpp>
+#include <petuum_ps_common/storage/dense_row.hpp>
+#include <petuum_ps_common/util/class_register.hpp>
+#include <petuum_ps_common/util/record_buff.hpp>
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdint.h>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+DEFINE_int32(num_rows, 1000, "Rows held by the server thread.");
+DEFINE_int32(row_capacity, 10000, "Columns per row.");
+DEFINE_int32(num_nonzeros, 100, "Columns per sparse row oplog.");
+DEFINE_int32(num_clients, 8, "Clients subscribed to every row.");
+DEFINE_int32(num_reps, 10, "Repetitions per case.");
+
+namespace {
+
+const char kBench[] = "ps_server_bench";
+const int32_t kDenseRowType = 0;
+
+void BenchServerTable(int32_t table_id,
+                      petuum::ServerStorageType storage_type,
+                      bool dense_oplog,
+                      petuum::ServerUpdateRuleType update_rule) {
+  static const char *kRuleNames[] = {
+    "Add", "SGDMomentum", "AdaGrad", "Adam", "FTRL"};
+
+  const int32_t num_rows = FLAGS_num_rows;
+  const int32_t capacity = FLAGS_row_capacity;
+  const int32_t num_nonzeros = dense_oplog ? capacity
+      : std::min(FLAGS_num_nonzeros, capacity);
+  const int32_t num_clients = FLAGS_num_clients;
+
+  petuum::TableInfo table_info;
+  table_info.row_type = kDenseRowType;
+  table_info.row_capacity = capacity;
+  table_info.oplog_dense_serialized = dense_oplog;
+  table_info.row_oplog_type = dense_oplog
+      ? petuum::RowOpLogType::kDenseRowOpLog
+      : petuum::RowOpLogType::kSparseRowOpLog;
+  table_info.dense_row_oplog_capacity = capacity;
+  table_info.server_storage_type = storage_type;
+  table_info.server_storage_capacity = num_rows;
+  table_info.server_update_rule.type = update_rule;
+
+  std::string params = petuum::bench::Params()
+      .Add("storage", storage_type == petuum::ServerDenseRange
+           ? "DenseRange" : "OpenAddressing")
+      .Add("oplog", dense_oplog ? "Dense" : "Sparse")
+      .Add("rule", kRuleNames[update_rule])
+      .Add("rows", num_rows).Add("capacity", capacity)
+      .Add("nonzeros", num_nonzeros).Add("clients", num_clients).str();
+
+  petuum::GlobalContext::RegisterRowPartitioner(table_id, table_info);
+  petuum::ServerTable server_table(table_id, table_info);
+
+  // With modulo partitioning over num_clients servers, this server holds
+  // every num_clients-th row.
+  std::vector<int32_t> row_ids(num_rows);
+  for (int32_t i = 0; i < num_rows; ++i) {
+    row_ids[i] = i * num_clients;
+    petuum::ServerRow *server_row = server_table.CreateRow(row_ids[i]);
+    for (int32_t client_id = 0; client_id < num_clients; ++client_id)
+      server_row->Subscribe(client_id);
+  }
+
+  std::mt19937 gen(num_rows);
+  std::vector<int32_t> columns(capacity);
+  for (int32_t i = 0; i < capacity; ++i)
+    columns[i] = i;
+  std::vector<std::vector<int32_t> > row_columns(num_rows);
+  for (auto &cols : row_columns) {
+    std::shuffle(columns.begin(), columns.end(), gen);
+    cols.assign(columns.begin(), columns.begin() + num_nonzeros);
+    std::sort(cols.begin(), cols.end());
+  }
+  std::normal_distribution<float> dist(0, 0.01);
+  std::vector<float> updates(num_nonzeros);
+  for (auto &update : updates)
+    update = dist(gen);
+
+  // Every client gets every row pushed once per rep.
+  petuum::DenseRow<float> sample_row;
+  sample_row.Init(capacity);
+  size_t buff_size = num_rows * (sample_row.SerializedSize()
+                                 + sizeof(int32_t) + sizeof(size_t));
+  std::vector<std::vector<uint8_t> > buff_mems(num_clients,
+                                               std::vector<uint8_t>(buff_size));
+
+  double apply_seconds = 0;
+  double push_seconds = 0;
+  size_t push_bytes = 0;
+  for (int32_t r = 0; r < FLAGS_num_reps; ++r) {
+    petuum::HighResolutionTimer timer;
+    for (int32_t i = 0; i < num_rows; ++i) {
+      CHECK(server_table.ApplyRowOpLog(row_ids[i], row_columns[i].data(),
+                                       updates.data(), num_nonzeros));
+    }
+    apply_seconds += timer.elapsed();
+
+    boost::unordered_map<int32_t, petuum::RecordBuff> buffs;
+    for (int32_t client_id = 0; client_id < num_clients; ++client_id) {
+      buffs.insert(std::make_pair(client_id, petuum::RecordBuff(
+          buff_mems[client_id].data(), buff_size)));
+    }
+    timer.restart();
+    server_table.InitAppendTableToBuffs();
+    int32_t failed_client_id;
+    CHECK(server_table.AppendTableToBuffs(0, &buffs, &failed_client_id,
+                                          false));
+    push_seconds += timer.elapsed();
+    for (auto &buff : buffs)
+      push_bytes += buff.second.GetMemUsedSize();
+  }
+
+  int64_t num_updates = int64_t(FLAGS_num_reps) * num_rows * num_nonzeros;
+  petuum::bench::Report(kBench, "apply", params,
+                        apply_seconds / num_updates * 1e9, "ns/update");
+  petuum::bench::Report(kBench, "push", params,
+                        push_bytes / push_seconds * 1e-6, "MB/s");
+  petuum::bench::Report(kBench, "push_rows", params,
+                        int64_t(FLAGS_num_reps) * num_rows * num_clients
+                        / push_seconds, "rows/s");
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  // One comm channel per client and no hosts; only the sizes matter to the
+  // server table.
+  std::map<int32_t, petuum::HostInfo> host_map;
+  petuum::GlobalContext::Init(1, 1, 1, 1, FLAGS_num_clients, host_map, 0, 1,
+                              petuum::SSP, false, -1, "", -1, "",
+                              petuum::Random, 0, 0, 0, false, 0, 0, 0, 0, 1);
+  petuum::ClassRegistry<petuum::AbstractRow>::GetRegistry().AddCreator(
+      kDenseRowType,
+      petuum::CreateObj<petuum::AbstractRow, petuum::DenseRow<float> >);
+
+  petuum::bench::PrintHeader(kBench);
+  int32_t table_id = 0;
+  for (auto storage_type : {petuum::ServerOpenAddressing,
+          petuum::ServerDenseRange}) {
+    for (bool dense_oplog : {false, true}) {
+      for (auto update_rule : {petuum::ServerAdd, petuum::ServerAdam}) {
+        BenchServerTable(table_id++, storage_type, dense_oplog,
+                         update_rule);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,225 @@
+// End-to-end benchmark of the table API through the full client and server
+// stack. Every table thread of every client reads and updates the same
+// num_rows rows of one float table and clocks num_clocks times. Run one
+// process per client, e.g. through run_ps_bench.sh; the system and table
+// flags (consistency_model, row_type, oplog encodings, ...) are the usual
+// ones from system_gflags.hpp and table_gflags.hpp. --row_type: 0 DenseRow,
+// 1 SparseFeatureRow, 2 SparseRow, 3 SortedVectorMapRow.
+//
+// Usage: ps_table_bench --hostfile=F --num_clients=N --client_id=I
+//                       [--num_table_threads=N] [--num_rows=N]
+//                       [--row_capacity=N] [--batch_size=N] [--num_clocks=N]
+
+#include "bench_report.hpp"
+
+#include <petuum_ps_common/include/petuum_ps.hpp>
+#include <petuum_ps_common/include/system_gflags.hpp>
+#include <petuum_ps_common/include/table_gflags.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+DEFINE_int32(num_rows, 1000, "Rows of the table.");
+DEFINE_int32(row_capacity, 1000, "Columns per row.");
+DEFINE_int32(batch_size, 100, "Updates per row per clock for each of Inc and "
+             "BatchInc.");
+DEFINE_int32(num_clocks, 20, "Clocks per table thread.");
+DEFINE_int32(num_get_reps, 10, "Passes over the rows for the cache hit case.");
+
+namespace {
+
+const char kBench[] = "ps_table_bench";
+const int32_t kTableId = 0;
+
+// Sums over all table threads of all clients, in seconds and operations.
+enum BenchStat {
+  kGetMissSeconds = 0,
+  kGetMissCount,
+  kGetHitSeconds,
+  kGetHitCount,
+  kIncSeconds,
+  kIncCount,
+  kBatchIncSeconds,
+  kBatchIncCount,
+  kDenseBatchIncSeconds,
+  kDenseBatchIncCount,
+  kClockSeconds,
+  kClockGetSeconds,
+  kClockGetCount,
+  kNumBenchStats
+};
+
+// A RowAccessor per Get, as the apps do; it holds a reference on the cached
+// row until it goes out of scope.
+void GetRow(petuum::Table<float> *table, int32_t row_id) {
+  petuum::RowAccessor row_acc;
+  table->Get(row_id, &row_acc);
+}
+
+void TableThread(int32_t thread_idx) {
+  petuum::PSTableGroup::RegisterThread();
+  petuum::Table<float> table =
+      petuum::PSTableGroup::GetTableOrDie<float>(kTableId);
+
+  const int32_t num_rows = FLAGS_num_rows;
+  const int32_t capacity = FLAGS_row_capacity;
+  const int32_t batch_size = std::min(FLAGS_batch_size, capacity);
+
+  std::mt19937 gen(FLAGS_client_id * 1000 + thread_idx);
+  std::uniform_int_distribution<int32_t> pick(0, capacity - 1);
+  std::vector<int32_t> columns(capacity);
+  for (int32_t i = 0; i < capacity; ++i)
+    columns[i] = i;
+
+  std::vector<double> stats(kNumBenchStats, 0);
+
+  petuum::PSTableGroup::GlobalBarrier();
+  petuum::HighResolutionTimer timer;
+  for (int32_t row_id = 0; row_id < num_rows; ++row_id)
+    GetRow(&table, row_id);
+  stats[kGetMissSeconds] = timer.elapsed();
+  stats[kGetMissCount] = num_rows;
+
+  timer.restart();
+  for (int32_t r = 0; r < FLAGS_num_get_reps; ++r) {
+    for (int32_t row_id = 0; row_id < num_rows; ++row_id)
+      GetRow(&table, row_id);
+  }
+  stats[kGetHitSeconds] = timer.elapsed();
+  stats[kGetHitCount] = double(FLAGS_num_get_reps) * num_rows;
+
+  petuum::DenseUpdateBatch<float> dense_batch(0, capacity);
+  for (int32_t i = 0; i < capacity; ++i)
+    dense_batch[i] = 1e-3;
+
+  petuum::PSTableGroup::GlobalBarrier();
+  petuum::HighResolutionTimer run_timer;
+  for (int32_t clock = 0; clock < FLAGS_num_clocks; ++clock) {
+    timer.restart();
+    for (int32_t row_id = 0; row_id < num_rows; ++row_id) {
+      for (int32_t i = 0; i < batch_size; ++i)
+        table.Inc(row_id, pick(gen), 1e-3);
+    }
+    stats[kIncSeconds] += timer.elapsed();
+    stats[kIncCount] += double(num_rows) * batch_size;
+
+    petuum::UpdateBatch<float> update_batch(batch_size);
+    std::shuffle(columns.begin(), columns.end(), gen);
+    std::sort(columns.begin(), columns.begin() + batch_size);
+    for (int32_t i = 0; i < batch_size; ++i)
+      update_batch.UpdateSet(i, columns[i], 1e-3);
+    timer.restart();
+    for (int32_t row_id = 0; row_id < num_rows; ++row_id)
+      table.BatchInc(row_id, update_batch);
+    stats[kBatchIncSeconds] += timer.elapsed();
+    stats[kBatchIncCount] += double(num_rows) * batch_size;
+
+    timer.restart();
+    for (int32_t row_id = 0; row_id < num_rows; ++row_id)
+      table.DenseBatchInc(row_id, dense_batch);
+    stats[kDenseBatchIncSeconds] += timer.elapsed();
+    stats[kDenseBatchIncCount] += double(num_rows) * capacity;
+
+    // Clock includes flushing the oplogs; the Get pass after it includes
+    // waiting for fresh enough rows.
+    timer.restart();
+    petuum::PSTableGroup::Clock();
+    stats[kClockSeconds] += timer.elapsed();
+
+    timer.restart();
+    for (int32_t row_id = 0; row_id < num_rows; ++row_id)
+      GetRow(&table, row_id);
+    stats[kClockGetSeconds] += timer.elapsed();
+    stats[kClockGetCount] += num_rows;
+  }
+  double run_seconds = run_timer.elapsed();
+
+  petuum::PSTableGroup::GlobalBarrier();
+  petuum::PSTableGroup::AllReduce(stats.data(), stats.size(),
+                                  petuum::AllReduceSum);
+  petuum::PSTableGroup::AllReduce(&run_seconds, 1, petuum::AllReduceMax);
+
+  if (FLAGS_client_id == 0 && thread_idx == 0) {
+    std::string params = petuum::bench::Params()
+        .Add("consistency", FLAGS_consistency_model)
+        .Add("clients", FLAGS_num_clients)
+        .Add("threads", FLAGS_num_table_threads)
+        .Add("row_type", FLAGS_row_type)
+        .Add("rows", num_rows).Add("capacity", capacity)
+        .Add("batch", batch_size).Add("staleness", FLAGS_table_staleness)
+        .str();
+    petuum::bench::Report(kBench, "get_miss", params,
+                          stats[kGetMissSeconds] / stats[kGetMissCount] * 1e6,
+                          "us/row");
+    petuum::bench::Report(kBench, "get_hit", params,
+                          stats[kGetHitSeconds] / stats[kGetHitCount] * 1e9,
+                          "ns/row");
+    petuum::bench::Report(kBench, "inc", params,
+                          stats[kIncSeconds] / stats[kIncCount] * 1e9,
+                          "ns/update");
+    petuum::bench::Report(kBench, "batch_inc", params,
+                          stats[kBatchIncSeconds] / stats[kBatchIncCount]
+                          * 1e9, "ns/update");
+    petuum::bench::Report(kBench, "dense_batch_inc", params,
+                          stats[kDenseBatchIncSeconds]
+                          / stats[kDenseBatchIncCount] * 1e9, "ns/update");
+    int32_t num_table_threads = FLAGS_num_clients * FLAGS_num_table_threads;
+    petuum::bench::Report(kBench, "clock", params,
+                          stats[kClockSeconds]
+                          / (num_table_threads * FLAGS_num_clocks) * 1e3,
+                          "ms/clock");
+    petuum::bench::Report(kBench, "get_after_clock", params,
+                          stats[kClockGetSeconds] / stats[kClockGetCount]
+                          * 1e6, "us/row");
+    petuum::bench::Report(kBench, "throughput", params,
+                          FLAGS_num_clocks / run_seconds, "clocks/s");
+  }
+
+  petuum::PSTableGroup::DeregisterThread();
+}
+
+}  // anonymous namespace
+
+int main(int argc, char *argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+
+  petuum::TableGroupConfig table_group_config;
+  int32_t client_id;
+  petuum::InitTableGroupConfig(&table_group_config, &client_id, 1);
+
+  petuum::PSTableGroup::RegisterRow<petuum::DenseRow<float> >(0);
+  petuum::PSTableGroup::RegisterRow<petuum::SparseFeatureRow<float> >(1);
+  petuum::PSTableGroup::RegisterRow<petuum::SparseRow<float> >(2);
+  petuum::PSTableGroup::RegisterRow<petuum::SortedVectorMapRow<float> >(3);
+
+  petuum::PSTableGroup::Init(table_group_config, false);
+
+  petuum::ClientTableConfig table_config;
+  petuum::InitTableConfig(&table_config);
+  table_config.table_info.row_capacity = FLAGS_row_capacity;
+  table_config.table_info.dense_row_oplog_capacity = FLAGS_row_capacity;
+  table_config.table_info.server_storage_capacity = FLAGS_num_rows;
+  table_config.table_info.range_partition_num_rows = FLAGS_num_rows;
+  table_config.process_cache_capacity = FLAGS_num_rows;
+  table_config.oplog_capacity = FLAGS_num_rows;
+  CHECK(petuum::PSTableGroup::CreateTable(kTableId, table_config));
+  petuum::PSTableGroup::CreateTableDone();
+
+  if (client_id == 0)
+    petuum::bench::PrintHeader(kBench);
+
+  std::vector<std::thread> threads(FLAGS_num_table_threads);
+  for (int32_t i = 0; i < FLAGS_num_table_threads; ++i)
+    threads[i] = std::thread(TableThread, i);
+  for (auto &thread : threads)
+    thread.join();
+
+  petuum::PSTableGroup::ShutDown();
+  return 0;
+}
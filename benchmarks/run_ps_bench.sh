@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+#
+# Runs the ps_bench suite on this host and writes all results to one
+# tab-separated file (see bench_report.hpp). The table benchmark runs
+# num_clients processes talking over 127.0.0.1, once for each consistency
+# model. Build first with `make ps_bench`.
+#
+# Usage: run_ps_bench.sh [output_file]
+#
+# Set ipc_dir to e.g. /dev/shm to have the clients use IPC instead of TCP.
+
+output_file=${1:-ps_bench.tsv}
+
+num_clients=${num_clients:-2}
+num_table_threads=${num_table_threads:-2}
+base_port=${base_port:-10000}
+ipc_dir=${ipc_dir:-}
+consistency_models=${consistency_models:-"SSP SSPPush SSPAggr"}
+table_args=${table_args:-"--num_rows=1000 --row_capacity=1000 --num_clocks=20 --table_staleness=1"}
+
+# Figure out the paths.
+script_path=`readlink -f $0`
+script_dir=`dirname $script_path`
+project_dir=`dirname $script_dir`
+bin_dir=$project_dir/bin/benchmarks
+
+host_file=`mktemp`
+trap "rm -f $host_file" EXIT
+
+# Each client takes a few consecutive ports (name node and comm channels).
+for client_id in $(seq 0 $((num_clients - 1))); do
+  echo "$client_id 127.0.0.1 $((base_port + client_id * 1000))"
+done > $host_file
+
+: > $output_file
+
+for bench in ps_row_bench ps_oplog_bench ps_server_bench; do
+  echo "Running $bench"
+  $bin_dir/$bench >> $output_file || exit 1
+done
+
+for consistency_model in $consistency_models; do
+  echo "Running ps_table_bench with $consistency_model on $num_clients clients"
+  pids=""
+  for client_id in $(seq 0 $((num_clients - 1))); do
+    $bin_dir/ps_table_bench \
+      --hostfile=$host_file \
+      --num_clients=$num_clients \
+      --client_id=$client_id \
+      --num_table_threads=$num_table_threads \
+      --consistency_model=$consistency_model \
+      --comm_bus_ipc_dir=$ipc_dir \
+      $table_args >> $output_file &
+    pids="$pids $!"
+  done
+  for pid in $pids; do
+    wait $pid || exit 1
+  done
+done
+
+echo "Results in $output_file"
@@ -4,6 +4,7 @@
 #include <ml/util/data_loading.hpp>
 #include <ml/util/metafile_reader.hpp>
 #include <ml/util/math_util.hpp>
+#include <ml/util/csr_dataset.hpp>
 #include <ml/util/fastapprox/fastapprox.hpp>
 
 #include <ml/feature/sparse_feature.hpp>
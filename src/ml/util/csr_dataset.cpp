@@ -0,0 +1,347 @@
+#include <ml/util/csr_dataset.hpp>
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <glog/logging.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace petuum {
+namespace ml {
+
+namespace {
+
+const int32_t base = 10;
+
+// Cache file layout: CSRCacheHeader, row_offsets (num_data + 1 int64_t),
+// feature_ids (num_entries int32_t), feature_vals (num_entries float),
+// labels (num_data int32_t).
+struct CSRCacheHeader {
+  uint64_t magic;
+  int64_t num_data;
+  int64_t num_entries;
+  int32_t feature_dim;
+  int32_t reserved;
+};
+
+const uint64_t kCSRCacheMagic = 0x3152534354454d50ull;  // "PMETCSR1"
+
+void RunOnThreads(int32_t num_threads,
+    const std::function<void(int32_t)>& func) {
+  std::vector<std::thread> threads;
+  for (int32_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back(func, t);
+  }
+  func(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+inline bool IsBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Counts the non-blank lines and the feature entries (one per ':') in
+// [begin, end).
+void CountLibSVM(const char* begin, const char* end, int64_t* num_lines,
+    int64_t* num_entries) {
+  int64_t lines = 0, entries = 0;
+  bool has_content = false;
+  for (const char* p = begin; p < end; ++p) {
+    char c = *p;
+    if (c == '\n') {
+      lines += has_content;
+      has_content = false;
+    } else if (c == ':') {
+      ++entries;
+    } else if (!has_content && !IsBlank(c)) {
+      has_content = true;
+    }
+  }
+  *num_lines = lines + has_content;
+  *num_entries = entries;
+}
+
+// Parses up to max_lines non-blank lines of [begin, end) into sample
+// line_idx onwards, entry entry_idx onwards. Each line must end in '\n', or
+// [begin, end) must be followed by '\0'. Returns the end entry index.
+int64_t ParseLibSVM(const char* begin, const char* end, int64_t max_lines,
+    int32_t feature_dim, bool feature_one_based, bool label_one_based,
+    int64_t line_idx, int64_t entry_idx, int64_t* row_offsets,
+    int32_t* feature_ids, float* feature_vals, int32_t* labels) {
+  const char* ptr = begin;
+  int64_t num_lines = 0;
+  std::vector<std::pair<int32_t, float> > unsorted;
+  while (ptr < end && num_lines < max_lines) {
+    while (ptr < end && (IsBlank(*ptr) || *ptr == '\n')) ++ptr;
+    if (ptr == end)
+      break;
+    char* endptr;
+    int32_t label = strtol(ptr, &endptr, base);
+    labels[line_idx] = label_one_based ? label - 1 : label;
+    row_offsets[line_idx] = entry_idx;
+    ptr = endptr;
+
+    bool sorted = true;
+    int64_t row_begin = entry_idx;
+    while (1) {
+      while (ptr < end && IsBlank(*ptr)) ++ptr;
+      if (ptr == end || *ptr == '\n' || *ptr == '\0')
+        break;
+      int32_t feature_id = strtol(ptr, &endptr, base);
+      if (feature_one_based) {
+        --feature_id;
+      }
+      CHECK_EQ(':', *endptr) << "Malformed LibSVM line " << line_idx;
+      CHECK(feature_id >= 0 && feature_id < feature_dim)
+        << "Feature id " << feature_id << " out of range on line "
+        << line_idx;
+      if (entry_idx > row_begin && feature_id < feature_ids[entry_idx - 1]) {
+        sorted = false;
+      }
+      feature_ids[entry_idx] = feature_id;
+      feature_vals[entry_idx] = strtof(endptr + 1, &endptr);
+      ptr = endptr;
+      ++entry_idx;
+    }
+
+    if (!sorted) {
+      unsorted.clear();
+      for (int64_t k = row_begin; k < entry_idx; ++k) {
+        unsorted.push_back(std::make_pair(feature_ids[k], feature_vals[k]));
+      }
+      std::sort(unsorted.begin(), unsorted.end());
+      for (int64_t k = row_begin; k < entry_idx; ++k) {
+        feature_ids[k] = unsorted[k - row_begin].first;
+        feature_vals[k] = unsorted[k - row_begin].second;
+      }
+    }
+    ++line_idx;
+    ++num_lines;
+  }
+  return entry_idx;
+}
+
+}  // anonymous namespace
+
+CSRDataset::CSRDataset() :
+  mapped_(0),
+  mapped_size_(0) {
+  Clear();
+}
+
+CSRDataset::~CSRDataset() {
+  Clear();
+}
+
+void CSRDataset::Clear() {
+  if (mapped_ != 0) {
+    munmap(mapped_, mapped_size_);
+    mapped_ = 0;
+    mapped_size_ = 0;
+  }
+  owned_row_offsets_.assign(1, 0);
+  owned_feature_ids_.clear();
+  owned_feature_vals_.clear();
+  owned_labels_.clear();
+  num_data_ = 0;
+  feature_dim_ = 0;
+  num_entries_ = 0;
+  UseOwnedStorage();
+}
+
+void CSRDataset::UseOwnedStorage() {
+  row_offsets_ = owned_row_offsets_.data();
+  feature_ids_ = owned_feature_ids_.data();
+  feature_vals_ = owned_feature_vals_.data();
+  labels_ = owned_labels_.data();
+}
+
+void CSRDataset::LoadLibSVM(const std::string& filename, int32_t feature_dim,
+    int32_t num_data, bool feature_one_based, bool label_one_based,
+    int32_t num_threads) {
+  petuum::HighResolutionTimer read_timer;
+  Clear();
+  CHECK_GT(num_threads, 0);
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Can't open " << filename;
+  struct stat st;
+  CHECK_EQ(0, fstat(fd, &st));
+  size_t size = st.st_size;
+  const char* mem = 0;
+  if (size > 0) {
+    void* addr = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK(addr != MAP_FAILED) << "Can't mmap " << filename << ": "
+      << strerror(errno);
+    madvise(addr, size, MADV_SEQUENTIAL);
+    mem = reinterpret_cast<const char*>(addr);
+  }
+  close(fd);
+
+  // strtol and friends may not run off the mapping, so an unterminated
+  // last line is parsed from a copy.
+  size_t body_size = size;
+  while (body_size > 0 && mem[body_size - 1] != '\n') --body_size;
+  std::string tail;
+  if (body_size < size)
+    tail.assign(mem + body_size, size - body_size);
+
+  // Chunk t is [chunk_begin[t], chunk_begin[t + 1]) of the body, split at
+  // line boundaries; the tail is the last chunk.
+  std::vector<const char*> chunk_begin(num_threads + 1);
+  chunk_begin[0] = mem;
+  for (int32_t t = 1; t < num_threads; ++t) {
+    const char* p = std::max(chunk_begin[t - 1],
+        mem + body_size * t / num_threads);
+    while (p > mem && p < mem + body_size && p[-1] != '\n') ++p;
+    chunk_begin[t] = p;
+  }
+  chunk_begin[num_threads] = mem + body_size;
+  int32_t num_chunks = num_threads + 1;
+  auto chunk_range = [&](int32_t c, const char** begin, const char** end) {
+    if (c < num_threads) {
+      *begin = chunk_begin[c];
+      *end = chunk_begin[c + 1];
+    } else {
+      *begin = tail.data();
+      *end = tail.data() + tail.size();
+    }
+  };
+
+  std::vector<int64_t> chunk_lines(num_chunks + 1, 0);
+  std::vector<int64_t> chunk_entries(num_chunks + 1, 0);
+  RunOnThreads(num_threads, [&](int32_t t) {
+    const char *begin, *end;
+    chunk_range(t, &begin, &end);
+    CountLibSVM(begin, end, &chunk_lines[t + 1], &chunk_entries[t + 1]);
+  });
+  CountLibSVM(tail.data(), tail.data() + tail.size(),
+      &chunk_lines[num_chunks], &chunk_entries[num_chunks]);
+  for (int32_t c = 0; c < num_chunks; ++c) {
+    chunk_lines[c + 1] += chunk_lines[c];
+    chunk_entries[c + 1] += chunk_entries[c];
+  }
+  int64_t total_lines = chunk_lines[num_chunks];
+  if (num_data <= 0) {
+    CHECK_LE(total_lines, INT32_MAX) << filename << " has too many lines";
+    num_data = total_lines;
+  }
+  CHECK_LE(num_data, total_lines) << "Request to read " << num_data
+    << " data instances but only " << total_lines << " found in "
+    << filename;
+
+  owned_row_offsets_.resize(num_data + 1);
+  owned_labels_.resize(num_data);
+  owned_feature_ids_.resize(chunk_entries[num_chunks]);
+  owned_feature_vals_.resize(chunk_entries[num_chunks]);
+
+  // A chunk may end past sample num_data, so each records where its
+  // entries end.
+  std::vector<int64_t> chunk_entry_end(num_chunks, 0);
+  auto parse_chunk = [&](int32_t c) {
+    if (chunk_lines[c] >= num_data)
+      return;
+    const char *begin, *end;
+    chunk_range(c, &begin, &end);
+    chunk_entry_end[c] = ParseLibSVM(begin, end, num_data - chunk_lines[c],
+        feature_dim, feature_one_based, label_one_based, chunk_lines[c],
+        chunk_entries[c], owned_row_offsets_.data(),
+        owned_feature_ids_.data(), owned_feature_vals_.data(),
+        owned_labels_.data());
+  };
+  RunOnThreads(num_threads, parse_chunk);
+  parse_chunk(num_threads);
+
+  num_entries_ = 0;
+  for (int32_t c = 0; c < num_chunks && chunk_lines[c] < num_data; ++c) {
+    num_entries_ = chunk_entry_end[c];
+  }
+  owned_row_offsets_[num_data] = num_entries_;
+
+  if (mem != 0)
+    munmap(const_cast<char*>(mem), size);
+  owned_feature_ids_.resize(num_entries_);
+  owned_feature_vals_.resize(num_entries_);
+  num_data_ = num_data;
+  feature_dim_ = feature_dim;
+  UseOwnedStorage();
+  LOG(INFO) << "Read " << num_data_ << " instances (" << num_entries_
+    << " entries) from " << filename << " in " << read_timer.elapsed()
+    << " seconds.";
+}
+
+void CSRDataset::SaveCache(const std::string& filename) const {
+  FILE* file = fopen(filename.c_str(), "wb");
+  CHECK(file != 0) << "Can't open " << filename;
+  CSRCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kCSRCacheMagic;
+  header.num_data = num_data_;
+  header.num_entries = num_entries_;
+  header.feature_dim = feature_dim_;
+  CHECK_EQ(1, fwrite(&header, sizeof(header), 1, file));
+  CHECK_EQ(num_data_ + 1, fwrite(row_offsets_, sizeof(int64_t),
+        num_data_ + 1, file));
+  CHECK_EQ(num_entries_, fwrite(feature_ids_, sizeof(int32_t),
+        num_entries_, file));
+  CHECK_EQ(num_entries_, fwrite(feature_vals_, sizeof(float),
+        num_entries_, file));
+  CHECK_EQ(num_data_, fwrite(labels_, sizeof(int32_t), num_data_, file));
+  CHECK_EQ(0, fclose(file)) << "Failed to write " << filename;
+}
+
+void CSRDataset::LoadCache(const std::string& filename) {
+  petuum::HighResolutionTimer read_timer;
+  Clear();
+  int fd = open(filename.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Can't open " << filename;
+  struct stat st;
+  CHECK_EQ(0, fstat(fd, &st));
+  CHECK_GE(st.st_size, sizeof(CSRCacheHeader)) << filename
+    << " is not a CSRDataset cache";
+  void* addr = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  CHECK(addr != MAP_FAILED) << "Can't mmap " << filename << ": "
+    << strerror(errno);
+  close(fd);
+  madvise(addr, st.st_size, MADV_WILLNEED);
+  mapped_ = addr;
+  mapped_size_ = st.st_size;
+
+  const uint8_t* mem = reinterpret_cast<const uint8_t*>(addr);
+  const CSRCacheHeader* header = reinterpret_cast<const CSRCacheHeader*>(mem);
+  CHECK_EQ(kCSRCacheMagic, header->magic) << filename
+    << " is not a CSRDataset cache";
+  size_t expected_size = sizeof(CSRCacheHeader)
+    + (header->num_data + 1) * sizeof(int64_t)
+    + header->num_entries * (sizeof(int32_t) + sizeof(float))
+    + header->num_data * sizeof(int32_t);
+  CHECK_EQ(expected_size, mapped_size_) << filename << " is truncated";
+
+  num_data_ = header->num_data;
+  num_entries_ = header->num_entries;
+  feature_dim_ = header->feature_dim;
+  mem += sizeof(CSRCacheHeader);
+  row_offsets_ = reinterpret_cast<const int64_t*>(mem);
+  mem += (num_data_ + 1) * sizeof(int64_t);
+  feature_ids_ = reinterpret_cast<const int32_t*>(mem);
+  mem += num_entries_ * sizeof(int32_t);
+  feature_vals_ = reinterpret_cast<const float*>(mem);
+  mem += num_entries_ * sizeof(float);
+  labels_ = reinterpret_cast<const int32_t*>(mem);
+  LOG(INFO) << "Mapped " << num_data_ << " instances (" << num_entries_
+    << " entries) from " << filename << " in " << read_timer.elapsed()
+    << " seconds.";
+}
+
+}  // namespace ml
+}  // namespace petuum
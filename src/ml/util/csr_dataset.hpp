@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+
+namespace petuum {
+namespace ml {
+
+// Sparse samples and their labels in compressed sparse row form: the
+// entries of sample i are feature_ids[k], feature_vals[k] for k in
+// [row_offsets[i], row_offsets[i+1]), sorted by feature id.
+//
+// The arrays are either owned or point into a memory-mapped cache file
+// (see LoadCache).
+class CSRDataset : boost::noncopyable {
+public:
+  CSRDataset();
+  ~CSRDataset();
+
+  // Parses a LibSVM file (label [feature_id:feature_val]...) on num_threads
+  // threads. Reads the first num_data samples, or all of them if
+  // num_data <= 0. Empty lines are skipped.
+  void LoadLibSVM(const std::string& filename, int32_t feature_dim,
+      int32_t num_data, bool feature_one_based = false,
+      bool label_one_based = false, int32_t num_threads = 1);
+
+  // Binary cache, written by SaveCache and loaded with one mmap.
+  void SaveCache(const std::string& filename) const;
+  void LoadCache(const std::string& filename);
+
+  int32_t GetNumData() const {
+    return num_data_;
+  }
+
+  int32_t GetFeatureDim() const {
+    return feature_dim_;
+  }
+
+  int64_t GetTotalNumEntries() const {
+    return num_entries_;
+  }
+
+  int32_t GetNumEntries(int32_t i) const {
+    return row_offsets_[i + 1] - row_offsets_[i];
+  }
+
+  const int32_t *GetFeatureIds(int32_t i) const {
+    return feature_ids_ + row_offsets_[i];
+  }
+
+  const float *GetFeatureVals(int32_t i) const {
+    return feature_vals_ + row_offsets_[i];
+  }
+
+  int32_t GetLabel(int32_t i) const {
+    return labels_[i];
+  }
+
+  const int64_t *GetRowOffsets() const {
+    return row_offsets_;
+  }
+
+  const int32_t *GetLabels() const {
+    return labels_;
+  }
+
+private:
+  void Clear();
+  // Points the arrays at the owned vectors.
+  void UseOwnedStorage();
+
+  int32_t num_data_;
+  int32_t feature_dim_;
+  int64_t num_entries_;
+
+  const int64_t *row_offsets_;
+  const int32_t *feature_ids_;
+  const float *feature_vals_;
+  const int32_t *labels_;
+
+  std::vector<int64_t> owned_row_offsets_;
+  std::vector<int32_t> owned_feature_ids_;
+  std::vector<float> owned_feature_vals_;
+  std::vector<int32_t> owned_labels_;
+
+  void *mapped_;
+  size_t mapped_size_;
+};
+
+}  // namespace ml
+}  // namespace petuum
@@ -108,6 +108,62 @@ void FeatureScaleAndAdd(float alpha, const AbstractFeature<float>& f1,
   }
 }
 
+float CSRDenseDotProduct(const CSRDataset& data, int32_t i, const float* w) {
+  const int32_t* ids = data.GetFeatureIds(i);
+  const float* vals = data.GetFeatureVals(i);
+  int32_t num_entries = data.GetNumEntries(i);
+  float sum = 0.;
+  for (int32_t k = 0; k < num_entries; ++k) {
+    sum += vals[k] * w[ids[k]];
+  }
+  return sum;
+}
+
+void CSRDenseMatVec(const CSRDataset& data, int32_t begin, int32_t end,
+    const float* w, float* out) {
+  const int64_t* row_offsets = data.GetRowOffsets();
+  const int32_t* ids = data.GetFeatureIds(0);
+  const float* vals = data.GetFeatureVals(0);
+  for (int32_t i = begin; i < end; ++i) {
+    float sum = 0.;
+    for (int64_t k = row_offsets[i]; k < row_offsets[i + 1]; ++k) {
+      sum += vals[k] * w[ids[k]];
+    }
+    out[i - begin] = sum;
+  }
+}
+
+float CSRSparseDotProduct(const CSRDataset& data1, int32_t i,
+    const CSRDataset& data2, int32_t j) {
+  const int32_t* ids1 = data1.GetFeatureIds(i);
+  const float* vals1 = data1.GetFeatureVals(i);
+  const int32_t* ids2 = data2.GetFeatureIds(j);
+  const float* vals2 = data2.GetFeatureVals(j);
+  int32_t n1 = data1.GetNumEntries(i);
+  int32_t n2 = data2.GetNumEntries(j);
+  int32_t k1 = 0, k2 = 0;
+  float sum = 0.;
+  while (k1 < n1 && k2 < n2) {
+    if (ids1[k1] < ids2[k2]) {
+      ++k1;
+    } else if (ids1[k1] > ids2[k2]) {
+      ++k2;
+    } else {
+      sum += vals1[k1++] * vals2[k2++];
+    }
+  }
+  return sum;
+}
+
+void CSRScaleAndAdd(float alpha, const CSRDataset& data, int32_t i,
+    float* w) {
+  const int32_t* ids = data.GetFeatureIds(i);
+  const float* vals = data.GetFeatureVals(i);
+  int32_t num_entries = data.GetNumEntries(i);
+  for (int32_t k = 0; k < num_entries; ++k) {
+    w[ids[k]] += alpha * vals[k];
+  }
+}
 
 }  // namespace ml
 }  // namespace petuum
@@ -9,6 +9,7 @@
 #include <ml/feature/abstract_feature.hpp>
 #include <ml/feature/dense_feature.hpp>
 #include <ml/feature/sparse_feature.hpp>
+#include <ml/util/csr_dataset.hpp>
 #include <sstream>
 
 namespace petuum {
@@ -62,5 +63,23 @@ void FeatureScaleAndAdd(float alpha, const DenseFeature<float>& f1,
 void FeatureScaleAndAdd(float alpha, const AbstractFeature<float>& f1,
     AbstractFeature<float>* f2);
 
+// Kernels on CSRDataset samples. They read the flat arrays directly and are
+// several times faster than the AbstractFeature versions above. w is dense
+// with data.GetFeatureDim() entries.
+
+// Return x_i . w.
+float CSRDenseDotProduct(const CSRDataset& data, int32_t i, const float* w);
+
+// out[i - begin] = x_i . w for i in [begin, end).
+void CSRDenseMatVec(const CSRDataset& data, int32_t begin, int32_t end,
+    const float* w, float* out);
+
+// Return x_i . y_j, where x_i is from data1 and y_j from data2.
+float CSRSparseDotProduct(const CSRDataset& data1, int32_t i,
+    const CSRDataset& data2, int32_t j);
+
+// w += alpha * x_i.
+void CSRScaleAndAdd(float alpha, const CSRDataset& data, int32_t i, float* w);
+
 }  // namespace ml
 }  // namespace petuum
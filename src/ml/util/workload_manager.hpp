@@ -4,8 +4,11 @@
 #pragma once
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <cstdint>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 namespace petuum {
 namespace ml {
@@ -96,6 +99,21 @@ public:
     return result;
   }
 
+  // Same indices as GetBatchDataIdx(num_data), as contiguous [begin, end)
+  // ranges in order. Lets CSRDataset kernels (e.g. CSRDenseMatVec) run on
+  // whole ranges.
+  void GetBatchDataRanges(int32_t num_data,
+      std::vector<std::pair<int32_t, int32_t> >* ranges) const {
+    ranges->clear();
+    int32_t begin = WrapAround(num_data_this_epoch_ + data_idx_begin_);
+    while (num_data > 0) {
+      int32_t len = std::min(num_data, data_idx_end_ - begin);
+      ranges->push_back(std::make_pair(begin, begin + len));
+      num_data -= len;
+      begin = data_idx_begin_;
+    }
+  }
+
   // Is end of the data set (of this partition).
   bool IsEnd() const {
     return num_data_this_epoch_ == num_data_per_epoch_;
@@ -2,9 +2,11 @@
 #include <petuum_ps/client/client_table.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 #include <petuum_ps_common/client/client_row.hpp>
 #include <petuum_ps_common/storage/bounded_dense_process_storage.hpp>
 #include <petuum_ps_common/storage/bounded_sparse_process_storage.hpp>
+#include <petuum_ps_common/storage/lock_free_sparse_process_storage.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
 
 #include <petuum_ps/client/ssp_client_row.hpp>
@@ -39,7 +41,14 @@ ClientTable::ClientTable(int32_t table_id, const ClientTableConfig &config):
     dense_row_oplog_capacity_(config.table_info.dense_row_oplog_capacity),
     append_only_oplog_type_(config.append_only_oplog_type),
     row_capacity_(config.table_info.row_capacity),
-    no_oplog_replay_(config.no_oplog_replay) {
+    no_oplog_replay_(config.no_oplog_replay
+                     || config.table_info.server_update_rule.type
+                     != ServerAdd) {
+  // Pending oplogs hold gradients, not the change the server makes to a row
+  // under other update rules, so they are never replayed onto fresh rows.
+  CHECK(config.table_info.server_update_rule.type == ServerAdd
+        || config.oplog_type != AppendOnly)
+      << "Server update rules other than Add need a Sparse or Dense oplog";
   switch (config.process_storage_type) {
     case BoundedDense:
       {
@@ -68,6 +77,12 @@ ClientTable::ClientTable(int32_t table_id, const ClientTableConfig &config):
             GlobalContext::GetLockPoolSize(config.process_cache_capacity)));
       }
       break;
+    case LockFreeSparse:
+      {
+        process_storage_ = static_cast<AbstractProcessStorage*>(
+            new LockFreeSparseProcessStorage(config.process_cache_capacity));
+      }
+      break;
     default:
       LOG(FATAL) << "Unknown process storage type " << config.process_storage_type;
   }
@@ -79,6 +94,7 @@ ClientTable::ClientTable(int32_t table_id, const ClientTableConfig &config):
       break;
     case AppendOnly:
       oplog_ = new AppendOnlyOpLog(
+          table_id,
           config.append_only_buff_capacity,
           sample_row_,
           config.append_only_oplog_type,
@@ -96,6 +112,13 @@ ClientTable::ClientTable(int32_t table_id, const ClientTableConfig &config):
       LOG(FATAL) << "Unknown oplog type = " << config.oplog_type;
   }
 
+  CHECK(!config.thread_local_oplog
+        || ((GlobalContext::get_consistency_model() == SSP
+             || GlobalContext::get_consistency_model() == SSPPush)
+            && (config.oplog_type == Sparse || config.oplog_type == Dense)))
+      << "thread_local_oplog requires SSP or SSPPush with a Sparse or Dense "
+      << "oplog";
+
   switch (GlobalContext::get_consistency_model()) {
     case SSP:
       {
@@ -103,7 +126,7 @@ ClientTable::ClientTable(int32_t table_id, const ClientTableConfig &config):
             = new SSPConsistencyController(
                 config.table_info,
                 table_id, *process_storage_, *oplog_, sample_row_, thread_cache_,
-                oplog_index_, row_oplog_type_);
+                oplog_index_, row_oplog_type_, config.thread_local_oplog);
       }
       break;
     case SSPPush:
@@ -113,7 +136,7 @@ ClientTable::ClientTable(int32_t table_id, const ClientTableConfig &config):
             = new SSPPushConsistencyController(
                 config.table_info,
                 table_id, *process_storage_, *oplog_, sample_row_, thread_cache_,
-                oplog_index_, row_oplog_type_);
+                oplog_index_, row_oplog_type_, config.thread_local_oplog);
         } else if (config.oplog_type == AppendOnly) {
           consistency_controller_
             = new SSPPushAppendOnlyConsistencyController(
@@ -160,8 +183,10 @@ ClientTable::~ClientTable() {
 void ClientTable::RegisterThread() {
   if (thread_cache_.get() == 0)
     thread_cache_.reset(new ThreadTable(
-        sample_row_, client_table_config_.table_info.row_oplog_type,
-        client_table_config_.table_info.row_capacity));
+        table_id_, sample_row_, client_table_config_.table_info.row_oplog_type,
+        client_table_config_.table_info.row_capacity,
+        client_table_config_.table_info.server_update_rule.type
+        == ServerAdd));
 
   oplog_->RegisterThread();
 }
@@ -203,10 +228,16 @@ void ClientTable::FlushThreadCache() {
 }
 
 ClientRow *ClientTable::Get(int32_t row_id, RowAccessor *row_accessor) {
+  MetricTimer metric_timer(kMetricAppGet, true);
   return consistency_controller_->Get(row_id, row_accessor);
 }
 
+void ClientTable::GetBatch(const int32_t *row_ids, int32_t num_rows) {
+  consistency_controller_->GetBatch(row_ids, num_rows);
+}
+
 void ClientTable::Inc(int32_t row_id, int32_t column_id, const void *update) {
+  MetricTimer metric_timer(kMetricAppInc, true);
   STATS_APP_SAMPLE_INC_BEGIN(table_id_);
   consistency_controller_->Inc(row_id, column_id, update);
   STATS_APP_SAMPLE_INC_END(table_id_);
@@ -214,6 +245,7 @@ void ClientTable::Inc(int32_t row_id, int32_t column_id, const void *update) {
 
 void ClientTable::BatchInc(int32_t row_id, const int32_t* column_ids,
   const void* updates, int32_t num_updates) {
+  MetricTimer metric_timer(kMetricAppBatchInc, true);
   STATS_APP_SAMPLE_BATCH_INC_BEGIN(table_id_);
   consistency_controller_->BatchInc(row_id, column_ids, updates,
                                     num_updates);
@@ -223,6 +255,7 @@ void ClientTable::BatchInc(int32_t row_id, const int32_t* column_ids,
 void ClientTable::DenseBatchInc(
     int32_t row_id, const void *updates, int32_t index_st,
     int32_t num_updates) {
+  MetricTimer metric_timer(kMetricAppBatchInc, true);
   STATS_APP_SAMPLE_BATCH_INC_BEGIN(table_id_);
   consistency_controller_->DenseBatchInc(row_id, updates, index_st,
                                          num_updates);
@@ -1,4 +1,5 @@
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 #include <petuum_ps/client/table_group.hpp>
 #include <petuum_ps/thread/context.hpp>
 #include <petuum_ps/server/server_threads.hpp>
@@ -12,8 +13,7 @@
 namespace petuum {
 TableGroup::TableGroup(const TableGroupConfig &table_group_config,
                        bool table_access, int32_t *init_thread_id):
-    AbstractTableGroup(),
-    max_table_staleness_(0) {
+    AbstractTableGroup() {
 
   int32_t num_comm_channels_per_client
       = table_group_config.num_comm_channels_per_client;
@@ -34,6 +34,7 @@ TableGroup::TableGroup(const TableGroupConfig &table_group_config,
 
   STATS_INIT(table_group_config);
   STATS_REGISTER_THREAD(kAppThread);
+  Metrics::Init(table_group_config);
 
   // can be Inited after CommBus but must be before everything else
   GlobalContext::Init(
@@ -55,6 +56,7 @@ TableGroup::TableGroup(const TableGroupConfig &table_group_config,
       table_group_config.bg_idle_milli,
       table_group_config.bandwidth_mbps,
       table_group_config.oplog_push_upper_bound_kb,
+      table_group_config.adaptive_oplog_push,
       table_group_config.oplog_push_staleness_tolerance,
       table_group_config.thread_oplog_batch_size,
       table_group_config.server_push_row_threshold,
@@ -64,7 +66,8 @@ TableGroup::TableGroup(const TableGroupConfig &table_group_config,
   NumaMgr::Init(table_group_config.numa_opt);
 
   CommBus *comm_bus = new CommBus(local_id_min, local_id_max,
-                                  num_total_clients, 1);
+                                  num_total_clients, 1,
+                                  table_group_config.comm_bus_ipc_dir);
   GlobalContext::comm_bus = comm_bus;
 
   *init_thread_id = local_id_min
@@ -112,13 +115,11 @@ TableGroup::~TableGroup() {
   }
   STATS_DEREGISTER_THREAD();
   STATS_PRINT();
+  Metrics::ShutDown();
 }
 
 bool TableGroup::CreateTable(int32_t table_id,
   const ClientTableConfig& table_config) {
-  max_table_staleness_ = std::max(max_table_staleness_,
-      table_config.table_info.table_staleness);
-
   bool suc = BgWorkers::CreateTable(table_id, table_config);
   if (suc
       && (GlobalContext::get_num_app_threads()
@@ -133,6 +134,7 @@ void TableGroup::CreateTableDone() {
   BgWorkers::WaitCreateTable();
   pthread_barrier_init(&register_barrier_, 0,
     GlobalContext::get_num_table_threads());
+  thread_collective_.Init(GlobalContext::get_num_table_threads());
 }
 
 void TableGroup::WaitThreadRegister() {
@@ -182,16 +184,40 @@ void TableGroup::DeregisterThread(){
 }
 
 void TableGroup::Clock() {
+  MetricTimer metric_timer(kMetricAppClock, false);
   STATS_APP_ACCUM_TG_CLOCK_BEGIN();
   ThreadContext::Clock();
   (this->*ClockInternal)();
   STATS_APP_ACCUM_TG_CLOCK_END();
 }
 
-void TableGroup::GlobalBarrier() {
-  for (int i = 0; i < max_table_staleness_ + 1; ++i) {
-    Clock();
+void TableGroup::FlushOpLogs() {
+  // Same as the flush in Clock(), but the clock does not advance, so the
+  // bg workers send the oplogs as an update to the current clock.
+  for (auto table_iter = tables_.cbegin(); table_iter != tables_.cend();
+    table_iter++) {
+    table_iter->second->Clock();
   }
+  BgWorkers::SendOpLogsAllTables();
+}
+
+void TableGroup::GlobalBarrier() {
+  // One clock ships every update made before the barrier. Rows that have
+  // them all carry a clock no less than the clock after it, so reads past
+  // the barrier are held to that clock instead of clocking staleness + 1
+  // times.
+  Clock();
+  if (thread_collective_.Arrive())
+    BgWorkers::GlobalBarrier();
+  thread_collective_.Release();
+  ThreadContext::set_barrier_clock(ThreadContext::get_clock());
+}
+
+void TableGroup::AllReduce(void *buf, int32_t count,
+                           AllReduceDataType data_type, AllReduceOp op) {
+  if (thread_collective_.ArriveReduce(buf, count, data_type, op))
+    BgWorkers::AllReduce(thread_collective_.get_buff(), count, data_type, op);
+  thread_collective_.ReleaseReduce(buf);
 }
 
 void TableGroup::ClockAggressive() {
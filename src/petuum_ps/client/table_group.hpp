@@ -15,6 +15,7 @@
 #include <petuum_ps/client/client_table.hpp>
 
 #include <petuum_ps_common/client/abstract_table_group.hpp>
+#include <petuum_ps_common/client/thread_collective.hpp>
 
 namespace petuum {
 
@@ -44,8 +45,13 @@ public:
 
   void Clock();
 
+  void FlushOpLogs();
+
   void GlobalBarrier();
 
+  void AllReduce(void *buf, int32_t count, AllReduceDataType data_type,
+                 AllReduceOp op);
+
 private:
   typedef void (TableGroup::*ClockFunc) ();
   ClockFunc ClockInternal;
@@ -57,9 +63,9 @@ private:
   pthread_barrier_t register_barrier_;
   std::atomic<int> num_app_threads_registered_;
 
-  // Max staleness among all tables.
-  int32_t max_table_staleness_;
   VectorClockMT vector_clock_;
+
+  ThreadCollective thread_collective_;
 };
 
 }   // namespace petuum
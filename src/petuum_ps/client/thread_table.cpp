@@ -11,12 +11,14 @@
 namespace petuum {
 
 ThreadTable::ThreadTable(
-    const AbstractRow *sample_row, int32_t row_oplog_type,
-    size_t dense_row_oplog_capacity) :
+    int32_t table_id, const AbstractRow *sample_row, int32_t row_oplog_type,
+    size_t dense_row_oplog_capacity, bool apply_local_inc) :
+    partitioner_(GlobalContext::GetRowPartitioner(table_id)),
     oplog_index_(GlobalContext::get_num_comm_channels_per_client()),
     sample_row_(sample_row),
     update_count_(0),
-    dense_row_oplog_capacity_(dense_row_oplog_capacity) {
+    dense_row_oplog_capacity_(dense_row_oplog_capacity),
+    apply_local_inc_(apply_local_inc) {
 
   ApplyThreadOpLog_ = &ThreadTable::ApplyThreadOpLogSSP;
 
@@ -65,12 +67,12 @@ void ThreadTable::UpdateOpLogClockSSPAggr(AbstractRowOpLog *row_oplog) {
 }
 
 void ThreadTable::IndexUpdate(int32_t row_id) {
-  int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+  int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
   oplog_index_[partition_num].insert(row_id);
 }
 
 size_t ThreadTable::IndexUpdateAndGetCount(int32_t row_id, size_t num_updates) {
-  int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+  int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
   oplog_index_[partition_num].insert(row_id);
   update_count_ += num_updates;
   return update_count_;
@@ -117,7 +119,7 @@ void ThreadTable::InsertRow(int32_t row_id, const AbstractRow *to_insert) {
 
   boost::unordered_map<int32_t, AbstractRowOpLog* >::iterator oplog_iter
       = oplog_map_.find(row_id);
-  if (oplog_iter != oplog_map_.end()) {
+  if (apply_local_inc_ && oplog_iter != oplog_map_.end()) {
     int32_t column_id;
     void *delta = oplog_iter->second->BeginIterate(&column_id);
     while (delta != 0) {
@@ -145,6 +147,9 @@ void ThreadTable::Inc(int32_t row_id, int32_t column_id, const void *delta) {
   void *oplog_delta = row_oplog->FindCreate(column_id);
   sample_row_->AddUpdates(column_id, oplog_delta, delta);
 
+  if (!apply_local_inc_)
+    return;
+
   auto row_iter = row_storage_.find(row_id);
   if (row_iter != row_storage_.end()) {
     row_iter->second->ApplyIncUnsafe(column_id, delta);
@@ -172,6 +177,9 @@ void ThreadTable::BatchInc(int32_t row_id, const int32_t *column_ids,
                             + sample_row_->get_update_size()*i);
   }
 
+  if (!apply_local_inc_)
+    return;
+
   auto row_iter = row_storage_.find(row_id);
   if (row_iter != row_storage_.end()) {
     row_iter->second->ApplyBatchIncUnsafe(column_ids, deltas, num_updates);
@@ -198,12 +206,69 @@ void ThreadTable::DenseBatchInc(int32_t row_id, const void *updates,
     }
   }
 
+  if (!apply_local_inc_)
+    return;
+
   auto row_iter = row_storage_.find(row_id);
   if (row_iter != row_storage_.end()) {
     row_iter->second->ApplyDenseBatchIncUnsafe(updates, index_st, num_updates);
   }
 }
 
+void ThreadTable::BufferBatchInc(int32_t row_id, const int32_t *column_ids,
+                                 const void *deltas, int32_t num_updates) {
+  const uint8_t* deltas_uint8 = reinterpret_cast<const uint8_t*>(deltas);
+  size_t update_size = sample_row_->get_update_size();
+  ThreadOpLogBuffer *oplog_buffer = GetOpLogBuffer();
+  for (int i = 0; i < num_updates; ++i) {
+    oplog_buffer->Inc(row_id, column_ids[i], deltas_uint8 + update_size*i);
+  }
+}
+
+void ThreadTable::BufferDenseBatchInc(int32_t row_id, const void *updates,
+                                      int32_t index_st, int32_t num_updates) {
+  const uint8_t* updates_uint8 = reinterpret_cast<const uint8_t*>(updates);
+  size_t update_size = sample_row_->get_update_size();
+  ThreadOpLogBuffer *oplog_buffer = GetOpLogBuffer();
+  for (int i = 0; i < num_updates; ++i) {
+    oplog_buffer->Inc(row_id, index_st + i, updates_uint8 + update_size*i);
+  }
+}
+
+void ThreadTable::FlushOpLogBuffer(AbstractProcessStorage &process_storage,
+                                   AbstractOpLog &table_oplog) {
+  if (!oplog_buffer_ || oplog_buffer_->get_num_entries() == 0)
+    return;
+
+  size_t update_size = sample_row_->get_update_size();
+  oplog_buffer_->ForEachRow(
+      [&](int32_t row_id, const int32_t *column_ids, const uint8_t *deltas,
+          int32_t num_updates) {
+        // The oplog lock is held until the cached row is updated too, as in
+        // FlushCacheOpLog(); otherwise a bg thread inserting the row in
+        // between would copy these deltas into it and they would be applied
+        // twice.
+        OpLogAccessor oplog_accessor;
+        table_oplog.FindInsertOpLog(row_id, &oplog_accessor);
+        AbstractRowOpLog *row_oplog = oplog_accessor.get_row_oplog();
+        for (int i = 0; i < num_updates; ++i) {
+          void *oplog_delta = row_oplog->FindCreate(column_ids[i]);
+          sample_row_->AddUpdates(column_ids[i], oplog_delta,
+                                  deltas + update_size*i);
+        }
+
+        RowAccessor row_accessor;
+        ClientRow *client_row = apply_local_inc_
+            ? process_storage.Find(row_id, &row_accessor) : 0;
+        if (client_row != 0) {
+          client_row->GetRowDataPtr()->ApplyBatchInc(column_ids, deltas,
+                                                     num_updates);
+        }
+        IndexUpdate(row_id);
+      });
+  oplog_buffer_->Clear();
+}
+
 void ThreadTable::FlushCache(AbstractProcessStorage &process_storage,
                              AbstractOpLog &table_oplog,
 			     const AbstractRow *sample_row) {
@@ -229,7 +294,8 @@ void ThreadTable::FlushCacheOpLog(AbstractProcessStorage &process_storage,
     UpdateOpLogClock_(oplog_accessor.get_row_oplog());
 
     RowAccessor row_accessor;
-    bool found = process_storage.Find(row_id, &row_accessor);
+    bool found = apply_local_inc_
+        && process_storage.Find(row_id, &row_accessor);
 
     (this->*ApplyThreadOpLog_)(&oplog_accessor, &row_accessor, found,
                                oplog_iter->second, row_id);
@@ -242,7 +308,7 @@ void ThreadTable::ApplyThreadOpLogSSP(
     OpLogAccessor *oplog_accessor, RowAccessor *row_accessor, bool row_found,
     AbstractRowOpLog *row_oplog, int32_t row_id) {
 
-  int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+  int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
 
   int32_t column_id;
   void *delta = row_oplog->BeginIterate(&column_id);
@@ -263,7 +329,7 @@ void ThreadTable::ApplyThreadOpLogGetImportance(
     OpLogAccessor *oplog_accessor, RowAccessor *row_accessor, bool row_found,
     AbstractRowOpLog *row_oplog, int32_t row_id) {
 
-  int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+  int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
 
   int32_t column_id;
   void *delta = row_oplog->BeginIterate(&column_id);
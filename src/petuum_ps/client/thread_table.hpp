@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_set>
+#include <memory>
 #include <vector>
 #include <boost/noncopyable.hpp>
 
@@ -11,13 +12,16 @@
 #include <petuum_ps/oplog/oplog_index.hpp>
 #include <petuum_ps/oplog/abstract_oplog.hpp>
 #include <petuum_ps/oplog/create_row_oplog.hpp>
+#include <petuum_ps/oplog/thread_oplog_buffer.hpp>
+#include <petuum_ps/thread/row_partitioner.hpp>
 
 namespace petuum {
 
 class ThreadTable : boost::noncopyable {
 public:
-  explicit ThreadTable(const AbstractRow *sample_row, int32_t row_oplog_type,
-                       size_t dense_row_oplog_capacity);
+  ThreadTable(int32_t table_id, const AbstractRow *sample_row,
+              int32_t row_oplog_type, size_t dense_row_oplog_capacity,
+              bool apply_local_inc);
   ~ThreadTable();
   void IndexUpdate(int32_t row_id);
   void FlushOpLogIndex(TableOpLogIndex &oplog_index);
@@ -31,6 +35,21 @@ public:
   void DenseBatchInc(int32_t row_id, const void *updates, int32_t index_st,
                      int32_t num_updates);
 
+  // Inc, BatchInc and DenseBatchInc of tables with thread_local_oplog. They
+  // only touch memory private to this thread.
+  void BufferInc(int32_t row_id, int32_t column_id, const void *delta) {
+    GetOpLogBuffer()->Inc(row_id, column_id, delta);
+  }
+  void BufferBatchInc(int32_t row_id, const int32_t *column_ids,
+                      const void *deltas, int32_t num_updates);
+  void BufferDenseBatchInc(int32_t row_id, const void *updates,
+                           int32_t index_st, int32_t num_updates);
+
+  // Merges the buffered updates into table_oplog and process_storage, taking
+  // each row's lock once.
+  void FlushOpLogBuffer(AbstractProcessStorage &process_storage,
+                        AbstractOpLog &table_oplog);
+
   void FlushCache(AbstractProcessStorage &process_storage, AbstractOpLog &table_oplog,
 		  const AbstractRow *sample_row);
   void FlushCacheOpLog(AbstractProcessStorage &process_storage, AbstractOpLog &table_oplog,
@@ -46,6 +65,7 @@ public:
   }
 
 private:
+  const RowPartitioner &partitioner_;
   std::vector<std::unordered_set<int32_t> > oplog_index_;
   boost::unordered_map<int32_t, AbstractRow* > row_storage_;
   boost::unordered_map<int32_t, AbstractRowOpLog* > oplog_map_;
@@ -53,8 +73,22 @@ private:
 
   size_t update_count_;
 
+  // Created on the first buffered update, so that tables without
+  // thread_local_oplog don't pay for it.
+  std::unique_ptr<ThreadOpLogBuffer> oplog_buffer_;
+
+  ThreadOpLogBuffer *GetOpLogBuffer() {
+    if (!oplog_buffer_)
+      oplog_buffer_.reset(new ThreadOpLogBuffer(sample_row_));
+    return oplog_buffer_.get();
+  }
+
   size_t dense_row_oplog_capacity_;
 
+  // False under server update rules other than ServerAdd; updates then only
+  // go to the oplogs and never to the cached rows.
+  const bool apply_local_inc_;
+
   typedef void (*UpdateOpLogClockFunc)(AbstractRowOpLog *row_oplog);
 
   static void UpdateOpLogClockSSPAggr(AbstractRowOpLog *row_oplog);
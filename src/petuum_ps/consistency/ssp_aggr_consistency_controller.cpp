@@ -33,7 +33,8 @@ void SSPAggrConsistencyController::Inc(int32_t row_id, int32_t column_id,
   meta_row_oplog->GetMeta().set_clock(ThreadContext::get_clock());
 
   RowAccessor row_accessor;
-  ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
+  ClientRow *client_row = apply_local_inc_
+      ? process_storage_.Find(row_id, &row_accessor) : 0;
   if (client_row != 0) {
     client_row->GetRowDataPtr()->ApplyInc(column_id, delta);
   }
@@ -63,7 +64,8 @@ void SSPAggrConsistencyController::BatchInc(int32_t row_id,
   meta_row_oplog->GetMeta().set_clock(ThreadContext::get_clock());
 
   RowAccessor row_accessor;
-  ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
+  ClientRow *client_row = apply_local_inc_
+      ? process_storage_.Find(row_id, &row_accessor) : 0;
   if (client_row != 0) {
     client_row->GetRowDataPtr()->ApplyBatchInc(column_ids, updates,
                                                num_updates);
@@ -84,21 +86,17 @@ void SSPAggrConsistencyController::DenseBatchInc(
     oplog_accessor.get_row_oplog()->OverwriteWithDenseUpdate(
         updates, index_st, num_updates);
   } else {
-    const uint8_t* deltas_uint8 = reinterpret_cast<const uint8_t*>(updates);
-    for (int i = 0; i < num_updates; ++i) {
-      int32_t col_id = i + index_st;
-      void *oplog_delta
-          = oplog_accessor.get_row_oplog()->FindCreate(col_id);
-      sample_row_->AddUpdates(col_id, oplog_delta, deltas_uint8
-                              + sample_row_->get_update_size()*i);
-    }
+    (this->*DenseBatchIncOpLog_)(
+        &oplog_accessor, reinterpret_cast<const uint8_t*>(updates),
+        index_st, num_updates);
   }
   MetaRowOpLog *meta_row_oplog
       = dynamic_cast<MetaRowOpLog*>(oplog_accessor.get_row_oplog());
   meta_row_oplog->GetMeta().set_clock(ThreadContext::get_clock());
 
   RowAccessor row_accessor;
-  ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
+  ClientRow *client_row = apply_local_inc_
+      ? process_storage_.Find(row_id, &row_accessor) : 0;
   if (client_row != 0) {
     client_row->GetRowDataPtr()->ApplyDenseBatchInc(
         updates, index_st, num_updates);
@@ -35,7 +35,8 @@ void SSPAggrValueConsistencyController::Inc(int32_t row_id, int32_t column_id,
 
   double importance = 0.0;
   RowAccessor row_accessor;
-  ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
+  ClientRow *client_row = apply_local_inc_
+      ? process_storage_.Find(row_id, &row_accessor) : 0;
 
   if (client_row != 0) {
     importance = client_row->GetRowDataPtr()->ApplyIncGetImportance(
@@ -71,7 +72,8 @@ void SSPAggrValueConsistencyController::BatchInc(int32_t row_id,
 
   double importance = 0.0;
   RowAccessor row_accessor;
-  ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
+  ClientRow *client_row = apply_local_inc_
+      ? process_storage_.Find(row_id, &row_accessor) : 0;
   if (client_row != 0) {
     importance = client_row->GetRowDataPtr()->ApplyBatchIncGetImportance(
         column_ids, updates, num_updates);
@@ -111,7 +113,8 @@ void SSPAggrValueConsistencyController::DenseBatchInc(
 
   double importance = 0.0;
   RowAccessor row_accessor;
-  ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
+  ClientRow *client_row = apply_local_inc_
+      ? process_storage_.Find(row_id, &row_accessor) : 0;
   if (client_row != 0) {
     importance = client_row->GetRowDataPtr()->ApplyDenseBatchIncGetImportance(
         updates, index_st, num_updates);
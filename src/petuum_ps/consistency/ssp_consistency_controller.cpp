@@ -16,16 +16,16 @@ SSPConsistencyController::SSPConsistencyController(
     const AbstractRow* sample_row,
     boost::thread_specific_ptr<ThreadTable> &thread_cache,
     TableOpLogIndex &oplog_index,
-    int32_t row_oplog_type) :
+    int32_t row_oplog_type,
+    bool thread_local_oplog) :
   AbstractConsistencyController(table_id, process_storage,
     sample_row),
   staleness_(info.table_staleness),
   thread_cache_(thread_cache),
   oplog_index_(oplog_index),
-  oplog_(oplog) {
-  AddUpdates_ = std::bind(&AbstractRow::AddUpdates,
-                          sample_row_, std::placeholders::_1,
-                          std::placeholders::_2, std::placeholders::_3);
+  oplog_(oplog),
+  thread_local_oplog_(thread_local_oplog),
+  apply_local_inc_(info.server_update_rule.type == ServerAdd) {
   if (row_oplog_type == RowOpLogType::kDenseRowOpLog) {
     DenseBatchIncOpLog_ = &SSPConsistencyController::DenseBatchIncDenseOpLog;
   } else {
@@ -37,7 +37,7 @@ ClientRow *SSPConsistencyController::Get(int32_t row_id, RowAccessor* row_access
   STATS_APP_SAMPLE_SSP_GET_BEGIN(table_id_);
 
   // Look for row_id in process_storage_.
-  int32_t stalest_clock = std::max(0, ThreadContext::get_clock() - staleness_);
+  int32_t stalest_clock = ThreadContext::GetStalestClock(staleness_);
 
   ClientRow *client_row = process_storage_.Find(row_id, row_accessor);
 
@@ -74,8 +74,46 @@ ClientRow *SSPConsistencyController::Get(int32_t row_id, RowAccessor* row_access
   return client_row;
 }
 
+void SSPConsistencyController::GetBatch(const int32_t *row_ids,
+                                        int32_t num_rows) {
+  int32_t stalest_clock = ThreadContext::GetStalestClock(staleness_);
+  FetchRowBatch(row_ids, num_rows, stalest_clock, true);
+}
+
+void SSPConsistencyController::FetchRowBatch(const int32_t *row_ids,
+                                             int32_t num_rows,
+                                             int32_t stalest_clock,
+                                             bool check_clock) {
+  std::vector<int32_t> row_ids_to_fetch;
+  for (int32_t i = 0; i < num_rows; ++i) {
+    RowAccessor row_accessor;
+    ClientRow *client_row = process_storage_.Find(row_ids[i], &row_accessor);
+    if (client_row == 0
+        || (check_clock && client_row->GetClock() < stalest_clock))
+      row_ids_to_fetch.push_back(row_ids[i]);
+  }
+
+  if (row_ids_to_fetch.empty())
+    return;
+
+  // Each requested row gets exactly one reply, so do not request twice.
+  std::sort(row_ids_to_fetch.begin(), row_ids_to_fetch.end());
+  row_ids_to_fetch.erase(
+      std::unique(row_ids_to_fetch.begin(), row_ids_to_fetch.end()),
+      row_ids_to_fetch.end());
+
+  STATS_APP_ACCUM_SSP_GET_SERVER_FETCH_BEGIN(table_id_);
+  BgWorkers::RequestRowBatch(table_id_, row_ids_to_fetch.data(),
+                             row_ids_to_fetch.size(), stalest_clock);
+  STATS_APP_ACCUM_SSP_GET_SERVER_FETCH_END(table_id_);
+}
+
 void SSPConsistencyController::Inc(int32_t row_id, int32_t column_id,
     const void* delta) {
+  if (thread_local_oplog_) {
+    thread_cache_->BufferInc(row_id, column_id, delta);
+    return;
+  }
   thread_cache_->IndexUpdate(row_id);
 
   OpLogAccessor oplog_accessor;
@@ -84,6 +122,9 @@ void SSPConsistencyController::Inc(int32_t row_id, int32_t column_id,
   void *oplog_delta = oplog_accessor.get_row_oplog()->FindCreate(column_id);
   sample_row_->AddUpdates(column_id, oplog_delta, delta);
 
+  if (!apply_local_inc_)
+    return;
+
   RowAccessor row_accessor;
   ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
   if (client_row != 0) {
@@ -94,6 +135,11 @@ void SSPConsistencyController::Inc(int32_t row_id, int32_t column_id,
 void SSPConsistencyController::BatchInc(int32_t row_id,
   const int32_t* column_ids, const void* updates, int32_t num_updates) {
 
+  if (thread_local_oplog_) {
+    thread_cache_->BufferBatchInc(row_id, column_ids, updates, num_updates);
+    return;
+  }
+
   STATS_APP_SAMPLE_BATCH_INC_OPLOG_BEGIN();
   thread_cache_->IndexUpdate(row_id);
 
@@ -110,6 +156,9 @@ void SSPConsistencyController::BatchInc(int32_t row_id,
   }
   STATS_APP_SAMPLE_BATCH_INC_OPLOG_END();
 
+  if (!apply_local_inc_)
+    return;
+
   STATS_APP_SAMPLE_BATCH_INC_PROCESS_STORAGE_BEGIN();
   RowAccessor row_accessor;
   ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
@@ -123,6 +172,12 @@ void SSPConsistencyController::BatchInc(int32_t row_id,
 void SSPConsistencyController::DenseBatchInc(
     int32_t row_id, const void *updates,
     int32_t index_st, int32_t num_updates) {
+  if (thread_local_oplog_) {
+    thread_cache_->BufferDenseBatchInc(row_id, updates, index_st,
+                                       num_updates);
+    return;
+  }
+
   STATS_APP_SAMPLE_BATCH_INC_OPLOG_BEGIN();
   thread_cache_->IndexUpdate(row_id);
 
@@ -139,6 +194,9 @@ void SSPConsistencyController::DenseBatchInc(
   }
   STATS_APP_SAMPLE_BATCH_INC_OPLOG_END();
 
+  if (!apply_local_inc_)
+    return;
+
   STATS_APP_SAMPLE_BATCH_INC_PROCESS_STORAGE_BEGIN();
   RowAccessor row_accessor;
   ClientRow *client_row = process_storage_.Find(row_id, &row_accessor);
@@ -152,14 +210,9 @@ void SSPConsistencyController::DenseBatchInc(
 void SSPConsistencyController::DenseBatchIncDenseOpLog(
     OpLogAccessor *oplog_accessor, const uint8_t *updates,
     int32_t index_st, int32_t num_updates) {
-  size_t update_size = sample_row_->get_update_size();
-  uint8_t *oplog_delta = reinterpret_cast<uint8_t*>(
-      oplog_accessor->get_row_oplog()->FindCreate(index_st));
-  for (int i = 0; i < num_updates; ++i) {
-    int32_t col_id = i + index_st;
-    AddUpdates_(col_id, oplog_delta, updates + update_size*i);
-    oplog_delta += update_size;
-  }
+  // Dense row oplog stores updates contiguously.
+  void *oplog_delta = oplog_accessor->get_row_oplog()->FindCreate(index_st);
+  sample_row_->AddDenseUpdates(index_st, oplog_delta, updates, num_updates);
 }
 
 void SSPConsistencyController::DenseBatchIncNonDenseOpLog(
@@ -186,7 +239,7 @@ void SSPConsistencyController::ThreadGet(int32_t row_id,
   RowAccessor process_row_accessor;
   ClientRow *client_row = process_storage_.Find(row_id, &process_row_accessor);
 
-  int32_t stalest_clock = std::max(0, ThreadContext::get_clock() - staleness_);
+  int32_t stalest_clock = ThreadContext::GetStalestClock(staleness_);
   if (client_row != 0) {
     // Found it! Check staleness.
     int32_t clock = client_row->GetClock();
@@ -244,11 +297,13 @@ void SSPConsistencyController::ThreadDenseBatchInc(
 }
 
 void SSPConsistencyController::FlushThreadCache() {
+  thread_cache_->FlushOpLogBuffer(process_storage_, oplog_);
   thread_cache_->FlushCache(process_storage_, oplog_, sample_row_);
 }
 
 void SSPConsistencyController::Clock() {
   // order is important
+  thread_cache_->FlushOpLogBuffer(process_storage_, oplog_);
   thread_cache_->FlushCache(process_storage_, oplog_, sample_row_);
   thread_cache_->FlushOpLogIndex(oplog_index_);
 }
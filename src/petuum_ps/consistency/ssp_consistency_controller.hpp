@@ -24,7 +24,8 @@ public:
       const AbstractRow* sample_row,
       boost::thread_specific_ptr<ThreadTable> &thread_cache,
       TableOpLogIndex &oplog_index,
-      int32_t row_oplog_type);
+      int32_t row_oplog_type,
+      bool thread_local_oplog = false);
 
   // We don't need GetAsync because in SSP we reply on the clock count of each
   // client row to check whether the row is too stale and fetch it from server
@@ -37,6 +38,9 @@ public:
   // in storage.
   virtual ClientRow *Get(int32_t row_id, RowAccessor* row_accessor);
 
+  // Fetch all rows that are not found or too stale in one batch.
+  virtual void GetBatch(const int32_t *row_ids, int32_t num_rows);
+
   // Return immediately.
   virtual void Inc(int32_t row_id, int32_t column_id, const void* delta);
 
@@ -62,6 +66,11 @@ public:
   virtual void Clock();
 
 protected:
+  // Request the rows that are not in process storage, or, if check_clock is
+  // true, whose clock is less than stalest_clock.
+  void FetchRowBatch(const int32_t *row_ids, int32_t num_rows,
+                     int32_t stalest_clock, bool check_clock);
+
   void DenseBatchIncDenseOpLog(OpLogAccessor *oplog_accessor, const uint8_t *updates,
                                int32_t index_st, int32_t num_updates);
   void DenseBatchIncNonDenseOpLog(OpLogAccessor *oplog_accessor, const uint8_t *updates,
@@ -80,9 +89,17 @@ protected:
   // all local updates are reflected in the row values.
   AbstractOpLog& oplog_;
 
-  typedef std::function<void(int32_t, void*, const void*)> AddUpdatesFunc;
-  AddUpdatesFunc AddUpdates_;
   DenseBatchIncOpLogFunc DenseBatchIncOpLog_;
+
+  // Inc, BatchInc and DenseBatchInc go to the calling thread's oplog buffer
+  // in thread_cache_ and reach oplog_ and process_storage_ at Clock() or
+  // FlushThreadCache().
+  const bool thread_local_oplog_;
+
+  // False if the server applies an update rule other than ServerAdd. Local
+  // Incs then only go to the oplog: the gradients sent are not the change
+  // the server makes to the row, so Get() only shows server-applied values.
+  const bool apply_local_inc_;
 };
 
 }  // namespace petuum
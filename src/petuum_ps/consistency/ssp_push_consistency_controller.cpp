@@ -14,9 +14,11 @@ SSPPushConsistencyController::SSPPushConsistencyController(
   const AbstractRow* sample_row,
   boost::thread_specific_ptr<ThreadTable> &thread_cache,
   TableOpLogIndex &oplog_index,
-  int32_t row_oplog_type) :
+  int32_t row_oplog_type,
+  bool thread_local_oplog) :
   SSPConsistencyController(info, table_id, process_storage, oplog,
-                           sample_row, thread_cache, oplog_index, row_oplog_type) { }
+                           sample_row, thread_cache, oplog_index, row_oplog_type,
+                           thread_local_oplog) { }
 
 void SSPPushConsistencyController::GetAsyncForced(int32_t row_id) {
   // Look for row_id in process_storage_.
@@ -72,7 +74,7 @@ ClientRow *SSPPushConsistencyController::Get(int32_t row_id,
   STATS_APP_SAMPLE_SSP_GET_BEGIN(table_id_);
 
   // Look for row_id in process_storage_.
-  int32_t stalest_clock = std::max(0, ThreadContext::get_clock() - staleness_);
+  int32_t stalest_clock = ThreadContext::GetStalestClock(staleness_);
 
   if (ThreadContext::GetCachedSystemClock() < stalest_clock) {
     int32_t system_clock = BgWorkers::GetSystemClock();
@@ -114,12 +116,32 @@ ClientRow *SSPPushConsistencyController::Get(int32_t row_id,
   return client_row;
 }
 
+void SSPPushConsistencyController::GetBatch(const int32_t *row_ids,
+                                            int32_t num_rows) {
+  int32_t stalest_clock = ThreadContext::GetStalestClock(staleness_);
+
+  if (ThreadContext::GetCachedSystemClock() < stalest_clock) {
+    int32_t system_clock = BgWorkers::GetSystemClock();
+    if(system_clock < stalest_clock) {
+      STATS_APP_ACCUM_SSPPUSH_GET_COMM_BLOCK_BEGIN(table_id_);
+      BgWorkers::WaitSystemClock(stalest_clock);
+      STATS_APP_ACCUM_SSPPUSH_GET_COMM_BLOCK_END(table_id_);
+      system_clock = BgWorkers::GetSystemClock();
+    }
+    ThreadContext::SetCachedSystemClock(system_clock);
+  }
+
+  // Replies to pending async gets are not distinguishable from the batch's.
+  WaitPendingAsnycGet();
+  FetchRowBatch(row_ids, num_rows, stalest_clock, false);
+}
+
 void SSPPushConsistencyController::ThreadGet(int32_t row_id,
   ThreadRowAccessor* row_accessor) {
   STATS_APP_SAMPLE_THREAD_GET_BEGIN(table_id_);
 
   // Look for row_id in process_storage_.
-  int32_t stalest_clock = std::max(0, ThreadContext::get_clock() - staleness_);
+  int32_t stalest_clock = ThreadContext::GetStalestClock(staleness_);
 
   if (ThreadContext::GetCachedSystemClock() < stalest_clock) {
     int32_t system_clock = BgWorkers::GetSystemClock();
@@ -20,7 +20,8 @@ public:
       const AbstractRow* sample_row,
       boost::thread_specific_ptr<ThreadTable> &thread_cache,
       TableOpLogIndex &oplog_index,
-      int32_t row_oplog_type);
+      int32_t row_oplog_type,
+      bool thread_local_oplog = false);
 
   void GetAsyncForced(int32_t row_id);
   void GetAsync(int32_t row_id);
@@ -30,6 +31,9 @@ public:
   // in storage.
   ClientRow *Get(int32_t row_id, RowAccessor* row_accessor);
 
+  // Rows are fresh once the system clock is, so only fetch missing rows.
+  void GetBatch(const int32_t *row_ids, int32_t num_rows);
+
   void ThreadGet(int32_t row_id, ThreadRowAccessor* row_accessor);
 
 private:
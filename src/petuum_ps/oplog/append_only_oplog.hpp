@@ -20,11 +20,13 @@ namespace petuum {
 // OpLogs for a particular table.
 class AppendOnlyOpLog : public AbstractOpLog {
 public:
-  AppendOnlyOpLog(size_t append_only_buff_capacity,
+  AppendOnlyOpLog(int32_t table_id,
+                  size_t append_only_buff_capacity,
                   const AbstractRow *sample_row,
                   AppendOnlyOpLogType append_only_oplog_type,
                   size_t dense_row_oplog_capacity,
                   size_t append_only_per_thread_buff_pool_size):
+      partitioner_(GlobalContext::GetRowPartitioner(table_id)),
       oplog_partitions_(GlobalContext::get_num_comm_channels_per_client()) {
     for (int32_t i = 0; i < GlobalContext::get_num_comm_channels_per_client();
          ++i) {
@@ -56,7 +58,7 @@ public:
   }
 
   int32_t Inc(int32_t row_id, int32_t column_id, const void *delta) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     int32_t buff_pushed
         = oplog_partitions_[partition_num]->Inc(row_id, column_id, delta);
     return (buff_pushed == 1) ? partition_num : -1;
@@ -64,7 +66,7 @@ public:
 
   int32_t BatchInc(int32_t row_id, const int32_t *column_ids, const void *deltas,
     int32_t num_updates) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     int32_t buff_pushed = oplog_partitions_[partition_num]->BatchInc(
         row_id, column_ids, deltas, num_updates);
     return (buff_pushed == 1) ? partition_num : -1;
@@ -72,41 +74,41 @@ public:
 
   int32_t DenseBatchInc(int32_t row_id, const void *updates,
                      int32_t index_st, int32_t num_updates) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     int32_t buff_pushed = oplog_partitions_[partition_num]->DenseBatchInc(
         row_id, updates, index_st, num_updates);
     return (buff_pushed == 1) ? partition_num : -1;
   }
 
   bool FindOpLog(int32_t row_id, OpLogAccessor *oplog_accessor) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->FindOpLog(row_id, oplog_accessor);
   }
 
   bool FindInsertOpLog(int32_t row_id, OpLogAccessor *oplog_accessor) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->FindInsertOpLog(
         row_id, oplog_accessor);
   }
 
   AbstractRowOpLog *FindOpLog(int32_t row_id) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->FindOpLog(row_id);
   }
 
   AbstractRowOpLog *FindInsertOpLog(int32_t row_id) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->FindInsertOpLog(row_id);
   }
 
   bool FindAndLock(int32_t row_id, OpLogAccessor *oplog_accessor) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->FindAndLock(row_id,
                                                          oplog_accessor);
   }
 
   bool GetEraseOpLog(int32_t row_id, AbstractRowOpLog **row_oplog_ptr) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->GetEraseOpLog(row_id,
                                                            row_oplog_ptr);
   }
@@ -114,7 +116,7 @@ public:
   bool GetEraseOpLogIf(int32_t row_id,
                        GetOpLogTestFunc test,
                        void *test_args, AbstractRowOpLog **row_oplog_ptr) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->GetEraseOpLogIf(row_id, test,
                                                             test_args,
                                                             row_oplog_ptr);
@@ -122,7 +124,7 @@ public:
 
   bool GetInvalidateOpLogMeta(int32_t row_id,
                               RowOpLogMeta *row_oplog_meta) {
-    int32_t partition_num = GlobalContext::GetPartitionCommChannelIndex(row_id);
+    int32_t partition_num = partitioner_.GetCommChannelIndex(row_id);
     return oplog_partitions_[partition_num]->GetInvalidateOpLogMeta(
         row_id, row_oplog_meta);
   }
@@ -142,6 +144,7 @@ public:
   }
 
 private:
+  const RowPartitioner &partitioner_;
   std::vector<AppendOnlyOpLogPartition*> oplog_partitions_;
 };
 
@@ -0,0 +1,65 @@
+#include <petuum_ps/oplog/thread_oplog_buffer.hpp>
+#include <glog/logging.h>
+#include <string.h>
+
+namespace petuum {
+
+const uint64_t ThreadOpLogBuffer::kEmptyKey;
+const size_t ThreadOpLogBuffer::kInitCapacity;
+
+ThreadOpLogBuffer::ThreadOpLogBuffer(const AbstractRow *sample_row):
+    sample_row_(sample_row),
+    update_size_(sample_row->get_update_size()),
+    num_entries_(0),
+    shift_(64) {
+  Resize(kInitCapacity);
+}
+
+void ThreadOpLogBuffer::Clear() {
+  if (num_entries_ == 0)
+    return;
+  std::fill(keys_.begin(), keys_.end(), kEmptyKey);
+  num_entries_ = 0;
+}
+
+void *ThreadOpLogBuffer::Insert(uint64_t key, int32_t column_id) {
+  // Keep the load factor at most 1/2 so that probe sequences stay short.
+  if ((num_entries_ + 1) * 2 > keys_.size())
+    Resize(keys_.size() * 2);
+
+  size_t slot = Slot(key);
+  while (keys_[slot] != kEmptyKey)
+    slot = (slot + 1) & (keys_.size() - 1);
+
+  keys_[slot] = key;
+  ++num_entries_;
+  void *delta = deltas_.data() + slot * update_size_;
+  sample_row_->InitUpdate(column_id, delta);
+  return delta;
+}
+
+void ThreadOpLogBuffer::Resize(size_t capacity) {
+  CHECK_EQ(capacity & (capacity - 1), 0u) << "capacity must be a power of 2";
+  std::vector<uint64_t> old_keys(capacity, kEmptyKey);
+  std::vector<uint8_t> old_deltas(capacity * update_size_);
+  old_keys.swap(keys_);
+  old_deltas.swap(deltas_);
+
+  shift_ = 64;
+  for (size_t c = capacity; c > 1; c >>= 1)
+    --shift_;
+
+  for (size_t old_slot = 0; old_slot < old_keys.size(); ++old_slot) {
+    uint64_t key = old_keys[old_slot];
+    if (key == kEmptyKey)
+      continue;
+    size_t slot = Slot(key);
+    while (keys_[slot] != kEmptyKey)
+      slot = (slot + 1) & (keys_.size() - 1);
+    keys_[slot] = key;
+    memcpy(deltas_.data() + slot * update_size_,
+           old_deltas.data() + old_slot * update_size_, update_size_);
+  }
+}
+
+}  // namespace petuum
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <petuum_ps_common/include/abstract_row.hpp>
+#include <boost/noncopyable.hpp>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+namespace petuum {
+
+// Accumulates the updates of one app thread to one table, keyed by
+// (row_id, column_id), in an open-addressing hash table with the deltas
+// stored inline. Not thread-safe; it is only touched by its owner thread.
+class ThreadOpLogBuffer : boost::noncopyable {
+public:
+  explicit ThreadOpLogBuffer(const AbstractRow *sample_row);
+
+  void Inc(int32_t row_id, int32_t column_id, const void *delta) {
+    sample_row_->AddUpdates(column_id, FindCreate(row_id, column_id), delta);
+  }
+
+  size_t get_num_entries() const {
+    return num_entries_;
+  }
+
+  // Calls func(row_id, column_ids, deltas, num_updates) once per row, in
+  // row id order, where deltas holds num_updates updates back to back.
+  template<typename Func>
+  void ForEachRow(Func func);
+
+  // Removes all entries, keeping the memory.
+  void Clear();
+
+private:
+  static const uint64_t kEmptyKey = ~0ull;
+  static const size_t kInitCapacity = 1024;
+
+  static uint64_t MakeKey(int32_t row_id, int32_t column_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(row_id)) << 32)
+        | static_cast<uint32_t>(column_id);
+  }
+
+  size_t Slot(uint64_t key) const {
+    return (key * 0x9e3779b97f4a7c15ull) >> shift_;
+  }
+
+  void *FindCreate(int32_t row_id, int32_t column_id) {
+    uint64_t key = MakeKey(row_id, column_id);
+    size_t slot = Slot(key);
+    while (keys_[slot] != key) {
+      if (keys_[slot] == kEmptyKey)
+        return Insert(key, column_id);
+      slot = (slot + 1) & (keys_.size() - 1);
+    }
+    return deltas_.data() + slot * update_size_;
+  }
+
+  void *Insert(uint64_t key, int32_t column_id);
+  void Resize(size_t capacity);
+
+  const AbstractRow *sample_row_;
+  const size_t update_size_;
+
+  std::vector<uint64_t> keys_;
+  std::vector<uint8_t> deltas_;
+  size_t num_entries_;
+  // 64 - log2(capacity).
+  int32_t shift_;
+
+  // Scratch space of ForEachRow.
+  std::vector<size_t> sorted_slots_;
+  std::vector<int32_t> row_column_ids_;
+  std::vector<uint8_t> row_deltas_;
+};
+
+template<typename Func>
+void ThreadOpLogBuffer::ForEachRow(Func func) {
+  sorted_slots_.clear();
+  for (size_t slot = 0; slot < keys_.size(); ++slot) {
+    if (keys_[slot] != kEmptyKey)
+      sorted_slots_.push_back(slot);
+  }
+  std::sort(sorted_slots_.begin(), sorted_slots_.end(),
+            [this](size_t a, size_t b) { return keys_[a] < keys_[b]; });
+
+  size_t i = 0;
+  while (i < sorted_slots_.size()) {
+    int32_t row_id = keys_[sorted_slots_[i]] >> 32;
+    row_column_ids_.clear();
+    row_deltas_.clear();
+    for (; i < sorted_slots_.size()
+             && int32_t(keys_[sorted_slots_[i]] >> 32) == row_id; ++i) {
+      size_t slot = sorted_slots_[i];
+      row_column_ids_.push_back(static_cast<int32_t>(keys_[slot]));
+      const uint8_t *delta = deltas_.data() + slot * update_size_;
+      row_deltas_.insert(row_deltas_.end(), delta, delta + update_size_);
+    }
+    func(row_id, row_column_ids_.data(), row_deltas_.data(),
+         static_cast<int32_t>(row_column_ids_.size()));
+  }
+}
+
+}  // namespace petuum
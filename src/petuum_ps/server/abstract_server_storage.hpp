@@ -0,0 +1,40 @@
+// author: jinliang
+
+#pragma once
+
+#include <petuum_ps/server/server_row.hpp>
+#include <boost/noncopyable.hpp>
+#include <stdint.h>
+
+namespace petuum {
+
+// Row storage of a ServerTable. Rows are kept by value in flat arrays so that
+// applying oplogs and scanning the table for pushes do not chase a pointer
+// per row.
+// Rows are never erased. Growing the storage relocates rows, so a ServerRow
+// pointer is valid only until the next Insert().
+class AbstractServerStorage : boost::noncopyable {
+public:
+  AbstractServerStorage() { }
+
+  virtual ~AbstractServerStorage() { }
+
+  // Return 0 if row_id does not exist.
+  virtual ServerRow *Find(int32_t row_id) = 0;
+
+  // row_id must not exist. Take ownership of row_data.
+  virtual ServerRow *Insert(int32_t row_id, AbstractRow *row_data) = 0;
+
+  virtual size_t get_num_rows() const = 0;
+
+  // Rows are visited by slot index in [0, get_num_slots()). Return 0 for an
+  // empty slot; otherwise row_id is set. Slots are stable between Inserts,
+  // which allows resuming a scan from a saved slot index.
+  virtual size_t get_num_slots() const = 0;
+
+  virtual ServerRow *GetSlot(size_t slot, int32_t *row_id) = 0;
+
+  virtual const ServerRow *GetSlot(size_t slot, int32_t *row_id) const = 0;
+};
+
+}  // namespace petuum
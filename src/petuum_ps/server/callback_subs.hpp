@@ -3,6 +3,7 @@
 #include <bitset>
 
 #include <petuum_ps_common/util/record_buff.hpp>
+#include <petuum_ps_common/include/abstract_row.hpp>
 #include <petuum_ps/thread/context.hpp>
 #include <glog/logging.h>
 
@@ -35,18 +36,25 @@ public:
     return bit_changed;
   }
 
+  // The row is serialized once, directly into the buffer of the first
+  // subscriber, and copied from there to the other subscribers' buffers.
+  // row_size is an upper bound of the serialized size.
   bool AppendRowToBuffs(
       int32_t client_id_st,
       boost::unordered_map<int32_t, RecordBuff> *buffs,
-      const void *row_data, size_t row_size, int32_t row_id,
+      const AbstractRow *row_data, size_t row_size, int32_t row_id,
       int32_t *failed_client_id) {
     // Some simple tests show that iterating bitset isn't too bad.
     // For bitset size below 512, it takes 200~300 ns on an Intel i5 CPU.
+    const uint8_t *serialized_row = 0;
+    size_t serialized_size = 0;
     int32_t client_id;
     for (client_id = client_id_st;
          client_id < GlobalContext::get_num_clients(); ++client_id) {
       if (subscriptions_.test(client_id)) {
-        bool suc = (*buffs)[client_id].Append(row_id, row_data, row_size);
+        bool suc = AppendSerializedRow(&(*buffs)[client_id], row_data,
+                                       row_size, row_id, &serialized_row,
+                                       &serialized_size);
         if (!suc) {
           *failed_client_id = client_id;
           return false;
@@ -72,14 +80,18 @@ public:
 
   void AppendRowToBuffs(
       boost::unordered_map<int32_t, RecordBuff> *buffs,
-      const void *row_data, size_t row_size, int32_t row_id) {
+      const AbstractRow *row_data, size_t row_size, int32_t row_id) {
     // Some simple tests show that iterating bitset isn't too bad.
     // For bitset size below 512, it takes 200~300 ns on an Intel i5 CPU.
+    const uint8_t *serialized_row = 0;
+    size_t serialized_size = 0;
     int32_t client_id;
     for (client_id = 0;
          client_id < GlobalContext::get_num_clients(); ++client_id) {
       if (subscriptions_.test(client_id)) {
-        bool suc = (*buffs)[client_id].Append(row_id, row_data, row_size);
+        bool suc = AppendSerializedRow(&(*buffs)[client_id], row_data,
+                                       row_size, row_id, &serialized_row,
+                                       &serialized_size);
         if (!suc)
           (*buffs)[client_id].PrintInfo();
       }
@@ -87,6 +99,24 @@ public:
   }
 
 private:
+  // Serialize the row into buff if it has not been serialized yet, otherwise
+  // copy the serialized row.
+  static bool AppendSerializedRow(
+      RecordBuff *buff, const AbstractRow *row_data, size_t row_size,
+      int32_t row_id, const uint8_t **serialized_row,
+      size_t *serialized_size) {
+    if (*serialized_row != 0)
+      return buff->Append(row_id, *serialized_row, *serialized_size);
+
+    uint8_t *mem = buff->BeginRecord(row_id, row_size);
+    if (mem == 0)
+      return false;
+    *serialized_size = row_data->Serialize(mem);
+    buff->CommitRecord(*serialized_size);
+    *serialized_row = mem;
+    return true;
+  }
+
   std::bitset<PETUUM_MAX_NUM_CLIENTS> subscriptions_;
 };
 
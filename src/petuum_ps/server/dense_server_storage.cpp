@@ -0,0 +1,44 @@
+// author: jinliang
+
+#include <petuum_ps/server/dense_server_storage.hpp>
+#include <glog/logging.h>
+#include <algorithm>
+
+namespace petuum {
+
+const int32_t DenseServerStorage::kEmptyRowId;
+
+DenseServerStorage::DenseServerStorage(size_t capacity,
+                                       const RowPartitioner &partitioner):
+    partitioner_(partitioner),
+    row_ids_(capacity, kEmptyRowId),
+    rows_(capacity),
+    num_rows_(0) {
+  CHECK(partitioner.HasLocalIndex())
+      << "ServerDenseRange storage requires ModuloPartition or RangePartition";
+}
+
+ServerRow *DenseServerStorage::Find(int32_t row_id) {
+  size_t idx = partitioner_.GetLocalIndex(row_id);
+  if (idx >= row_ids_.size() || row_ids_[idx] != row_id)
+    return 0;
+  return &(rows_[idx]);
+}
+
+ServerRow *DenseServerStorage::Insert(int32_t row_id, AbstractRow *row_data) {
+  CHECK_GE(row_id, 0);
+  size_t idx = partitioner_.GetLocalIndex(row_id);
+  if (idx >= row_ids_.size()) {
+    size_t new_size = std::max(row_ids_.size() * 2, idx + 1);
+    row_ids_.resize(new_size, kEmptyRowId);
+    rows_.resize(new_size);
+  }
+
+  CHECK(row_ids_[idx] == kEmptyRowId) << "row " << row_id << " exists";
+  row_ids_[idx] = row_id;
+  rows_[idx] = ServerRow(row_data);
+  ++num_rows_;
+  return &(rows_[idx]);
+}
+
+}  // namespace petuum
@@ -0,0 +1,58 @@
+// author: jinliang
+
+#pragma once
+
+#include <petuum_ps/server/abstract_server_storage.hpp>
+#include <petuum_ps/thread/row_partitioner.hpp>
+#include <vector>
+
+namespace petuum {
+
+// DenseServerStorage assumes the table's row ids are contiguous so the rows
+// held by this server are indexed directly by their partition-local index
+// (RowPartitioner::GetLocalIndex()). The array grows to cover the largest
+// row inserted so far.
+class DenseServerStorage : public AbstractServerStorage {
+public:
+  // capacity is a hint of the number of rows to be stored. partitioner
+  // must have local indices.
+  DenseServerStorage(size_t capacity, const RowPartitioner &partitioner);
+  ~DenseServerStorage() { }
+
+  ServerRow *Find(int32_t row_id);
+
+  ServerRow *Insert(int32_t row_id, AbstractRow *row_data);
+
+  size_t get_num_rows() const {
+    return num_rows_;
+  }
+
+  size_t get_num_slots() const {
+    return row_ids_.size();
+  }
+
+  ServerRow *GetSlot(size_t slot, int32_t *row_id) {
+    if (row_ids_[slot] == kEmptyRowId)
+      return 0;
+    *row_id = row_ids_[slot];
+    return &(rows_[slot]);
+  }
+
+  const ServerRow *GetSlot(size_t slot, int32_t *row_id) const {
+    if (row_ids_[slot] == kEmptyRowId)
+      return 0;
+    *row_id = row_ids_[slot];
+    return &(rows_[slot]);
+  }
+
+private:
+  static const int32_t kEmptyRowId = -1;
+
+  const RowPartitioner &partitioner_;
+
+  std::vector<int32_t> row_ids_;
+  std::vector<ServerRow> rows_;
+  size_t num_rows_;
+};
+
+}  // namespace petuum
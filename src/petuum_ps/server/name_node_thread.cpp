@@ -7,6 +7,7 @@
 #include <pthread.h>
 #include <utility>
 #include <iostream>
+#include <cstring>
 
 namespace petuum {
 
@@ -137,6 +138,16 @@ void NameNodeThread::HandleCreateTable (int32_t sender_id,
     table_info.oplog_dense_serialized = create_table_msg.get_oplog_dense_serialized();
     table_info.row_oplog_type = create_table_msg.get_row_oplog_type();
     table_info.dense_row_oplog_capacity = create_table_msg.get_dense_row_oplog_capacity();
+    table_info.server_storage_type = create_table_msg.get_server_storage_type();
+    table_info.server_storage_capacity = create_table_msg.get_server_storage_capacity();
+    table_info.oplog_index_encoding = create_table_msg.get_oplog_index_encoding();
+    table_info.oplog_value_encoding = create_table_msg.get_oplog_value_encoding();
+    table_info.oplog_compressed = create_table_msg.get_oplog_compressed();
+    table_info.row_partition_type = create_table_msg.get_row_partition_type();
+    table_info.range_partition_num_rows
+        = create_table_msg.get_range_partition_num_rows();
+    table_info.server_update_rule
+        = create_table_msg.get_server_update_rule();
     server_obj_.CreateTable(table_id, table_info);
 
     create_table_map_.insert(std::make_pair(table_id, CreateTableInfo())); // access it to call default constructor
@@ -181,6 +192,50 @@ void NameNodeThread::HandleCreateTableReply(
   }
 }
 
+void NameNodeThread::HandleBarrier(int32_t sender_id) {
+  barrier_bgs_.push_back(sender_id);
+  if ((int32_t) barrier_bgs_.size() < GlobalContext::get_num_clients())
+    return;
+
+  BarrierReplyMsg barrier_reply_msg;
+  for (const auto &bg_id : barrier_bgs_) {
+    size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(
+        bg_id, barrier_reply_msg.get_mem(), barrier_reply_msg.get_size());
+    CHECK_EQ(sent_size, barrier_reply_msg.get_size());
+  }
+  barrier_bgs_.clear();
+}
+
+void NameNodeThread::HandleAllReduce(int32_t sender_id,
+                                     AllReduceMsg &all_reduce_msg) {
+  size_t size = all_reduce_msg.get_avai_size();
+  if (all_reduce_bgs_.empty()) {
+    all_reduce_buff_.resize(size);
+    memcpy(all_reduce_buff_.data(), all_reduce_msg.get_data(), size);
+  } else {
+    CHECK_EQ(all_reduce_buff_.size(), size) << "All-reduce size mismatch";
+    AllReduceDataType data_type = all_reduce_msg.get_data_type();
+    AllReduceInto(all_reduce_buff_.data(), all_reduce_msg.get_data(),
+                  size / GetAllReduceDataTypeSize(data_type), data_type,
+                  all_reduce_msg.get_op());
+  }
+  all_reduce_bgs_.push_back(sender_id);
+  if ((int32_t) all_reduce_bgs_.size() < GlobalContext::get_num_clients())
+    return;
+
+  AllReduceReplyMsg all_reduce_reply_msg(size);
+  all_reduce_reply_msg.get_data_type() = all_reduce_msg.get_data_type();
+  all_reduce_reply_msg.get_op() = all_reduce_msg.get_op();
+  memcpy(all_reduce_reply_msg.get_data(), all_reduce_buff_.data(), size);
+  for (const auto &bg_id : all_reduce_bgs_) {
+    size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(
+        bg_id, all_reduce_reply_msg.get_mem(),
+        all_reduce_reply_msg.get_size());
+    CHECK_EQ(sent_size, all_reduce_reply_msg.get_size());
+  }
+  all_reduce_bgs_.clear();
+}
+
 void NameNodeThread::SetUpCommBus() {
   CommBus::Config comm_config;
   comm_config.entity_id_ = my_id_;
@@ -234,6 +289,17 @@ void *NameNodeThread::operator() () {
 	HandleCreateTableReply(create_table_reply_msg);
 	break;
       }
+    case kBarrier:
+      {
+        HandleBarrier(sender_id);
+        break;
+      }
+    case kAllReduce:
+      {
+        AllReduceMsg all_reduce_msg(zmq_msg.data());
+        HandleAllReduce(sender_id, all_reduce_msg);
+        break;
+      }
     default:
       LOG(FATAL) << "Unrecognized message type " << msg_type
 		 << " sender = " << sender_id;
@@ -68,6 +68,8 @@ private:
   bool HandleShutDownMsg(); // returns true if the server may shut down
   void HandleCreateTable(int32_t sender_id, CreateTableMsg &create_table_msg);
   void HandleCreateTableReply(CreateTableReplyMsg &create_table_reply_msg);
+  void HandleBarrier(int32_t sender_id);
+  void HandleAllReduce(int32_t sender_id, AllReduceMsg &all_reduce_msg);
 
   int32_t my_id_;
   pthread_barrier_t *init_barrier_;
@@ -78,5 +80,11 @@ private:
   std::map<int32_t, CreateTableInfo> create_table_map_;
   Server server_obj_;
   int32_t num_shutdown_bgs_;
+
+  // Head bgs waiting at the barrier or in the all-reduce in progress. A
+  // client takes part in one collective at a time.
+  std::vector<int32_t> barrier_bgs_;
+  std::vector<int32_t> all_reduce_bgs_;
+  std::vector<uint8_t> all_reduce_buff_;
 };
 }
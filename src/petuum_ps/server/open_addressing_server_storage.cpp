@@ -0,0 +1,74 @@
+// author: jinliang
+
+#include <petuum_ps/server/open_addressing_server_storage.hpp>
+#include <glog/logging.h>
+#include <utility>
+
+namespace petuum {
+
+const int32_t OpenAddressingServerStorage::kEmptyRowId;
+
+OpenAddressingServerStorage::OpenAddressingServerStorage(size_t capacity):
+    num_rows_(0),
+    num_slot_bits_(0) {
+  size_t num_slots = kMinNumSlots;
+  while (num_slots * kMaxLoadNumerator < capacity * kMaxLoadDenominator)
+    num_slots *= 2;
+  Resize(num_slots);
+}
+
+size_t OpenAddressingServerStorage::FindSlot(int32_t row_id) const {
+  // Fibonacci hashing. Row ids held by one server are usually strided by the
+  // number of servers, so the high bits of the product are used.
+  size_t mask = row_ids_.size() - 1;
+  size_t slot = (static_cast<uint64_t>(static_cast<uint32_t>(row_id))
+                 * 11400714819323198485ull) >> (64 - num_slot_bits_);
+  while (row_ids_[slot] != row_id && row_ids_[slot] != kEmptyRowId)
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+ServerRow *OpenAddressingServerStorage::Find(int32_t row_id) {
+  size_t slot = FindSlot(row_id);
+  if (row_ids_[slot] == kEmptyRowId)
+    return 0;
+  return &(rows_[slot]);
+}
+
+ServerRow *OpenAddressingServerStorage::Insert(int32_t row_id,
+                                               AbstractRow *row_data) {
+  CHECK_GE(row_id, 0);
+  if ((num_rows_ + 1) * kMaxLoadDenominator
+      > row_ids_.size() * kMaxLoadNumerator)
+    Resize(row_ids_.size() * 2);
+
+  size_t slot = FindSlot(row_id);
+  CHECK(row_ids_[slot] == kEmptyRowId) << "row " << row_id << " exists";
+  row_ids_[slot] = row_id;
+  rows_[slot] = ServerRow(row_data);
+  ++num_rows_;
+  return &(rows_[slot]);
+}
+
+void OpenAddressingServerStorage::Resize(size_t num_slots) {
+  std::vector<int32_t> old_row_ids;
+  std::vector<ServerRow> old_rows;
+  old_row_ids.swap(row_ids_);
+  old_rows.swap(rows_);
+  row_ids_.assign(num_slots, kEmptyRowId);
+  rows_ = std::vector<ServerRow>(num_slots);
+
+  num_slot_bits_ = 0;
+  while ((size_t(1) << num_slot_bits_) < num_slots)
+    ++num_slot_bits_;
+
+  for (size_t i = 0; i < old_row_ids.size(); ++i) {
+    if (old_row_ids[i] == kEmptyRowId)
+      continue;
+    size_t slot = FindSlot(old_row_ids[i]);
+    row_ids_[slot] = old_row_ids[i];
+    rows_[slot] = std::move(old_rows[i]);
+  }
+}
+
+}  // namespace petuum
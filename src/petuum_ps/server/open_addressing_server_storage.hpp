@@ -0,0 +1,65 @@
+// author: jinliang
+
+#pragma once
+
+#include <petuum_ps/server/abstract_server_storage.hpp>
+#include <vector>
+
+namespace petuum {
+
+// Linear probing hash table. Row ids and rows are kept in two parallel
+// arrays: probing only touches the densely packed row ids and the row itself
+// is accessed once its slot is found.
+class OpenAddressingServerStorage : public AbstractServerStorage {
+public:
+  // capacity is a hint of the number of rows to be stored.
+  explicit OpenAddressingServerStorage(size_t capacity);
+  ~OpenAddressingServerStorage() { }
+
+  ServerRow *Find(int32_t row_id);
+
+  ServerRow *Insert(int32_t row_id, AbstractRow *row_data);
+
+  size_t get_num_rows() const {
+    return num_rows_;
+  }
+
+  size_t get_num_slots() const {
+    return row_ids_.size();
+  }
+
+  ServerRow *GetSlot(size_t slot, int32_t *row_id) {
+    if (row_ids_[slot] == kEmptyRowId)
+      return 0;
+    *row_id = row_ids_[slot];
+    return &(rows_[slot]);
+  }
+
+  const ServerRow *GetSlot(size_t slot, int32_t *row_id) const {
+    if (row_ids_[slot] == kEmptyRowId)
+      return 0;
+    *row_id = row_ids_[slot];
+    return &(rows_[slot]);
+  }
+
+private:
+  // Return the slot holding row_id, or the empty slot where row_id should be
+  // inserted.
+  size_t FindSlot(int32_t row_id) const;
+  void Resize(size_t num_slots);
+
+  // Row ids are non-negative.
+  static const int32_t kEmptyRowId = -1;
+  static const size_t kMinNumSlots = 1024;
+  // Grow when more than 7/10 of the slots are occupied.
+  static const size_t kMaxLoadNumerator = 7;
+  static const size_t kMaxLoadDenominator = 10;
+
+  std::vector<int32_t> row_ids_;
+  std::vector<ServerRow> rows_;
+  size_t num_rows_;
+  // log2(row_ids_.size())
+  int32_t num_slot_bits_;
+};
+
+}  // namespace petuum
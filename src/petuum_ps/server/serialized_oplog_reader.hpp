@@ -2,6 +2,8 @@
 
 #include <boost/noncopyable.hpp>
 #include <petuum_ps/server/server_table.hpp>
+#include <petuum_ps_common/oplog/oplog_codec.hpp>
+#include <vector>
 
 namespace petuum {
 
@@ -13,7 +15,8 @@ namespace petuum {
 // 1. int32_t : num_tables
 // 2. int32_t : table id
 // 3. size_t : update_size for this table
-// 4. serialized table, details in oplog_partition
+// 4. serialized table, details in oplog_partition, or its encoding if the
+//    table does not use raw oplogs, see OpLogCodec.
 
 class SerializedOpLogReader : boost::noncopyable {
 public:
@@ -22,14 +25,15 @@ public:
       const void *oplog_ptr,
       const boost::unordered_map<int32_t, ServerTable> &server_tables):
       serialized_oplog_ptr_(reinterpret_cast<const uint8_t*>(oplog_ptr)),
-      server_tables_(server_tables) { }
+      server_tables_(server_tables),
+      resume_ptr_(0) { }
   ~SerializedOpLogReader() {}
 
   bool Restart() {
-    offset_ = 0;
-    num_tables_left_ =
-      *(reinterpret_cast<const int32_t*>(serialized_oplog_ptr_ + offset_));
-    offset_ += sizeof(int32_t);
+    cursor_ = serialized_oplog_ptr_;
+    resume_ptr_ = 0;
+    num_tables_left_ = *(reinterpret_cast<const int32_t*>(cursor_));
+    cursor_ += sizeof(int32_t);
     if(num_tables_left_ == 0)
       return false;
     StartNewTable();
@@ -46,15 +50,13 @@ public:
       // can read from current row
       if (num_rows_left_in_current_table_ > 0) {
         *table_id = current_table_id_;
-        *row_id = *(reinterpret_cast<const int32_t*>(
-            serialized_oplog_ptr_ + offset_));
-        offset_ += sizeof(int32_t);
+        *row_id = *(reinterpret_cast<const int32_t*>(cursor_));
+        cursor_ += sizeof(int32_t);
         size_t serialized_size;
         const void *update
-            = GetNextUpdate_(curr_sample_row_oplog_,
-                             serialized_oplog_ptr_ + offset_,
+            = GetNextUpdate_(curr_sample_row_oplog_, cursor_,
                              column_ids, num_updates, &serialized_size);
-        offset_ += serialized_size;
+        cursor_ += serialized_size;
         --num_rows_left_in_current_table_;
         return update;
       } else {
@@ -93,19 +95,32 @@ private:
   }
 
   void StartNewTable() {
-    current_table_id_ = *(reinterpret_cast<const int32_t*>(serialized_oplog_ptr_
-      + offset_));
-    offset_ += sizeof(int32_t);
+    // Go back to the message if the last table was decoded.
+    if (resume_ptr_ != 0) {
+      cursor_ = resume_ptr_;
+      resume_ptr_ = 0;
+    }
 
-    update_size_ = *(reinterpret_cast<const size_t*>(serialized_oplog_ptr_
-      + offset_));
-    offset_ += sizeof(size_t);
+    current_table_id_ = *(reinterpret_cast<const int32_t*>(cursor_));
+    cursor_ += sizeof(int32_t);
 
-    num_rows_left_in_current_table_ =
-      *(reinterpret_cast<const int32_t*>(serialized_oplog_ptr_ + offset_));
-    offset_ += sizeof(int32_t);
+    update_size_ = *(reinterpret_cast<const size_t*>(cursor_));
+    cursor_ += sizeof(size_t);
 
     auto table_iter = server_tables_.find(current_table_id_);
+    CHECK(table_iter != server_tables_.end())
+        << "Not found table_id = " << current_table_id_;
+    const TableInfo &table_info = table_iter->second.get_table_info();
+    if (!OpLogCodec::IsRaw(table_info)) {
+      OpLogCodec codec(table_info, update_size_);
+      resume_ptr_ = cursor_ + codec.Decode(cursor_, &decoded_oplogs_);
+      cursor_ = decoded_oplogs_.data();
+    }
+
+    num_rows_left_in_current_table_ =
+      *(reinterpret_cast<const int32_t*>(cursor_));
+    cursor_ += sizeof(int32_t);
+
     curr_sample_row_oplog_ = table_iter->second.get_sample_row_oplog();
     if (table_iter->second.oplog_dense_serialized())
       GetNextUpdate_ = GetNextUpdateDense;
@@ -115,7 +130,7 @@ private:
 
   const uint8_t *serialized_oplog_ptr_;
   size_t update_size_;
-  int32_t offset_; // bytes to be read next
+  const uint8_t *cursor_; // next byte to read
   int32_t num_tables_left_; // number of tables that I have not finished
                             //reading (might have started)
   int32_t current_table_id_;
@@ -124,6 +139,11 @@ private:
   const boost::unordered_map<int32_t, ServerTable> &server_tables_;
   const AbstractRowOpLog *curr_sample_row_oplog_;
   GetNextUpdateFunc GetNextUpdate_;
+
+  // Holds the raw oplogs of the current table if it was encoded; cursor_
+  // continues from resume_ptr_ after the table.
+  std::vector<uint8_t> decoded_oplogs_;
+  const uint8_t *resume_ptr_;
 };
 
 }  // namespace petuum
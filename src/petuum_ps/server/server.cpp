@@ -3,6 +3,8 @@
 #include <petuum_ps/server/server.hpp>
 #include <petuum_ps/server/serialized_oplog_reader.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
+#include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 
 #include <utility>
 #include <fstream>
@@ -25,10 +27,14 @@ void Server::Init(int32_t server_id,
    server_id_ = server_id;
 
    accum_oplog_count_ = 0;
+
+   if (GlobalContext::get_snapshot_clock() > 0)
+     snapshot_writer_.Start();
  }
 
  void Server::CreateTable(int32_t table_id, TableInfo &table_info){
-   auto ret = tables_.emplace(table_id, ServerTable(table_info));
+   GlobalContext::RegisterRowPartitioner(table_id, table_info);
+   auto ret = tables_.emplace(table_id, ServerTable(table_id, table_info));
    CHECK(ret.second);
 
    if (GlobalContext::get_resume_clock() > 0) {
@@ -62,11 +68,14 @@ void Server::Init(int32_t server_id,
      if (GlobalContext::get_snapshot_clock() <= 0
          || new_clock % GlobalContext::get_snapshot_clock() != 0)
        return true;
+     // Keep at most one snapshot in memory.
+     snapshot_writer_.WaitUntilIdle();
      for (auto table_iter = tables_.begin(); table_iter != tables_.end();
           table_iter++) {
        table_iter->second.TakeSnapShot(GlobalContext::get_snapshot_dir(),
                                        server_id_,
-                                       table_iter->first, new_clock);
+                                       table_iter->first, new_clock,
+                                       &snapshot_writer_);
      }
      return true;
    }
@@ -92,6 +101,7 @@ void Server::Init(int32_t server_id,
        std::vector<ServerRowRequest>()));
    }
    clock_bg_row_requests_[clock][bg_id].push_back(server_row_request);
+   Metrics::AddGauge(kMetricServerBufferedRowRequests, 1);
  }
 
  void Server::GetFulfilledRowRequests(std::vector<ServerRowRequest> *requests) {
@@ -111,6 +121,8 @@ void Server::Init(int32_t server_id,
    }
 
    clock_bg_row_requests_.erase(clock);
+   Metrics::AddGauge(kMetricServerBufferedRowRequests,
+                     -int64_t(requests->size()));
  }
 
  void Server::ApplyOpLogUpdateVersion(
@@ -144,8 +156,10 @@ void Server::Init(int32_t server_id,
      server_table = &(table_iter->second);
    }
 
+   size_t num_row_oplogs = 0;
    while (updates != 0) {
      ++accum_oplog_count_;
+     ++num_row_oplogs;
      bool found
        = server_table->ApplyRowOpLog(row_id, column_ids, updates, num_updates);
 
@@ -166,6 +180,8 @@ void Server::Init(int32_t server_id,
        server_table = &(table_iter->second);
      }
    }
+   STATS_SERVER_ADD_NUM_ROW_OPLOG_APPLIED(num_row_oplogs);
+   Metrics::AddCounter(kMetricServerRowOpLogsApplied, num_row_oplogs);
  }
 
  int32_t Server::GetMinClock() {
@@ -211,10 +227,8 @@ void Server::Init(int32_t server_id,
       if (table_id_ptr == 0) {
         int32_t bg_id = GlobalContext::get_bg_thread_id(client_id,
                                                         comm_channel_idx);
-        PushMsgSend(bg_id, msg_map[client_id], false && clock_changed,
-                    GetBgVersion(bg_id), GetMinClock());
-        memset((msg_map[client_id])->get_data(), 0, push_row_msg_data_size_);
-        record_buff.ResetOffset();
+        SendRenewPushRowMsg(PushMsgSend, bg_id, &msg_map[client_id],
+                            &record_buff);
         table_id_ptr = record_buff.GetMemPtrInt32();
       }
       *table_id_ptr = table_id;
@@ -233,11 +247,8 @@ void Server::Init(int32_t server_id,
 
       int32_t bg_id = GlobalContext::get_bg_thread_id(failed_client_id,
                                                       comm_channel_idx);
-      PushMsgSend(bg_id, msg_map[failed_client_id], false && clock_changed,
-                  GetBgVersion(bg_id), GetMinClock());
-      memset((msg_map[failed_client_id])->get_data(), 0,
-             push_row_msg_data_size_);
-      record_buff.ResetOffset();
+      SendRenewPushRowMsg(PushMsgSend, bg_id, &msg_map[failed_client_id],
+                          &record_buff);
       int32_t *table_id_ptr = record_buff.GetMemPtrInt32();
       *table_id_ptr = table_id;
       pack_suc = server_table.AppendTableToBuffs(failed_client_id, &buffs,
@@ -255,10 +266,8 @@ void Server::Init(int32_t server_id,
           int32_t bg_id = GlobalContext::get_bg_thread_id(client_id,
                                                           comm_channel_idx);
 
-          PushMsgSend(bg_id, msg_map[client_id], false && clock_changed,
-                      GetBgVersion(bg_id), GetMinClock());
-          memset((msg_map[client_id])->get_data(), 0, push_row_msg_data_size_);
-          record_buff.ResetOffset();
+          SendRenewPushRowMsg(PushMsgSend, bg_id, &msg_map[client_id],
+                              &record_buff);
         } else {
           *table_sep_ptr = GlobalContext::get_serialized_table_separator();
         }
@@ -291,6 +300,19 @@ void Server::Init(int32_t server_id,
   return accum_send_bytes;
 }
 
+void Server::SendRenewPushRowMsg(PushMsgSendFunc PushMsgSend, int32_t bg_id,
+                                 ServerPushRowMsg **msg,
+                                 RecordBuff *record_buff) {
+  (*msg)->get_avai_size() = record_buff->GetMemUsedSize();
+  PushMsgSend(bg_id, *msg, false, GetBgVersion(bg_id), GetMinClock());
+
+  // The message memory now belongs to the comm bus; a new message comes
+  // from MsgBuffPool and is typically the buffer of an earlier message.
+  delete *msg;
+  *msg = new ServerPushRowMsg(push_row_msg_data_size_);
+  record_buff->ResetMem((*msg)->get_data(), push_row_msg_data_size_);
+}
+
 size_t Server::CreateSendServerPushRowMsgsPartial(
     PushMsgSendFunc PushMsgSend) {
   boost::unordered_map<int32_t, RecordBuff> buffs;
@@ -398,12 +420,12 @@ size_t Server::CreateSendServerPushRowMsgsPartial(
 
     int32_t bg_id = GlobalContext::get_bg_thread_id(client_id,
                                                     comm_channel_idx);
-    PushMsgSend(bg_id, msg, false, GetBgVersion(bg_id), GetMinClock());
-
     VLOG(0) << "Send server push row size = " << msg->get_avai_size()
             << " to bg id = " << bg_id
             << " server id = " << ThreadContext::get_id();
 
+    PushMsgSend(bg_id, msg, false, GetBgVersion(bg_id), GetMinClock());
+
     delete msg;
   }
 
@@ -11,6 +11,7 @@
 #include <petuum_ps_common/include/constants.hpp>
 #include <petuum_ps_common/util/vector_clock.hpp>
 #include <petuum_ps/server/server_table.hpp>
+#include <petuum_ps/server/server_snapshot.hpp>
 #include <petuum_ps/thread/ps_msgs.hpp>
 
 namespace petuum {
@@ -59,6 +60,11 @@ public:
   bool AccumedOpLogSinceLastPush();
 
 private:
+  // Send a push row message that is not the last one of its push and
+  // replace it with a new message, as the memory is handed to the comm bus.
+  void SendRenewPushRowMsg(PushMsgSendFunc PushMsgSend, int32_t bg_id,
+                           ServerPushRowMsg **msg, RecordBuff *record_buff);
+
   VectorClock bg_clock_;
 
   boost::unordered_map<int32_t, ServerTable> tables_;
@@ -76,6 +82,10 @@ private:
   int32_t server_id_;
 
   size_t accum_oplog_count_;
+
+  // Writes snapshots in the background; started only if snapshots are
+  // enabled.
+  SnapShotWriter snapshot_writer_;
 };
 
 }  // namespace petuum
@@ -2,7 +2,9 @@
 
 #include <petuum_ps_common/include/abstract_row.hpp>
 #include <petuum_ps/server/callback_subs.hpp>
+#include <petuum_ps/server/server_update_rule.hpp>
 #include <boost/noncopyable.hpp>
+#include <vector>
 
 #pragma once
 
@@ -13,54 +15,100 @@ namespace petuum {
 class ServerRow : boost::noncopyable {
 public:
   ServerRow():
-    dirty_(false) { }
+      row_data_(0),
+      num_clients_subscribed_(0),
+      dirty_(false),
+      importance_(0),
+      update_rule_step_(0) { }
   ServerRow(AbstractRow *row_data):
       row_data_(row_data),
       num_clients_subscribed_(0),
-      dirty_(false) { }
+      dirty_(false),
+      importance_(0),
+      update_rule_step_(0) { }
 
   ~ServerRow() {
     if(row_data_ != 0)
       delete row_data_;
   }
 
+  // Server storage relocates rows when it grows, so the subscriptions,
+  // importance and update rule state have to travel with the row data.
   ServerRow(ServerRow && other):
+      callback_subs_(other.callback_subs_),
       row_data_(other.row_data_),
       num_clients_subscribed_(other.num_clients_subscribed_),
-      dirty_(other.dirty_) {
+      dirty_(other.dirty_),
+      importance_(other.importance_),
+      update_rule_state_(std::move(other.update_rule_state_)),
+      update_rule_step_(other.update_rule_step_) {
     other.row_data_ = 0;
   }
 
+  ServerRow & operator = (ServerRow && other) {
+    if (this == &other)
+      return *this;
+    if (row_data_ != 0)
+      delete row_data_;
+    callback_subs_ = other.callback_subs_;
+    row_data_ = other.row_data_;
+    num_clients_subscribed_ = other.num_clients_subscribed_;
+    dirty_ = other.dirty_;
+    importance_ = other.importance_;
+    update_rule_state_ = std::move(other.update_rule_state_);
+    update_rule_step_ = other.update_rule_step_;
+    other.row_data_ = 0;
+    return *this;
+  }
+
   ServerRow & operator = (ServerRow & other) = delete;
 
-  void ApplyBatchInc(
+  // The ApplyBatchInc family returns true if the row was clean before the
+  // update, so that the caller can track dirty rows incrementally.
+  bool ApplyBatchInc(
       const int32_t *column_ids,
       const void *update_batch, int32_t num_updates) {
     row_data_->ApplyBatchIncUnsafe(column_ids, update_batch, num_updates);
-    dirty_ = true;
+    return MarkDirty();
   }
 
-  void ApplyBatchIncAccumImportance(
+  bool ApplyBatchIncAccumImportance(
       const int32_t *column_ids,
       const void *update_batch, int32_t num_updates) {
     double importance = row_data_->ApplyBatchIncUnsafeGetImportance(
         column_ids, update_batch, num_updates);
     AccumImportance(importance);
-    dirty_ = true;
+    return MarkDirty();
   }
 
-  void ApplyDenseBatchInc(const void *update_batch, int32_t num_updates) {
+  bool ApplyDenseBatchInc(const void *update_batch, int32_t num_updates) {
     row_data_->ApplyDenseBatchIncUnsafe(update_batch, 0, num_updates);
-    dirty_ = true;
+    return MarkDirty();
   }
 
-  void ApplyDenseBatchIncAccumImportance(const void *update_batch,
+  bool ApplyDenseBatchIncAccumImportance(const void *update_batch,
                                          int32_t num_updates) {
     double importance
         = row_data_->ApplyDenseBatchIncUnsafeGetImportance(
             update_batch, 0, num_updates);
     AccumImportance(importance);
-    dirty_ = true;
+    return MarkDirty();
+  }
+
+  // Treats the updates as gradients for update_rule. column_ids is 0 for
+  // dense updates.
+  bool ApplyUpdateRule(const ServerUpdateRule &update_rule,
+                       const int32_t *column_ids,
+                       const void *update_batch, int32_t num_updates) {
+    if (update_rule_state_.empty())
+      update_rule_state_.resize(update_rule.get_state_size(), 0);
+    ++update_rule_step_;
+    update_rule.Apply(column_ids,
+                      reinterpret_cast<const float*>(update_batch),
+                      num_updates, update_rule_step_,
+                      row_data_->GetFloatDataUnsafe(),
+                      update_rule_state_.data());
+    return MarkDirty();
   }
 
   size_t SerializedSize() const {
@@ -87,10 +135,9 @@ public:
 
   bool AppendRowToBuffs(int32_t client_id_st,
     boost::unordered_map<int32_t, RecordBuff> *buffs,
-    const void *row_data, size_t row_size, int32_t row_id,
-    int32_t *failed_client_id) {
-    return callback_subs_.AppendRowToBuffs(client_id_st, buffs, row_data,
-      row_size, row_id, failed_client_id);
+    int32_t row_id, int32_t *failed_client_id) {
+    return callback_subs_.AppendRowToBuffs(client_id_st, buffs, row_data_,
+      SerializedSize(), row_id, failed_client_id);
   }
 
   bool IsDirty() {
@@ -108,10 +155,9 @@ public:
   }
 
   void AppendRowToBuffs(
-      boost::unordered_map<int32_t, RecordBuff> *buffs,
-      const void *row_data, size_t row_size, int32_t row_id) {
-    callback_subs_.AppendRowToBuffs(buffs, row_data,
-      row_size, row_id);
+      boost::unordered_map<int32_t, RecordBuff> *buffs, int32_t row_id) {
+    callback_subs_.AppendRowToBuffs(buffs, row_data_,
+      SerializedSize(), row_id);
   }
 
   double get_importance() {
@@ -127,6 +173,11 @@ public:
   }
 
 private:
+  bool MarkDirty() {
+    bool was_clean = !dirty_;
+    dirty_ = true;
+    return was_clean;
+  }
 
   CallBackSubs callback_subs_;
   AbstractRow *row_data_;
@@ -135,5 +186,10 @@ private:
   bool dirty_;
 
   double importance_;
+
+  // Optimizer state of the columns, allocated on the first update if the
+  // table has a server update rule.
+  std::vector<float> update_rule_state_;
+  int64_t update_rule_step_;
 };
 }
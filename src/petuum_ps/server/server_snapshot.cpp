@@ -0,0 +1,206 @@
+// author: jinliang
+
+#include <petuum_ps/server/server_snapshot.hpp>
+#include <petuum_ps_common/util/class_register.hpp>
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <snappy.h>
+#include <glog/logging.h>
+
+namespace petuum {
+
+SnapShotWriter::SnapShotWriter():
+    busy_(false),
+    stop_(false),
+    started_(false) { }
+
+SnapShotWriter::~SnapShotWriter() {
+  ShutDown();
+}
+
+void SnapShotWriter::Start() {
+  started_ = true;
+  Thread::Start();
+}
+
+void SnapShotWriter::Enqueue(SnapShotJob *job) {
+  CHECK(started_);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    jobs_.push_back(job);
+  }
+  cv_.notify_all();
+}
+
+void SnapShotWriter::WaitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (busy_ || !jobs_.empty())
+    cv_.wait(lock);
+}
+
+void SnapShotWriter::ShutDown() {
+  if (!started_)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  Join();
+  started_ = false;
+}
+
+void *SnapShotWriter::operator() () {
+  while (1) {
+    SnapShotJob *job;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      busy_ = false;
+      cv_.notify_all();
+      while (jobs_.empty() && !stop_)
+        cv_.wait(lock);
+      if (jobs_.empty())
+        return 0;
+      job = jobs_.front();
+      jobs_.pop_front();
+      busy_ = true;
+    }
+    WriteSnapShot(job);
+    delete job;
+  }
+  return 0;
+}
+
+void SnapShotWriter::WriteSnapShot(SnapShotJob *job) {
+  // Write to a temporary file first so that a partially written snapshot
+  // is never picked up by resume.
+  std::string tmp_filename = job->filename + ".tmp";
+  FILE *file = fopen(tmp_filename.c_str(), "wb");
+  CHECK(file != 0) << "Failed to open " << tmp_filename;
+
+  job->header.num_blocks = job->blocks.size();
+  CHECK_EQ(fwrite(&job->header, sizeof(SnapShotFileHeader), 1, file), 1);
+
+  std::string compressed;
+  for (auto &block : job->blocks) {
+    snappy::Compress(reinterpret_cast<const char*>(block.data()),
+                     block.size(), &compressed);
+    SnapShotBlockHeader block_header;
+    block_header.compressed_size = compressed.size();
+    block_header.uncompressed_size = block.size();
+    // Release the uncompressed copy as soon as possible.
+    std::vector<uint8_t>().swap(block);
+
+    CHECK_EQ(fwrite(&block_header, sizeof(SnapShotBlockHeader), 1, file), 1);
+    CHECK_EQ(fwrite(compressed.data(), 1, compressed.size(), file),
+             compressed.size());
+  }
+  CHECK_EQ(fflush(file), 0);
+  CHECK_EQ(fsync(fileno(file)), 0);
+  CHECK_EQ(fclose(file), 0);
+  CHECK_EQ(rename(tmp_filename.c_str(), job->filename.c_str()), 0)
+      << "Failed to rename " << tmp_filename;
+}
+
+SnapShotReader::SnapShotReader(const std::string &filename, int32_t row_type):
+    filename_(filename),
+    row_type_(row_type) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  CHECK(fd >= 0) << "Failed to open snapshot " << filename;
+  struct stat file_stat;
+  CHECK_EQ(fstat(fd, &file_stat), 0);
+  mem_size_ = file_stat.st_size;
+  CHECK(mem_size_ >= sizeof(SnapShotFileHeader))
+      << "Corrupted snapshot " << filename;
+  void *mem = mmap(0, mem_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  CHECK(mem != MAP_FAILED) << "Failed to mmap snapshot " << filename;
+  close(fd);
+  mem_ = reinterpret_cast<uint8_t*>(mem);
+  madvise(mem_, mem_size_, MADV_SEQUENTIAL);
+
+  header_ = reinterpret_cast<const SnapShotFileHeader*>(mem_);
+  CHECK(header_->magic == kSnapShotMagic) << "Bad snapshot " << filename;
+
+  size_t offset = sizeof(SnapShotFileHeader);
+  for (uint64_t i = 0; i < header_->num_blocks; ++i) {
+    CHECK(offset + sizeof(SnapShotBlockHeader) <= mem_size_)
+        << "Corrupted snapshot " << filename;
+    const SnapShotBlockHeader *block_header
+        = reinterpret_cast<const SnapShotBlockHeader*>(mem_ + offset);
+    offset += sizeof(SnapShotBlockHeader) + block_header->compressed_size;
+    CHECK(offset <= mem_size_) << "Corrupted snapshot " << filename;
+    blocks_.push_back(block_header);
+  }
+}
+
+SnapShotReader::~SnapShotReader() {
+  munmap(mem_, mem_size_);
+}
+
+void SnapShotReader::Load(
+    int32_t num_threads,
+    std::vector<std::pair<int32_t, AbstractRow*> > *rows) {
+  if (num_threads > (int32_t) blocks_.size())
+    num_threads = blocks_.size();
+  if (num_threads < 1)
+    num_threads = 1;
+
+  std::vector<LoaderThread*> threads;
+  for (int32_t i = 1; i < num_threads; ++i) {
+    threads.push_back(new LoaderThread(this, i, num_threads));
+    threads.back()->Start();
+  }
+  // The calling thread takes a share too.
+  LoaderThread self(this, 0, num_threads);
+  self();
+
+  rows->reserve(header_->num_rows);
+  rows->insert(rows->end(), self.rows_.begin(), self.rows_.end());
+  for (auto &thread : threads) {
+    thread->Join();
+    rows->insert(rows->end(), thread->rows_.begin(), thread->rows_.end());
+    delete thread;
+  }
+  CHECK_EQ(rows->size(), header_->num_rows)
+      << "Corrupted snapshot " << filename_;
+}
+
+void *SnapShotReader::LoaderThread::operator() () {
+  for (size_t block_idx = thread_idx_; block_idx < reader_->blocks_.size();
+       block_idx += num_threads_) {
+    reader_->LoadBlock(block_idx, &rows_);
+  }
+  return 0;
+}
+
+void SnapShotReader::LoadBlock(
+    size_t block_idx,
+    std::vector<std::pair<int32_t, AbstractRow*> > *rows) const {
+  const SnapShotBlockHeader *block_header = blocks_[block_idx];
+  const char *compressed = reinterpret_cast<const char*>(block_header + 1);
+
+  std::vector<uint8_t> block(block_header->uncompressed_size);
+  CHECK(snappy::RawUncompress(compressed, block_header->compressed_size,
+                              reinterpret_cast<char*>(block.data())))
+      << "Corrupted snapshot " << filename_ << " block " << block_idx;
+
+  size_t offset = 0;
+  while (offset < block.size()) {
+    int32_t row_id = *(reinterpret_cast<const int32_t*>(&block[offset]));
+    offset += sizeof(int32_t);
+    size_t row_size = *(reinterpret_cast<const size_t*>(&block[offset]));
+    offset += sizeof(size_t);
+
+    AbstractRow *row
+        = ClassRegistry<AbstractRow>::GetRegistry().CreateObject(row_type_);
+    row->Deserialize(&block[offset], row_size);
+    offset += row_size;
+    rows->push_back(std::make_pair(row_id, row));
+  }
+}
+
+}  // namespace petuum
@@ -0,0 +1,115 @@
+// author: jinliang
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <mutex>
+#include <condition_variable>
+#include <boost/noncopyable.hpp>
+
+#include <petuum_ps_common/include/abstract_row.hpp>
+#include <petuum_ps_common/util/thread.hpp>
+
+namespace petuum {
+
+// Server table snapshot file layout:
+//   SnapShotFileHeader
+//   num_blocks x (SnapShotBlockHeader, snappy compressed block)
+// An uncompressed block is a sequence of rows, each stored as
+// (int32_t row_id, size_t row_size, serialized row), same as RecordBuff.
+struct SnapShotFileHeader {
+  uint64_t magic;
+  int32_t table_id;
+  int32_t clock;
+  uint64_t num_rows;
+  uint64_t num_blocks;
+};
+
+struct SnapShotBlockHeader {
+  uint64_t compressed_size;
+  uint64_t uncompressed_size;
+};
+
+const uint64_t kSnapShotMagic = 0x3150414e53535054ull;  // "TPSSNAP1"
+
+// Uncompressed rows of a table at a given clock, ready to be written out.
+struct SnapShotJob {
+  std::string filename;
+  SnapShotFileHeader header;
+  std::vector<std::vector<uint8_t> > blocks;
+};
+
+// Writes snapshots on a background thread so that the server thread only
+// pays for serializing rows to memory. Each server thread owns one writer.
+class SnapShotWriter : public Thread, boost::noncopyable {
+public:
+  SnapShotWriter();
+  ~SnapShotWriter();
+
+  void Start();
+  // Takes ownership of job.
+  void Enqueue(SnapShotJob *job);
+  // Blocks until all enqueued snapshots are written.
+  void WaitUntilIdle();
+  // Writes the remaining snapshots and stops the thread.
+  void ShutDown();
+
+  void *operator() ();
+
+private:
+  static void WriteSnapShot(SnapShotJob *job);
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<SnapShotJob*> jobs_;
+  bool busy_;
+  bool stop_;
+  bool started_;
+};
+
+// Loads a snapshot file via mmap, decompressing and deserializing blocks
+// on num_threads threads.
+class SnapShotReader : boost::noncopyable {
+public:
+  SnapShotReader(const std::string &filename, int32_t row_type);
+  ~SnapShotReader();
+
+  // Caller takes ownership of the returned rows.
+  void Load(int32_t num_threads,
+            std::vector<std::pair<int32_t, AbstractRow*> > *rows);
+
+private:
+  class LoaderThread : public Thread {
+  public:
+    LoaderThread(const SnapShotReader *reader,
+                 int32_t thread_idx, int32_t num_threads):
+        reader_(reader),
+        thread_idx_(thread_idx),
+        num_threads_(num_threads) { }
+
+    void *operator() ();
+
+    std::vector<std::pair<int32_t, AbstractRow*> > rows_;
+
+  private:
+    const SnapShotReader *reader_;
+    int32_t thread_idx_;
+    int32_t num_threads_;
+  };
+
+  void LoadBlock(size_t block_idx,
+                 std::vector<std::pair<int32_t, AbstractRow*> > *rows) const;
+
+  const std::string filename_;
+  const int32_t row_type_;
+  uint8_t *mem_;
+  size_t mem_size_;
+  const SnapShotFileHeader *header_;
+  std::vector<const SnapShotBlockHeader*> blocks_;
+};
+
+}  // namespace petuum
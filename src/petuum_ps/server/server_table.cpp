@@ -1,8 +1,9 @@
 #include <petuum_ps/server/server_table.hpp>
+#include <petuum_ps_common/util/top_k.hpp>
 #include <iterator>
 #include <vector>
 #include <sstream>
-#include <leveldb/db.h>
+#include <unistd.h>
 #include <random>
 #include <algorithm>
 #include <iostream>
@@ -15,70 +16,66 @@ bool ServerTable::AppendTableToBuffs(
     int32_t *failed_client_id, bool resume) {
 
   if (resume) {
+    int32_t row_id = dirty_row_ids_[dirty_row_idx_];
+    ServerRow *server_row = storage_->Find(row_id);
     bool append_row_suc
-        = row_iter_->second.AppendRowToBuffs(
-            client_id_st,
-            buffs, tmp_row_buff_, curr_row_size_, row_iter_->first,
-            failed_client_id);
+        = server_row->AppendRowToBuffs(
+            client_id_st, buffs, row_id, failed_client_id);
     if (!append_row_suc)
       return false;
-    ++row_iter_;
+    ++dirty_row_idx_;
     client_id_st = 0;
   }
-  for (; row_iter_ != storage_.end(); ++row_iter_) {
-    if (row_iter_->second.NoClientSubscribed())
+  for (; dirty_row_idx_ < dirty_row_ids_.size(); ++dirty_row_idx_) {
+    int32_t row_id = dirty_row_ids_[dirty_row_idx_];
+    ServerRow *server_row = storage_->Find(row_id);
+
+    // A subscriber gets the latest row when it subscribes, so an
+    // unsubscribed row need not stay dirty.
+    server_row->ResetDirty();
+    if (server_row->NoClientSubscribed())
       continue;
 
-    if (!row_iter_->second.IsDirty())
-      continue;
-
-    row_iter_->second.ResetDirty();
-    ResetImportance_(&(row_iter_->second));
+    ResetImportance_(server_row);
 
-    curr_row_size_ = row_iter_->second.SerializedSize();
-    if (curr_row_size_ > tmp_row_buff_size_) {
-      delete[] tmp_row_buff_;
-      tmp_row_buff_size_ = curr_row_size_;
-      tmp_row_buff_ = new uint8_t[curr_row_size_];
-    }
-    curr_row_size_ = row_iter_->second.Serialize(tmp_row_buff_);
-
-    bool append_row_suc = row_iter_->second.AppendRowToBuffs(
-        client_id_st,
-        buffs, tmp_row_buff_, curr_row_size_, row_iter_->first,
-        failed_client_id);
+    bool append_row_suc = server_row->AppendRowToBuffs(
+        client_id_st, buffs, row_id, failed_client_id);
 
     if (!append_row_suc) {
       return false;
     }
   }
-  delete[] tmp_row_buff_;
+  dirty_row_ids_.clear();
   return true;
 }
 
 void ServerTable::SortCandidateVectorRandom(
-    std::vector<CandidateServerRow> *candidate_row_vector) {
+    std::vector<CandidateServerRow> *candidate_row_vector,
+    size_t num_to_select) {
   std::random_device rd;
   std::mt19937 g(rd());
 
-  std::shuffle((*candidate_row_vector).begin(),
-               (*candidate_row_vector).end(), g);
+  // Shuffles only the first num_to_select positions (Fisher-Yates).
+  size_t size = (*candidate_row_vector).size();
+  num_to_select = std::min(num_to_select, size);
+  for (size_t i = 0; i < num_to_select; ++i) {
+    std::uniform_int_distribution<size_t> dist(i, size - 1);
+    std::swap((*candidate_row_vector)[i], (*candidate_row_vector)[dist(g)]);
+  }
 }
 
 void ServerTable::SortCandidateVectorImportance(
-    std::vector<CandidateServerRow> *candidate_row_vector) {
+    std::vector<CandidateServerRow> *candidate_row_vector,
+    size_t num_to_select) {
 
-  std::sort((*candidate_row_vector).begin(),
-            (*candidate_row_vector).end(),
+  SelectTop((*candidate_row_vector).begin(),
+            (*candidate_row_vector).end(), num_to_select,
             [] (const CandidateServerRow &row1, const CandidateServerRow &row2)
             {
-
-              if (row1.server_row_ptr->get_importance() ==
-                  row2.server_row_ptr->get_importance()) {
+              if (row1.importance == row2.importance) {
                 return row1.row_id < row2.row_id;
               } else {
-                return (row1.server_row_ptr->get_importance() >
-                    row2.server_row_ptr->get_importance());
+                return row1.importance > row2.importance;
               }
             });
 }
@@ -93,25 +90,29 @@ void ServerTable::GetPartialTableToSend(
 
   std::vector<CandidateServerRow> candidate_row_vector;
 
-  auto row_iter = storage_.begin();
-  for (; row_iter != storage_.end(); ++row_iter) {
-    if (row_iter->second.NoClientSubscribed())
-      continue;
+  // Drop unsubscribed rows from the dirty list while collecting candidates.
+  size_t num_dirty_rows = 0;
+  for (size_t i = 0; i < dirty_row_ids_.size(); ++i) {
+    int32_t row_id = dirty_row_ids_[i];
+    ServerRow *server_row = storage_->Find(row_id);
 
-    if (!row_iter->second.IsDirty())
+    if (server_row->NoClientSubscribed()) {
+      server_row->ResetDirty();
       continue;
+    }
 
-    candidate_row_vector.push_back(
-        CandidateServerRow(row_iter->first, &(row_iter->second)));
+    dirty_row_ids_[num_dirty_rows++] = row_id;
 
-    if (candidate_row_vector.size() >= num_candidate_rows)
-      break;
+    if (candidate_row_vector.size() < num_candidate_rows)
+      candidate_row_vector.push_back(
+          CandidateServerRow(row_id, server_row));
   }
+  dirty_row_ids_.resize(num_dirty_rows);
 
   if (candidate_row_vector.empty())
     return;
 
-  SortCandidateVector_(&candidate_row_vector);
+  SortCandidateVector_(&candidate_row_vector, num_rows_threshold);
 
   for (auto vec_iter = candidate_row_vector.begin();
        vec_iter != candidate_row_vector.end(); vec_iter++) {
@@ -130,8 +131,6 @@ void ServerTable::AppendRowsToBuffsPartial(
     boost::unordered_map<int32_t, RecordBuff> *buffs,
     const boost::unordered_map<int32_t, ServerRow*> &rows_to_send) {
 
-  tmp_row_buff_ = new uint8_t[tmp_row_buff_size_];
-
   for (auto row_iter = rows_to_send.cbegin(); row_iter != rows_to_send.cend();
        ++row_iter) {
     if (row_iter->second->NoClientSubscribed())
@@ -143,20 +142,17 @@ void ServerTable::AppendRowsToBuffsPartial(
     row_iter->second->ResetDirty();
     ResetImportance_(row_iter->second);
 
-    curr_row_size_ = row_iter->second->SerializedSize();
-    if (curr_row_size_ > tmp_row_buff_size_) {
-      delete[] tmp_row_buff_;
-      tmp_row_buff_size_ = curr_row_size_;
-      tmp_row_buff_ = new uint8_t[curr_row_size_];
-    }
-
-    curr_row_size_ = row_iter->second->Serialize(tmp_row_buff_);
-
-    row_iter->second->AppendRowToBuffs(
-        buffs, tmp_row_buff_, curr_row_size_, row_iter->first);
+    row_iter->second->AppendRowToBuffs(buffs, row_iter->first);
   }
 
-  delete[] tmp_row_buff_;
+  // Remove the rows just sent from the dirty list.
+  size_t num_dirty_rows = 0;
+  for (size_t i = 0; i < dirty_row_ids_.size(); ++i) {
+    int32_t row_id = dirty_row_ids_[i];
+    if (storage_->Find(row_id)->IsDirty())
+      dirty_row_ids_[num_dirty_rows++] = row_id;
+  }
+  dirty_row_ids_.resize(num_dirty_rows);
 }
 
 void ServerTable::MakeSnapShotFileName(
@@ -167,70 +163,69 @@ void ServerTable::MakeSnapShotFileName(
   std::stringstream ss;
   ss << snapshot_dir << "/server_table" << ".server-" << server_id
      << ".table-" << table_id << ".clock-" << clock
-     << ".db";
+     << ".snap";
   *filename = ss.str();
 }
 
 void ServerTable::TakeSnapShot(
     const std::string &snapshot_dir,
-    int32_t server_id, int32_t table_id, int32_t clock) const {
-
-  std::string db_name;
-  MakeSnapShotFileName(snapshot_dir, server_id, table_id, clock, &db_name);
-
-  leveldb::DB* db;
-  leveldb::Options options;
-  options.create_if_missing = true;
-  leveldb::Status status = leveldb::DB::Open(options, db_name, &db);
-
-  uint8_t *mem_buff = new uint8_t[512];
-  int32_t buff_size = 512;
-  for (auto row_iter = storage_.begin(); row_iter != storage_.end();
-       row_iter++) {
-    int32_t serialized_size = row_iter->second.SerializedSize();
-    if (buff_size < serialized_size) {
-      delete[] mem_buff;
-      buff_size = serialized_size;
-      mem_buff = new uint8_t[buff_size];
+    int32_t server_id, int32_t table_id, int32_t clock,
+    SnapShotWriter *snapshot_writer) const {
+
+  SnapShotJob *job = new SnapShotJob;
+  MakeSnapShotFileName(snapshot_dir, server_id, table_id, clock,
+                       &job->filename);
+  job->header.magic = kSnapShotMagic;
+  job->header.table_id = table_id;
+  job->header.clock = clock;
+  job->header.num_rows = storage_->get_num_rows();
+
+  std::vector<uint8_t> *block = 0;
+  size_t num_slots = storage_->get_num_slots();
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    int32_t row_id;
+    const ServerRow *server_row = storage_->GetSlot(slot, &row_id);
+    if (server_row == 0)
+      continue;
+
+    size_t serialized_size = server_row->SerializedSize();
+    if (block == 0 || block->size() >= kSnapShotBlockSize) {
+      job->blocks.push_back(std::vector<uint8_t>());
+      block = &job->blocks.back();
+      block->reserve(kSnapShotBlockSize);
     }
-    row_iter->second.Serialize(mem_buff);
-    leveldb::Slice key(reinterpret_cast<const char*>(&(row_iter->first)),
-                       sizeof(int32_t));
-    leveldb::Slice value(reinterpret_cast<const char*>(mem_buff),
-                         serialized_size);
-    db->Put(leveldb::WriteOptions(), key, value);
+    size_t offset = block->size();
+    block->resize(offset + sizeof(int32_t) + sizeof(size_t)
+                  + serialized_size);
+    uint8_t *mem = block->data() + offset;
+    *(reinterpret_cast<int32_t*>(mem)) = row_id;
+    mem += sizeof(int32_t);
+    serialized_size = server_row->Serialize(mem + sizeof(size_t));
+    *(reinterpret_cast<size_t*>(mem)) = serialized_size;
+    block->resize(offset + sizeof(int32_t) + sizeof(size_t)
+                  + serialized_size);
   }
-  delete[] mem_buff;
-  delete db;
+  snapshot_writer->Enqueue(job);
 }
 
 void ServerTable::ReadSnapShot(const std::string &resume_dir,
                                int32_t server_id, int32_t table_id, int32_t clock) {
 
-  std::string db_name;
-  MakeSnapShotFileName(resume_dir, server_id, table_id, clock, &db_name);
-
-  leveldb::DB* db;
-  leveldb::Options options;
-  options.create_if_missing = true;
-  leveldb::Status status = leveldb::DB::Open(options, db_name, &db);
+  std::string filename;
+  MakeSnapShotFileName(resume_dir, server_id, table_id, clock, &filename);
 
-  leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    int32_t row_id = *(reinterpret_cast<const int32_t*>(it->key().data()));
-        const uint8_t *row_data
-            = reinterpret_cast<const uint8_t*>(it->value().data());
-        size_t row_data_size = it->value().size();
+  // Server threads load their snapshots concurrently, so split the cores
+  // among them.
+  int32_t num_threads = sysconf(_SC_NPROCESSORS_ONLN)
+                        / GlobalContext::get_num_comm_channels_per_client();
 
-        int32_t row_type = table_info_.row_type;
-            AbstractRow *abstract_row
-                = ClassRegistry<AbstractRow>::GetRegistry().CreateObject(row_type);
-            abstract_row->Deserialize(row_data, row_data_size);
+  std::vector<std::pair<int32_t, AbstractRow*> > rows;
+  SnapShotReader reader(filename, table_info_.row_type);
+  reader.Load(num_threads, &rows);
 
-            storage_.insert(std::make_pair(row_id, ServerRow(abstract_row)));
-            VLOG(0) << "ReadSnapShot, row_id = " << row_id;
+  for (auto &row : rows) {
+    storage_->Insert(row.first, row.second);
   }
-  delete it;
-  delete db;
+  VLOG(0) << "ReadSnapShot " << filename << ", num_rows = " << rows.size();
 }
 }
@@ -2,6 +2,11 @@
 
 #pragma once
 #include <petuum_ps/server/server_row.hpp>
+#include <petuum_ps/server/abstract_server_storage.hpp>
+#include <petuum_ps/server/open_addressing_server_storage.hpp>
+#include <petuum_ps/server/dense_server_storage.hpp>
+#include <petuum_ps/server/server_snapshot.hpp>
+#include <petuum_ps/server/server_update_rule.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
 #include <petuum_ps/thread/context.hpp>
 #include <petuum_ps_common/oplog/dense_row_oplog.hpp>
@@ -15,22 +20,39 @@ namespace petuum {
 struct CandidateServerRow {
   int32_t row_id;
   ServerRow *server_row_ptr;
+  // Copied so that ordering candidates does not chase server_row_ptr.
+  double importance;
 
   CandidateServerRow(int32_t _row_id,
                      ServerRow *_server_row_ptr):
       row_id(_row_id),
-      server_row_ptr(_server_row_ptr) { }
+      server_row_ptr(_server_row_ptr),
+      importance(_server_row_ptr->get_importance()) { }
 };
 
 class ServerTable : boost::noncopyable {
 public:
-  explicit ServerTable(const TableInfo &table_info):
+  ServerTable(int32_t table_id, const TableInfo &table_info):
       table_info_(table_info),
-      tmp_row_buff_size_ (kTmpRowBuffSizeInit),
+      dirty_row_idx_(0),
       sample_row_(
           ClassRegistry<AbstractRow>::GetRegistry().CreateObject(
               table_info.row_type)) {
 
+    if (table_info.server_storage_type == ServerDenseRange)
+      storage_ = new DenseServerStorage(
+          table_info.server_storage_capacity,
+          GlobalContext::GetRowPartitioner(table_id));
+    else
+      storage_ = new OpenAddressingServerStorage(
+          table_info.server_storage_capacity);
+
+    if (table_info.server_update_rule.type != ServerAdd)
+      update_rule_ = new ServerUpdateRule(table_info.server_update_rule,
+                                          table_info.row_capacity);
+    else
+      update_rule_ = 0;
+
     if (GlobalContext::get_consistency_model() == SSPAggr
         && (GlobalContext::get_update_sort_policy() == RelativeMagnitude
             || GlobalContext::get_update_sort_policy() == FIFO_N_ReMag)) {
@@ -64,18 +86,27 @@ public:
   }
 
   ~ServerTable() {
+    if (storage_)
+      delete storage_;
     if (sample_row_)
       delete sample_row_;
     if (sample_row_oplog_)
       delete sample_row_oplog_;
+    if (update_rule_)
+      delete update_rule_;
   }
 
   // Move constructor: storage gets other's storage, leaving other
   // in an unspecified but valid state.
   ServerTable(ServerTable && other):
     table_info_(other.table_info_),
-    storage_(std::move(other.storage_)) ,
-    tmp_row_buff_size_(other.tmp_row_buff_size_) {
+    storage_(other.storage_),
+    dirty_row_ids_(std::move(other.dirty_row_ids_)),
+    dirty_row_idx_(other.dirty_row_idx_) {
+    other.storage_ = 0;
+    other.dirty_row_ids_.clear();
+    other.dirty_row_idx_ = 0;
+
     ApplyRowBatchInc_ = other.ApplyRowBatchInc_;
     ResetImportance_ = other.ResetImportance_;
     SortCandidateVector_ = other.SortCandidateVector_;
@@ -85,15 +116,15 @@ public:
 
     sample_row_oplog_ = other.sample_row_oplog_;
     other.sample_row_oplog_ = 0;
+
+    update_rule_ = other.update_rule_;
+    other.update_rule_ = 0;
   }
 
   ServerTable & operator = (ServerTable & other) = delete;
 
   ServerRow *FindRow(int32_t row_id) {
-    auto row_iter = storage_.find(row_id);
-    if(row_iter == storage_.end())
-      return 0;
-    return &(row_iter->second);
+    return storage_->Find(row_id);
   }
 
   ServerRow *CreateRow (int32_t row_id) {
@@ -101,24 +132,26 @@ public:
     AbstractRow *row_data
       = ClassRegistry<AbstractRow>::GetRegistry().CreateObject(row_type);
     row_data->Init(table_info_.row_capacity);
-    storage_.insert(std::make_pair(row_id, ServerRow(row_data)));
-    return &(storage_[row_id]);
+    return storage_->Insert(row_id, row_data);
   }
 
   bool ApplyRowOpLog (int32_t row_id, const int32_t *column_ids,
     const void *updates, int32_t num_updates) {
-    auto row_iter = storage_.find(row_id);
-    if (row_iter == storage_.end())
+    ServerRow *server_row = storage_->Find(row_id);
+    if (server_row == 0)
       return false;
 
-    ApplyRowBatchInc_(column_ids, updates, num_updates, &(row_iter->second));
+    bool turned_dirty = (update_rule_ == 0)
+        ? ApplyRowBatchInc_(column_ids, updates, num_updates, server_row)
+        : ApplyRowUpdateRule(column_ids, updates, num_updates, server_row);
+    if (turned_dirty)
+      dirty_row_ids_.push_back(row_id);
 
     return true;
   }
 
   void InitAppendTableToBuffs() {
-    row_iter_ = storage_.begin();
-    tmp_row_buff_ = new uint8_t[tmp_row_buff_size_];
+    dirty_row_idx_ = 0;
   }
 
   const AbstractRowOpLog *get_sample_row_oplog() const {
@@ -129,16 +162,24 @@ public:
     return table_info_.oplog_dense_serialized;
   }
 
+  const TableInfo &get_table_info() const {
+    return table_info_;
+  }
+
   bool AppendTableToBuffs(
       int32_t client_id_st,
       boost::unordered_map<int32_t, RecordBuff> *buffs,
       int32_t *failed_client_id, bool resume);
 
+  // Put the num_to_select candidates to send first at the front of
+  // candidate_row_vector, in order; the rest stay unordered.
   static void SortCandidateVectorRandom(
-      std::vector<CandidateServerRow> *candidate_row_vector);
+      std::vector<CandidateServerRow> *candidate_row_vector,
+      size_t num_to_select);
 
   static void SortCandidateVectorImportance(
-      std::vector<CandidateServerRow> *candidate_row_vector);
+      std::vector<CandidateServerRow> *candidate_row_vector,
+      size_t num_to_select);
 
   void GetPartialTableToSend(
     boost::unordered_map<int32_t, ServerRow*> *rows_to_send,
@@ -153,42 +194,60 @@ public:
                             int32_t table_id, int32_t clock,
                             std::string *filename) const;
 
+  // Serializes the table to memory and hands it to snapshot_writer, which
+  // compresses and writes it in the background.
   void TakeSnapShot(const std::string &snapshot_dir, int32_t server_id,
-                    int32_t table_id, int32_t clock) const;
+                    int32_t table_id, int32_t clock,
+                    SnapShotWriter *snapshot_writer) const;
 
   void ReadSnapShot(const std::string &resume_dir, int32_t server_id,
                     int32_t table_id, int32_t clock);
 private:
-  static void ApplyRowBatchInc(
+  // Return true if the row turns dirty.
+  static bool ApplyRowBatchInc(
       const int32_t *column_ids,
       const void *updates, int32_t num_updates,
       ServerRow *server_row) {
-    server_row->ApplyBatchInc(column_ids, updates, num_updates);
+    return server_row->ApplyBatchInc(column_ids, updates, num_updates);
   }
 
-  static void ApplyRowBatchIncAccumImportance(
+  static bool ApplyRowBatchIncAccumImportance(
       const int32_t *column_ids,
       const void *updates, int32_t num_updates,
       ServerRow *server_row) {
-    server_row->ApplyBatchIncAccumImportance(
+    return server_row->ApplyBatchIncAccumImportance(
         column_ids, updates, num_updates);
   }
 
-  static void ApplyRowDenseBatchInc(
+  static bool ApplyRowDenseBatchInc(
       const int32_t *column_ids,
       const void *updates, int32_t num_updates,
       ServerRow *server_row) {
-    server_row->ApplyDenseBatchInc(updates, num_updates);
+    return server_row->ApplyDenseBatchInc(updates, num_updates);
   }
 
-  static void ApplyRowDenseBatchIncAccumImportance(
+  static bool ApplyRowDenseBatchIncAccumImportance(
       const int32_t *column_ids,
       const void *updates, int32_t num_updates,
       ServerRow *server_row) {
-    server_row->ApplyDenseBatchIncAccumImportance(updates, num_updates);
+    return server_row->ApplyDenseBatchIncAccumImportance(updates, num_updates);
   }
 
-  typedef void (*ApplyRowBatchIncFunc)(
+  bool ApplyRowUpdateRule(
+      const int32_t *column_ids,
+      const void *updates, int32_t num_updates,
+      ServerRow *server_row) {
+    // Importance is the magnitude of the gradients.
+    if (ResetImportance_ != ResetImportanceNoOp)
+      server_row->AccumImportance(
+          sample_row_->GetAccumImportance(column_ids, updates, num_updates));
+    return server_row->ApplyUpdateRule(
+        *update_rule_,
+        table_info_.oplog_dense_serialized ? 0 : column_ids,
+        updates, num_updates);
+  }
+
+  typedef bool (*ApplyRowBatchIncFunc)(
       const int32_t *column_ids,
       const void *updates, int32_t num_updates,
       ServerRow *server_row);
@@ -202,17 +261,22 @@ private:
   typedef void (*ResetImportanceFunc)(ServerRow *server_row);
 
   typedef void (*SortCandidateVectorFunc)(
-      std::vector<CandidateServerRow> *candidate_row_vector);
+      std::vector<CandidateServerRow> *candidate_row_vector,
+      size_t num_to_select);
 
   TableInfo table_info_;
-  boost::unordered_map<int32_t, ServerRow> storage_;
+  AbstractServerStorage *storage_;
+
+  // Ids of the dirty rows, each appears once. A row is added when an update
+  // turns it dirty and removed when it is pushed, so pushes only visit rows
+  // that have changed.
+  std::vector<int32_t> dirty_row_ids_;
 
   // used for appending rows to buffs
-  boost::unordered_map<int32_t, ServerRow>::iterator row_iter_;
-  uint8_t *tmp_row_buff_;
-  size_t tmp_row_buff_size_;
-  static const size_t kTmpRowBuffSizeInit = 512;
-  size_t curr_row_size_;
+  size_t dirty_row_idx_;
+
+  // Uncompressed size of a snapshot block.
+  static const size_t kSnapShotBlockSize = 4*k1_Mi;
 
   ApplyRowBatchIncFunc ApplyRowBatchInc_;
   ResetImportanceFunc ResetImportance_;
@@ -220,6 +284,9 @@ private:
 
   const AbstractRow *sample_row_;
   const AbstractRowOpLog *sample_row_oplog_;
+
+  // 0 for ServerAdd, which goes through ApplyRowBatchInc_.
+  ServerUpdateRule *update_rule_;
 };
 
 }
@@ -3,6 +3,7 @@
 #include <petuum_ps/thread/context.hpp>
 #include <petuum_ps/thread/ps_msgs.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 #include <petuum_ps_common/thread/mem_transfer.hpp>
 #include <petuum_ps/thread/numa_mgr.hpp>
 
@@ -160,14 +161,46 @@ void ServerThread::HandleCreateTable(int32_t sender_id,
       = create_table_msg.get_row_oplog_type();
   table_info.dense_row_oplog_capacity
       = create_table_msg.get_dense_row_oplog_capacity();
+  table_info.server_storage_type
+      = create_table_msg.get_server_storage_type();
+  table_info.server_storage_capacity
+      = create_table_msg.get_server_storage_capacity();
+  table_info.oplog_index_encoding
+      = create_table_msg.get_oplog_index_encoding();
+  table_info.oplog_value_encoding
+      = create_table_msg.get_oplog_value_encoding();
+  table_info.oplog_compressed
+      = create_table_msg.get_oplog_compressed();
+  table_info.row_partition_type
+      = create_table_msg.get_row_partition_type();
+  table_info.range_partition_num_rows
+      = create_table_msg.get_range_partition_num_rows();
+  table_info.server_update_rule
+      = create_table_msg.get_server_update_rule();
   server_obj_.CreateTable(table_id, table_info);
 }
 
 void ServerThread::HandleRowRequest(int32_t sender_id,
                                     RowRequestMsg &row_request_msg) {
-  int32_t table_id = row_request_msg.get_table_id();
-  int32_t row_id = row_request_msg.get_row_id();
-  int32_t clock = row_request_msg.get_clock();
+  HandleRowRequest(sender_id, row_request_msg.get_table_id(),
+                   row_request_msg.get_row_id(), row_request_msg.get_clock());
+}
+
+void ServerThread::HandleRowBatchRequest(
+    int32_t sender_id, RowBatchRequestMsg &row_batch_request_msg) {
+  int32_t table_id = row_batch_request_msg.get_table_id();
+  int32_t clock = row_batch_request_msg.get_clock();
+  int32_t num_rows = row_batch_request_msg.get_num_rows();
+  const int32_t *row_ids = row_batch_request_msg.get_row_ids();
+  for (int32_t i = 0; i < num_rows; ++i) {
+    HandleRowRequest(sender_id, table_id, row_ids[i], clock);
+  }
+}
+
+void ServerThread::HandleRowRequest(int32_t sender_id, int32_t table_id,
+                                    int32_t row_id, int32_t clock) {
+  STATS_SERVER_ROW_REQUEST_INC_ONE();
+  Metrics::AddCounter(kMetricServerRowRequests, 1);
   int32_t server_clock = server_obj_.GetMinClock();
   if (server_clock < clock) {
     // not fresh enough, wait
@@ -209,11 +242,16 @@ void ServerThread::HandleOpLogMsg(int32_t sender_id,
   int32_t bg_clock = client_send_oplog_msg.get_bg_clock();
 
   STATS_SERVER_ADD_PER_CLOCK_OPLOG_SIZE(client_send_oplog_msg.get_size());
+  Metrics::AddCounter(kMetricServerOpLogRecvBytes,
+                      client_send_oplog_msg.get_size());
 
   STATS_SERVER_ACCUM_APPLY_OPLOG_BEGIN();
-  server_obj_.ApplyOpLogUpdateVersion(
-      client_send_oplog_msg.get_data(), client_send_oplog_msg.get_avai_size(),
-      sender_id, version);
+  {
+    MetricTimer metric_timer(kMetricServerApplyOpLog, false);
+    server_obj_.ApplyOpLogUpdateVersion(
+        client_send_oplog_msg.get_data(),
+        client_send_oplog_msg.get_avai_size(), sender_id, version);
+  }
   STATS_SERVER_ACCUM_APPLY_OPLOG_END();
 
   bool clock_changed = false;
@@ -320,6 +358,12 @@ void *ServerThread::operator() () {
 	HandleRowRequest(sender_id, row_request_msg);
       }
       break;
+    case kRowBatchRequest:
+      {
+	RowBatchRequestMsg row_batch_request_msg(msg_mem);
+	HandleRowBatchRequest(sender_id, row_batch_request_msg);
+      }
+      break;
     case kClientSendOpLog:
       {
 	ClientSendOpLogMsg client_send_oplog_msg(msg_mem);
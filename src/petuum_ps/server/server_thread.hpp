@@ -50,6 +50,10 @@ protected:
   bool HandleShutDownMsg();
   void HandleCreateTable(int32_t sender_id, CreateTableMsg &create_table_msg);
   void HandleRowRequest(int32_t sender_id, RowRequestMsg &row_request_msg);
+  void HandleRowBatchRequest(int32_t sender_id,
+                             RowBatchRequestMsg &row_batch_request_msg);
+  void HandleRowRequest(int32_t sender_id, int32_t table_id, int32_t row_id,
+                        int32_t clock);
   void ReplyRowRequest(int32_t bg_id, ServerRow *server_row,
                        int32_t table_id, int32_t row_id, int32_t server_clock,
                        uint32_t version);
@@ -0,0 +1,338 @@
+#include <petuum_ps/server/server_update_rule.hpp>
+#include <petuum_ps_common/util/dense_kernels.hpp>
+#include <glog/logging.h>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PETUUM_UPDATE_RULE_X86
+#endif
+
+namespace petuum {
+
+namespace {
+
+struct RuleParams {
+  float learning_rate;
+  float momentum;
+  float one_minus_momentum;
+  float beta2;
+  float one_minus_beta2;
+  float epsilon;
+  float ftrl_beta;
+  float l1;
+  float l2;
+  // Adam learning rate with the bias correction of this step folded in.
+  float adam_learning_rate;
+};
+
+struct DenseIndex {
+  int32_t operator()(int32_t i) const {
+    return i;
+  }
+};
+
+struct SparseIndex {
+  const int32_t *column_ids;
+
+  int32_t operator()(int32_t i) const {
+    return column_ids[i];
+  }
+};
+
+// The scalar kernels update the columns idx(0), ..., idx(n - 1); g is
+// indexed by position, values and state by column.
+
+template<typename Index>
+void SGDMomentumScalar(const RuleParams &p, Index idx, const float *g,
+                       int32_t n, float *w, float *v) {
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t c = idx(i);
+    v[c] = p.momentum * v[c] + g[i];
+    w[c] = w[c] - p.learning_rate * v[c];
+  }
+}
+
+template<typename Index>
+void AdaGradScalar(const RuleParams &p, Index idx, const float *g,
+                   int32_t n, float *w, float *h) {
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t c = idx(i);
+    h[c] = h[c] + g[i] * g[i];
+    w[c] = w[c] - (p.learning_rate * g[i]) / (std::sqrt(h[c]) + p.epsilon);
+  }
+}
+
+template<typename Index>
+void AdamScalar(const RuleParams &p, Index idx, const float *g,
+                int32_t n, float *w, float *m, float *v) {
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t c = idx(i);
+    m[c] = p.momentum * m[c] + p.one_minus_momentum * g[i];
+    v[c] = p.beta2 * v[c] + p.one_minus_beta2 * (g[i] * g[i]);
+    w[c] = w[c]
+           - (p.adam_learning_rate * m[c]) / (std::sqrt(v[c]) + p.epsilon);
+  }
+}
+
+// FTRL-proximal (McMahan et al., 2013) with per-coordinate learning rates.
+template<typename Index>
+void FTRLScalar(const RuleParams &p, Index idx, const float *g,
+                int32_t n, float *w, float *z, float *sq) {
+  for (int32_t i = 0; i < n; ++i) {
+    int32_t c = idx(i);
+    float sq_new = sq[c] + g[i] * g[i];
+    float sqrt_sq_new = std::sqrt(sq_new);
+    float sigma = (sqrt_sq_new - std::sqrt(sq[c])) / p.learning_rate;
+    z[c] = (z[c] + g[i]) - sigma * w[c];
+    sq[c] = sq_new;
+    float denom = (p.ftrl_beta + sqrt_sq_new) / p.learning_rate + p.l2;
+    float shrunk = std::copysign(p.l1, z[c]) - z[c];
+    w[c] = (std::fabs(z[c]) > p.l1) ? shrunk / denom : 0.0f;
+  }
+}
+
+void SGDMomentumDenseScalar(const RuleParams &p, const float *g, int32_t n,
+                            float *w, float *v) {
+  SGDMomentumScalar(p, DenseIndex(), g, n, w, v);
+}
+
+void AdaGradDenseScalar(const RuleParams &p, const float *g, int32_t n,
+                        float *w, float *h) {
+  AdaGradScalar(p, DenseIndex(), g, n, w, h);
+}
+
+void AdamDenseScalar(const RuleParams &p, const float *g, int32_t n,
+                     float *w, float *m, float *v) {
+  AdamScalar(p, DenseIndex(), g, n, w, m, v);
+}
+
+void FTRLDenseScalar(const RuleParams &p, const float *g, int32_t n,
+                     float *w, float *z, float *sq) {
+  FTRLScalar(p, DenseIndex(), g, n, w, z, sq);
+}
+
+#ifdef PETUUM_UPDATE_RULE_X86
+
+// Same operations in the same order as the scalar kernels, and no FMA, so
+// the results match bit for bit.
+
+__attribute__((target("avx2")))
+void SGDMomentumDenseAVX2(const RuleParams &p, const float *g, int32_t n,
+                          float *w, float *v) {
+  __m256 lr = _mm256_set1_ps(p.learning_rate);
+  __m256 mom = _mm256_set1_ps(p.momentum);
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 vv = _mm256_add_ps(_mm256_mul_ps(mom, _mm256_loadu_ps(v + i)),
+                              _mm256_loadu_ps(g + i));
+    __m256 wv = _mm256_sub_ps(_mm256_loadu_ps(w + i), _mm256_mul_ps(lr, vv));
+    _mm256_storeu_ps(v + i, vv);
+    _mm256_storeu_ps(w + i, wv);
+  }
+  SGDMomentumDenseScalar(p, g + i, n - i, w + i, v + i);
+}
+
+__attribute__((target("avx2")))
+void AdaGradDenseAVX2(const RuleParams &p, const float *g, int32_t n,
+                      float *w, float *h) {
+  __m256 lr = _mm256_set1_ps(p.learning_rate);
+  __m256 eps = _mm256_set1_ps(p.epsilon);
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 gv = _mm256_loadu_ps(g + i);
+    __m256 hv = _mm256_add_ps(_mm256_loadu_ps(h + i), _mm256_mul_ps(gv, gv));
+    __m256 step = _mm256_div_ps(_mm256_mul_ps(lr, gv),
+                                _mm256_add_ps(_mm256_sqrt_ps(hv), eps));
+    _mm256_storeu_ps(h + i, hv);
+    _mm256_storeu_ps(w + i, _mm256_sub_ps(_mm256_loadu_ps(w + i), step));
+  }
+  AdaGradDenseScalar(p, g + i, n - i, w + i, h + i);
+}
+
+__attribute__((target("avx2")))
+void AdamDenseAVX2(const RuleParams &p, const float *g, int32_t n,
+                   float *w, float *m, float *v) {
+  __m256 b1 = _mm256_set1_ps(p.momentum);
+  __m256 one_minus_b1 = _mm256_set1_ps(p.one_minus_momentum);
+  __m256 b2 = _mm256_set1_ps(p.beta2);
+  __m256 one_minus_b2 = _mm256_set1_ps(p.one_minus_beta2);
+  __m256 lr = _mm256_set1_ps(p.adam_learning_rate);
+  __m256 eps = _mm256_set1_ps(p.epsilon);
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 gv = _mm256_loadu_ps(g + i);
+    __m256 mv = _mm256_add_ps(_mm256_mul_ps(b1, _mm256_loadu_ps(m + i)),
+                              _mm256_mul_ps(one_minus_b1, gv));
+    __m256 vv = _mm256_add_ps(
+        _mm256_mul_ps(b2, _mm256_loadu_ps(v + i)),
+        _mm256_mul_ps(one_minus_b2, _mm256_mul_ps(gv, gv)));
+    __m256 step = _mm256_div_ps(_mm256_mul_ps(lr, mv),
+                                _mm256_add_ps(_mm256_sqrt_ps(vv), eps));
+    _mm256_storeu_ps(m + i, mv);
+    _mm256_storeu_ps(v + i, vv);
+    _mm256_storeu_ps(w + i, _mm256_sub_ps(_mm256_loadu_ps(w + i), step));
+  }
+  AdamDenseScalar(p, g + i, n - i, w + i, m + i, v + i);
+}
+
+__attribute__((target("avx2")))
+void FTRLDenseAVX2(const RuleParams &p, const float *g, int32_t n,
+                   float *w, float *z, float *sq) {
+  __m256 lr = _mm256_set1_ps(p.learning_rate);
+  __m256 beta = _mm256_set1_ps(p.ftrl_beta);
+  __m256 l1 = _mm256_set1_ps(p.l1);
+  __m256 l2 = _mm256_set1_ps(p.l2);
+  __m256 sign_mask = _mm256_set1_ps(-0.0f);
+  int32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 gv = _mm256_loadu_ps(g + i);
+    __m256 sqv = _mm256_loadu_ps(sq + i);
+    __m256 sq_new = _mm256_add_ps(sqv, _mm256_mul_ps(gv, gv));
+    __m256 sqrt_sq_new = _mm256_sqrt_ps(sq_new);
+    __m256 sigma = _mm256_div_ps(
+        _mm256_sub_ps(sqrt_sq_new, _mm256_sqrt_ps(sqv)), lr);
+    __m256 zv = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(z + i), gv),
+                              _mm256_mul_ps(sigma, _mm256_loadu_ps(w + i)));
+    __m256 denom = _mm256_add_ps(
+        _mm256_div_ps(_mm256_add_ps(beta, sqrt_sq_new), lr), l2);
+    __m256 signed_l1 = _mm256_or_ps(_mm256_and_ps(sign_mask, zv), l1);
+    __m256 wv = _mm256_div_ps(_mm256_sub_ps(signed_l1, zv), denom);
+    __m256 active = _mm256_cmp_ps(_mm256_andnot_ps(sign_mask, zv), l1,
+                                  _CMP_GT_OQ);
+    _mm256_storeu_ps(z + i, zv);
+    _mm256_storeu_ps(sq + i, sq_new);
+    _mm256_storeu_ps(w + i, _mm256_and_ps(active, wv));
+  }
+  FTRLDenseScalar(p, g + i, n - i, w + i, z + i, sq + i);
+}
+
+#endif  // PETUUM_UPDATE_RULE_X86
+
+struct UpdateRuleKernels {
+  void (*SGDMomentum)(const RuleParams &p, const float *g, int32_t n,
+                      float *w, float *v);
+  void (*AdaGrad)(const RuleParams &p, const float *g, int32_t n,
+                  float *w, float *h);
+  void (*Adam)(const RuleParams &p, const float *g, int32_t n,
+               float *w, float *m, float *v);
+  void (*FTRL)(const RuleParams &p, const float *g, int32_t n,
+               float *w, float *z, float *sq);
+
+  UpdateRuleKernels():
+      SGDMomentum(SGDMomentumDenseScalar),
+      AdaGrad(AdaGradDenseScalar),
+      Adam(AdamDenseScalar),
+      FTRL(FTRLDenseScalar) {
+#ifdef PETUUM_UPDATE_RULE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      SGDMomentum = SGDMomentumDenseAVX2;
+      AdaGrad = AdaGradDenseAVX2;
+      Adam = AdamDenseAVX2;
+      FTRL = FTRLDenseAVX2;
+    }
+#endif
+  }
+};
+
+const UpdateRuleKernels &GetUpdateRuleKernels() {
+  static const UpdateRuleKernels kernels;
+  return kernels;
+}
+
+}  // anonymous namespace
+
+ServerUpdateRule::ServerUpdateRule(const ServerUpdateRuleConfig &config,
+                                   size_t row_capacity):
+    config_(config),
+    row_capacity_(row_capacity) {
+  CHECK_GT(config.learning_rate, 0);
+  CHECK_GE(config.l1, 0);
+  CHECK_GT(row_capacity, 0) << "server update rules need row_capacity";
+}
+
+size_t ServerUpdateRule::get_num_state_vectors() const {
+  switch (config_.type) {
+    case ServerAdd:
+      return 0;
+    case ServerSGDMomentum:
+    case ServerAdaGrad:
+      return 1;
+    case ServerAdam:
+    case ServerFTRL:
+      return 2;
+    default:
+      LOG(FATAL) << "Unknown server update rule " << config_.type;
+  }
+  return 0;
+}
+
+void ServerUpdateRule::Apply(const int32_t *column_ids, const float *grads,
+                             int32_t num_updates, int64_t step,
+                             float *values, float *state) const {
+  CHECK(values != 0) << "server update rules require DenseRow<float> rows";
+
+  RuleParams p;
+  p.learning_rate = config_.learning_rate;
+  p.momentum = config_.momentum;
+  p.one_minus_momentum = 1 - config_.momentum;
+  p.beta2 = config_.beta2;
+  p.one_minus_beta2 = 1 - config_.beta2;
+  p.epsilon = config_.epsilon;
+  p.ftrl_beta = config_.ftrl_beta;
+  p.l1 = config_.l1;
+  p.l2 = config_.l2;
+  p.adam_learning_rate = 0;
+  if (config_.type == ServerAdam) {
+    double t = double(step);
+    p.adam_learning_rate = config_.learning_rate
+        * std::sqrt(1 - std::pow(double(config_.beta2), t))
+        / (1 - std::pow(double(config_.momentum), t));
+  }
+
+  const UpdateRuleKernels &kernels = GetUpdateRuleKernels();
+  float *state2 = state + row_capacity_;
+  SparseIndex sparse_index = {column_ids};
+
+  switch (config_.type) {
+    case ServerAdd:
+      if (column_ids == 0) {
+        DenseAdd(values, grads, num_updates);
+      } else {
+        for (int32_t i = 0; i < num_updates; ++i)
+          values[column_ids[i]] += grads[i];
+      }
+      break;
+    case ServerSGDMomentum:
+      if (column_ids == 0)
+        kernels.SGDMomentum(p, grads, num_updates, values, state);
+      else
+        SGDMomentumScalar(p, sparse_index, grads, num_updates, values, state);
+      break;
+    case ServerAdaGrad:
+      if (column_ids == 0)
+        kernels.AdaGrad(p, grads, num_updates, values, state);
+      else
+        AdaGradScalar(p, sparse_index, grads, num_updates, values, state);
+      break;
+    case ServerAdam:
+      if (column_ids == 0)
+        kernels.Adam(p, grads, num_updates, values, state, state2);
+      else
+        AdamScalar(p, sparse_index, grads, num_updates, values, state,
+                   state2);
+      break;
+    case ServerFTRL:
+      if (column_ids == 0)
+        kernels.FTRL(p, grads, num_updates, values, state, state2);
+      else
+        FTRLScalar(p, sparse_index, grads, num_updates, values, state,
+                   state2);
+      break;
+    default:
+      LOG(FATAL) << "Unknown server update rule " << config_.type;
+  }
+}
+
+}  // namespace petuum
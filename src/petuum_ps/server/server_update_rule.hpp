@@ -0,0 +1,40 @@
+#pragma once
+
+#include <petuum_ps_common/include/configs.hpp>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace petuum {
+
+// Applies a table's ServerUpdateRuleConfig to the server rows, treating the
+// incoming updates as gradients. The state of a row is one float array
+// holding get_num_state_vectors() vectors of row_capacity floats each
+// (velocity, squared-gradient sums, ...), so each rule runs as one pass over
+// the values, the gradients and the state. Dense updates use AVX2 when the
+// CPU has it; the results are the same as the scalar version.
+class ServerUpdateRule {
+public:
+  ServerUpdateRule(const ServerUpdateRuleConfig &config,
+                   size_t row_capacity);
+
+  // Number of floats of state per row.
+  size_t get_state_size() const {
+    return get_num_state_vectors() * row_capacity_;
+  }
+
+  // values and state belong to the same row; state is zero-initialized
+  // before the first update of the row. step counts the updates the row
+  // has received, this one included. column_ids is 0 if the gradients are
+  // for columns [0, num_updates).
+  void Apply(const int32_t *column_ids, const float *grads,
+             int32_t num_updates, int64_t step,
+             float *values, float *state) const;
+
+private:
+  size_t get_num_state_vectors() const;
+
+  const ServerUpdateRuleConfig config_;
+  const size_t row_capacity_;
+};
+
+}  // namespace petuum
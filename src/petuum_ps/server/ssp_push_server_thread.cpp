@@ -2,6 +2,7 @@
 #include <petuum_ps/thread/context.hpp>
 #include <petuum_ps_common/thread/mem_transfer.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 
 namespace petuum {
 
@@ -11,18 +12,14 @@ void SSPPushServerThread::SendServerPushRowMsg(
   msg->get_version() = version;
   STATS_SERVER_ADD_PER_CLOCK_PUSH_ROW_SIZE(msg->get_size());
   STATS_SERVER_PUSH_ROW_MSG_SEND_INC_ONE();
+  Metrics::AddCounter(kMetricServerPushSentBytes, msg->get_size());
 
-  if (last_msg) {
-    msg->get_is_clock() = true;
+  msg->get_is_clock() = last_msg;
+  if (last_msg)
     msg->get_clock() = server_min_clock;
-    MemTransfer::TransferMem(GlobalContext::comm_bus, bg_id, msg);
-  } else {
-    msg->get_is_clock() = false;
-    size_t sent_size = (GlobalContext::comm_bus->*(
-        GlobalContext::comm_bus->SendAny_))(
-        bg_id, msg->get_mem(), msg->get_size());
-    CHECK_EQ(sent_size, msg->get_size());
-  }
+
+  // The message memory is handed over without copying; msg is left empty.
+  MemTransfer::TransferMem(GlobalContext::comm_bus, bg_id, msg);
 }
 
 void SSPPushServerThread::ServerPushRow(bool clock_changed) {
@@ -6,6 +6,7 @@
 #include <petuum_ps/client/oplog_serializer.hpp>
 #include <petuum_ps/client/ssp_client_row.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 #include <petuum_ps_common/comm_bus/comm_bus.hpp>
 #include <petuum_ps_common/thread/mem_transfer.hpp>
 #include <petuum_ps/thread/context.hpp>
@@ -13,6 +14,7 @@
 #include <utility>
 #include <limits.h>
 #include <algorithm>
+#include <cstring>
 
 namespace petuum {
 
@@ -29,7 +31,8 @@ AbstractBgWorker::AbstractBgWorker(int32_t id,
     clock_has_pushed_(-1),
     comm_bus_(GlobalContext::comm_bus),
     init_barrier_(init_barrier),
-    create_table_barrier_(create_table_barrier) {
+    create_table_barrier_(create_table_barrier),
+    collective_app_thread_id_(-1) {
   GlobalContext::GetServerThreadIDs(my_comm_channel_idx_, &(server_ids_));
   for (const auto &server_id : server_ids_) {
     server_table_oplog_size_map_.insert(
@@ -43,6 +46,9 @@ AbstractBgWorker::~AbstractBgWorker() {
   for (auto &serializer_pair : row_oplog_serializer_map_) {
     delete serializer_pair.second;
   }
+  for (auto &codec_pair : oplog_codec_map_) {
+    delete codec_pair.second;
+  }
 }
 
 void AbstractBgWorker::ShutDown() {
@@ -99,6 +105,22 @@ bool AbstractBgWorker::CreateTable(int32_t table_id,
         = table_config.process_storage_type;
     bg_create_table_msg.get_no_oplog_replay()
         = table_config.no_oplog_replay;
+    bg_create_table_msg.get_server_storage_type()
+        = table_info.server_storage_type;
+    bg_create_table_msg.get_server_storage_capacity()
+        = table_info.server_storage_capacity;
+    bg_create_table_msg.get_oplog_index_encoding()
+        = table_info.oplog_index_encoding;
+    bg_create_table_msg.get_oplog_value_encoding()
+        = table_info.oplog_value_encoding;
+    bg_create_table_msg.get_oplog_compressed()
+        = table_info.oplog_compressed;
+    bg_create_table_msg.get_row_partition_type()
+        = table_info.row_partition_type;
+    bg_create_table_msg.get_range_partition_num_rows()
+        = table_info.range_partition_num_rows;
+    bg_create_table_msg.get_server_update_rule()
+        = table_info.server_update_rule;
 
     size_t sent_size = SendMsg(
         reinterpret_cast<MsgBase*>(&bg_create_table_msg));
@@ -150,6 +172,20 @@ void AbstractBgWorker::RequestRowAsync(int32_t table_id, int32_t row_id,
   CHECK_EQ(sent_size, request_row_msg.get_size());
 }
 
+void AbstractBgWorker::RequestRowBatchAsync(int32_t table_id,
+                                            const int32_t *row_ids,
+                                            int32_t num_rows, int32_t clock) {
+  RowBatchRequestMsg row_batch_request_msg(num_rows);
+  row_batch_request_msg.get_table_id() = table_id;
+  row_batch_request_msg.get_clock() = clock;
+  memcpy(row_batch_request_msg.get_row_ids(), row_ids,
+         num_rows*sizeof(int32_t));
+
+  size_t sent_size = SendMsg(
+      reinterpret_cast<MsgBase*>(&row_batch_request_msg));
+  CHECK_EQ(sent_size, row_batch_request_msg.get_size());
+}
+
 void AbstractBgWorker::GetAsyncRowRequestReply() {
   zmq::message_t zmq_msg;
   int32_t sender_id;
@@ -178,6 +214,47 @@ void AbstractBgWorker::SendOpLogsAllTables() {
   CHECK_EQ(sent_size, bg_send_oplog_msg.get_size());
 }
 
+void AbstractBgWorker::GlobalBarrier() {
+  {
+    BarrierMsg barrier_msg;
+    size_t sent_size = SendMsg(reinterpret_cast<MsgBase*>(&barrier_msg));
+    CHECK_EQ(sent_size, barrier_msg.get_size());
+  }
+
+  {
+    zmq::message_t zmq_msg;
+    int32_t sender_id;
+    comm_bus_->RecvInProc(&sender_id, &zmq_msg);
+    MsgType msg_type = MsgBase::get_msg_type(zmq_msg.data());
+    CHECK_EQ(msg_type, kBarrierReply);
+  }
+}
+
+void AbstractBgWorker::AllReduce(void *buf, int32_t count,
+                                 AllReduceDataType data_type,
+                                 AllReduceOp op) {
+  size_t size = count * GetAllReduceDataTypeSize(data_type);
+  {
+    AllReduceMsg all_reduce_msg(size);
+    all_reduce_msg.get_data_type() = data_type;
+    all_reduce_msg.get_op() = op;
+    memcpy(all_reduce_msg.get_data(), buf, size);
+    size_t sent_size = SendMsg(reinterpret_cast<MsgBase*>(&all_reduce_msg));
+    CHECK_EQ(sent_size, all_reduce_msg.get_size());
+  }
+
+  {
+    zmq::message_t zmq_msg;
+    int32_t sender_id;
+    comm_bus_->RecvInProc(&sender_id, &zmq_msg);
+    MsgType msg_type = MsgBase::get_msg_type(zmq_msg.data());
+    CHECK_EQ(msg_type, kAllReduceReply);
+    AllReduceReplyMsg all_reduce_reply_msg(zmq_msg.data());
+    CHECK_EQ(all_reduce_reply_msg.get_avai_size(), size);
+    memcpy(buf, all_reduce_reply_msg.get_data(), size);
+  }
+}
+
 void AbstractBgWorker::InitWhenStart() {
   SetWaitMsg();
   CreateRowRequestOpLogMgr();
@@ -328,6 +405,22 @@ void AbstractBgWorker::HandleCreateTables() {
           = bg_create_table_msg.get_process_storage_type();
       client_table_config.no_oplog_replay
           = bg_create_table_msg.get_no_oplog_replay();
+      client_table_config.table_info.server_storage_type
+          = bg_create_table_msg.get_server_storage_type();
+      client_table_config.table_info.server_storage_capacity
+          = bg_create_table_msg.get_server_storage_capacity();
+      client_table_config.table_info.oplog_index_encoding
+          = bg_create_table_msg.get_oplog_index_encoding();
+      client_table_config.table_info.oplog_value_encoding
+          = bg_create_table_msg.get_oplog_value_encoding();
+      client_table_config.table_info.oplog_compressed
+          = bg_create_table_msg.get_oplog_compressed();
+      client_table_config.table_info.row_partition_type
+          = bg_create_table_msg.get_row_partition_type();
+      client_table_config.table_info.range_partition_num_rows
+          = bg_create_table_msg.get_range_partition_num_rows();
+      client_table_config.table_info.server_update_rule
+          = bg_create_table_msg.get_server_update_rule();
 
       CreateTableMsg create_table_msg;
       create_table_msg.get_table_id() = bg_create_table_msg.get_table_id();
@@ -341,6 +434,22 @@ void AbstractBgWorker::HandleCreateTables() {
           = bg_create_table_msg.get_row_oplog_type();
       create_table_msg.get_dense_row_oplog_capacity()
           = bg_create_table_msg.get_dense_row_oplog_capacity();
+      create_table_msg.get_server_storage_type()
+          = bg_create_table_msg.get_server_storage_type();
+      create_table_msg.get_server_storage_capacity()
+          = bg_create_table_msg.get_server_storage_capacity();
+      create_table_msg.get_oplog_index_encoding()
+          = bg_create_table_msg.get_oplog_index_encoding();
+      create_table_msg.get_oplog_value_encoding()
+          = bg_create_table_msg.get_oplog_value_encoding();
+      create_table_msg.get_oplog_compressed()
+          = bg_create_table_msg.get_oplog_compressed();
+      create_table_msg.get_row_partition_type()
+          = bg_create_table_msg.get_row_partition_type();
+      create_table_msg.get_range_partition_num_rows()
+          = bg_create_table_msg.get_range_partition_num_rows();
+      create_table_msg.get_server_update_rule()
+          = bg_create_table_msg.get_server_update_rule();
 
       table_id = create_table_msg.get_table_id();
 
@@ -362,6 +471,9 @@ void AbstractBgWorker::HandleCreateTables() {
       CreateTableReplyMsg create_table_reply_msg(zmq_msg.data());
       CHECK_EQ(create_table_reply_msg.get_table_id(), table_id);
 
+      GlobalContext::RegisterRowPartitioner(
+          table_id, client_table_config.table_info);
+
       ClientTable *client_table;
       try {
 	client_table  = new ClientTable(table_id, client_table_config);
@@ -371,6 +483,12 @@ void AbstractBgWorker::HandleCreateTables() {
       // not thread-safe
       (*tables_)[table_id] = client_table;
 
+      if (!OpLogCodec::IsRaw(client_table_config.table_info)) {
+        oplog_codec_map_[table_id] = new OpLogCodec(
+            client_table_config.table_info,
+            client_table->get_sample_row()->get_update_size());
+      }
+
       size_t sent_size = comm_bus_->SendInProc(sender_id, zmq_msg.data(),
         zmq_msg.size());
       CHECK_EQ(sent_size, zmq_msg.size());
@@ -388,9 +506,12 @@ void AbstractBgWorker::HandleCreateTables() {
 
 long AbstractBgWorker::HandleClockMsg(bool clock_advanced) {
   STATS_BG_ACCUM_CLOCK_END_OPLOG_SERIALIZE_BEGIN();
-  BgOpLog *bg_oplog = PrepareOpLogsToSend();
-
-  CreateOpLogMsgs(bg_oplog);
+  BgOpLog *bg_oplog;
+  {
+    MetricTimer metric_timer(kMetricBgOpLogSerialize, false);
+    bg_oplog = PrepareOpLogsToSend();
+    CreateOpLogMsgs(bg_oplog);
+  }
   STATS_BG_ACCUM_CLOCK_END_OPLOG_SERIALIZE_END();
 
   clock_has_pushed_ = client_clock_;
@@ -548,6 +669,11 @@ void AbstractBgWorker::FinalizeOpLogMsgStats(
   }
 }
 
+void AbstractBgWorker::HandleServerOpLogAck(int32_t server_id,
+                                            uint32_t ack_version) {
+  row_request_oplog_mgr_->ServerAcknowledgeVersion(server_id, ack_version);
+}
+
 void AbstractBgWorker::CreateOpLogMsgs(const BgOpLog *bg_oplog) {
   std::map<int32_t, std::map<int32_t, void*> > table_server_mem_map;
 
@@ -607,6 +733,77 @@ void AbstractBgWorker::CreateOpLogMsgs(const BgOpLog *bg_oplog) {
           table_pair.second->oplog_dense_serialized());
     }
   }
+
+  if (!oplog_codec_map_.empty())
+    EncodeOpLogMsgs();
+}
+
+void AbstractBgWorker::EncodeOpLogMsgs() {
+  // table id and update size are kept as is
+  const size_t table_header_size = sizeof(int32_t) + sizeof(size_t);
+
+  for (auto &msg_pair : server_oplog_msg_map_) {
+    int32_t server_id = msg_pair.first;
+    ClientSendOpLogMsg *oplog_msg = msg_pair.second;
+    if (oplog_msg == 0)
+      continue;
+
+    const std::map<int32_t, size_t> &table_size_map
+        = server_table_oplog_size_map_[server_id];
+    const uint8_t *oplog_mem = reinterpret_cast<const uint8_t*>(
+        oplog_msg->get_data());
+    int32_t num_tables = *(reinterpret_cast<const int32_t*>(oplog_mem));
+
+    // Encode every table first, so that the encoded message is allocated
+    // once, at a bound on its size, and the codecs write straight into it.
+    size_t max_encoded_size = sizeof(int32_t);
+    const uint8_t *mem = oplog_mem + sizeof(int32_t);
+    for (int32_t i = 0; i < num_tables; ++i) {
+      int32_t table_id = *(reinterpret_cast<const int32_t*>(mem));
+      auto size_iter = table_size_map.find(table_id);
+      CHECK(size_iter != table_size_map.end()) << "table id = " << table_id;
+      mem += table_header_size;
+
+      max_encoded_size += table_header_size;
+      auto codec_iter = oplog_codec_map_.find(table_id);
+      if (codec_iter == oplog_codec_map_.end())
+        max_encoded_size += size_iter->second;
+      else
+        max_encoded_size += codec_iter->second->Encode(mem);
+      mem += size_iter->second;
+    }
+
+    ClientSendOpLogMsg *encoded_msg
+        = new ClientSendOpLogMsg(max_encoded_size);
+    uint8_t *encoded_mem = reinterpret_cast<uint8_t*>(
+        encoded_msg->get_data());
+    uint8_t *encoded = encoded_mem;
+    memcpy(encoded, oplog_mem, sizeof(int32_t));
+    encoded += sizeof(int32_t);
+
+    mem = oplog_mem + sizeof(int32_t);
+    for (int32_t i = 0; i < num_tables; ++i) {
+      int32_t table_id = *(reinterpret_cast<const int32_t*>(mem));
+      size_t table_size = table_size_map.find(table_id)->second;
+      memcpy(encoded, mem, table_header_size);
+      encoded += table_header_size;
+      mem += table_header_size;
+
+      auto codec_iter = oplog_codec_map_.find(table_id);
+      if (codec_iter == oplog_codec_map_.end()) {
+        memcpy(encoded, mem, table_size);
+        encoded += table_size;
+      } else {
+        encoded += codec_iter->second->WriteEncoded(encoded);
+      }
+      mem += table_size;
+    }
+
+    // Only the bytes written are sent.
+    encoded_msg->get_avai_size() = encoded - encoded_mem;
+    delete oplog_msg;
+    msg_pair.second = encoded_msg;
+  }
 }
 
 size_t AbstractBgWorker::SendOpLogMsgs(bool clock_advanced) {
@@ -637,19 +834,20 @@ size_t AbstractBgWorker::SendOpLogMsgs(bool clock_advanced) {
   }
 
   STATS_BG_ADD_PER_CLOCK_OPLOG_SIZE(accum_size);
+  Metrics::AddCounter(kMetricBgOpLogSentBytes, accum_size);
 
   return accum_size;
 }
 
 size_t AbstractBgWorker::CountRowOpLogToSend(
-      int32_t row_id, AbstractRowOpLog *row_oplog,
+      int32_t table_id, int32_t row_id, AbstractRowOpLog *row_oplog,
       std::map<int32_t, size_t> *table_num_bytes_by_server,
       BgOpLogPartition *bg_table_oplog,
       GetSerializedRowOpLogSizeFunc GetSerializedRowOpLogSize) {
 
   // update oplog message size
   int32_t server_id = GlobalContext::GetPartitionServerID(
-      row_id, my_comm_channel_idx_);
+      table_id, row_id, my_comm_channel_idx_);
   // 1) row id
   // 2) serialized row size
   size_t serialized_size = sizeof(int32_t)
@@ -677,6 +875,58 @@ void AbstractBgWorker::CheckForwardRowRequestToServer(
   int32_t clock = row_request_msg.get_clock();
   bool forced = row_request_msg.get_forced_request();
 
+  bool should_be_sent = CheckRowRequest(app_thread_id, table_id, row_id,
+                                        clock, forced);
+
+  if (should_be_sent) {
+    int32_t server_id
+        = GlobalContext::GetPartitionServerID(table_id, row_id,
+                                              my_comm_channel_idx_);
+
+    size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(server_id,
+      row_request_msg.get_mem(), row_request_msg.get_size());
+    CHECK_EQ(sent_size, row_request_msg.get_size());
+  }
+}
+
+void AbstractBgWorker::CheckForwardRowBatchRequestToServer(
+    int32_t app_thread_id, RowBatchRequestMsg &row_batch_request_msg) {
+
+  int32_t table_id = row_batch_request_msg.get_table_id();
+  int32_t clock = row_batch_request_msg.get_clock();
+  int32_t num_rows = row_batch_request_msg.get_num_rows();
+  const int32_t *row_ids = row_batch_request_msg.get_row_ids();
+
+  // server id -> rows to request from that server
+  std::map<int32_t, std::vector<int32_t> > server_row_ids;
+  for (int32_t i = 0; i < num_rows; ++i) {
+    bool should_be_sent = CheckRowRequest(app_thread_id, table_id, row_ids[i],
+                                          clock, false);
+    if (should_be_sent) {
+      int32_t server_id = GlobalContext::GetPartitionServerID(
+          table_id, row_ids[i], my_comm_channel_idx_);
+      server_row_ids[server_id].push_back(row_ids[i]);
+    }
+  }
+
+  for (const auto &server_rows : server_row_ids) {
+    const std::vector<int32_t> &server_row_id_vec = server_rows.second;
+    RowBatchRequestMsg server_request_msg(server_row_id_vec.size());
+    server_request_msg.get_table_id() = table_id;
+    server_request_msg.get_clock() = clock;
+    memcpy(server_request_msg.get_row_ids(), server_row_id_vec.data(),
+           server_row_id_vec.size()*sizeof(int32_t));
+
+    size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(
+        server_rows.first, server_request_msg.get_mem(),
+        server_request_msg.get_size());
+    CHECK_EQ(sent_size, server_request_msg.get_size());
+  }
+}
+
+bool AbstractBgWorker::CheckRowRequest(int32_t app_thread_id,
+                                       int32_t table_id, int32_t row_id,
+                                       int32_t clock, bool forced) {
   if (!forced) {
     // Check if the row exists in process cache
     auto table_iter = tables_->find(table_id);
@@ -697,32 +947,21 @@ void AbstractBgWorker::CheckForwardRowRequestToServer(
               app_thread_id, row_request_reply_msg.get_mem(),
               row_request_reply_msg.get_size());
           CHECK_EQ(sent_size, row_request_reply_msg.get_size());
-          return;
+          return false;
         }
       }
     }
   }
 
-  std::pair<int32_t, int32_t> request_key(table_id, row_id);
   RowRequestInfo row_request;
   row_request.app_thread_id = app_thread_id;
-  row_request.clock = row_request_msg.get_clock();
+  row_request.clock = clock;
 
   // Version in request denotes the update version that the row on server can
   // see. Which should be 1 less than the current version number.
   row_request.version = version_ - 1;
 
-  bool should_be_sent
-    = row_request_oplog_mgr_->AddRowRequest(row_request, table_id, row_id);
-
-  if (should_be_sent) {
-    int32_t server_id
-        = GlobalContext::GetPartitionServerID(row_id, my_comm_channel_idx_);
-
-    size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(server_id,
-      row_request_msg.get_mem(), row_request_msg.get_size());
-    CHECK_EQ(sent_size, row_request_msg.get_size());
-  }
+  return row_request_oplog_mgr_->AddRowRequest(row_request, table_id, row_id);
 }
 
 void AbstractBgWorker::UpdateExistingRow(
@@ -879,7 +1118,7 @@ void AbstractBgWorker::HandleServerRowRequestReply(
     row_request_msg.get_clock() = clock_to_request;
 
     int32_t server_id = GlobalContext::GetPartitionServerID(
-        row_id, my_comm_channel_idx_);
+        table_id, row_id, my_comm_channel_idx_);
 
     size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(server_id,
       row_request_msg.get_mem(), row_request_msg.get_size());
@@ -896,6 +1135,25 @@ void AbstractBgWorker::HandleServerRowRequestReply(
   }
 }
 
+void AbstractBgWorker::ForwardCollectiveToNameNode(int32_t app_thread_id,
+                                                   void *msg_mem,
+                                                   size_t msg_size) {
+  CHECK_EQ(collective_app_thread_id_, -1)
+      << "Only one collective may be in progress";
+  collective_app_thread_id_ = app_thread_id;
+  size_t sent_size = (comm_bus_->*(comm_bus_->SendAny_))(
+      GlobalContext::get_name_node_id(), msg_mem, msg_size);
+  CHECK_EQ(sent_size, msg_size);
+}
+
+void AbstractBgWorker::ReplyCollectiveToApp(void *msg_mem, size_t msg_size) {
+  CHECK_NE(collective_app_thread_id_, -1);
+  size_t sent_size = comm_bus_->SendInProc(collective_app_thread_id_,
+                                           msg_mem, msg_size);
+  CHECK_EQ(sent_size, msg_size);
+  collective_app_thread_id_ = -1;
+}
+
 size_t AbstractBgWorker::SendMsg(MsgBase *msg) {
   size_t sent_size = comm_bus_->SendInProc(my_id_, msg->get_mem(),
                                             msg->get_size());
@@ -1029,6 +1287,13 @@ void *AbstractBgWorker::operator() () {
           CheckForwardRowRequestToServer(sender_id, row_request_msg);
         }
         break;
+      case kRowBatchRequest:
+        {
+          RowBatchRequestMsg row_batch_request_msg(msg_mem);
+          CheckForwardRowBatchRequestToServer(sender_id,
+                                              row_batch_request_msg);
+        }
+        break;
       case kServerRowRequestReply:
         {
           ServerRowRequestReplyMsg server_row_request_reply_msg(msg_mem);
@@ -1055,8 +1320,8 @@ void *AbstractBgWorker::operator() () {
       case kServerOpLogAck:
         {
           ServerOpLogAckMsg server_oplog_ack_msg(msg_mem);
-          row_request_oplog_mgr_->ServerAcknowledgeVersion(
-              sender_id, server_oplog_ack_msg.get_ack_version());
+          HandleServerOpLogAck(sender_id,
+                               server_oplog_ack_msg.get_ack_version());
         }
         break;
       case kBgHandleAppendOpLog:
@@ -1065,6 +1330,32 @@ void *AbstractBgWorker::operator() () {
           HandleAppendOpLogMsg(handle_append_oplog_msg.get_table_id());
         }
         break;
+      case kBarrier:
+        {
+          BarrierMsg barrier_msg(msg_mem);
+          ForwardCollectiveToNameNode(sender_id, msg_mem,
+                                      barrier_msg.get_size());
+        }
+        break;
+      case kAllReduce:
+        {
+          AllReduceMsg all_reduce_msg(msg_mem);
+          ForwardCollectiveToNameNode(sender_id, msg_mem,
+                                      all_reduce_msg.get_size());
+        }
+        break;
+      case kBarrierReply:
+        {
+          BarrierReplyMsg barrier_reply_msg(msg_mem);
+          ReplyCollectiveToApp(msg_mem, barrier_reply_msg.get_size());
+        }
+        break;
+      case kAllReduceReply:
+        {
+          AllReduceReplyMsg all_reduce_reply_msg(msg_mem);
+          ReplyCollectiveToApp(msg_mem, all_reduce_reply_msg.get_size());
+        }
+        break;
       default:
         LOG(FATAL) << "Unrecognized type " << msg_type;
     }
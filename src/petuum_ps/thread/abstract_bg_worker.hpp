@@ -17,6 +17,7 @@
 #include <petuum_ps/client/client_table.hpp>
 #include <petuum_ps/thread/append_only_row_oplog_buffer.hpp>
 #include <petuum_ps/thread/row_oplog_serializer.hpp>
+#include <petuum_ps_common/oplog/oplog_codec.hpp>
 
 namespace petuum {
 class AbstractBgWorker : public Thread {
@@ -38,12 +39,22 @@ public:
   bool RequestRow(int32_t table_id, int32_t row_id, int32_t clock);
   void RequestRowAsync(int32_t table_id, int32_t row_id, int32_t clock,
                        bool forced);
+  // Requests rows that all belong to this bg worker's partition. The app
+  // thread receives one reply per row.
+  void RequestRowBatchAsync(int32_t table_id, const int32_t *row_ids,
+                            int32_t num_rows, int32_t clock);
   void GetAsyncRowRequestReply();
   void SignalHandleAppendOnlyBuffer(int32_t table_id);
 
   void ClockAllTables();
   void SendOpLogsAllTables();
 
+  // Collectives among clients, called on the head bg worker by one app
+  // thread per client. They block until every client has joined.
+  void GlobalBarrier();
+  void AllReduce(void *buf, int32_t count, AllReduceDataType data_type,
+                 AllReduceOp op);
+
   virtual void *operator() ();
 
 protected:
@@ -97,15 +108,19 @@ protected:
 
   virtual BgOpLog *PrepareOpLogsToSend() = 0;
   void CreateOpLogMsgs(const BgOpLog *bg_oplog);
+  // Replaces the oplog msgs with ones where the tables that have a codec
+  // are encoded.
+  void EncodeOpLogMsgs();
   size_t SendOpLogMsgs(bool clock_advanced) ;
 
   size_t CountRowOpLogToSend(
-      int32_t row_id, AbstractRowOpLog *row_oplog,
+      int32_t table_id, int32_t row_id, AbstractRowOpLog *row_oplog,
       std::map<int32_t, size_t> *table_num_bytes_by_server,
       BgOpLogPartition *bg_table_oplog,
       GetSerializedRowOpLogSizeFunc GetSerializedRowOpLogSize);
 
   virtual void TrackBgOpLog(BgOpLog *bg_oplog) = 0;
+  virtual void HandleServerOpLogAck(int32_t server_id, uint32_t ack_version);
 
   void FinalizeOpLogMsgStats(
       int32_t table_id,
@@ -117,6 +132,15 @@ protected:
   /* Handles Row Requests -- BEGIN */
   void CheckForwardRowRequestToServer(int32_t app_thread_id,
                                       RowRequestMsg &row_request_msg);
+  // Requests that are not fulfilled from the process storage are grouped by
+  // server, and each server receives a single batch request.
+  void CheckForwardRowBatchRequestToServer(
+      int32_t app_thread_id, RowBatchRequestMsg &row_batch_request_msg);
+  // Replies to the app thread right away if the row in process storage is
+  // fresh enough. Otherwise registers the request and returns true if it
+  // needs to be sent to the server.
+  bool CheckRowRequest(int32_t app_thread_id, int32_t table_id,
+                       int32_t row_id, int32_t clock, bool forced);
   void HandleServerRowRequestReply(
       int32_t server_id,
       ServerRowRequestReplyMsg &server_row_request_reply_msg);
@@ -129,6 +153,12 @@ protected:
   // Handles server pushed rows
   virtual void HandleServerPushRow(int32_t sender_id, void *msg_mem);
 
+  // Collective messages go from the app thread through the head bg worker
+  // to the name node and back.
+  void ForwardCollectiveToNameNode(int32_t app_thread_id, void *msg_mem,
+                                   size_t msg_size);
+  void ReplyCollectiveToApp(void *msg_mem, size_t msg_size);
+
   /* Helper Functions */
   size_t SendMsg(MsgBase *msg);
   void RecvMsg(zmq::message_t &zmq_msg);
@@ -170,6 +200,12 @@ protected:
   std::unordered_map<int32_t, int32_t> append_only_buff_proc_count_;
 
   std::unordered_map<int32_t, RowOpLogSerializer*> row_oplog_serializer_map_;
+
+  // Only for tables that do not send raw oplogs.
+  std::unordered_map<int32_t, OpLogCodec*> oplog_codec_map_;
+
+  // The app thread waiting for the collective in progress.
+  int32_t collective_app_thread_id_;
 };
 
 }
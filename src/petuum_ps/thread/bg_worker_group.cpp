@@ -71,16 +71,41 @@ void BgWorkerGroup::WaitCreateTable() {
 
 bool BgWorkerGroup::RequestRow(int32_t table_id, int32_t row_id,
                                int32_t clock) {
-  int32_t bg_idx = GlobalContext::GetPartitionCommChannelIndex(row_id);
+  int32_t bg_idx = GlobalContext::GetPartitionCommChannelIndex(table_id,
+                                                               row_id);
   return bg_worker_vec_[bg_idx]->RequestRow(table_id, row_id, clock);
 }
 
 void BgWorkerGroup::RequestRowAsync(int32_t table_id, int32_t row_id,
                                     int32_t clock, bool forced){
-  int32_t bg_idx = GlobalContext::GetPartitionCommChannelIndex(row_id);
+  int32_t bg_idx = GlobalContext::GetPartitionCommChannelIndex(table_id,
+                                                               row_id);
   bg_worker_vec_[bg_idx]->RequestRowAsync(table_id, row_id, clock, forced);
 }
 
+void BgWorkerGroup::RequestRowBatch(int32_t table_id, const int32_t *row_ids,
+                                    int32_t num_rows, int32_t clock) {
+  std::vector<std::vector<int32_t> > bg_row_ids(bg_worker_vec_.size());
+  for (int32_t i = 0; i < num_rows; ++i) {
+    int32_t bg_idx = GlobalContext::GetPartitionCommChannelIndex(table_id,
+                                                                 row_ids[i]);
+    bg_row_ids[bg_idx].push_back(row_ids[i]);
+  }
+
+  for (size_t bg_idx = 0; bg_idx < bg_worker_vec_.size(); ++bg_idx) {
+    if (bg_row_ids[bg_idx].empty())
+      continue;
+    bg_worker_vec_[bg_idx]->RequestRowBatchAsync(
+        table_id, bg_row_ids[bg_idx].data(), bg_row_ids[bg_idx].size(),
+        clock);
+  }
+
+  // One reply per row, in whatever order the rows arrive.
+  for (int32_t i = 0; i < num_rows; ++i) {
+    GetAsyncRowRequestReply();
+  }
+}
+
 void BgWorkerGroup::GetAsyncRowRequestReply() {
   zmq::message_t zmq_msg;
   int32_t sender_id;
@@ -106,6 +131,15 @@ void BgWorkerGroup::SendOpLogsAllTables() {
   }
 }
 
+void BgWorkerGroup::GlobalBarrier() {
+  bg_worker_vec_[0]->GlobalBarrier();
+}
+
+void BgWorkerGroup::AllReduce(void *buf, int32_t count,
+                              AllReduceDataType data_type, AllReduceOp op) {
+  bg_worker_vec_[0]->AllReduce(buf, count, data_type, op);
+}
+
 // not used
 int32_t BgWorkerGroup::GetSystemClock() {
   LOG(FATAL) << "Not supported function";
@@ -24,12 +24,18 @@ public:
   bool RequestRow(int32_t table_id, int32_t row_id, int32_t clock);
   void RequestRowAsync(int32_t table_id, int32_t row_id, int32_t clock,
                        bool forced);
+  void RequestRowBatch(int32_t table_id, const int32_t *row_ids,
+                       int32_t num_rows, int32_t clock);
   void GetAsyncRowRequestReply();
   void SignalHandleAppendOnlyBuffer(int32_t table_id, int32_t channel_idx);
 
   void ClockAllTables();
   void SendOpLogsAllTables();
 
+  void GlobalBarrier();
+  void AllReduce(void *buf, int32_t count, AllReduceDataType data_type,
+                 AllReduceOp op);
+
   virtual int32_t GetSystemClock();
   virtual void WaitSystemClock(int32_t my_clock);
 
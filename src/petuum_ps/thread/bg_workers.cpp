@@ -2,6 +2,7 @@
 #include <petuum_ps_common/include/configs.hpp>
 #include <petuum_ps/thread/bg_worker_group.hpp>
 #include <petuum_ps/thread/ssp_push_bg_worker_group.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 
 namespace petuum {
 BgWorkerGroup *BgWorkers::bg_worker_group_;
@@ -45,7 +46,11 @@ void BgWorkers::WaitCreateTable() {
 }
 
 bool BgWorkers::RequestRow(int32_t table_id, int32_t row_id, int32_t clock) {
-  return bg_worker_group_->RequestRow(table_id, row_id, clock);
+  MetricTimer metric_timer(kMetricAppRowFetch, false);
+  Metrics::AddGauge(kMetricAppRowFetchesInFlight, 1);
+  bool found = bg_worker_group_->RequestRow(table_id, row_id, clock);
+  Metrics::AddGauge(kMetricAppRowFetchesInFlight, -1);
+  return found;
 }
 
 void BgWorkers::RequestRowAsync(int32_t table_id, int32_t row_id,
@@ -53,6 +58,14 @@ void BgWorkers::RequestRowAsync(int32_t table_id, int32_t row_id,
   return bg_worker_group_->RequestRowAsync(table_id, row_id, clock, forced);
 }
 
+void BgWorkers::RequestRowBatch(int32_t table_id, const int32_t *row_ids,
+                                int32_t num_rows, int32_t clock) {
+  MetricTimer metric_timer(kMetricAppRowFetch, false);
+  Metrics::AddGauge(kMetricAppRowFetchesInFlight, num_rows);
+  bg_worker_group_->RequestRowBatch(table_id, row_ids, num_rows, clock);
+  Metrics::AddGauge(kMetricAppRowFetchesInFlight, -num_rows);
+}
+
 void BgWorkers::GetAsyncRowRequestReply() {
   return bg_worker_group_->GetAsyncRowRequestReply();
 }
@@ -70,6 +83,15 @@ void BgWorkers::SendOpLogsAllTables() {
   bg_worker_group_->SendOpLogsAllTables();
 }
 
+void BgWorkers::GlobalBarrier() {
+  bg_worker_group_->GlobalBarrier();
+}
+
+void BgWorkers::AllReduce(void *buf, int32_t count,
+                          AllReduceDataType data_type, AllReduceOp op) {
+  bg_worker_group_->AllReduce(buf, count, data_type, op);
+}
+
 int32_t BgWorkers::GetSystemClock() {
   return bg_worker_group_->GetSystemClock();
 }
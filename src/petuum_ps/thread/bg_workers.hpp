@@ -23,11 +23,25 @@ public:
   // it exists in the process storage and clock is fresh enough.
   static void RequestRowAsync(int32_t table_id, int32_t row_id, int32_t clock,
                               bool forced);
+  // Requests a batch of rows of a table and blocks until all of them are
+  // in the process storage with clock no less than the given one. Rows are
+  // batched per bg worker and then per server, so the whole batch takes one
+  // round trip. Must not be called while async gets are pending.
+  static void RequestRowBatch(int32_t table_id, const int32_t *row_ids,
+                              int32_t num_rows, int32_t clock);
   static void GetAsyncRowRequestReply();
   static void SignalHandleAppendOnlyBuffer(int32_t table_id, int32_t channel_idx);
   static void ClockAllTables();
   static void SendOpLogsAllTables();
 
+  // Blocks until one app thread of every client has called it. Must not be
+  // called while async gets are pending.
+  static void GlobalBarrier();
+  // Reduces buf across clients with the same restrictions as
+  // GlobalBarrier().
+  static void AllReduce(void *buf, int32_t count,
+                        AllReduceDataType data_type, AllReduceOp op);
+
   static int32_t GetSystemClock();
   static void WaitSystemClock(int32_t my_clock);
 
@@ -52,6 +52,8 @@ double GlobalContext::bandwidth_mbps_;
 
 size_t GlobalContext::oplog_push_upper_bound_kb_;
 
+bool GlobalContext::adaptive_oplog_push_;
+
 int32_t GlobalContext::oplog_push_staleness_tolerance_;
 
 size_t GlobalContext::thread_oplog_batch_size_;
@@ -62,4 +64,31 @@ long GlobalContext::server_idle_milli_;
 
 int32_t GlobalContext::server_row_candidate_factor_;
 
+std::mutex GlobalContext::row_partitioners_mtx_;
+
+namespace {
+// Published until the first table registers its partitioner.
+const std::map<int32_t, RowPartitioner*> kNoRowPartitioners;
+}  // anonymous namespace
+
+std::atomic<const GlobalContext::RowPartitionerMap*>
+GlobalContext::row_partitioners_(&kNoRowPartitioners);
+
+std::vector<std::unique_ptr<GlobalContext::RowPartitionerMap> >
+GlobalContext::row_partitioner_maps_;
+
+void GlobalContext::RegisterRowPartitioner(int32_t table_id,
+                                           const TableInfo &table_info) {
+  std::lock_guard<std::mutex> lock(row_partitioners_mtx_);
+  const RowPartitionerMap *row_partitioners = row_partitioners_.load();
+  if (row_partitioners->count(table_id) > 0)
+    return;
+  RowPartitionerMap *new_row_partitioners
+      = new RowPartitionerMap(*row_partitioners);
+  (*new_row_partitioners)[table_id] = new RowPartitioner(
+      table_id, table_info, num_clients_, num_comm_channels_per_client_);
+  row_partitioner_maps_.emplace_back(new_row_partitioners);
+  row_partitioners_.store(new_row_partitioners, std::memory_order_release);
+}
+
 }   // namespace petuum
@@ -4,6 +4,10 @@
 
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <glog/logging.h>
 #include <boost/utility.hpp>
 
@@ -12,6 +16,7 @@
 #include <petuum_ps_common/comm_bus/comm_bus.hpp>
 #include <petuum_ps_common/include/configs.hpp>
 #include <petuum_ps_common/util/vector_clock_mt.hpp>
+#include <petuum_ps/thread/row_partitioner.hpp>
 
 namespace petuum {
 
@@ -44,18 +49,36 @@ public:
     thr_info_->cached_system_clock_ = system_clock;
   }
 
+  // Reads accept no row older than the clock of the thread's last
+  // GlobalBarrier, whatever the table staleness.
+  static int32_t get_barrier_clock() {
+    return thr_info_->barrier_clock_;
+  }
+
+  static void set_barrier_clock(int32_t barrier_clock) {
+    thr_info_->barrier_clock_ = barrier_clock;
+  }
+
+  // The oldest row clock a read at the thread's clock may return.
+  static int32_t GetStalestClock(int32_t staleness) {
+    return std::max(thr_info_->barrier_clock_,
+                    thr_info_->clock_ - staleness);
+  }
+
 private:
   struct Info : boost::noncopyable {
     explicit Info(int32_t entity_id):
         entity_id_(entity_id),
         clock_(0),
-        cached_system_clock_(0) { }
+        cached_system_clock_(0),
+        barrier_clock_(0) { }
 
     ~Info(){ }
 
     const int32_t entity_id_;
     int32_t clock_;
     int32_t cached_system_clock_;
+    int32_t barrier_clock_;
   };
 
   // We do not use thread_local here because there's a bug in
@@ -149,6 +172,7 @@ public:
       long bg_idle_milli,
       double bandwidth_mbps,
       size_t oplog_push_upper_bound_kb,
+      bool adaptive_oplog_push,
       int32_t oplog_push_staleness_tolerance,
       size_t thread_oplog_batch_size,
       size_t server_push_row_threshold,
@@ -182,6 +206,7 @@ public:
 
     bandwidth_mbps_ = bandwidth_mbps;
     oplog_push_upper_bound_kb_ = oplog_push_upper_bound_kb;
+    adaptive_oplog_push_ = adaptive_oplog_push;
     oplog_push_staleness_tolerance_ = oplog_push_staleness_tolerance;
     thread_oplog_batch_size_ = thread_oplog_batch_size;
 
@@ -278,18 +303,42 @@ public:
     return client_id_;
   }
 
-  static int32_t GetPartitionCommChannelIndex(int32_t row_id) {
-    return row_id % num_comm_channels_per_client_;
+  // Called when a table is created, on the client before its bg threads
+  // create it and on the server before it stores any row. Calling it again
+  // for the same table has no effect.
+  static void RegisterRowPartitioner(int32_t table_id,
+                                     const TableInfo &table_info);
+
+  // Takes no lock. A bg or server thread may still register a table while
+  // others look up tables they have created, so registering copies the map
+  // and publishes the copy; a map is never modified once published.
+  static const RowPartitioner &GetRowPartitioner(int32_t table_id) {
+    const RowPartitionerMap *row_partitioners
+        = row_partitioners_.load(std::memory_order_acquire);
+    auto iter = row_partitioners->find(table_id);
+    CHECK(iter != row_partitioners->end())
+        << "No row partitioner for table " << table_id;
+    return *(iter->second);
+  }
+
+  static int32_t GetPartitionCommChannelIndex(int32_t table_id,
+                                              int32_t row_id) {
+    return GetRowPartitioner(table_id).GetCommChannelIndex(row_id);
   }
 
   // get the id of the server who is responsible for holding that row
-  static int32_t GetPartitionClientID(int32_t row_id) {
-    return (row_id / num_comm_channels_per_client_) % num_clients_;
+  static int32_t GetPartitionClientID(int32_t table_id, int32_t row_id) {
+    return GetRowPartitioner(table_id).GetClientID(row_id);
+  }
+
+  // Rows held by the same server are numbered contiguously from 0.
+  static int32_t GetPartitionLocalIndex(int32_t table_id, int32_t row_id) {
+    return GetRowPartitioner(table_id).GetLocalIndex(row_id);
   }
 
-  static int32_t GetPartitionServerID(int32_t row_id,
+  static int32_t GetPartitionServerID(int32_t table_id, int32_t row_id,
                                       int32_t comm_channel_idx) {
-    int32_t client_id = GetPartitionClientID(row_id);
+    int32_t client_id = GetPartitionClientID(table_id, row_id);
     return get_server_thread_id(client_id, comm_channel_idx);
   }
 
@@ -361,6 +410,10 @@ public:
     return oplog_push_upper_bound_kb_;
   }
 
+  static bool get_adaptive_oplog_push() {
+    return adaptive_oplog_push_;
+  }
+
   static int32_t get_oplog_push_staleness_tolerance() {
     return oplog_push_staleness_tolerance_;
   }
@@ -422,6 +475,7 @@ private:
 
   static double bandwidth_mbps_;
   static size_t oplog_push_upper_bound_kb_;
+  static bool adaptive_oplog_push_;
   static int32_t oplog_push_staleness_tolerance_;
 
   static size_t thread_oplog_batch_size_;
@@ -432,6 +486,15 @@ private:
   static long server_idle_milli_;
 
   static int32_t server_row_candidate_factor_;
+
+  typedef std::map<int32_t, RowPartitioner*> RowPartitionerMap;
+
+  static std::mutex row_partitioners_mtx_;
+  static std::atomic<const RowPartitionerMap*> row_partitioners_;
+  // The maps RegisterRowPartitioner() published. Replaced ones are kept, as
+  // readers may still be using them; there is one per table created.
+  static std::vector<std::unique_ptr<RowPartitionerMap> >
+  row_partitioner_maps_;
 };
 
 }   // namespace petuum
@@ -0,0 +1,121 @@
+#include <petuum_ps/thread/oplog_push_controller.hpp>
+#include <petuum_ps_common/include/constants.hpp>
+#include <petuum_ps_common/util/stats.hpp>
+#include <algorithm>
+
+namespace petuum {
+
+const double OpLogPushController::kBandwidthWeight = 0.25;
+const double OpLogPushController::kCongestionRttRatio = 1.5;
+const double OpLogPushController::kDecreaseFactor = 0.5;
+
+OpLogPushController::OpLogPushController(double init_bandwidth_mbps,
+                                         size_t init_push_bytes):
+    init_bandwidth_mbps_(init_bandwidth_mbps),
+    init_push_bytes_(init_push_bytes),
+    min_push_bytes_(std::max(init_push_bytes / kPushBytesRange, k1_Ki)),
+    max_push_bytes_(std::max(init_push_bytes * kPushBytesRange, k1_Ki)),
+    push_bytes_step_(std::max(init_push_bytes / 8, k1_Ki)) { }
+
+OpLogPushController::ServerState &OpLogPushController::GetServerState(
+    int32_t server_id) {
+  auto state_iter = server_states_.find(server_id);
+  if (state_iter == server_states_.end()) {
+    ServerState &state = server_states_[server_id];
+    state.bandwidth_mbps = init_bandwidth_mbps_;
+    state.push_bytes = init_push_bytes_;
+    state.min_rtt_sec = 0;
+    state.window_min_rtt_sec = 0;
+    state.num_window_samples = 0;
+    state.recover_version = 0;
+    state.recovering = false;
+    return state;
+  }
+  return state_iter->second;
+}
+
+void OpLogPushController::OnSend(int32_t server_id, uint32_t version,
+                                 size_t num_bytes) {
+  ServerState &state = GetServerState(server_id);
+  if (state.in_flight.size() >= kMaxNumInFlight)
+    state.in_flight.pop_front();
+  InFlightMsg msg;
+  msg.version = version;
+  msg.num_bytes = num_bytes;
+  msg.send_sec = timer_.elapsed();
+  state.in_flight.push_back(msg);
+}
+
+void OpLogPushController::OnAck(int32_t server_id, uint32_t ack_version) {
+  ServerState &state = GetServerState(server_id);
+  // Versions wrap around; compare by difference.
+  while (!state.in_flight.empty()
+         && int32_t(state.in_flight.front().version - ack_version) < 0)
+    state.in_flight.pop_front();
+  if (state.in_flight.empty()
+      || state.in_flight.front().version != ack_version)
+    return;
+
+  InFlightMsg msg = state.in_flight.front();
+  state.in_flight.pop_front();
+  double rtt_sec = std::max(timer_.elapsed() - msg.send_sec, 1e-6);
+
+  if (msg.num_bytes >= kMinRateSampleBytes) {
+    double sample_mbps = msg.num_bytes * kNumBitsPerByte / rtt_sec
+                         / (kOneThousand * kOneThousand);
+    state.bandwidth_mbps = (1 - kBandwidthWeight) * state.bandwidth_mbps
+                           + kBandwidthWeight * sample_mbps;
+  }
+
+  if (state.num_window_samples == 0
+      || rtt_sec < state.window_min_rtt_sec)
+    state.window_min_rtt_sec = rtt_sec;
+  if (state.min_rtt_sec == 0 || rtt_sec < state.min_rtt_sec)
+    state.min_rtt_sec = rtt_sec;
+  if (++state.num_window_samples == kMinRttWindow) {
+    state.min_rtt_sec = state.window_min_rtt_sec;
+    state.num_window_samples = 0;
+  }
+
+  if (state.recovering
+      && int32_t(ack_version - state.recover_version) > 0)
+    state.recovering = false;
+
+  if (rtt_sec > state.min_rtt_sec * kCongestionRttRatio) {
+    if (!state.recovering) {
+      state.push_bytes = std::max(
+          size_t(state.push_bytes * kDecreaseFactor), min_push_bytes_);
+      state.recovering = true;
+      state.recover_version = state.in_flight.empty() ?
+                              ack_version : state.in_flight.back().version;
+    }
+  } else {
+    state.push_bytes = std::min(state.push_bytes + push_bytes_step_,
+                                max_push_bytes_);
+  }
+
+  STATS_BG_OPLOG_PUSH_ADJUST(state.bandwidth_mbps, state.push_bytes,
+                             rtt_sec);
+}
+
+size_t OpLogPushController::get_push_bytes(int32_t server_id) const {
+  auto state_iter = server_states_.find(server_id);
+  if (state_iter == server_states_.end())
+    return init_push_bytes_;
+  return state_iter->second.push_bytes;
+}
+
+double OpLogPushController::get_bandwidth_mbps(int32_t server_id) const {
+  auto state_iter = server_states_.find(server_id);
+  if (state_iter == server_states_.end())
+    return init_bandwidth_mbps_;
+  return state_iter->second.bandwidth_mbps;
+}
+
+double OpLogPushController::EstimateTransMillisec(int32_t server_id,
+                                                  size_t num_bytes) const {
+  return (num_bytes * kNumBitsPerByte)
+      / get_bandwidth_mbps(server_id) / kOneThousand;
+}
+
+}  // namespace petuum
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <boost/noncopyable.hpp>
+#include <map>
+#include <deque>
+#include <stdint.h>
+
+namespace petuum {
+
+// Sizes and paces the oplog pushes of one bg worker to each server, from
+// the round trip between sending an oplog message and the server's ack of
+// its version.
+//
+// The send rate to a server is a moving average of the bytes delivered per
+// round trip. The push size grows additively while the round trip stays
+// close to the smallest one recently seen, and is halved, at most once per
+// round trip, when it grows past that, i.e. when messages start to queue.
+// Both start from the configured bandwidth_mbps and
+// oplog_push_upper_bound_kb.
+class OpLogPushController : boost::noncopyable {
+public:
+  OpLogPushController(double init_bandwidth_mbps, size_t init_push_bytes);
+
+  void OnSend(int32_t server_id, uint32_t version, size_t num_bytes);
+  // ack_version is the latest version the server has applied. Versions
+  // sent along with a clock tick are not always acked.
+  void OnAck(int32_t server_id, uint32_t ack_version);
+
+  size_t get_push_bytes(int32_t server_id) const;
+  double get_bandwidth_mbps(int32_t server_id) const;
+
+  double EstimateTransMillisec(int32_t server_id, size_t num_bytes) const;
+
+private:
+  struct InFlightMsg {
+    uint32_t version;
+    size_t num_bytes;
+    double send_sec;
+  };
+
+  struct ServerState {
+    double bandwidth_mbps;
+    size_t push_bytes;
+    double min_rtt_sec;
+    double window_min_rtt_sec;
+    int32_t num_window_samples;
+    // No further decrease until the messages in flight at the last
+    // decrease are acked.
+    uint32_t recover_version;
+    bool recovering;
+    std::deque<InFlightMsg> in_flight;
+  };
+
+  ServerState &GetServerState(int32_t server_id);
+
+  // Messages smaller than this do not measure bandwidth.
+  static const size_t kMinRateSampleBytes = 4 * 1024;
+  static const size_t kMaxNumInFlight = 1024;
+  // The smallest round trip is taken over this many acks.
+  static const int32_t kMinRttWindow = 256;
+  static const double kBandwidthWeight;
+  static const double kCongestionRttRatio;
+  static const double kDecreaseFactor;
+  // Push size bounds, relative to the initial push size.
+  static const size_t kPushBytesRange = 16;
+
+  const double init_bandwidth_mbps_;
+  const size_t init_push_bytes_;
+  const size_t min_push_bytes_;
+  const size_t max_push_bytes_;
+  const size_t push_bytes_step_;
+
+  std::map<int32_t, ServerState> server_states_;
+  HighResolutionTimer timer_;
+};
+
+}  // namespace petuum
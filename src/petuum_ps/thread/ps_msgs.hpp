@@ -5,6 +5,7 @@
 
 #include <petuum_ps_common/thread/msg_base.hpp>
 #include <petuum_ps_common/include/configs.hpp>
+#include <petuum_ps_common/util/all_reduce.hpp>
 
 namespace petuum {
 
@@ -116,7 +117,11 @@ public:
         + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
         + sizeof(size_t)  + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
         + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
-        + sizeof(ProcessStorageType) + sizeof(bool);
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) + sizeof(RowPartitionType) + sizeof(int32_t)
+        + sizeof(ServerUpdateRuleConfig);
   }
 
   int32_t &get_table_id() {
@@ -250,6 +255,109 @@ public:
         + sizeof(ProcessStorageType) ));
   }
 
+  ServerStorageType &get_server_storage_type() {
+    return *(reinterpret_cast<ServerStorageType*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool) ));
+  }
+
+  size_t &get_server_storage_capacity() {
+    return *(reinterpret_cast<size_t*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) ));
+  }
+
+  OpLogIndexEncoding &get_oplog_index_encoding() {
+    return *(reinterpret_cast<OpLogIndexEncoding*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t) ));
+  }
+
+  OpLogValueEncoding &get_oplog_value_encoding() {
+    return *(reinterpret_cast<OpLogValueEncoding*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) ));
+  }
+
+  bool &get_oplog_compressed() {
+    return *(reinterpret_cast<bool*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding) ));
+  }
+
+  RowPartitionType &get_row_partition_type() {
+    return *(reinterpret_cast<RowPartitionType*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) ));
+  }
+
+  int32_t &get_range_partition_num_rows() {
+    return *(reinterpret_cast<int32_t*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) + sizeof(RowPartitionType) ));
+  }
+
+  ServerUpdateRuleConfig &get_server_update_rule() {
+    return *(reinterpret_cast<ServerUpdateRuleConfig*>(
+        mem_.get_mem()
+        + NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(int32_t) + sizeof(size_t) + sizeof(size_t)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(OpLogType) +sizeof(AppendOnlyOpLogType)
+        + sizeof(size_t) + sizeof(size_t) + sizeof(int32_t)
+        + sizeof(ProcessStorageType) + sizeof(bool)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) + sizeof(RowPartitionType) + sizeof(int32_t) ));
+  }
+
 protected:
   void InitMsg() {
     NumberedMsg::InitMsg();
@@ -278,7 +386,11 @@ public:
   size_t get_size() {
     return NumberedMsg::get_size() + sizeof(int32_t) + sizeof(int32_t)
         + sizeof(int32_t) + sizeof(size_t)
-        + sizeof(bool) + sizeof(int32_t) + sizeof(size_t);
+        + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) + sizeof(RowPartitionType) + sizeof(int32_t)
+        + sizeof(ServerUpdateRuleConfig);
   }
 
   int32_t &get_table_id() {
@@ -322,6 +434,77 @@ public:
         + sizeof(size_t) + sizeof(bool) + sizeof(int32_t)));
   }
 
+  ServerStorageType &get_server_storage_type() {
+    return *(reinterpret_cast<ServerStorageType*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)));
+  }
+
+  size_t &get_server_storage_capacity() {
+    return *(reinterpret_cast<size_t*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType)));
+  }
+
+  OpLogIndexEncoding &get_oplog_index_encoding() {
+    return *(reinterpret_cast<OpLogIndexEncoding*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)));
+  }
+
+  OpLogValueEncoding &get_oplog_value_encoding() {
+    return *(reinterpret_cast<OpLogValueEncoding*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding)));
+  }
+
+  bool &get_oplog_compressed() {
+    return *(reinterpret_cast<bool*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)));
+  }
+
+  RowPartitionType &get_row_partition_type() {
+    return *(reinterpret_cast<RowPartitionType*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool)));
+  }
+
+  int32_t &get_range_partition_num_rows() {
+    return *(reinterpret_cast<int32_t*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) + sizeof(RowPartitionType)));
+  }
+
+  ServerUpdateRuleConfig &get_server_update_rule() {
+    return *(reinterpret_cast<ServerUpdateRuleConfig*>(
+        mem_.get_mem() + NumberedMsg::get_size()
+        + sizeof(int32_t) + sizeof(int32_t) + sizeof(int32_t)
+        + sizeof(size_t) + sizeof(bool) + sizeof(int32_t) + sizeof(size_t)
+        + sizeof(ServerStorageType) + sizeof(size_t)
+        + sizeof(OpLogIndexEncoding) + sizeof(OpLogValueEncoding)
+        + sizeof(bool) + sizeof(RowPartitionType) + sizeof(int32_t)));
+  }
+
 protected:
   void InitMsg() {
     NumberedMsg::InitMsg();
@@ -677,6 +860,56 @@ protected:
   }
 };
 
+struct BarrierMsg : public NumberedMsg {
+public:
+  BarrierMsg() {
+    if (get_size() > PETUUM_MSG_STACK_BUFF_SIZE) {
+       own_mem_ = true;
+       use_stack_buff_ = false;
+       mem_.Alloc(get_size());
+    } else {
+      own_mem_ = false;
+      use_stack_buff_ = true;
+      mem_.Reset(stack_buff_);
+    }
+    InitMsg();
+  }
+
+  explicit BarrierMsg(void *msg):
+    NumberedMsg(msg) {}
+
+protected:
+  void InitMsg() {
+    NumberedMsg::InitMsg();
+    get_msg_type() = kBarrier;
+  }
+};
+
+struct BarrierReplyMsg : public NumberedMsg {
+public:
+  BarrierReplyMsg() {
+    if (get_size() > PETUUM_MSG_STACK_BUFF_SIZE) {
+       own_mem_ = true;
+       use_stack_buff_ = false;
+       mem_.Alloc(get_size());
+    } else {
+      own_mem_ = false;
+      use_stack_buff_ = true;
+      mem_.Reset(stack_buff_);
+    }
+    InitMsg();
+  }
+
+  explicit BarrierReplyMsg(void *msg):
+    NumberedMsg(msg) {}
+
+protected:
+  void InitMsg() {
+    NumberedMsg::InitMsg();
+    get_msg_type() = kBarrierReply;
+  }
+};
+
 struct BgHandleAppendOpLogMsg : public NumberedMsg {
 public:
   BgHandleAppendOpLogMsg() {
@@ -770,6 +1003,138 @@ protected:
   }
 };
 
+// Requests a batch of rows of the same table with the same clock. Sent by an
+// app thread to a bg worker and by a bg worker to a server. The row ids
+// follow the header.
+struct RowBatchRequestMsg : public ArbitrarySizedMsg {
+public:
+  explicit RowBatchRequestMsg(int32_t num_rows) {
+    own_mem_ = true;
+    mem_.Alloc(get_header_size() + num_rows*sizeof(int32_t));
+    InitMsg(num_rows*sizeof(int32_t));
+  }
+
+  explicit RowBatchRequestMsg(void *msg):
+    ArbitrarySizedMsg(msg) {}
+
+  size_t get_header_size() {
+    return ArbitrarySizedMsg::get_header_size() + sizeof(int32_t)
+        + sizeof(int32_t);
+  }
+
+  int32_t &get_table_id() {
+    return *(reinterpret_cast<int32_t*>(mem_.get_mem()
+      + ArbitrarySizedMsg::get_header_size()));
+  }
+
+  int32_t &get_clock() {
+    return *(reinterpret_cast<int32_t*>(mem_.get_mem()
+      + ArbitrarySizedMsg::get_header_size() + sizeof(int32_t)));
+  }
+
+  int32_t get_num_rows() {
+    return get_avai_size() / sizeof(int32_t);
+  }
+
+  int32_t *get_row_ids() {
+    return reinterpret_cast<int32_t*>(mem_.get_mem() + get_header_size());
+  }
+
+  size_t get_size() {
+    return get_header_size() + get_avai_size();
+  }
+
+protected:
+  virtual void InitMsg(int32_t avai_size) {
+    ArbitrarySizedMsg::InitMsg(avai_size);
+    get_msg_type() = kRowBatchRequest;
+  }
+};
+
+// An all-reduce buffer; data holds avai_size bytes of elements of
+// data_type.
+struct AllReduceMsg : public ArbitrarySizedMsg {
+public:
+  explicit AllReduceMsg(int32_t avai_size) {
+    own_mem_ = true;
+    mem_.Alloc(get_header_size() + avai_size);
+    InitMsg(avai_size);
+  }
+
+  explicit AllReduceMsg(void *msg):
+    ArbitrarySizedMsg(msg) {}
+
+  size_t get_header_size() {
+    return ArbitrarySizedMsg::get_header_size() + sizeof(AllReduceDataType)
+        + sizeof(AllReduceOp);
+  }
+
+  AllReduceDataType &get_data_type() {
+    return *(reinterpret_cast<AllReduceDataType*>(mem_.get_mem()
+      + ArbitrarySizedMsg::get_header_size()));
+  }
+
+  AllReduceOp &get_op() {
+    return *(reinterpret_cast<AllReduceOp*>(mem_.get_mem()
+      + ArbitrarySizedMsg::get_header_size() + sizeof(AllReduceDataType)));
+  }
+
+  void *get_data() {
+    return mem_.get_mem() + get_header_size();
+  }
+
+  size_t get_size() {
+    return get_header_size() + get_avai_size();
+  }
+
+protected:
+  virtual void InitMsg(int32_t avai_size) {
+    ArbitrarySizedMsg::InitMsg(avai_size);
+    get_msg_type() = kAllReduce;
+  }
+};
+
+struct AllReduceReplyMsg : public ArbitrarySizedMsg {
+public:
+  explicit AllReduceReplyMsg(int32_t avai_size) {
+    own_mem_ = true;
+    mem_.Alloc(get_header_size() + avai_size);
+    InitMsg(avai_size);
+  }
+
+  explicit AllReduceReplyMsg(void *msg):
+    ArbitrarySizedMsg(msg) {}
+
+  size_t get_header_size() {
+    return ArbitrarySizedMsg::get_header_size() + sizeof(AllReduceDataType)
+        + sizeof(AllReduceOp);
+  }
+
+  AllReduceDataType &get_data_type() {
+    return *(reinterpret_cast<AllReduceDataType*>(mem_.get_mem()
+      + ArbitrarySizedMsg::get_header_size()));
+  }
+
+  AllReduceOp &get_op() {
+    return *(reinterpret_cast<AllReduceOp*>(mem_.get_mem()
+      + ArbitrarySizedMsg::get_header_size() + sizeof(AllReduceDataType)));
+  }
+
+  void *get_data() {
+    return mem_.get_mem() + get_header_size();
+  }
+
+  size_t get_size() {
+    return get_header_size() + get_avai_size();
+  }
+
+protected:
+  virtual void InitMsg(int32_t avai_size) {
+    ArbitrarySizedMsg::InitMsg(avai_size);
+    get_msg_type() = kAllReduceReply;
+  }
+};
+
 struct ClientSendOpLogMsg : public ArbitrarySizedMsg {
 public:
   explicit ClientSendOpLogMsg(int32_t avai_size) {
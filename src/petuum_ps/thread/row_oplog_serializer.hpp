@@ -78,8 +78,9 @@ private:
 
 class RowOpLogSerializer : boost::noncopyable {
 public:
-  RowOpLogSerializer(bool dense_serialize,
+  RowOpLogSerializer(int32_t table_id, bool dense_serialize,
                      int32_t my_comm_channel_idx):
+      partitioner_(GlobalContext::GetRowPartitioner(table_id)),
       dense_serialize_(dense_serialize),
       my_comm_channel_idx_(my_comm_channel_idx) { }
 
@@ -89,8 +90,8 @@ public:
 
   size_t AppendRowOpLog(int32_t row_id, AbstractRowOpLog *row_oplog) {
 
-    int32_t server_id = GlobalContext::GetPartitionServerID(
-        row_id, my_comm_channel_idx_);
+    int32_t server_id = GlobalContext::get_server_thread_id(
+        partitioner_.GetClientID(row_id), my_comm_channel_idx_);
 
     auto map_iter = buffer_map_.find(server_id);
 
@@ -152,6 +153,7 @@ public:
   }
 
 private:
+  const RowPartitioner &partitioner_;
   const bool dense_serialize_;
   const int32_t my_comm_channel_idx_;
   std::unordered_map<int32_t, std::vector<SerializedOpLogBuffer*> >
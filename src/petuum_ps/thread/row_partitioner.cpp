@@ -0,0 +1,97 @@
+#include <petuum_ps/thread/row_partitioner.hpp>
+#include <glog/logging.h>
+#include <algorithm>
+#include <limits>
+
+namespace petuum {
+
+namespace {
+
+// splitmix64 finalizer.
+uint64_t Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+}  // anonymous namespace
+
+RowPartitioner::RowPartitioner(int32_t table_id, const TableInfo &table_info,
+                               int32_t num_clients,
+                               int32_t num_comm_channels_per_client):
+    table_id_(table_id),
+    type_(table_info.row_partition_type),
+    num_comm_channels_per_client_(num_comm_channels_per_client),
+    num_partitions_(num_clients * num_comm_channels_per_client),
+    range_size_(0),
+    GetLocalIndexFunc_(0) {
+  CHECK_GT(num_partitions_, 0);
+
+  switch (type_) {
+    case ModuloPartition:
+      GetPartitionFunc_ = &RowPartitioner::GetPartitionModulo;
+      GetLocalIndexFunc_ = &RowPartitioner::GetLocalIndexModulo;
+      break;
+    case HashPartition:
+      GetPartitionFunc_ = &RowPartitioner::GetPartitionHash;
+      break;
+    case RangePartition:
+      CHECK_GT(table_info.range_partition_num_rows, 0)
+          << "RangePartition of table " << table_id
+          << " requires range_partition_num_rows";
+      range_size_ = (table_info.range_partition_num_rows + num_partitions_ - 1)
+                    / num_partitions_;
+      GetPartitionFunc_ = &RowPartitioner::GetPartitionRange;
+      GetLocalIndexFunc_ = &RowPartitioner::GetLocalIndexRange;
+      break;
+    case ConsistentHashPartition:
+      ring_.reserve(num_partitions_ * kNumVirtualNodes);
+      for (int32_t p = 0; p < num_partitions_; ++p) {
+        for (int32_t v = 0; v < kNumVirtualNodes; ++v) {
+          uint64_t point = Mix(Mix((uint64_t(uint32_t(table_id)) << 32)
+                                   | uint32_t(p)) + v);
+          ring_.push_back(std::make_pair(point, p));
+        }
+      }
+      std::sort(ring_.begin(), ring_.end());
+      GetPartitionFunc_ = &RowPartitioner::GetPartitionConsistentHash;
+      break;
+    default:
+      LOG(FATAL) << "Unknown row partition type " << type_;
+  }
+}
+
+int32_t RowPartitioner::GetPartitionModulo(int32_t row_id) const {
+  return row_id % num_partitions_;
+}
+
+int32_t RowPartitioner::GetPartitionHash(int32_t row_id) const {
+  return HashRow(row_id) % num_partitions_;
+}
+
+int32_t RowPartitioner::GetPartitionRange(int32_t row_id) const {
+  return std::min(row_id / range_size_, num_partitions_ - 1);
+}
+
+int32_t RowPartitioner::GetPartitionConsistentHash(int32_t row_id) const {
+  auto iter = std::upper_bound(
+      ring_.begin(), ring_.end(),
+      std::make_pair(HashRow(row_id), std::numeric_limits<int32_t>::max()));
+  if (iter == ring_.end())
+    iter = ring_.begin();
+  return iter->second;
+}
+
+int32_t RowPartitioner::GetLocalIndexModulo(int32_t row_id) const {
+  return row_id / num_partitions_;
+}
+
+int32_t RowPartitioner::GetLocalIndexRange(int32_t row_id) const {
+  return row_id - GetPartitionRange(row_id) * range_size_;
+}
+
+uint64_t RowPartitioner::HashRow(int32_t row_id) const {
+  return Mix((uint64_t(uint32_t(table_id_)) << 32) | uint32_t(row_id));
+}
+
+}  // namespace petuum
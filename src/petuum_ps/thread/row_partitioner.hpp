@@ -0,0 +1,77 @@
+#pragma once
+
+#include <petuum_ps_common/include/configs.hpp>
+#include <boost/noncopyable.hpp>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+namespace petuum {
+
+// Maps the rows of a table to server threads. The server threads are
+// numbered by partition index p in [0, num_clients * num_comm_channels);
+// p is held by comm channel p % num_comm_channels of client
+// p / num_comm_channels. ModuloPartition places row_id at
+// row_id % num_partitions, as PS always did.
+class RowPartitioner : boost::noncopyable {
+public:
+  RowPartitioner(int32_t table_id, const TableInfo &table_info,
+                 int32_t num_clients, int32_t num_comm_channels_per_client);
+
+  int32_t GetPartition(int32_t row_id) const {
+    return (this->*GetPartitionFunc_)(row_id);
+  }
+
+  int32_t GetCommChannelIndex(int32_t row_id) const {
+    return GetPartition(row_id) % num_comm_channels_per_client_;
+  }
+
+  int32_t GetClientID(int32_t row_id) const {
+    return GetPartition(row_id) / num_comm_channels_per_client_;
+  }
+
+  // True if the rows held by a server thread are numbered contiguously
+  // from 0, which lets the server keep them in an array.
+  bool HasLocalIndex() const {
+    return GetLocalIndexFunc_ != 0;
+  }
+
+  int32_t GetLocalIndex(int32_t row_id) const {
+    return (this->*GetLocalIndexFunc_)(row_id);
+  }
+
+  RowPartitionType get_type() const {
+    return type_;
+  }
+
+private:
+  typedef int32_t (RowPartitioner::*GetPartitionFunc)(int32_t row_id) const;
+  typedef int32_t (RowPartitioner::*GetLocalIndexFunc)(int32_t row_id) const;
+
+  int32_t GetPartitionModulo(int32_t row_id) const;
+  int32_t GetPartitionHash(int32_t row_id) const;
+  int32_t GetPartitionRange(int32_t row_id) const;
+  int32_t GetPartitionConsistentHash(int32_t row_id) const;
+
+  int32_t GetLocalIndexModulo(int32_t row_id) const;
+  int32_t GetLocalIndexRange(int32_t row_id) const;
+
+  uint64_t HashRow(int32_t row_id) const;
+
+  // Points each partition takes on the consistent hashing ring.
+  static const int32_t kNumVirtualNodes = 128;
+
+  const int32_t table_id_;
+  const RowPartitionType type_;
+  const int32_t num_comm_channels_per_client_;
+  const int32_t num_partitions_;
+  // Rows per partition under RangePartition.
+  int32_t range_size_;
+  // Consistent hashing ring, (point, partition) sorted by point.
+  std::vector<std::pair<uint64_t, int32_t> > ring_;
+
+  GetPartitionFunc GetPartitionFunc_;
+  GetLocalIndexFunc GetLocalIndexFunc_;
+};
+
+}  // namespace petuum
@@ -1,6 +1,8 @@
 #include <petuum_ps/thread/ssp_aggr_bg_worker.hpp>
 #include <petuum_ps/thread/trans_time_estimate.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
+#include <algorithm>
 
 namespace petuum {
 
@@ -73,7 +75,7 @@ size_t SSPAggrBgWorker::ReadTableOpLogMetaUpToClock(
 
     if (found && row_oplog != 0) {
       size_t serialized_oplog_size = CountRowOpLogToSend(
-          row_id, row_oplog, &table_num_bytes_by_server_,
+          table_id, row_id, row_oplog, &table_num_bytes_by_server_,
           bg_table_oplog, GetSerializedRowOpLogSize);
 
       accum_table_oplog_bytes += serialized_oplog_size;
@@ -142,12 +144,14 @@ size_t SSPAggrBgWorker::ReadTableOpLogMetaUpToClockNoReplay(
 
     if (found && row_oplog != 0) {
       size_t serialized_oplog_size = CountRowOpLogToSend(
-          row_id, row_oplog, &table_num_bytes_by_server_,
+          table_id, row_id, row_oplog, &table_num_bytes_by_server_,
           bg_table_oplog, GetSerializedRowOpLogSize);
       accum_table_oplog_bytes += serialized_oplog_size;
 
-      if (accum_table_oplog_bytes
-          >= GlobalContext::get_oplog_push_upper_bound_kb()*k1_Ki)
+      int32_t server_id = GlobalContext::GetPartitionServerID(
+          table_id, row_id, my_comm_channel_idx_);
+      if (OpLogPushFull(server_id, table_num_bytes_by_server_[server_id],
+                        accum_table_oplog_bytes))
         break;
     }
 
@@ -162,6 +166,7 @@ size_t SSPAggrBgWorker::ReadTableOpLogMetaUpToCapacityNoReplay(
     RowOpLogSerializer *row_oplog_serializer) {
 
   size_t accum_table_oplog_bytes = bytes_accumulated;
+  std::map<int32_t, size_t> num_bytes_by_server;
 
   AbstractOpLog &table_oplog = table->get_oplog();
 
@@ -187,8 +192,11 @@ size_t SSPAggrBgWorker::ReadTableOpLogMetaUpToCapacityNoReplay(
 
         accum_table_oplog_bytes += serialized_oplog_size;
 
-        if (accum_table_oplog_bytes
-            >= GlobalContext::get_oplog_push_upper_bound_kb()*k1_Ki)
+        int32_t server_id = GlobalContext::GetPartitionServerID(
+            table_id, row_id, my_comm_channel_idx_);
+        num_bytes_by_server[server_id] += serialized_oplog_size;
+        if (OpLogPushFull(server_id, num_bytes_by_server[server_id],
+                          accum_table_oplog_bytes))
           break;
       }
       row_id = table_oplog_meta->GetAndClearNextInOrder();
@@ -246,7 +254,7 @@ void SSPAggrBgWorker::PrepareOpLogsNormalNoReplay(
 
   if (serializer_iter == row_oplog_serializer_map_.end()) {
     RowOpLogSerializer *row_oplog_serializer
-        = new RowOpLogSerializer(table->oplog_dense_serialized(),
+        = new RowOpLogSerializer(table_id, table->oplog_dense_serialized(),
                                  my_comm_channel_idx_);
     row_oplog_serializer_map_.insert(std::make_pair(table_id, row_oplog_serializer));
     serializer_iter = row_oplog_serializer_map_.find(table_id);
@@ -324,15 +332,16 @@ long SSPAggrBgWorker::HandleClockMsg(bool clock_advanced) {
   if (clock_to_push >= 0)
     clock_has_pushed_ = clock_to_push;
 
-  BgOpLog *bg_oplog = PrepareOpLogsToSend(clock_to_push);
-
-  CreateOpLogMsgs(bg_oplog);
+  BgOpLog *bg_oplog;
+  {
+    MetricTimer metric_timer(kMetricBgOpLogSerialize, false);
+    bg_oplog = PrepareOpLogsToSend(clock_to_push);
+    CreateOpLogMsgs(bg_oplog);
+  }
   size_t sent_size = SendOpLogMsgs(true);
+  oplog_send_milli_sec_ = TrackOpLogSend(sent_size);
   TrackBgOpLog(bg_oplog);
 
-  oplog_send_milli_sec_
-      = TransTimeEstimate::EstimateTransMillisec(sent_size);
-
   msg_send_timer_.restart();
 
   STATS_BG_ACCUM_IDLE_SEND_END();
@@ -414,7 +423,7 @@ void SSPAggrBgWorker::PrepareBgIdleOpLogsNormalNoReplay(int32_t table_id,
 
   if (serializer_iter == row_oplog_serializer_map_.end()) {
     RowOpLogSerializer *row_oplog_serializer
-        = new RowOpLogSerializer(table->oplog_dense_serialized(),
+        = new RowOpLogSerializer(table_id, table->oplog_dense_serialized(),
                                  my_comm_channel_idx_);
     row_oplog_serializer_map_.insert(std::make_pair(table_id, row_oplog_serializer));
     serializer_iter = row_oplog_serializer_map_.find(table_id);
@@ -448,6 +457,41 @@ void SSPAggrBgWorker::PrepareBgIdleOpLogsAppendOnlyNoReplay(int32_t table_id,
   LOG(FATAL) << "Operation not supported!";
 }
 
+void SSPAggrBgWorker::HandleServerOpLogAck(int32_t server_id,
+                                           uint32_t ack_version) {
+  SSPPushBgWorker::HandleServerOpLogAck(server_id, ack_version);
+  if (GlobalContext::get_adaptive_oplog_push())
+    push_controller_.OnAck(server_id, ack_version);
+}
+
+bool SSPAggrBgWorker::OpLogPushFull(int32_t server_id, size_t server_bytes,
+                                    size_t accum_bytes) const {
+  if (!GlobalContext::get_adaptive_oplog_push())
+    return accum_bytes
+        >= GlobalContext::get_oplog_push_upper_bound_kb()*k1_Ki;
+  return server_bytes >= push_controller_.get_push_bytes(server_id);
+}
+
+double SSPAggrBgWorker::TrackOpLogSend(size_t sent_size) {
+  if (!GlobalContext::get_adaptive_oplog_push())
+    return TransTimeEstimate::EstimateTransMillisec(sent_size);
+
+  // The next push waits for the slowest server.
+  double send_milli_sec = 0;
+  for (const auto &server_id : server_ids_) {
+    size_t server_bytes = 0;
+    for (const auto &table_size_pair
+             : server_table_oplog_size_map_[server_id]) {
+      server_bytes += table_size_pair.second;
+    }
+    push_controller_.OnSend(server_id, version_, server_bytes);
+    send_milli_sec = std::max(
+        send_milli_sec,
+        push_controller_.EstimateTransMillisec(server_id, server_bytes));
+  }
+  return send_milli_sec;
+}
+
 long SSPAggrBgWorker::BgIdleWork() {
   STATS_BG_IDLE_INVOKE_INC_ONE();
 
@@ -483,11 +527,9 @@ long SSPAggrBgWorker::BgIdleWork() {
 
   CreateOpLogMsgs(bg_oplog);
   size_t sent_size = SendOpLogMsgs(false);
+  oplog_send_milli_sec_ = TrackOpLogSend(sent_size);
   TrackBgOpLog(bg_oplog);
 
-  oplog_send_milli_sec_
-      = TransTimeEstimate::EstimateTransMillisec(sent_size);
-
   msg_send_timer_.restart();
 
   STATS_BG_ACCUM_IDLE_SEND_END();
@@ -5,7 +5,9 @@
 #include <petuum_ps/thread/ssp_push_bg_worker.hpp>
 #include <petuum_ps/thread/oplog_meta.hpp>
 #include <petuum_ps/thread/bg_oplog_partition.hpp>
+#include <petuum_ps/thread/oplog_push_controller.hpp>
 #include <petuum_ps_common/util/high_resolution_timer.hpp>
+#include <petuum_ps_common/include/constants.hpp>
 
 namespace petuum {
 
@@ -25,7 +27,9 @@ public:
                       system_clock_mtx,
                       system_clock_cv,
                       bg_server_clock),
-      min_table_staleness_(INT_MAX) { }
+      min_table_staleness_(INT_MAX),
+      push_controller_(GlobalContext::get_bandwidth_mbps(),
+                       GlobalContext::get_oplog_push_upper_bound_kb()*k1_Ki) { }
 
   ~SSPAggrBgWorker() { }
 
@@ -36,6 +40,15 @@ protected:
   virtual long ResetBgIdleMilli();
   virtual long BgIdleWork();
   virtual long HandleClockMsg(bool clock_advanced);
+  virtual void HandleServerOpLogAck(int32_t server_id, uint32_t ack_version);
+
+  // Whether the rows read so far fill a push, given that the last one went
+  // to server_id, which has now server_bytes of this table's oplogs.
+  bool OpLogPushFull(int32_t server_id, size_t server_bytes,
+                     size_t accum_bytes) const;
+  // Called before TrackBgOpLog. Returns how long the oplog msgs just sent
+  // take to go out, in milliseconds.
+  double TrackOpLogSend(size_t sent_size);
 
   void ReadTableOpLogsIntoOpLogMeta(int32_t table_id,
                                     ClientTable *table);
@@ -95,6 +108,7 @@ protected:
   OpLogMeta oplog_meta_;
   HighResolutionTimer msg_send_timer_;
   double oplog_send_milli_sec_;
+  OpLogPushController push_controller_;
 };
 
 }
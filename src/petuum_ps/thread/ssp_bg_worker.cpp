@@ -119,8 +119,9 @@ BgOpLogPartition *SSPBgWorker::PrepareOpLogsNormal(
 
     if (found && (row_oplog == 0)) continue;
 
-    CountRowOpLogToSend(row_id, row_oplog, &table_num_bytes_by_server_,
-                        bg_table_oplog, GetSerializedRowOpLogSize);
+    CountRowOpLogToSend(table_id, row_id, row_oplog,
+                        &table_num_bytes_by_server_, bg_table_oplog,
+                        GetSerializedRowOpLogSize);
   }
   delete new_table_oplog_index_ptr;
   return bg_table_oplog;
@@ -155,8 +156,9 @@ BgOpLogPartition *SSPBgWorker::PrepareOpLogsAppendOnly(
     AbstractRowOpLog *row_oplog
         = append_only_row_oplog_buffer->InitReadRmOpLog(&row_id);
     while (row_oplog != 0) {
-      CountRowOpLogToSend(row_id, row_oplog, &table_num_bytes_by_server_,
-                          bg_table_oplog, GetSerializedRowOpLogSize);
+      CountRowOpLogToSend(table_id, row_id, row_oplog,
+                          &table_num_bytes_by_server_, bg_table_oplog,
+                          GetSerializedRowOpLogSize);
 
       row_oplog = append_only_row_oplog_buffer->NextReadRmOpLog(&row_id);
     }
@@ -173,7 +175,7 @@ void SSPBgWorker::PrepareOpLogsNormalNoReplay(
 
   if (serializer_iter == row_oplog_serializer_map_.end()) {
     RowOpLogSerializer *row_oplog_serializer
-        = new RowOpLogSerializer(table->oplog_dense_serialized(),
+        = new RowOpLogSerializer(table_id, table->oplog_dense_serialized(),
                                  my_comm_channel_idx_);
     row_oplog_serializer_map_.insert(std::make_pair(table_id, row_oplog_serializer));
     serializer_iter = row_oplog_serializer_map_.find(table_id);
@@ -215,7 +217,7 @@ void SSPBgWorker::PrepareOpLogsAppendOnlyNoReplay(
   auto serializer_iter = row_oplog_serializer_map_.find(table_id);
   if (serializer_iter == row_oplog_serializer_map_.end()) {
     RowOpLogSerializer *row_oplog_serializer
-        = new RowOpLogSerializer(table->oplog_dense_serialized(),
+        = new RowOpLogSerializer(table_id, table->oplog_dense_serialized(),
                                  my_comm_channel_idx_);
     row_oplog_serializer_map_.insert(std::make_pair(table_id, row_oplog_serializer));
     serializer_iter = row_oplog_serializer_map_.find(table_id);
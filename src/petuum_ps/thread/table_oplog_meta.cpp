@@ -1,5 +1,6 @@
 #include <petuum_ps/thread/table_oplog_meta.hpp>
 #include <petuum_ps/thread/context.hpp>
+#include <petuum_ps_common/util/top_k.hpp>
 
 #include <time.h>
 #include <stdlib.h>
@@ -9,9 +10,19 @@
 namespace petuum {
 
 TableOpLogMeta::TableOpLogMeta(const AbstractRow *sample_row):
-    sample_row_(sample_row) {
-
-  switch(GlobalContext::get_update_sort_policy()) {
+    TableOpLogMeta(sample_row, GlobalContext::get_update_sort_policy()) { }
+
+TableOpLogMeta::TableOpLogMeta(const AbstractRow *sample_row,
+                               UpdateSortPolicy policy):
+    sample_row_(sample_row),
+    begin_(0),
+    sorted_end_(0),
+    select_batch_size_(kInitSelectBatchSize),
+    read_idx_(0),
+    write_idx_(0),
+    clock_to_clear_(-1) {
+
+  switch(policy) {
     case FIFO:
       CompRowOpLogMeta_ = CompRowOpLogMetaClock;
       ReassignImportance_ = ReassignImportanceNoOp;
@@ -33,8 +44,7 @@ TableOpLogMeta::TableOpLogMeta(const AbstractRow *sample_row):
       MergeRowOpLogMeta_ = MergeRowOpLogMetaAccum;
       break;
     default:
-      LOG(FATAL) << "Unrecognized update sort policy "
-                 << GlobalContext::get_update_sort_policy();
+      LOG(FATAL) << "Unrecognized update sort policy " << policy;
   }
 }
 
@@ -53,7 +63,7 @@ void TableOpLogMeta::InsertMergeRowOpLogMeta(int32_t row_id,
     RowOpLogMeta *meta_to_insert = new RowOpLogMeta;
     *meta_to_insert = row_oplog_meta;
     oplog_map_.insert(std::make_pair(row_id, meta_to_insert));
-    oplog_list_.push_back(std::make_pair(row_id, meta_to_insert));
+    oplog_vec_.push_back(std::make_pair(row_id, meta_to_insert));
     return;
   }
 
@@ -61,71 +71,82 @@ void TableOpLogMeta::InsertMergeRowOpLogMeta(int32_t row_id,
 }
 
 void TableOpLogMeta::Sort() {
-  ReassignImportance_(&oplog_list_);
-  oplog_list_.sort(CompRowOpLogMeta_);
+  Compact();
+  ReassignImportance_(&oplog_vec_);
+  select_batch_size_ = kInitSelectBatchSize;
 }
 
-
 int32_t TableOpLogMeta::GetAndClearNextInOrder() {
-  if (oplog_list_.empty())
-    return -1;
-
-  std::pair<int32_t, RowOpLogMeta*> &oplog_pair
-      = oplog_list_.front();
-  int32_t row_id = oplog_pair.first;
-  delete oplog_pair.second;
-
-  oplog_list_.pop_front();
-  oplog_map_.erase(row_id);
-
-  return row_id;
+  double importance;
+  return GetAndClearNextInOrder(&importance);
 }
 
 int32_t TableOpLogMeta::GetAndClearNextInOrder(double *importance) {
-  if (oplog_list_.empty())
-    return -1;
+  if (begin_ == sorted_end_) {
+    if (begin_ == oplog_vec_.size())
+      return -1;
+    size_t num_to_select
+        = std::min(select_batch_size_, oplog_vec_.size() - begin_);
+    SelectTop(oplog_vec_.begin() + begin_, oplog_vec_.end(), num_to_select,
+              CompRowOpLogMeta_);
+    sorted_end_ = begin_ + num_to_select;
+    select_batch_size_ *= 2;
+  }
 
-  std::pair<int32_t, RowOpLogMeta*> &oplog_pair
-      = oplog_list_.front();
+  RowOpLogMetaPair &oplog_pair = oplog_vec_[begin_++];
   int32_t row_id = oplog_pair.first;
   *importance = oplog_pair.second->get_importance();
   delete oplog_pair.second;
+  oplog_pair.second = 0;
 
-  oplog_list_.pop_front();
   oplog_map_.erase(row_id);
 
   return row_id;
 }
 
 int32_t TableOpLogMeta::InitGetUptoClock(int32_t clock) {
-  list_iter_ = oplog_list_.begin();
+  Compact();
   clock_to_clear_ = clock;
 
   return GetAndClearNextUptoClock();
 }
 
 int32_t TableOpLogMeta::GetAndClearNextUptoClock() {
-  for (; list_iter_ != oplog_list_.end(); ++list_iter_) {
-    if (list_iter_->second->get_clock() > clock_to_clear_)
+  while (read_idx_ < oplog_vec_.size()) {
+    RowOpLogMetaPair oplog_pair = oplog_vec_[read_idx_++];
+    if (oplog_pair.second->get_clock() > clock_to_clear_) {
+      oplog_vec_[write_idx_++] = oplog_pair;
       continue;
-    else
-      break;
+    }
+
+    int32_t row_id = oplog_pair.first;
+    delete oplog_pair.second;
+    oplog_map_.erase(row_id);
+    return row_id;
   }
 
-  if (list_iter_ == oplog_list_.end())
-    return -1;
+  oplog_vec_.resize(write_idx_);
+  read_idx_ = 0;
+  write_idx_ = 0;
+  return -1;
+}
 
-  int32_t row_id = list_iter_->first;
-  delete list_iter_->second;
+void TableOpLogMeta::Compact() {
+  if (write_idx_ < read_idx_) {
+    oplog_vec_.erase(oplog_vec_.begin() + write_idx_,
+                     oplog_vec_.begin() + read_idx_);
+  }
+  read_idx_ = 0;
+  write_idx_ = 0;
 
-  list_iter_ = oplog_list_.erase(list_iter_);
-  oplog_map_.erase(row_id);
-  return row_id;
+  oplog_vec_.erase(oplog_vec_.begin(), oplog_vec_.begin() + begin_);
+  begin_ = 0;
+  sorted_end_ = 0;
 }
 
 bool TableOpLogMeta::CompRowOpLogMetaClock(
-    const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-    const std::pair<int32_t, RowOpLogMeta*> &oplog2) {
+    const RowOpLogMetaPair &oplog1,
+    const RowOpLogMetaPair &oplog2) {
 
   if (oplog1.second->get_clock() == oplog2.second->get_clock()) {
     return oplog1.first < oplog2.first;
@@ -135,8 +156,8 @@ bool TableOpLogMeta::CompRowOpLogMetaClock(
 }
 
 bool TableOpLogMeta::CompRowOpLogMetaImportance(
-    const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-    const std::pair<int32_t, RowOpLogMeta*> &oplog2) {
+    const RowOpLogMetaPair &oplog1,
+    const RowOpLogMetaPair &oplog2) {
 
   if (oplog1.second->get_importance() == oplog2.second->get_importance()) {
     return oplog1.first < oplog2.first;
@@ -146,24 +167,24 @@ bool TableOpLogMeta::CompRowOpLogMetaImportance(
 }
 
 bool TableOpLogMeta::CompRowOpLogMetaRelativeFIFONReMag(
-    const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-    const std::pair<int32_t, RowOpLogMeta*> &oplog2) {
+    const RowOpLogMetaPair &oplog1,
+    const RowOpLogMetaPair &oplog2) {
 
   return CompRowOpLogMetaImportance(oplog1, oplog2);
 }
 
 void TableOpLogMeta::ReassignImportanceRandom(
-    std::list<std::pair<int32_t, RowOpLogMeta*> > *oplog_list) {
+    std::vector<RowOpLogMetaPair> *oplog_vec) {
   srand(time(NULL));
-  for (auto list_iter = (*oplog_list).begin(); list_iter != (*oplog_list).end();
-       ++list_iter) {
+  for (auto vec_iter = (*oplog_vec).begin(); vec_iter != (*oplog_vec).end();
+       ++vec_iter) {
     int importance = rand();
-    list_iter->second->set_importance(importance);
+    vec_iter->second->set_importance(importance);
   }
 }
 
 void TableOpLogMeta::ReassignImportanceNoOp(
-    std::list<std::pair<int32_t, RowOpLogMeta*> > *oplog_list) { }
+    std::vector<RowOpLogMetaPair> *oplog_vec) { }
 
 void TableOpLogMeta::MergeRowOpLogMetaAccum(RowOpLogMeta *row_oplog_meta,
                                             const RowOpLogMeta& to_merge) {
@@ -5,35 +5,50 @@
 #include <petuum_ps_common/include/configs.hpp>
 
 #include <boost/unordered_map.hpp>
-#include <list>
+#include <vector>
+#include <utility>
 #include <stdint.h>
 #include <petuum_ps/thread/context.hpp>
 #include <boost/noncopyable.hpp>
 
 namespace petuum {
 
+// The row oplog metas of a table, handed out in update sort policy order.
+//
+// Metas are kept in a flat vector. Sort() does not sort it: the next rows
+// in order are selected lazily, in batches that double in size, so a push
+// that takes k of n rows costs O(n + k log k) rather than O(n log n).
 class TableOpLogMeta : boost::noncopyable {
 public:
   TableOpLogMeta(const AbstractRow *sample_row);
+  TableOpLogMeta(const AbstractRow *sample_row, UpdateSortPolicy policy);
   ~TableOpLogMeta();
 
-  TableOpLogMeta(TableOpLogMeta && other) {
-    oplog_map_ = other.oplog_map_;
-    oplog_list_ = other.oplog_list_;
+  TableOpLogMeta(TableOpLogMeta && other):
+      oplog_map_(std::move(other.oplog_map_)),
+      oplog_vec_(std::move(other.oplog_vec_)),
+      sample_row_(other.sample_row_),
+      MergeRowOpLogMeta_(other.MergeRowOpLogMeta_),
+      CompRowOpLogMeta_(other.CompRowOpLogMeta_),
+      ReassignImportance_(other.ReassignImportance_),
+      begin_(other.begin_),
+      sorted_end_(other.sorted_end_),
+      select_batch_size_(other.select_batch_size_),
+      read_idx_(other.read_idx_),
+      write_idx_(other.write_idx_),
+      clock_to_clear_(other.clock_to_clear_) {
     other.oplog_map_.clear();
-    other.oplog_list_.clear();
-
-    CompRowOpLogMeta_ = other.CompRowOpLogMeta_;
-    ReassignImportance_ = other.ReassignImportance_;
-    MergeRowOpLogMeta_ = other.MergeRowOpLogMeta_;
+    other.oplog_vec_.clear();
   }
 
+  typedef std::pair<int32_t, RowOpLogMeta*> RowOpLogMetaPair;
+
   typedef bool (*CompRowOpLogMetaFunc)(
-      const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-      const std::pair<int32_t, RowOpLogMeta*> &oplog2);
+      const RowOpLogMetaPair &oplog1,
+      const RowOpLogMetaPair &oplog2);
 
   typedef void (*ReassignImportanceFunc)(
-      std::list<std::pair<int32_t, RowOpLogMeta*> > *oplog_list);
+      std::vector<RowOpLogMetaPair> *oplog_vec);
 
   typedef void (*MergeRowOpLogMetaFunc)(RowOpLogMeta* row_oplog_meta,
                                         const RowOpLogMeta& to_merge);
@@ -55,22 +70,22 @@ public:
 
 private:
   static bool CompRowOpLogMetaClock(
-      const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-      const std::pair<int32_t, RowOpLogMeta*> &oplog2);
+      const RowOpLogMetaPair &oplog1,
+      const RowOpLogMetaPair &oplog2);
 
   static bool CompRowOpLogMetaImportance(
-      const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-      const std::pair<int32_t, RowOpLogMeta*> &oplog2);
+      const RowOpLogMetaPair &oplog1,
+      const RowOpLogMetaPair &oplog2);
 
   static bool CompRowOpLogMetaRelativeFIFONReMag(
-      const std::pair<int32_t, RowOpLogMeta*> &oplog1,
-      const std::pair<int32_t, RowOpLogMeta*> &oplog2);
+      const RowOpLogMetaPair &oplog1,
+      const RowOpLogMetaPair &oplog2);
 
   static void ReassignImportanceRandom(
-      std::list<std::pair<int32_t, RowOpLogMeta*> > *oplog_list);
+      std::vector<RowOpLogMetaPair> *oplog_vec);
 
   static void ReassignImportanceNoOp(
-      std::list<std::pair<int32_t, RowOpLogMeta*> > *oplog_list);
+      std::vector<RowOpLogMetaPair> *oplog_vec);
 
   static void MergeRowOpLogMetaAccum(RowOpLogMeta* row_oplog_meta,
                                      const RowOpLogMeta& to_merge);
@@ -79,15 +94,30 @@ private:
   static void MergeRowOpLogMetaNoOp(RowOpLogMeta* row_oplog_meta,
                                     const RowOpLogMeta& to_merge);
 
+  // Drops the entries handed out in order and finishes an interrupted
+  // GetAndClearNextUptoClock() pass.
+  void Compact();
+
+  static const size_t kInitSelectBatchSize = 64;
+
   boost::unordered_map<int32_t, RowOpLogMeta*> oplog_map_;
-  std::list<std::pair<int32_t, RowOpLogMeta*> > oplog_list_;
+  std::vector<RowOpLogMetaPair> oplog_vec_;
 
   const AbstractRow *sample_row_;
   MergeRowOpLogMetaFunc MergeRowOpLogMeta_;
   CompRowOpLogMetaFunc CompRowOpLogMeta_;
   ReassignImportanceFunc ReassignImportance_;
 
-  std::list<std::pair<int32_t, RowOpLogMeta*> >::iterator list_iter_;
+  // oplog_vec_[0, begin_) have been handed out by GetAndClearNextInOrder();
+  // [begin_, sorted_end_) are the next ones in order.
+  size_t begin_;
+  size_t sorted_end_;
+  size_t select_batch_size_;
+
+  // GetAndClearNextUptoClock() compacts oplog_vec_ as it goes: entries
+  // before write_idx_ are kept, entries from read_idx_ on are unvisited.
+  size_t read_idx_;
+  size_t write_idx_;
 
   // After GetAndClearNextUptoClock(), all row oplogs will be above this clock
   // (exclusive)
@@ -12,6 +12,7 @@
 #include <petuum_ps_common/include/table.hpp>
 #include <petuum_ps_common/include/abstract_row.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
+#include <petuum_ps_common/util/all_reduce.hpp>
 
 #include <petuum_ps_common/client/abstract_client_table.hpp>
 
@@ -40,7 +41,12 @@ public:
 
   virtual void Clock() = 0;
 
+  virtual void FlushOpLogs() = 0;
+
   virtual void GlobalBarrier() = 0;
+
+  virtual void AllReduce(void *buf, int32_t count,
+                         AllReduceDataType data_type, AllReduceOp op) = 0;
 };
 
 }   // namespace petuum
@@ -0,0 +1,62 @@
+#include <petuum_ps_common/client/thread_collective.hpp>
+#include <glog/logging.h>
+#include <cstring>
+
+namespace petuum {
+
+ThreadCollective::ThreadCollective():
+    initialized_(false),
+    num_arrived_(0) { }
+
+ThreadCollective::~ThreadCollective() {
+  if (initialized_)
+    pthread_barrier_destroy(&barrier_);
+}
+
+void ThreadCollective::Init(int32_t num_threads) {
+  CHECK(!initialized_);
+  CHECK_GT(num_threads, 0);
+  pthread_barrier_init(&barrier_, 0, num_threads);
+  initialized_ = true;
+}
+
+bool ThreadCollective::Arrive() {
+  CHECK(initialized_) << "Collectives are only available after "
+                      << "CreateTableDone()";
+  return pthread_barrier_wait(&barrier_) == PTHREAD_BARRIER_SERIAL_THREAD;
+}
+
+void ThreadCollective::Release() {
+  pthread_barrier_wait(&barrier_);
+}
+
+bool ThreadCollective::ArriveReduce(const void *buf, int32_t count,
+                                    AllReduceDataType data_type,
+                                    AllReduceOp op) {
+  size_t size = count * GetAllReduceDataTypeSize(data_type);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (num_arrived_ == 0) {
+      buff_.resize(size);
+      memcpy(buff_.data(), buf, size);
+    } else {
+      CHECK_EQ(buff_.size(), size) << "All-reduce size mismatch";
+      AllReduceInto(buff_.data(), buf, count, data_type, op);
+    }
+    ++num_arrived_;
+  }
+  bool leader = Arrive();
+  // Every thread has arrived, so none is reading num_arrived_.
+  if (leader)
+    num_arrived_ = 0;
+  return leader;
+}
+
+void ThreadCollective::ReleaseReduce(void *buf) {
+  Release();
+  memcpy(buf, buff_.data(), buff_.size());
+  // Keep buff_ until every thread has copied it out.
+  pthread_barrier_wait(&barrier_);
+}
+
+}  // namespace petuum
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <petuum_ps_common/util/all_reduce.hpp>
+#include <boost/noncopyable.hpp>
+#include <pthread.h>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+namespace petuum {
+
+// Barrier and all-reduce among the table threads of a process. All table
+// threads call them in the same order. The call that returns true leads:
+// it carries out the process-wide step, e.g. exchanging the reduced buffer
+// with other processes, before every thread calls the matching Release.
+class ThreadCollective : boost::noncopyable {
+public:
+  ThreadCollective();
+  ~ThreadCollective();
+
+  // Must be called before any other function, once the number of table
+  // threads is known.
+  void Init(int32_t num_threads);
+
+  bool Arrive();
+  void Release();
+
+  // Reduces buf into the process buffer (get_buff()) before arriving.
+  bool ArriveReduce(const void *buf, int32_t count,
+                    AllReduceDataType data_type, AllReduceOp op);
+  // Copies the process buffer to buf after releasing.
+  void ReleaseReduce(void *buf);
+
+  void *get_buff() {
+    return buff_.data();
+  }
+
+private:
+  bool initialized_;
+  pthread_barrier_t barrier_;
+
+  std::mutex mtx_;
+  int32_t num_arrived_;
+  std::vector<uint8_t> buff_;
+};
+
+}  // namespace petuum
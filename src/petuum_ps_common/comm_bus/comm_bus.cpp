@@ -1,6 +1,9 @@
 // author: jinliang
 
 #include <stdlib.h>
+#include <ifaddrs.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include <glog/logging.h>
 #include <sstream>
 #include <string>
@@ -12,6 +15,7 @@ namespace petuum {
 
 const std::string CommBus::kInProcPrefix("inproc://comm_bus");
 const std::string CommBus::kInterProcPrefix("tcp://");
+const std::string CommBus::kIPCPrefix("ipc://");
 
 void CommBus::MakeInProcAddr(int32_t entity_id, std::string *result) {
   std::stringstream ss;
@@ -27,6 +31,56 @@ void CommBus::MakeInterProcAddr(const std::string &network_addr,
   *result += network_addr;
 }
 
+void CommBus::MakeIPCAddr(const std::string &network_addr,
+  std::string *result) {
+  std::string endpoint_name = network_addr;
+  for (auto &c : endpoint_name) {
+    if (c == ':')
+      c = '_';
+  }
+  *result = kIPCPrefix;
+  *result += ipc_dir_;
+  *result += "/petuum_comm_bus_";
+  *result += endpoint_name;
+}
+
+bool CommBus::IsSameHost(const std::string &network_addr) {
+  if (ipc_dir_.empty())
+    return false;
+  std::string ip = network_addr.substr(0, network_addr.rfind(':'));
+  return (local_ips_.count(ip) > 0) || (ip == "localhost")
+      || (ip.compare(0, 4, "127.") == 0);
+}
+
+void CommBus::InitLocalIPs() {
+  struct ifaddrs *if_addrs = 0;
+  if (getifaddrs(&if_addrs) != 0) {
+    LOG(WARNING) << "getifaddrs() failed, using TCP for all remote entities";
+    ipc_dir_.clear();
+    return;
+  }
+
+  for (struct ifaddrs *ifa = if_addrs; ifa != 0; ifa = ifa->ifa_next) {
+    if (ifa->ifa_addr == 0)
+      continue;
+    char addr_str[INET6_ADDRSTRLEN];
+    const void *addr = 0;
+    if (ifa->ifa_addr->sa_family == AF_INET) {
+      addr = &(reinterpret_cast<struct sockaddr_in*>(
+          ifa->ifa_addr)->sin_addr);
+    } else if (ifa->ifa_addr->sa_family == AF_INET6) {
+      addr = &(reinterpret_cast<struct sockaddr_in6*>(
+          ifa->ifa_addr)->sin6_addr);
+    } else {
+      continue;
+    }
+    if (inet_ntop(ifa->ifa_addr->sa_family, addr, addr_str,
+                  sizeof(addr_str)) != 0)
+      local_ips_.insert(addr_str);
+  }
+  freeifaddrs(if_addrs);
+}
+
 bool CommBus::IsLocalEntity(int32_t entity_id) {
   //VLOG(0) << "e_st_ = " << e_st_
   //	  << " e_end_ = " << e_end_;
@@ -35,9 +89,12 @@ bool CommBus::IsLocalEntity(int32_t entity_id) {
 
 
 CommBus::CommBus(int32_t e_st, int32_t e_end, int32_t num_clients,
-                 int32_t num_zmq_thrs) {
+                 int32_t num_zmq_thrs, const std::string &ipc_dir) {
   e_st_ = e_st;
   e_end_ = e_end;
+  ipc_dir_ = ipc_dir;
+  if (!ipc_dir_.empty())
+    InitLocalIPs();
 
   try {
     zmq_ctx_ = new zmq::context_t(num_zmq_thrs);
@@ -136,6 +193,13 @@ void CommBus::ThreadRegister(const Config &config) {
     MakeInterProcAddr(config.network_addr_, &bind_addr);
 
     ZMQUtil::ZMQBind(sock, bind_addr);
+
+    // Same-host peers connect here instead.
+    if (!ipc_dir_.empty()) {
+      std::string ipc_bind_addr;
+      MakeIPCAddr(config.network_addr_, &ipc_bind_addr);
+      ZMQUtil::ZMQBind(sock, ipc_bind_addr);
+    }
   }
 }
 
@@ -185,7 +249,11 @@ void CommBus::ConnectTo(int32_t entity_id, const std::string &network_addr,
   }
 
   std::string connect_addr;
-  MakeInterProcAddr(network_addr, &connect_addr);
+  if (IsSameHost(network_addr)) {
+    MakeIPCAddr(network_addr, &connect_addr);
+  } else {
+    MakeInterProcAddr(network_addr, &connect_addr);
+  }
   int32_t zmq_id = ZMQUtil::EntityID2ZmqID(entity_id);
   ZMQUtil::ZMQConnectSend(sock, connect_addr, zmq_id, connect_msg, size);
 }
@@ -247,6 +315,15 @@ size_t CommBus::SendInProc(int32_t entity_id, zmq::message_t &msg) {
   return nbytes;
 }
 
+size_t CommBus::SendInterProc(int32_t entity_id, zmq::message_t &msg) {
+  zmq::socket_t *sock = thr_info_->interproc_sock_.get();
+
+  int32_t recv_id = ZMQUtil::EntityID2ZmqID(entity_id);
+  size_t nbytes = ZMQUtil::ZMQSend(sock, recv_id, msg, 0);
+
+  return nbytes;
+}
+
 
 void CommBus::Recv(int32_t *entity_id, zmq::message_t *msg) {
   if (thr_info_->pollitems_.get() == NULL) {
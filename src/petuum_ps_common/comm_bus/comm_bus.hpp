@@ -5,6 +5,7 @@
 #include <petuum_ps_common/comm_bus/zmq_util.hpp>
 #include <zmq.hpp>
 #include <string>
+#include <set>
 #include <utility>
 #include <boost/thread/tss.hpp>
 #include <boost/scoped_ptr.hpp>
@@ -25,6 +26,10 @@ namespace petuum {
  * Each thread is an entity and should only register (ThreadRegister) once.
  * A thread is local if it is in the same CommBus object as myself, otherwise it
  * is remote.
+ * A remote thread that runs on the same host is reached through a zmq IPC
+ * (Unix domain socket) endpoint instead of TCP, when an IPC directory is
+ * given. Threads listening for remote connections bind to both endpoints,
+ * and ConnectTo() picks IPC if the remote address is one of this host's.
  */
 
 class CommBus : boost::noncopyable {
@@ -90,7 +95,10 @@ public:
 
   bool IsLocalEntity(int32_t entity_id);
 
-  CommBus(int32_t e_st, int32_t e_end, int32_t num_clients, int32_t num_zmq_thrs = 1);
+  // ipc_dir is where IPC endpoints are created, e.g. /dev/shm. It must be
+  // the same for all processes on a host. Empty disables IPC.
+  CommBus(int32_t e_st, int32_t e_end, int32_t num_clients,
+          int32_t num_zmq_thrs = 1, const std::string &ipc_dir = "");
   ~CommBus();
 
   // Register a thread, set up necessary commnication channel.
@@ -121,6 +129,7 @@ public:
   // msg is nollified
   size_t Send(int32_t entity_id, zmq::message_t &msg);
   size_t SendInProc(int32_t entity_id, zmq::message_t &msg);
+  size_t SendInterProc(int32_t entity_id, zmq::message_t &msg);
 
   void Recv(int32_t *entity_id, zmq::message_t *msg);
   bool RecvAsync(int32_t *entity_id, zmq::message_t *msg);
@@ -159,15 +168,23 @@ private:
   static void MakeInProcAddr(int32_t entity_id, std::string *result);
   static void MakeInterProcAddr(const std::string &network_addr,
       std::string *result);
+  void MakeIPCAddr(const std::string &network_addr, std::string *result);
+  // Whether network_addr ("ip:port") refers to this host and IPC is enabled.
+  bool IsSameHost(const std::string &network_addr);
+  void InitLocalIPs();
 
   static void SetUpRouterSocket(zmq::socket_t *sock, int32_t id,
     int num_bytes_send_buff, int num_bytes_recv_buff);
   static const std::string kInProcPrefix;
   static const std::string kInterProcPrefix;
+  static const std::string kIPCPrefix;
   zmq::context_t *zmq_ctx_;
   // denote the range of entity IDs that are local, inclusive
   int32_t e_st_;
   int32_t e_end_;
+  std::string ipc_dir_;
+  // Addresses of this host's network interfaces, set only if IPC is enabled.
+  std::set<std::string> local_ips_;
   boost::thread_specific_ptr<ThreadCommInfo> thr_info_;
 };
 }   // namespace petuum
@@ -37,6 +37,11 @@ public:
   // fresh in SSP. The result is returned in row_accessor.
   virtual ClientRow *Get(int32_t row_id, RowAccessor* row_accessor) = 0;
 
+  // Make sure all rows in row_ids are valid in the process storage, so that
+  // the following Get()s do not block. Rows that need to be fetched are
+  // requested together and the call blocks until all of them arrive.
+  virtual void GetBatch(const int32_t *row_ids, int32_t num_rows) = 0;
+
   // Increment (update) an entry. Does not take ownership of input argument
   // delta, which should be of template type UPDATE in Table. This may trigger
   // synchronization (e.g., in value-bound) and is blocked until consistency
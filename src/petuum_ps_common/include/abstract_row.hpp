@@ -88,6 +88,13 @@ public:
   virtual void ApplyDenseBatchIncUnsafe(
       const void* update_batch, int32_t index_st, int32_t num_updates) = 0;
 
+  // Rows that keep their values in a contiguous float array return it, so
+  // that server update rules can modify the values in place; other rows
+  // return 0. Not thread-safe.
+  virtual float *GetFloatDataUnsafe() {
+    return 0;
+  }
+
   // Aggregate update1 and update2 by summation and substraction (update1 -
   // update2), outputing to update2. column_id is optionally used in case
   // updates are applied differently for different column of a row.
@@ -102,6 +109,22 @@ public:
   virtual void SubtractUpdates(int32_t column_id, void *update1,
     const void* update2) const = 0;
 
+  // AddUpdates() on num_updates consecutive columns starting from
+  // column_id_st, where update1 and update2 point to the updates of
+  // column_id_st. Rows with plain numeric updates override this with a
+  // vectorized version.
+  virtual void AddDenseUpdates(int32_t column_id_st, void *update1,
+                               const void *update2,
+                               int32_t num_updates) const {
+    size_t update_size = get_update_size();
+    uint8_t *update1_uint8 = reinterpret_cast<uint8_t*>(update1);
+    const uint8_t *update2_uint8 = reinterpret_cast<const uint8_t*>(update2);
+    for (int32_t i = 0; i < num_updates; ++i) {
+      AddUpdates(column_id_st + i, update1_uint8 + update_size*i,
+                 update2_uint8 + update_size*i);
+    }
+  }
+
   // Get importance of this update as if it is applied on to the given value.
   virtual double GetImportance(int32_t column_id, const void *update,
                                const void *value) const = 0;
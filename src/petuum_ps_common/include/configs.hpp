@@ -51,13 +51,94 @@ enum AppendOnlyOpLogType {
 
 enum ProcessStorageType {
   BoundedDense = 0,
-  BoundedSparse = 1
+  BoundedSparse = 1,
+  // Like BoundedSparse, but Find() takes no lock.
+  LockFreeSparse = 2
+};
+
+enum ServerStorageType {
+  // Open-addressing hash table, works for any row id distribution.
+  ServerOpenAddressing = 0,
+  // Array indexed by row id, for tables whose row ids are contiguous.
+  ServerDenseRange = 1
+};
+
+// Wire encoding of the row and column ids in oplog messages.
+enum OpLogIndexEncoding {
+  RawIndex = 0,
+  // Varints, column ids delta-encoded within a row.
+  VarintIndex = 1
+};
+
+// Wire encoding of the update values in oplog messages. The lossy encodings
+// require float updates; the encoding error is added to the next update of
+// the same entry the bg thread sends.
+enum OpLogValueEncoding {
+  RawValue = 0,
+  FP16Value = 1,
+  BF16Value = 2,
+  // 8-bit linear quantization with one scale per row.
+  Q8Value = 3
+};
+
+// How the rows of a table are spread over the server threads.
+enum RowPartitionType {
+  // Row id modulo the number of server threads.
+  ModuloPartition = 0,
+  // Hash of table id and row id, spreads tables with strided or skewed row
+  // ids evenly.
+  HashPartition = 1,
+  // Contiguous ranges of range_partition_num_rows / num_server_threads rows.
+  RangePartition = 2,
+  // Consistent hashing with virtual nodes.
+  ConsistentHashPartition = 3
+};
+
+// How the server applies the updates of a table. With any rule but
+// ServerAdd, clients Inc() gradients rather than deltas, and the server
+// keeps the optimizer state of each column next to the row. Requires
+// DenseRow<float> rows.
+enum ServerUpdateRuleType {
+  // value += update.
+  ServerAdd = 0,
+  // v = momentum * v + g; value -= learning_rate * v.
+  ServerSGDMomentum = 1,
+  ServerAdaGrad = 2,
+  // beta1 is the momentum; bias correction counts the updates of the row.
+  ServerAdam = 3,
+  // FTRL-proximal, learning_rate is alpha.
+  ServerFTRL = 4
+};
+
+struct ServerUpdateRuleConfig {
+  ServerUpdateRuleConfig():
+      type(ServerAdd),
+      learning_rate(0.01),
+      momentum(0.9),
+      beta2(0.999),
+      epsilon(1e-8),
+      ftrl_beta(1),
+      l1(0),
+      l2(0) { }
+
+  ServerUpdateRuleType type;
+  float learning_rate;
+  // SGDMomentum momentum, Adam beta1.
+  float momentum;
+  float beta2;
+  float epsilon;
+  // FTRL only.
+  float ftrl_beta;
+  float l1;
+  float l2;
 };
 
 struct TableGroupConfig {
 
   TableGroupConfig():
       stats_path(""),
+      metrics_path(""),
+      metrics_interval_sec(10),
       num_comm_channels_per_client(1),
       num_tables(1),
       num_total_clients(1),
@@ -70,13 +151,21 @@ struct TableGroupConfig {
       bg_idle_milli(2),
       bandwidth_mbps(40),
       oplog_push_upper_bound_kb(100),
+      adaptive_oplog_push(false),
       oplog_push_staleness_tolerance(2),
       thread_oplog_batch_size(100*1000*1000),
       server_row_candidate_factor(5),
-      numa_opt(false) { }
+      numa_opt(false),
+      comm_bus_ipc_dir("/dev/shm") { }
 
   std::string stats_path;
 
+  // Prefix of the file the live metrics are written to, see Metrics::Init().
+  // Empty disables writing them.
+  std::string metrics_path;
+
+  int32_t metrics_interval_sec;
+
   // ================= Global Parameters ===================
   // Global parameters have to be the same across all processes.
 
@@ -138,6 +227,11 @@ struct TableGroupConfig {
   // upper bound on update message size in kilobytes
   size_t oplog_push_upper_bound_kb;
 
+  // SSPAggr: if true, bandwidth_mbps and oplog_push_upper_bound_kb are only
+  // the initial send rate and push size; bg threads adjust both per server
+  // from the measured oplog ack round trips.
+  bool adaptive_oplog_push;
+
   int32_t oplog_push_staleness_tolerance;
 
   size_t thread_oplog_batch_size;
@@ -149,6 +243,11 @@ struct TableGroupConfig {
   long server_row_candidate_factor;
 
   bool numa_opt;
+
+  // Directory for the IPC endpoints that processes on the same host use to
+  // talk to each other instead of TCP. Must be the same for all processes on
+  // a host. Empty means always use TCP.
+  std::string comm_bus_ipc_dir;
 };
 
 // TableInfo is shared between client and server.
@@ -159,7 +258,14 @@ struct TableInfo {
       row_capacity(0),
       oplog_dense_serialized(false),
       row_oplog_type(1),
-      dense_row_oplog_capacity(0) { }
+      dense_row_oplog_capacity(0),
+      server_storage_type(ServerOpenAddressing),
+      server_storage_capacity(0),
+      oplog_index_encoding(RawIndex),
+      oplog_value_encoding(RawValue),
+      oplog_compressed(false),
+      row_partition_type(ModuloPartition),
+      range_partition_num_rows(0) { }
 
   // table_staleness is used for SSP and ClockVAP.
   int32_t table_staleness;
@@ -178,6 +284,32 @@ struct TableInfo {
   int32_t row_oplog_type;
 
   size_t dense_row_oplog_capacity;
+
+  ServerStorageType server_storage_type;
+
+  // Estimated number of rows held by each server, used to size the server
+  // storage up front. 0 lets the storage start small and grow.
+  size_t server_storage_capacity;
+
+  OpLogIndexEncoding oplog_index_encoding;
+
+  OpLogValueEncoding oplog_value_encoding;
+
+  // Snappy-compress the encoded oplogs of the table.
+  bool oplog_compressed;
+
+  RowPartitionType row_partition_type;
+
+  // Row ids are in [0, range_partition_num_rows). Required by
+  // RangePartition.
+  int32_t range_partition_num_rows;
+
+  // With any rule but ServerAdd, Inc() sends gradients that the server turns
+  // into updates. Clients then read only server-applied values: their own
+  // gradients are neither added to cached rows nor replayed onto fetched
+  // ones (no_oplog_replay is implied), and AppendOnly oplogs are not
+  // supported.
+  ServerUpdateRuleConfig server_update_rule;
 };
 
 // ClientTableConfig is used by client only.
@@ -192,7 +324,8 @@ struct ClientTableConfig {
       per_thread_append_only_buff_pool_size(3),
       bg_apply_append_oplog_freq(1),
       process_storage_type(BoundedSparse),
-      no_oplog_replay(false) { }
+      no_oplog_replay(false),
+      thread_local_oplog(false) { }
 
   TableInfo table_info;
 
@@ -219,6 +352,11 @@ struct ClientTableConfig {
   ProcessStorageType process_storage_type;
 
   bool no_oplog_replay;
+
+  // Inc/BatchInc/DenseBatchInc accumulate in a buffer private to the app
+  // thread, merged into the table oplog at Clock(); the thread's own updates
+  // show up in Get() only after that. SSP and SSPPush, Sparse or Dense oplog.
+  bool thread_local_oplog;
 };
 
 }  // namespace petuum
@@ -114,6 +114,14 @@ public:
     return abstract_table_group_->Clock();
   }
 
+  // Sends the updates this thread has made so far in the current clock to
+  // the servers without advancing the clock, so that communication can
+  // overlap with the rest of the clock's computation. Reads are not
+  // affected; the updates still count as made in the current clock.
+  static void FlushOpLogs() {
+    return abstract_table_group_->FlushOpLogs();
+  }
+
   // Called by application threads that access table API
   // (referred to as table threads).
   // Threads that calls GlobalBarrier must be at the same clock.
@@ -121,10 +129,21 @@ public:
   // have reached the barrier;
   // 2) Table threads that move beyond the barrier are guaranteed to see
   // the updates that other table threads apply to the table.
+  // The barrier advances the clock of each table thread by one.
   static void GlobalBarrier() {
     return abstract_table_group_->GlobalBarrier();
   }
 
+  // Called by all table threads with the same count and op; on return buf
+  // holds op applied element-wise over the bufs of all table threads of all
+  // clients. T is int32_t, int64_t, float or double. Meant for small
+  // vectors, e.g. losses or counts, that need not live in a table.
+  template<typename T>
+  static void AllReduce(T *buf, int32_t count, AllReduceOp op) {
+    return abstract_table_group_->AllReduce(
+        buf, count, AllReduceDataTypeOf<T>::value, op);
+  }
+
 private:
   static AbstractTableGroup *abstract_table_group_;
 };
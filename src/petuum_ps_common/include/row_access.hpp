@@ -28,9 +28,19 @@ public:
     return *(dynamic_cast<ROW*>(client_row_ptr_->GetRowDataPtr()));
   }
 
+  // Read view of the row (ROW::View, see row_view.hpp), for reading the
+  // whole row without taking the row lock on every access. Unlike Get(), the
+  // view stays valid after this RowAccessor is gone, but does not see
+  // updates made after it was taken.
+  template<typename ROW>
+  inline typename ROW::View GetView() {
+    return Get<ROW>().GetView();
+  }
+
 private:
   friend class BoundedDenseProcessStorage;
   friend class BoundedSparseProcessStorage;
+  friend class LockFreeSparseProcessStorage;
   friend class AbstractBgWorker;
   friend class SSPBgWorker;
   friend class SSPPushBgWorker;
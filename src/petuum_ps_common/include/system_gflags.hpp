@@ -7,6 +7,9 @@
 #include <petuum_ps_common/util/utils.hpp>
 
 DEFINE_string(stats_path, "", "stats file path prefix");
+DEFINE_string(metrics_path, "",
+              "live metrics file path prefix; empty to not write them");
+DEFINE_int32(metrics_interval_sec, 10, "seconds between metrics writes");
 
 // Topology Configs
 DEFINE_int32(num_clients, 1, "total number of clients");
@@ -15,6 +18,8 @@ DEFINE_bool(init_thread_access_table, false, "whether init thread accesses table
 DEFINE_int32(num_table_threads, 1, "no. of worker threads per client");
 DEFINE_int32(client_id, 0, "This client's ID");
 DEFINE_string(hostfile, "", "path to Petuum PS server configuration file");
+DEFINE_string(comm_bus_ipc_dir, "/dev/shm",
+              "directory for same-host IPC endpoints; empty to use TCP only");
 
 // Execution Configs
 DEFINE_string(consistency_model, "SSPPush", "SSPAggr/SSPPush/SSP");
@@ -25,6 +30,8 @@ DEFINE_uint64(bg_idle_milli, 10, "Bg idle millisecond");
 
 DEFINE_uint64(oplog_push_upper_bound_kb, 100,
              "oplog push upper bound in Kilobytes per comm thread.");
+DEFINE_bool(adaptive_oplog_push, false,
+            "adapt oplog push size and rate per server to measured acks");
 DEFINE_int32(oplog_push_staleness_tolerance, 2,
              "oplog push staleness tolerance");
 DEFINE_uint64(thread_oplog_batch_size, 100*1000*1000, "thread oplog batch size");
@@ -45,6 +52,8 @@ namespace petuum {
 void InitTableGroupConfig(TableGroupConfig *config, int32_t *client_id,
                           int32_t num_tables) {
   config->stats_path = FLAGS_stats_path;
+  config->metrics_path = FLAGS_metrics_path;
+  config->metrics_interval_sec = FLAGS_metrics_interval_sec;
   config->num_comm_channels_per_client = FLAGS_num_comm_channels_per_client;
   config->num_tables = num_tables;
   config->num_total_clients = FLAGS_num_clients;
@@ -87,11 +96,13 @@ void InitTableGroupConfig(TableGroupConfig *config, int32_t *client_id,
   config->bg_idle_milli = FLAGS_bg_idle_milli;
   config->bandwidth_mbps = FLAGS_bandwidth_mbps;
   config->oplog_push_upper_bound_kb = FLAGS_oplog_push_upper_bound_kb;
+  config->adaptive_oplog_push = FLAGS_adaptive_oplog_push;
   config->oplog_push_staleness_tolerance = FLAGS_oplog_push_staleness_tolerance;
   config->thread_oplog_batch_size = FLAGS_thread_oplog_batch_size;
   config->server_push_row_threshold = FLAGS_server_push_row_threshold;
   config->server_idle_milli = FLAGS_server_idle_milli;
   config->server_row_candidate_factor = FLAGS_server_row_candidate_factor;
+  config->comm_bus_ipc_dir = FLAGS_comm_bus_ipc_dir;
 
   *client_id = FLAGS_client_id;
 }
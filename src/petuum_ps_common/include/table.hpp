@@ -168,6 +168,13 @@ public:
         system_table_->Get(row_id, row_accessor)->GetRowDataPtr()));
   }
 
+  // Make all rows in row_ids available to Get() without further blocking.
+  // Rows that are missing or too stale are fetched with one request per
+  // server, rather than one round trip per row.
+  void GetBatch(const std::vector<int32_t> &row_ids) {
+    system_table_->GetBatch(row_ids.data(), row_ids.size());
+  }
+
   void Inc(int32_t row_id, int32_t column_id, UPDATE update){
     system_table_->Inc(row_id, column_id, &update);
   }
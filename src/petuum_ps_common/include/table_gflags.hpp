@@ -18,6 +18,26 @@ DEFINE_uint64(append_only_buffer_capacity, 1024*1024, "buffer capacity in bytes"
 DEFINE_uint64(append_only_buffer_pool_size, 3, "append_ only buffer pool size");
 DEFINE_int32(bg_apply_append_oplog_freq, 4, "bg apply append oplog freq");
 DEFINE_string(process_storage_type, "BoundedSparse", "proess storage type");
+DEFINE_string(server_storage_type, "OpenAddressing", "server storage type");
+DEFINE_string(oplog_index_encoding, "Raw", "oplog index encoding: Raw or Varint");
+DEFINE_string(oplog_value_encoding, "Raw",
+              "oplog value encoding: Raw, FP16, BF16 or Q8");
+DEFINE_bool(oplog_compressed, false, "snappy-compress oplogs");
+DEFINE_string(row_partition_type, "Modulo",
+              "row partitioning: Modulo, Hash, Range or ConsistentHash");
+DEFINE_int32(range_partition_num_rows, 0,
+             "number of rows for Range partitioning");
+DEFINE_bool(thread_local_oplog, false,
+            "buffer Inc in per-thread oplogs until Clock");
+DEFINE_string(server_update_rule, "Add",
+              "server update rule: Add, SGDMomentum, AdaGrad, Adam or FTRL");
+DEFINE_double(server_learning_rate, 0.01, "server update rule learning rate");
+DEFINE_double(server_momentum, 0.9, "SGDMomentum momentum, Adam beta1");
+DEFINE_double(server_beta2, 0.999, "Adam beta2");
+DEFINE_double(server_epsilon, 1e-8, "AdaGrad and Adam epsilon");
+DEFINE_double(server_ftrl_beta, 1, "FTRL beta");
+DEFINE_double(server_l1, 0, "FTRL l1 regularization");
+DEFINE_double(server_l2, 0, "FTRL l2 regularization");
 
 namespace petuum {
 
@@ -62,9 +82,77 @@ void InitTableConfig(ClientTableConfig *config) {
     config->process_storage_type = petuum::BoundedDense;
   } else if (FLAGS_process_storage_type == "BoundedSparse") {
     config->process_storage_type = petuum::BoundedSparse;
+  } else if (FLAGS_process_storage_type == "LockFreeSparse") {
+    config->process_storage_type = petuum::LockFreeSparse;
   } else {
     LOG(FATAL) << "Unknown process storage type " << FLAGS_process_storage_type;
   }
+
+  if (FLAGS_server_storage_type == "OpenAddressing") {
+    config->table_info.server_storage_type = petuum::ServerOpenAddressing;
+  } else if (FLAGS_server_storage_type == "DenseRange") {
+    config->table_info.server_storage_type = petuum::ServerDenseRange;
+  } else {
+    LOG(FATAL) << "Unknown server storage type " << FLAGS_server_storage_type;
+  }
+
+  if (FLAGS_oplog_index_encoding == "Raw") {
+    config->table_info.oplog_index_encoding = petuum::RawIndex;
+  } else if (FLAGS_oplog_index_encoding == "Varint") {
+    config->table_info.oplog_index_encoding = petuum::VarintIndex;
+  } else {
+    LOG(FATAL) << "Unknown oplog index encoding " << FLAGS_oplog_index_encoding;
+  }
+
+  if (FLAGS_oplog_value_encoding == "Raw") {
+    config->table_info.oplog_value_encoding = petuum::RawValue;
+  } else if (FLAGS_oplog_value_encoding == "FP16") {
+    config->table_info.oplog_value_encoding = petuum::FP16Value;
+  } else if (FLAGS_oplog_value_encoding == "BF16") {
+    config->table_info.oplog_value_encoding = petuum::BF16Value;
+  } else if (FLAGS_oplog_value_encoding == "Q8") {
+    config->table_info.oplog_value_encoding = petuum::Q8Value;
+  } else {
+    LOG(FATAL) << "Unknown oplog value encoding " << FLAGS_oplog_value_encoding;
+  }
+
+  config->table_info.oplog_compressed = FLAGS_oplog_compressed;
+
+  if (FLAGS_row_partition_type == "Modulo") {
+    config->table_info.row_partition_type = petuum::ModuloPartition;
+  } else if (FLAGS_row_partition_type == "Hash") {
+    config->table_info.row_partition_type = petuum::HashPartition;
+  } else if (FLAGS_row_partition_type == "Range") {
+    config->table_info.row_partition_type = petuum::RangePartition;
+  } else if (FLAGS_row_partition_type == "ConsistentHash") {
+    config->table_info.row_partition_type = petuum::ConsistentHashPartition;
+  } else {
+    LOG(FATAL) << "Unknown row partition type " << FLAGS_row_partition_type;
+  }
+  config->table_info.range_partition_num_rows = FLAGS_range_partition_num_rows;
+  config->thread_local_oplog = FLAGS_thread_local_oplog;
+
+  ServerUpdateRuleConfig &rule = config->table_info.server_update_rule;
+  if (FLAGS_server_update_rule == "Add") {
+    rule.type = petuum::ServerAdd;
+  } else if (FLAGS_server_update_rule == "SGDMomentum") {
+    rule.type = petuum::ServerSGDMomentum;
+  } else if (FLAGS_server_update_rule == "AdaGrad") {
+    rule.type = petuum::ServerAdaGrad;
+  } else if (FLAGS_server_update_rule == "Adam") {
+    rule.type = petuum::ServerAdam;
+  } else if (FLAGS_server_update_rule == "FTRL") {
+    rule.type = petuum::ServerFTRL;
+  } else {
+    LOG(FATAL) << "Unknown server update rule " << FLAGS_server_update_rule;
+  }
+  rule.learning_rate = FLAGS_server_learning_rate;
+  rule.momentum = FLAGS_server_momentum;
+  rule.beta2 = FLAGS_server_beta2;
+  rule.epsilon = FLAGS_server_epsilon;
+  rule.ftrl_beta = FLAGS_server_ftrl_beta;
+  rule.l1 = FLAGS_server_l1;
+  rule.l2 = FLAGS_server_l2;
 }
 
 }
@@ -0,0 +1,442 @@
+#include <petuum_ps_common/oplog/oplog_codec.hpp>
+#include <glog/logging.h>
+#include <snappy.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace petuum {
+
+namespace {
+
+const size_t kHeaderSize = sizeof(int32_t) + sizeof(size_t) + sizeof(size_t);
+
+void PutVarint(uint32_t value, std::vector<uint8_t> *out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+uint32_t GetVarint(const uint8_t **in) {
+  uint32_t value = 0;
+  for (int32_t shift = 0; ; shift += 7) {
+    uint8_t byte = *((*in)++);
+    value |= uint32_t(byte & 0x7f) << shift;
+    if (byte < 0x80)
+      return value;
+  }
+}
+
+// Column ids are usually ascending, but the deltas are zigzag-encoded so
+// that unordered ids still round-trip.
+uint32_t ZigZagEncode(uint32_t delta) {
+  return (delta << 1) ^ uint32_t(int32_t(delta) >> 31);
+}
+
+uint32_t ZigZagDecode(uint32_t value) {
+  return (value >> 1) ^ (0u - (value & 1));
+}
+
+uint16_t FloatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint32_t sign = (bits >> 16) & 0x8000;
+  uint32_t abs_bits = bits & 0x7fffffff;
+  // Inf and NaN.
+  if (abs_bits >= 0x7f800000)
+    return sign | 0x7c00 | (abs_bits > 0x7f800000 ? 0x200 : 0);
+  // Rounds to 65520 or above, which is out of range.
+  if (abs_bits >= 0x477ff000)
+    return sign | 0x7c00;
+  // Subnormal, in units of 2^-24.
+  if (abs_bits < 0x38800000) {
+    float abs_value;
+    memcpy(&abs_value, &abs_bits, sizeof(abs_value));
+    return sign | uint32_t(lrintf(abs_value * 16777216.0f));
+  }
+  // Round to nearest even and rebias the exponent.
+  abs_bits += 0xfff + ((abs_bits >> 13) & 1);
+  abs_bits -= (127 - 15) << 23;
+  return sign | (abs_bits >> 13);
+}
+
+float HalfToFloat(uint16_t half) {
+  uint32_t sign = uint32_t(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  if (exponent == 0) {
+    float value = mantissa * (1.0f / 16777216.0f);
+    return sign ? -value : value;
+  }
+  uint32_t bits = (exponent == 0x1f)
+      ? (sign | 0x7f800000 | (mantissa << 13))
+      : (sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+uint16_t FloatToBF16(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  // Keep NaN a (quiet) NaN.
+  if ((bits & 0x7fffffff) > 0x7f800000)
+    return (bits >> 16) | 0x40;
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return bits >> 16;
+}
+
+float BF16ToFloat(uint16_t bf16) {
+  uint32_t bits = uint32_t(bf16) << 16;
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+}  // anonymous namespace
+
+OpLogCodec::OpLogCodec(const TableInfo &table_info, size_t update_size):
+    index_encoding_(table_info.oplog_index_encoding),
+    value_encoding_(table_info.oplog_value_encoding),
+    compressed_(table_info.oplog_compressed),
+    dense_serialized_(table_info.oplog_dense_serialized),
+    dense_row_size_(table_info.dense_row_oplog_capacity),
+    update_size_(update_size),
+    num_rows_(0),
+    raw_size_(0) {
+  if (value_encoding_ != RawValue) {
+    CHECK_EQ(update_size_, sizeof(float))
+        << "Lossy oplog value encodings require float updates";
+  }
+}
+
+bool OpLogCodec::IsRaw(const TableInfo &table_info) {
+  return table_info.oplog_index_encoding == RawIndex
+      && table_info.oplog_value_encoding == RawValue
+      && !table_info.oplog_compressed;
+}
+
+size_t OpLogCodec::Encode(const uint8_t *raw) {
+  num_rows_ = *(reinterpret_cast<const int32_t*>(raw));
+  const uint8_t *mem = raw + sizeof(int32_t);
+  raw_size_ = sizeof(int32_t);
+
+  payload_.clear();
+  for (int32_t i = 0; i < num_rows_; ++i) {
+    int32_t row_id = *(reinterpret_cast<const int32_t*>(mem));
+    mem += sizeof(int32_t);
+    if (dense_serialized_) {
+      EncodeDenseRow(row_id, mem, &raw_size_);
+      mem += dense_row_size_*update_size_;
+    } else {
+      int32_t num_updates = *(reinterpret_cast<const int32_t*>(mem));
+      mem += sizeof(int32_t);
+      EncodeSparseRow(row_id, mem, num_updates, &raw_size_);
+      mem += num_updates*(sizeof(int32_t) + update_size_);
+    }
+  }
+
+  return kHeaderSize + (compressed_
+      ? snappy::MaxCompressedLength(payload_.size()) : payload_.size());
+}
+
+size_t OpLogCodec::WriteEncoded(uint8_t *encoded) {
+  size_t payload_size = payload_.size();
+  if (compressed_) {
+    snappy::RawCompress(reinterpret_cast<const char*>(payload_.data()),
+                        payload_.size(),
+                        reinterpret_cast<char*>(encoded + kHeaderSize),
+                        &payload_size);
+  } else {
+    memcpy(encoded + kHeaderSize, payload_.data(), payload_size);
+  }
+
+  *(reinterpret_cast<int32_t*>(encoded)) = num_rows_;
+  *(reinterpret_cast<size_t*>(encoded + sizeof(int32_t))) = raw_size_;
+  *(reinterpret_cast<size_t*>(encoded + sizeof(int32_t) + sizeof(size_t)))
+      = payload_size;
+  return kHeaderSize + payload_size;
+}
+
+size_t OpLogCodec::Decode(const uint8_t *encoded,
+                          std::vector<uint8_t> *raw) const {
+  int32_t num_rows = *(reinterpret_cast<const int32_t*>(encoded));
+  size_t raw_size
+      = *(reinterpret_cast<const size_t*>(encoded + sizeof(int32_t)));
+  size_t payload_size = *(reinterpret_cast<const size_t*>(
+      encoded + sizeof(int32_t) + sizeof(size_t)));
+  const uint8_t *in = encoded + kHeaderSize;
+
+  std::vector<uint8_t> uncompressed;
+  if (compressed_) {
+    const char *compressed = reinterpret_cast<const char*>(in);
+    size_t uncompressed_size;
+    CHECK(snappy::GetUncompressedLength(compressed, payload_size,
+                                        &uncompressed_size));
+    uncompressed.resize(uncompressed_size);
+    CHECK(snappy::RawUncompress(compressed, payload_size,
+                                reinterpret_cast<char*>(uncompressed.data())));
+    in = uncompressed.data();
+  }
+
+  raw->resize(raw_size);
+  uint8_t *out = raw->data();
+  *(reinterpret_cast<int32_t*>(out)) = num_rows;
+  out += sizeof(int32_t);
+
+  for (int32_t i = 0; i < num_rows; ++i) {
+    *(reinterpret_cast<int32_t*>(out)) = GetIndex(&in);
+    out += sizeof(int32_t);
+
+    int32_t num_updates = dense_row_size_;
+    if (!dense_serialized_) {
+      num_updates = GetIndex(&in);
+      *(reinterpret_cast<int32_t*>(out)) = num_updates;
+      out += sizeof(int32_t);
+
+      uint32_t column_id = 0;
+      for (int32_t j = 0; j < num_updates; ++j) {
+        uint32_t index = GetIndex(&in);
+        if (index_encoding_ == VarintIndex)
+          column_id += ZigZagDecode(index);
+        else
+          column_id = index;
+        *(reinterpret_cast<int32_t*>(out)) = column_id;
+        out += sizeof(int32_t);
+      }
+    }
+    GetValues(&in, num_updates, out);
+    out += num_updates*update_size_;
+  }
+  CHECK_EQ(out - raw->data(), raw_size);
+  return kHeaderSize + payload_size;
+}
+
+// ==================== Private Methods ======================
+
+void OpLogCodec::PutIndex(uint32_t index, std::vector<uint8_t> *out) const {
+  if (index_encoding_ == VarintIndex) {
+    PutVarint(index, out);
+  } else {
+    const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&index);
+    out->insert(out->end(), bytes, bytes + sizeof(index));
+  }
+}
+
+uint32_t OpLogCodec::GetIndex(const uint8_t **in) const {
+  if (index_encoding_ == VarintIndex)
+    return GetVarint(in);
+  uint32_t index;
+  memcpy(&index, *in, sizeof(index));
+  *in += sizeof(index);
+  return index;
+}
+
+// Encoded values are packed with no alignment, so they are accessed through
+// memcpy.
+void OpLogCodec::PutValues(const float *values, int32_t num_values,
+                           std::vector<uint8_t> *out, float *decoded) const {
+  size_t offset = out->size();
+  switch (value_encoding_) {
+    case FP16Value:
+    case BF16Value:
+      {
+        out->resize(offset + num_values*sizeof(uint16_t));
+        uint8_t *encoded = out->data() + offset;
+        for (int32_t i = 0; i < num_values; ++i) {
+          uint16_t value;
+          if (value_encoding_ == FP16Value) {
+            value = FloatToHalf(values[i]);
+            decoded[i] = HalfToFloat(value);
+          } else {
+            value = FloatToBF16(values[i]);
+            decoded[i] = BF16ToFloat(value);
+          }
+          memcpy(encoded + i*sizeof(uint16_t), &value, sizeof(uint16_t));
+        }
+      }
+      break;
+    case Q8Value:
+      {
+        float max_abs = 0;
+        for (int32_t i = 0; i < num_values; ++i) {
+          float abs_value = std::fabs(values[i]);
+          if (abs_value > max_abs)
+            max_abs = abs_value;
+        }
+        float scale = max_abs / 127;
+
+        out->resize(offset + sizeof(float) + num_values);
+        memcpy(out->data() + offset, &scale, sizeof(float));
+        int8_t *encoded = reinterpret_cast<int8_t*>(
+            out->data() + offset + sizeof(float));
+        for (int32_t i = 0; i < num_values; ++i) {
+          long quantized = (scale > 0) ? lrintf(values[i] / scale) : 0;
+          if (quantized > 127)
+            quantized = 127;
+          else if (quantized < -127)
+            quantized = -127;
+          encoded[i] = quantized;
+          decoded[i] = quantized*scale;
+        }
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unknown lossy oplog value encoding = " << value_encoding_;
+  }
+}
+
+void OpLogCodec::GetValues(const uint8_t **in, int32_t num_values,
+                           uint8_t *out) const {
+  switch (value_encoding_) {
+    case RawValue:
+      memcpy(out, *in, num_values*update_size_);
+      *in += num_values*update_size_;
+      break;
+    case FP16Value:
+    case BF16Value:
+      for (int32_t i = 0; i < num_values; ++i) {
+        uint16_t value;
+        memcpy(&value, *in + i*sizeof(uint16_t), sizeof(uint16_t));
+        float decoded = (value_encoding_ == FP16Value)
+                        ? HalfToFloat(value) : BF16ToFloat(value);
+        memcpy(out + i*sizeof(float), &decoded, sizeof(float));
+      }
+      *in += num_values*sizeof(uint16_t);
+      break;
+    case Q8Value:
+      {
+        float scale;
+        memcpy(&scale, *in, sizeof(float));
+        const int8_t *encoded
+            = reinterpret_cast<const int8_t*>(*in + sizeof(float));
+        for (int32_t i = 0; i < num_values; ++i) {
+          float decoded = encoded[i]*scale;
+          memcpy(out + i*sizeof(float), &decoded, sizeof(float));
+        }
+        *in += sizeof(float) + num_values;
+      }
+      break;
+    default:
+      LOG(FATAL) << "Unknown oplog value encoding = " << value_encoding_;
+  }
+}
+
+void OpLogCodec::EncodeSparseRow(int32_t row_id, const uint8_t *mem,
+                                 int32_t num_updates, size_t *raw_size) {
+  const int32_t *column_ids = reinterpret_cast<const int32_t*>(mem);
+  const uint8_t *updates = mem + num_updates*sizeof(int32_t);
+
+  PutIndex(row_id, &payload_);
+  PutIndex(num_updates, &payload_);
+  uint32_t prev_column_id = 0;
+  for (int32_t i = 0; i < num_updates; ++i) {
+    uint32_t column_id = column_ids[i];
+    if (index_encoding_ == VarintIndex)
+      PutIndex(ZigZagEncode(column_id - prev_column_id), &payload_);
+    else
+      PutIndex(column_id, &payload_);
+    prev_column_id = column_id;
+  }
+
+  *raw_size += sizeof(int32_t) + sizeof(int32_t)
+               + num_updates*(sizeof(int32_t) + update_size_);
+
+  if (value_encoding_ == RawValue) {
+    payload_.insert(payload_.end(), updates,
+                    updates + num_updates*update_size_);
+    return;
+  }
+
+  // Residuals are only added to the columns that are sent anyway, so that
+  // rows do not grow; the others wait for the next update of their column.
+  entries_.resize(num_updates);
+  values_.resize(num_updates);
+  for (int32_t i = 0; i < num_updates; ++i) {
+    entries_[i].first = column_ids[i];
+    memcpy(&(entries_[i].second), updates + i*sizeof(float), sizeof(float));
+    values_[i] = entries_[i].second;
+  }
+  auto CompareColumnId = [](const std::pair<int32_t, float> &a,
+                            const std::pair<int32_t, float> &b) {
+    return a.first < b.first;
+  };
+
+  auto residual_iter = sparse_residuals_.find(row_id);
+  SparseResidual *residual = (residual_iter == sparse_residuals_.end())
+                             ? 0 : &(residual_iter->second);
+  if (residual != 0) {
+    for (int32_t i = 0; i < num_updates; ++i) {
+      auto iter = std::lower_bound(residual->begin(), residual->end(),
+                                   entries_[i], CompareColumnId);
+      if (iter != residual->end() && iter->first == column_ids[i])
+        values_[i] += iter->second;
+    }
+  }
+
+  decoded_.resize(num_updates);
+  PutValues(values_.data(), num_updates, &payload_, decoded_.data());
+
+  // entries_ now holds the new residuals of the columns sent.
+  for (int32_t i = 0; i < num_updates; ++i) {
+    entries_[i].second = values_[i] - decoded_[i];
+  }
+  if (!std::is_sorted(entries_.begin(), entries_.end(), CompareColumnId))
+    std::sort(entries_.begin(), entries_.end(), CompareColumnId);
+
+  // Keep the residuals of the columns that were not sent.
+  SparseResidual new_residual;
+  for (const auto &entry : entries_) {
+    if (entry.second != 0)
+      new_residual.push_back(entry);
+  }
+  if (residual != 0) {
+    size_t num_sent_residuals = new_residual.size();
+    for (const auto &column_residual : *residual) {
+      if (!std::binary_search(entries_.begin(), entries_.end(),
+                              column_residual, CompareColumnId))
+        new_residual.push_back(column_residual);
+    }
+    std::inplace_merge(new_residual.begin(),
+                       new_residual.begin() + num_sent_residuals,
+                       new_residual.end(), CompareColumnId);
+  }
+
+  if (new_residual.empty())
+    sparse_residuals_.erase(row_id);
+  else
+    sparse_residuals_[row_id].swap(new_residual);
+}
+
+void OpLogCodec::EncodeDenseRow(int32_t row_id, const uint8_t *mem,
+                                size_t *raw_size) {
+  PutIndex(row_id, &payload_);
+  *raw_size += sizeof(int32_t) + dense_row_size_*update_size_;
+
+  if (value_encoding_ == RawValue) {
+    payload_.insert(payload_.end(), mem, mem + dense_row_size_*update_size_);
+    return;
+  }
+
+  std::vector<float> &residual = dense_residuals_[row_id];
+  residual.resize(dense_row_size_, 0);
+
+  values_.resize(dense_row_size_);
+  memcpy(values_.data(), mem, dense_row_size_*sizeof(float));
+  for (int32_t i = 0; i < dense_row_size_; ++i) {
+    values_[i] += residual[i];
+  }
+  decoded_.resize(dense_row_size_);
+  PutValues(values_.data(), dense_row_size_, &payload_, decoded_.data());
+  bool has_residual = false;
+  for (int32_t i = 0; i < dense_row_size_; ++i) {
+    residual[i] = values_[i] - decoded_[i];
+    has_residual = has_residual || (residual[i] != 0);
+  }
+  if (!has_residual)
+    dense_residuals_.erase(row_id);
+}
+
+}  // namespace petuum
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <petuum_ps_common/include/configs.hpp>
+#include <boost/noncopyable.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace petuum {
+
+// Encodes the serialized row oplogs of one table for the wire, following
+// the table's TableInfo, and decodes them back on the server.
+//
+// The raw format is what RowOpLogSerializer and BgOpLogPartition write:
+// 1. int32_t : num_rows
+// 2. for each row, int32_t row id followed by the sparse or dense
+//    serialized row oplog
+//
+// The encoded format is
+// 1. int32_t : num_rows
+// 2. size_t : size of the decoded raw format
+// 3. size_t : payload size
+// 4. payload : the rows with ids and values encoded, snappy-compressed if
+//    oplog_compressed is set.
+class OpLogCodec : boost::noncopyable {
+public:
+  OpLogCodec(const TableInfo &table_info, size_t update_size);
+
+  // True if the table's oplogs are sent in the raw format.
+  static bool IsRaw(const TableInfo &table_info);
+
+  // Encodes raw and returns an upper bound on the size of its encoding,
+  // which WriteEncoded() then writes out. This lets the caller size the
+  // message before any of it is written. With a lossy value encoding the
+  // error of each value is kept, and added to the same entry the next time
+  // its row is encoded. Not thread-safe.
+  size_t Encode(const uint8_t *raw);
+
+  // Writes the encoding prepared by the last Encode() to encoded, which has
+  // room for the size Encode() returned, and returns the bytes written.
+  size_t WriteEncoded(uint8_t *encoded);
+
+  // Decodes into raw and returns the number of bytes read from encoded.
+  size_t Decode(const uint8_t *encoded, std::vector<uint8_t> *raw) const;
+
+private:
+  typedef std::vector<std::pair<int32_t, float> > SparseResidual;
+
+  void PutIndex(uint32_t index, std::vector<uint8_t> *out) const;
+  uint32_t GetIndex(const uint8_t **in) const;
+
+  // Appends the encoding of num_values floats to out and writes the
+  // decoded values to decoded.
+  void PutValues(const float *values, int32_t num_values,
+                 std::vector<uint8_t> *out, float *decoded) const;
+  // Decodes num_values values into out.
+  void GetValues(const uint8_t **in, int32_t num_values, uint8_t *out) const;
+
+  void EncodeSparseRow(int32_t row_id, const uint8_t *mem,
+                       int32_t num_updates, size_t *raw_size);
+  void EncodeDenseRow(int32_t row_id, const uint8_t *mem, size_t *raw_size);
+
+  const OpLogIndexEncoding index_encoding_;
+  const OpLogValueEncoding value_encoding_;
+  const bool compressed_;
+  const bool dense_serialized_;
+  const int32_t dense_row_size_;
+  const size_t update_size_;
+
+  // Encoding errors carried over to the next oplogs, by row id. Sparse
+  // residuals are sorted by column id.
+  std::unordered_map<int32_t, std::vector<float> > dense_residuals_;
+  std::unordered_map<int32_t, SparseResidual> sparse_residuals_;
+
+  // The encoding prepared by Encode().
+  int32_t num_rows_;
+  size_t raw_size_;
+
+  // Buffers reused across Encode() calls.
+  std::vector<uint8_t> payload_;
+  std::vector<std::pair<int32_t, float> > entries_;
+  std::vector<float> values_;
+  std::vector<float> decoded_;
+};
+
+}  // namespace petuum
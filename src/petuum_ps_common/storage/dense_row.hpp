@@ -3,6 +3,8 @@
 #pragma once
 
 #include <mutex>
+#include <memory>
+#include <atomic>
 #include <vector>
 #include <string.h>
 #include <assert.h>
@@ -11,7 +13,9 @@
 #include <cmath>
 
 #include <petuum_ps_common/util/lock.hpp>
+#include <petuum_ps_common/util/dense_kernels.hpp>
 #include <petuum_ps_common/storage/numeric_container_row.hpp>
+#include <petuum_ps_common/storage/row_view.hpp>
 #include <ml/feature/dense_feature.hpp>
 
 namespace petuum {
@@ -72,6 +76,8 @@ public:
   void ApplyDenseBatchIncUnsafe(
       const void* update_batch, int32_t index_st, int32_t num_updates);
 
+  float *GetFloatDataUnsafe();
+
   // Thread-safe.
   V operator [](int32_t column_id) const;
   int32_t get_capacity();
@@ -79,27 +85,44 @@ public:
   // Bulk read. Thread-safe.
   void CopyToVector(std::vector<V> *to) const;
 
+  // Copies the first num values to the caller's buffer. Thread-safe.
+  void CopyToMem(V *to, int32_t num) const;
+
   void CopyToDenseFeature(ml::DenseFeature<V>* to) const;
 
+  typedef DenseRowView<V> View;
+
+  // Read view of the current values; takes the lock once, and reads through
+  // the view take no lock at all. Thread-safe.
+  View GetView() const;
+
   static_assert(std::is_pod<V>::value, "V must be POD");
 private:
+  // Gives data_ a private copy if a view still holds it. Called before every
+  // write to data_, with mtx_ held (or before the row is shared).
+  void DetachFromViews();
+
   mutable std::mutex mtx_;
-  std::vector<V> data_;
+  // Shared with the views taken by GetView(); copied on write while any
+  // view is alive.
+  std::shared_ptr<std::vector<V> > data_;
   int32_t capacity_;
 };
 
 template<typename V>
-DenseRow<V>::DenseRow() { }
+DenseRow<V>::DenseRow():
+    data_(new std::vector<V>()) { }
 
 template<typename V>
 DenseRow<V>::~DenseRow() { }
 
 template<typename V>
 void DenseRow<V>::Init(int32_t capacity) {
-  data_.resize(capacity);
+  DetachFromViews();
+  data_->resize(capacity);
   int i;
   for(i = 0; i < capacity; ++i){
-    data_[i] = V(0);
+    (*data_)[i] = V(0);
   }
   capacity_ = capacity;
 }
@@ -109,20 +132,20 @@ AbstractRow *DenseRow<V>::Clone() const {
   std::unique_lock<std::mutex> lock(mtx_);
   DenseRow<V> *new_row = new DenseRow<V>();
   new_row->Init(capacity_);
-  memcpy(new_row->data_.data(), data_.data(), capacity_*sizeof(V));
+  memcpy(new_row->data_->data(), data_->data(), capacity_*sizeof(V));
   //VLOG(0) << "Cloned, capacity_ = " << new_row->capacity_;
   return static_cast<AbstractRow*>(new_row);
 }
 
 template<typename V>
 size_t DenseRow<V>::SerializedSize() const {
-  return data_.size()*sizeof(V);
+  return data_->size()*sizeof(V);
 }
 
 template<typename V>
 size_t DenseRow<V>::Serialize(void *bytes) const {
-  size_t num_bytes = data_.size()*sizeof(V);
-  memcpy(bytes, data_.data(), num_bytes);
+  size_t num_bytes = data_->size()*sizeof(V);
+  memcpy(bytes, data_->data(), num_bytes);
   return num_bytes;
 }
 
@@ -130,8 +153,9 @@ template<typename V>
 bool DenseRow<V>::Deserialize(const void *data, size_t num_bytes) {
   int32_t vec_size = num_bytes/sizeof(V);
   capacity_ = vec_size;
-  data_.resize(vec_size);
-  memcpy(data_.data(), data, num_bytes);
+  DetachFromViews();
+  data_->resize(vec_size);
+  memcpy(data_->data(), data, num_bytes);
   return true;
 }
 
@@ -139,7 +163,8 @@ template<typename V>
 void DenseRow<V>::ResetRowData(const void *data, size_t num_bytes) {
   int32_t vec_size = num_bytes/sizeof(V);
   CHECK_EQ(capacity_, vec_size);
-  memcpy(data_.data(), data, num_bytes);
+  DetachFromViews();
+  memcpy(data_->data(), data, num_bytes);
 }
 
 template<typename V>
@@ -167,16 +192,18 @@ void DenseRow<V>::ApplyBatchInc(const int32_t *column_ids,
 
 template<typename V>
 void DenseRow<V>::ApplyIncUnsafe(int32_t column_id, const void *update) {
-  data_[column_id] += *(reinterpret_cast<const V*>(update));
+  DetachFromViews();
+  (*data_)[column_id] += *(reinterpret_cast<const V*>(update));
 }
 
 template<typename V>
 void DenseRow<V>::ApplyBatchIncUnsafe(const int32_t *column_ids,
   const void *update_batch, int32_t num_updates) {
+  DetachFromViews();
   const V *update_array = reinterpret_cast<const V*>(update_batch);
   int i;
   for (i = 0; i < num_updates; ++i) {
-    data_[column_ids[i]] += update_array[i];
+    (*data_)[column_ids[i]] += update_array[i];
   }
 }
 
@@ -197,24 +224,28 @@ double DenseRow<V>::ApplyBatchIncGetImportance(const int32_t *column_ids,
 template<typename V>
 double DenseRow<V>::ApplyIncUnsafeGetImportance(int32_t column_id,
                                                 const void *update) {
+  DetachFromViews();
   V type_update = *(reinterpret_cast<const V*>(update));
-  double importance = (double(data_[column_id]) == 0) ? double(type_update)
-                      : double(type_update) / double(data_[column_id]);
-  data_[column_id] += type_update;
+  std::vector<V> &data = *data_;
+  double importance = (double(data[column_id]) == 0) ? double(type_update)
+                      : double(type_update) / double(data[column_id]);
+  data[column_id] += type_update;
   return std::abs(importance);
 }
 
 template<typename V>
 double DenseRow<V>::ApplyBatchIncUnsafeGetImportance(const int32_t *column_ids,
   const void *update_batch, int32_t num_updates) {
+  DetachFromViews();
   const V *update_array = reinterpret_cast<const V*>(update_batch);
+  std::vector<V> &data = *data_;
   int i;
   double accum_importance = 0;
   for (i = 0; i < num_updates; ++i) {
     double importance
-        = (double(data_[column_ids[i]]) == 0) ? double(update_array[i])
-        : double(update_array[i]) / double(data_[column_ids[i]]);
-    data_[column_ids[i]] += update_array[i];
+        = (double(data[column_ids[i]]) == 0) ? double(update_array[i])
+        : double(update_array[i]) / double(data[column_ids[i]]);
+    data[column_ids[i]] += update_array[i];
 
     accum_importance += std::abs(importance);
   }
@@ -224,15 +255,17 @@ double DenseRow<V>::ApplyBatchIncUnsafeGetImportance(const int32_t *column_ids,
 template<typename V>
 double DenseRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  DetachFromViews();
   const V *update_array = reinterpret_cast<const V*>(update_batch);
+  std::vector<V> &data = *data_;
   int i;
   double accum_importance = 0;
   for (i = 0; i < num_updates; ++i) {
     int col_id = i + index_st;
     double importance
-        = (double(data_[col_id]) == 0) ? double(update_array[i])
-        : double(update_array[i]) / double(data_[col_id]);
-    data_[col_id] += update_array[i];
+        = (double(data[col_id]) == 0) ? double(update_array[i])
+        : double(update_array[i]) / double(data[col_id]);
+    data[col_id] += update_array[i];
 
     accum_importance += std::abs(importance);
   }
@@ -242,12 +275,9 @@ double DenseRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
 template<typename V>
 void DenseRow<V>::ApplyDenseBatchIncUnsafe(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  DetachFromViews();
   const V *update_array = reinterpret_cast<const V*>(update_batch);
-  int i;
-  for (i = 0; i < num_updates; ++i) {
-    int col_id = i + index_st;
-    data_[col_id] += update_array[i];
-  }
+  DenseAdd(data_->data() + index_st, update_array, num_updates);
 }
 
 template<typename V>
@@ -266,10 +296,19 @@ void DenseRow<V>::ApplyDenseBatchInc(
   return ApplyDenseBatchIncUnsafe(update_batch, index_st, num_updates);
 }
 
+template<typename V>
+float *DenseRow<V>::GetFloatDataUnsafe() {
+  if (!std::is_same<V, float>::value)
+    return 0;
+  // The caller writes through the pointer.
+  DetachFromViews();
+  return reinterpret_cast<float*>(data_->data());
+}
+
 template<typename V>
 V DenseRow<V>::operator [](int32_t column_id) const {
   std::unique_lock<std::mutex> lock(mtx_);
-  V v = data_[column_id];
+  V v = (*data_)[column_id];
   return v;
 }
 
@@ -280,16 +319,39 @@ int32_t DenseRow<V>::get_capacity(){
 
 template<typename V>
 void DenseRow<V>::CopyToVector(std::vector<V> *to) const {
-  std::unique_lock<std::mutex> lock(mtx_);
-  //CHECK_EQ(to->size(), data_.size());
-  to->resize(data_.size());
-  std::copy(data_.begin(), data_.end(), to->begin());
+  // Copies from a view so that writers are not held up by the copy.
+  DenseRowView<V> view = GetView();
+  to->assign(view.begin(), view.end());
+}
+
+template<typename V>
+void DenseRow<V>::CopyToMem(V *to, int32_t num) const {
+  DenseRowView<V> view = GetView();
+  assert(num <= view.size());
+  memcpy(to, view.data(), num * sizeof(V));
 }
 
 template<typename V>
 void DenseRow<V>::CopyToDenseFeature(ml::DenseFeature<V>* to) const {
   std::unique_lock<std::mutex> lock(mtx_);
-  to->Init(data_);
+  to->Init(*data_);
+}
+
+template<typename V>
+DenseRowView<V> DenseRow<V>::GetView() const {
+  std::unique_lock<std::mutex> lock(mtx_);
+  return DenseRowView<V>(data_);
+}
+
+template<typename V>
+void DenseRow<V>::DetachFromViews() {
+  if (data_.use_count() == 1) {
+    // Pairs with the release in the views' shared_ptr destructors, so the
+    // views' last reads happen before the writes that follow.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return;
+  }
+  data_.reset(new std::vector<V>(*data_));
 }
 
 }
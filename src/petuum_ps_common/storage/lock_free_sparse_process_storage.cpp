@@ -0,0 +1,187 @@
+#include <petuum_ps_common/storage/lock_free_sparse_process_storage.hpp>
+#include <glog/logging.h>
+
+namespace petuum {
+
+LockFreeSparseProcessStorage::Table::Table(size_t _num_slots):
+    num_slots(_num_slots),
+    num_slot_bits(__builtin_ctzll(_num_slots)),
+    num_used(0),
+    slots(new std::atomic<Entry*>[_num_slots]) {
+  for (size_t i = 0; i < num_slots; ++i) {
+    slots[i] = 0;
+  }
+}
+
+LockFreeSparseProcessStorage::LockFreeSparseProcessStorage(size_t capacity):
+    capacity_(capacity),
+    num_rows_(0),
+    evict_hand_(0) {
+  CHECK_GT(capacity, 0);
+  // Keep the load factor, tombstones included, below 3/4.
+  size_t num_slots = 2;
+  while (num_slots < capacity * 2)
+    num_slots *= 2;
+  table_ = new Table(num_slots);
+}
+
+LockFreeSparseProcessStorage::~LockFreeSparseProcessStorage() {
+  Table *table = table_.load();
+  for (size_t i = 0; i < table->num_slots; ++i) {
+    Entry *entry = table->slots[i].load();
+    if (entry != 0 && entry != Tombstone())
+      DeleteEntry(entry);
+  }
+  delete table;
+}
+
+ClientRow *LockFreeSparseProcessStorage::Find(int32_t row_id,
+                                              RowAccessor* row_accessor) {
+  CHECK_NOTNULL(row_accessor);
+  ClientRow *client_row = 0;
+  epoch_manager_.Enter();
+  Table *table = table_.load();
+  size_t slot;
+  Entry *entry = FindEntry(table, row_id, &slot);
+  if (entry != 0) {
+    // Pin the row first, then make sure it is still linked. Eviction
+    // unlinks a row before checking its ref count, so either the evicting
+    // thread sees our reference, or we see the row unlinked.
+    row_accessor->SetClientRow(entry->client_row);
+    if (table_.load() == table && table->slots[slot].load() == entry) {
+      if (!entry->referenced.load(std::memory_order_relaxed))
+        entry->referenced.store(true, std::memory_order_relaxed);
+      client_row = entry->client_row;
+    } else {
+      row_accessor->Clear();
+    }
+  }
+  epoch_manager_.Exit();
+  return client_row;
+}
+
+bool LockFreeSparseProcessStorage::Find(int32_t row_id) {
+  epoch_manager_.Enter();
+  size_t slot;
+  bool found = (FindEntry(table_.load(), row_id, &slot) != 0);
+  epoch_manager_.Exit();
+  return found;
+}
+
+bool LockFreeSparseProcessStorage::Insert(int32_t row_id,
+                                          ClientRow* client_row) {
+  std::lock_guard<std::mutex> lock(writer_mtx_);
+  size_t slot;
+  if (FindEntry(table_.load(), row_id, &slot) != 0)
+    return false;
+
+  if (num_rows_ >= capacity_)
+    EvictOneRow();
+
+  Table *table = table_.load();
+  if (table->num_used >= table->num_slots / 4 * 3) {
+    Rebuild();
+    table = table_.load();
+  }
+
+  slot = FindInsertSlot(table, row_id);
+  if (table->slots[slot].load() == 0)
+    ++table->num_used;
+  table->slots[slot].store(new Entry(row_id, client_row));
+  ++num_rows_;
+
+  epoch_manager_.Reclaim();
+  return true;
+}
+
+// ==================== Private Methods ======================
+
+LockFreeSparseProcessStorage::Entry *LockFreeSparseProcessStorage::FindEntry(
+    const Table *table, int32_t row_id, size_t *slot) {
+  size_t mask = table->num_slots - 1;
+  for (size_t idx = GetHomeSlot(table, row_id), num_probes = 0;
+       num_probes < table->num_slots; idx = (idx + 1) & mask, ++num_probes) {
+    Entry *entry = table->slots[idx].load();
+    if (entry == 0)
+      return 0;
+    if (entry != Tombstone() && entry->row_id == row_id) {
+      *slot = idx;
+      return entry;
+    }
+  }
+  return 0;
+}
+
+size_t LockFreeSparseProcessStorage::FindInsertSlot(Table *table,
+                                                    int32_t row_id) {
+  size_t mask = table->num_slots - 1;
+  size_t idx = GetHomeSlot(table, row_id);
+  while (true) {
+    Entry *entry = table->slots[idx].load();
+    if (entry == 0 || entry == Tombstone())
+      return idx;
+    idx = (idx + 1) & mask;
+  }
+}
+
+void LockFreeSparseProcessStorage::EvictOneRow() {
+  Table *table = table_.load();
+  size_t max_num_visits = table->num_slots * kMaxNumEvictRounds;
+  for (size_t num_visits = 0; num_visits < max_num_visits; ++num_visits) {
+    size_t slot = evict_hand_;
+    evict_hand_ = (evict_hand_ + 1) % table->num_slots;
+
+    Entry *entry = table->slots[slot].load();
+    if (entry == 0 || entry == Tombstone())
+      continue;
+
+    if (entry->referenced.load()) {
+      entry->referenced.store(false);
+      continue;
+    }
+
+    if (!entry->client_row->HasZeroRef())
+      continue;
+
+    // Unlink before checking the ref count again; see Find().
+    table->slots[slot].store(Tombstone());
+    if (!entry->client_row->HasZeroRef()) {
+      table->slots[slot].store(entry);
+      continue;
+    }
+
+    --num_rows_;
+    epoch_manager_.Retire(entry, DeleteEntry);
+    return;
+  }
+  LOG(FATAL) << "Failed to evict a row from process storage, capacity = "
+             << capacity_ << "; too many rows are referenced.";
+}
+
+void LockFreeSparseProcessStorage::Rebuild() {
+  Table *old_table = table_.load();
+  Table *new_table = new Table(old_table->num_slots);
+  for (size_t i = 0; i < old_table->num_slots; ++i) {
+    Entry *entry = old_table->slots[i].load();
+    if (entry == 0 || entry == Tombstone())
+      continue;
+    size_t slot = FindInsertSlot(new_table, entry->row_id);
+    new_table->slots[slot].store(entry);
+    ++new_table->num_used;
+  }
+  table_.store(new_table);
+  evict_hand_ = 0;
+  epoch_manager_.Retire(old_table, DeleteTable);
+}
+
+void LockFreeSparseProcessStorage::DeleteEntry(void *entry) {
+  Entry *typed_entry = reinterpret_cast<Entry*>(entry);
+  delete typed_entry->client_row;
+  delete typed_entry;
+}
+
+void LockFreeSparseProcessStorage::DeleteTable(void *table) {
+  delete reinterpret_cast<Table*>(table);
+}
+
+}  // namespace petuum
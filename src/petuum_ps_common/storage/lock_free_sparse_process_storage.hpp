@@ -0,0 +1,99 @@
+#pragma once
+
+#include <petuum_ps_common/include/row_access.hpp>
+#include <petuum_ps_common/client/client_row.hpp>
+#include <petuum_ps_common/storage/abstract_process_storage.hpp>
+#include <petuum_ps_common/util/epoch_manager.hpp>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+namespace petuum {
+
+// A bounded, sparse ProcessStorage optimized for reads. Find() takes no
+// lock: rows live in an open-addressing table of atomic entry pointers, and
+// evicted rows are freed through epoch-based reclamation, so a reader never
+// touches freed memory. Insertion and eviction are serialized by a mutex,
+// as they come from the few bg threads.
+//
+// Like BoundedSparseProcessStorage, rows are evicted following the CLOCK
+// algorithm and only when no RowAccessor refers to them. A Find() that
+// races with the eviction of the same row may miss a row that stays in the
+// storage; the caller then fetches it again as for any other miss.
+class LockFreeSparseProcessStorage : public AbstractProcessStorage {
+public:
+  explicit LockFreeSparseProcessStorage(size_t capacity);
+
+  ~LockFreeSparseProcessStorage();
+
+  ClientRow *Find(int32_t row_id, RowAccessor* row_accessor);
+
+  bool Find(int32_t row_id);
+
+  bool Insert(int32_t row_id, ClientRow* client_row);
+
+private:
+  struct Entry {
+    Entry(int32_t _row_id, ClientRow *_client_row):
+        row_id(_row_id),
+        client_row(_client_row),
+        referenced(true) { }
+
+    const int32_t row_id;
+    ClientRow * const client_row;
+    // CLOCK reference bit.
+    std::atomic<bool> referenced;
+  };
+
+  // Table is only replaced as a whole (when too many slots hold
+  // tombstones), so readers that loaded an old table can still probe it.
+  struct Table {
+    explicit Table(size_t _num_slots);
+
+    const size_t num_slots;
+    const int32_t num_slot_bits;
+    // Number of slots that are not empty, including tombstones. Only
+    // accessed by writers.
+    size_t num_used;
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+  };
+
+  static Entry *Tombstone() {
+    return reinterpret_cast<Entry*>(1);
+  }
+
+  static size_t GetHomeSlot(const Table *table, int32_t row_id) {
+    return (uint64_t(uint32_t(row_id)) * 11400714819323198485ull)
+        >> (64 - table->num_slot_bits);
+  }
+
+  // Return the entry of row_id and set *slot, or return 0 if not found.
+  static Entry *FindEntry(const Table *table, int32_t row_id, size_t *slot);
+
+  // Return the slot to insert row_id into; row_id must not exist.
+  static size_t FindInsertSlot(Table *table, int32_t row_id);
+
+  // The following are called with writer_mtx_ held.
+  void EvictOneRow();
+  void Rebuild();
+
+  static void DeleteEntry(void *entry);
+  static void DeleteTable(void *table);
+
+  // Evicting gives up after this many sweeps over the table.
+  static const int32_t kMaxNumEvictRounds = 16;
+
+  const size_t capacity_;
+
+  std::atomic<Table*> table_;
+
+  // The following are protected by writer_mtx_.
+  std::mutex writer_mtx_;
+  size_t num_rows_;
+  size_t evict_hand_;
+
+  EpochManager epoch_manager_;
+};
+
+}  // namespace petuum
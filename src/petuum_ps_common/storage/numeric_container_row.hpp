@@ -1,5 +1,6 @@
 #pragma once
 #include <petuum_ps_common/include/abstract_row.hpp>
+#include <petuum_ps_common/util/dense_kernels.hpp>
 #include <glog/logging.h>
 
 namespace petuum {
@@ -12,6 +13,13 @@ virtual void AddUpdates(int32_t column_id, void *update1,
   *(reinterpret_cast<V*>(update1)) += *(reinterpret_cast<const V*>(update2));
 }
 
+virtual void AddDenseUpdates(
+    int32_t column_id_st __attribute__ ((unused)), void *update1,
+    const void *update2, int32_t num_updates) const {
+  DenseAdd(reinterpret_cast<V*>(update1), reinterpret_cast<const V*>(update2),
+           num_updates);
+}
+
 virtual void SubtractUpdates(int32_t column_id, void *update1,
                      const void *update2) const {
   *(reinterpret_cast<V*>(update1)) -= *(reinterpret_cast<const V*>(update2));
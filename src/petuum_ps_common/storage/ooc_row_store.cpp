@@ -0,0 +1,271 @@
+#include <petuum_ps_common/storage/ooc_row_store.hpp>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <glog/logging.h>
+
+namespace petuum {
+
+OOCRowStore::OOCRowStore(const std::string &path):
+    path_(path),
+    file_end_(0),
+    pending_size_(0),
+    flush_(false),
+    read_ahead_size_(0),
+    stop_(false),
+    write_back_thread_(this),
+    read_ahead_thread_(this) {
+  fd_ = open(path_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  CHECK_GE(fd_, 0) << "creating " << path_ << " failed: " << strerror(errno);
+  write_back_thread_.Start();
+  read_ahead_thread_.Start();
+}
+
+OOCRowStore::~OOCRowStore() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  write_back_cv_.notify_all();
+  read_ahead_cv_.notify_all();
+  write_back_thread_.Join();
+  read_ahead_thread_.Join();
+  close(fd_);
+  unlink(path_.c_str());
+}
+
+bool OOCRowStore::Load(int32_t row_id, AbstractRow *row) {
+  std::vector<uint8_t> buf;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    RowSlot &slot = index_[row_id];
+    while (slot.resident)
+      cv_.wait(lock);
+    slot.resident = true;
+
+    auto pending_iter = pending_.find(row_id);
+    if (pending_iter != pending_.end()) {
+      // The row comes back before being written; no need to write it.
+      buf.swap(pending_iter->second);
+      pending_size_ -= buf.size();
+      pending_.erase(pending_iter);
+      cv_.notify_all();
+    } else if (writing_.count(row_id) > 0) {
+      // The write-back thread still reads it.
+      buf = writing_.find(row_id)->second;
+    } else if (read_ahead_.count(row_id) > 0) {
+      buf.swap(read_ahead_[row_id]);
+      read_ahead_size_ -= buf.size();
+      read_ahead_.erase(row_id);
+    } else if (slot.offset < 0) {
+      return false;
+    } else {
+      int64_t offset = slot.offset;
+      buf.resize(slot.size);
+      lock.unlock();
+      ReadFully(offset, buf.size(), buf.data());
+    }
+  }
+  bool suc = row->Deserialize(buf.data(), buf.size());
+  CHECK(suc) << "row " << row_id << " in " << path_;
+  return true;
+}
+
+void OOCRowStore::Evict(int32_t row_id, const AbstractRow &row) {
+  std::vector<uint8_t> buf(row.SerializedSize());
+  buf.resize(row.Serialize(buf.data()));
+
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (pending_size_ >= kMaxPendingSize)
+    cv_.wait(lock);
+
+  RowSlot &slot = index_[row_id];
+  CHECK(slot.resident) << "row " << row_id << " was not loaded";
+  ++slot.version;
+  slot.resident = false;
+
+  pending_size_ += buf.size();
+  pending_[row_id].swap(buf);
+  if (pending_size_ >= kWriteBatchSize)
+    write_back_cv_.notify_one();
+  cv_.notify_all();
+}
+
+void OOCRowStore::Prefetch(int32_t row_id) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (prefetch_queue_.size() >= kMaxPrefetchQueueSize)
+      return;
+    prefetch_queue_.push_back(row_id);
+  }
+  read_ahead_cv_.notify_one();
+}
+
+void OOCRowStore::Flush() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  flush_ = true;
+  write_back_cv_.notify_one();
+  while (!pending_.empty() || !writing_.empty())
+    cv_.wait(lock);
+}
+
+void *OOCRowStore::WriteBackThread::operator() () {
+  store_->WriteBack();
+  return 0;
+}
+
+void *OOCRowStore::ReadAheadThread::operator() () {
+  store_->ReadAhead();
+  return 0;
+}
+
+void OOCRowStore::WriteBack() {
+  // (offset, row_id)
+  std::vector<std::pair<int64_t, int32_t> > batch;
+  while (1) {
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      while (pending_size_ < kWriteBatchSize && !flush_ && !stop_)
+        write_back_cv_.wait(lock);
+      if (pending_.empty()) {
+        flush_ = false;
+        cv_.notify_all();
+        if (stop_)
+          return;
+        continue;
+      }
+
+      writing_.swap(pending_);
+      pending_size_ = 0;
+      cv_.notify_all();
+
+      batch.clear();
+      for (auto &row_pair : writing_) {
+        RowSlot &slot = index_[row_pair.first];
+        size_t size = row_pair.second.size();
+        if (slot.offset < 0 || size > slot.capacity) {
+          slot.offset = file_end_;
+          slot.capacity = size;
+          file_end_ += size;
+        }
+        slot.size = size;
+        batch.push_back(std::make_pair(slot.offset, row_pair.first));
+      }
+    }
+
+    WriteBatch(batch);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    writing_.clear();
+    cv_.notify_all();
+  }
+}
+
+void OOCRowStore::WriteBatch(
+    const std::vector<std::pair<int64_t, int32_t> > &batch) {
+  std::vector<std::pair<int64_t, int32_t> > sorted(batch);
+  std::sort(sorted.begin(), sorted.end());
+
+  // Rows in adjacent slots go out in one pwritev.
+  std::vector<struct iovec> iov;
+  size_t i = 0;
+  while (i < sorted.size()) {
+    int64_t run_offset = sorted[i].first;
+    int64_t run_end = run_offset;
+    iov.clear();
+    while (i < sorted.size() && sorted[i].first == run_end
+           && iov.size() < IOV_MAX) {
+      std::vector<uint8_t> &buf = writing_.find(sorted[i].second)->second;
+      struct iovec vec;
+      vec.iov_base = buf.data();
+      vec.iov_len = buf.size();
+      iov.push_back(vec);
+      // A row that does not fill its slot ends the run.
+      run_end += buf.size();
+      ++i;
+    }
+
+    size_t iov_idx = 0;
+    int64_t offset = run_offset;
+    while (iov_idx < iov.size()) {
+      ssize_t written = pwritev(fd_, &iov[iov_idx], iov.size() - iov_idx,
+                                offset);
+      if (written < 0 && errno == EINTR)
+        continue;
+      CHECK_GE(written, 0) << "writing " << path_ << " failed: "
+                           << strerror(errno);
+      offset += written;
+      while (iov_idx < iov.size() && (size_t) written >= iov[iov_idx].iov_len) {
+        written -= iov[iov_idx].iov_len;
+        ++iov_idx;
+      }
+      if (iov_idx < iov.size()) {
+        iov[iov_idx].iov_base
+            = reinterpret_cast<uint8_t*>(iov[iov_idx].iov_base) + written;
+        iov[iov_idx].iov_len -= written;
+      }
+    }
+  }
+}
+
+void OOCRowStore::ReadAhead() {
+  std::vector<uint8_t> buf;
+  while (1) {
+    int32_t row_id;
+    uint64_t version;
+    int64_t offset;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      while (prefetch_queue_.empty() && !stop_)
+        read_ahead_cv_.wait(lock);
+      if (stop_)
+        return;
+      row_id = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+
+      auto slot_iter = index_.find(row_id);
+      if (slot_iter == index_.end())
+        continue;
+      const RowSlot &slot = slot_iter->second;
+      if (slot.resident || slot.offset < 0
+          || pending_.count(row_id) > 0 || writing_.count(row_id) > 0
+          || read_ahead_.count(row_id) > 0
+          || read_ahead_size_ + slot.size > kMaxReadAheadSize)
+        continue;
+      version = slot.version;
+      offset = slot.offset;
+      buf.resize(slot.size);
+    }
+
+    ReadFully(offset, buf.size(), buf.data());
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    // Drop the read if the row has been loaded or evicted since.
+    const RowSlot &slot = index_[row_id];
+    if (slot.resident || slot.version != version
+        || read_ahead_.count(row_id) > 0)
+      continue;
+    read_ahead_size_ += buf.size();
+    read_ahead_[row_id].swap(buf);
+  }
+}
+
+void OOCRowStore::ReadFully(int64_t offset, size_t size, uint8_t *buf) const {
+  while (size > 0) {
+    ssize_t num_read = pread(fd_, buf, size, offset);
+    if (num_read < 0 && errno == EINTR)
+      continue;
+    CHECK_GT(num_read, 0) << "reading " << path_ << " failed: "
+                          << strerror(errno);
+    buf += num_read;
+    offset += num_read;
+    size -= num_read;
+  }
+}
+
+}  // namespace petuum
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <petuum_ps_common/include/abstract_row.hpp>
+#include <petuum_ps_common/util/thread.hpp>
+#include <boost/noncopyable.hpp>
+#include <unordered_map>
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <stdint.h>
+
+namespace petuum {
+
+// Holds the rows of a table that do not fit in the process cache, in a
+// single file. Each row has a slot in the file, found through an in-memory
+// index; a row is rewritten in place as long as it fits in its slot, and is
+// otherwise moved to the end of the file, so fixed-schema rows never move
+// after their first eviction.
+//
+// Evicted rows are serialized into memory and written back in batches,
+// sorted by offset, by a background thread. Rows announced through Prefetch
+// are read ahead by another background thread.
+//
+// A row is resident from Load() until Evict(). Callers must not Load or
+// Evict the same row concurrently, e.g. by holding a per-row lock; Load
+// waits for a concurrent Evict of the same row to finish.
+class OOCRowStore : boost::noncopyable {
+public:
+  explicit OOCRowStore(const std::string &path);
+  // Writes back pending rows and removes the file.
+  ~OOCRowStore();
+
+  // Deserializes row_id into row and returns true if row_id was evicted
+  // before; returns false and leaves row untouched otherwise.
+  bool Load(int32_t row_id, AbstractRow *row);
+  void Evict(int32_t row_id, const AbstractRow &row);
+
+  // Hints that row_id is going to be loaded soon.
+  void Prefetch(int32_t row_id);
+
+  // Blocks until every evicted row is on disk.
+  void Flush();
+
+private:
+  struct RowSlot {
+    RowSlot():
+        offset(-1),
+        size(0),
+        capacity(0),
+        version(0),
+        resident(false) { }
+
+    // -1 if the row has never been written to the file.
+    int64_t offset;
+    size_t size;
+    size_t capacity;
+    // Bumped on every eviction to invalidate in-flight read-aheads.
+    uint64_t version;
+    bool resident;
+  };
+
+  typedef std::unordered_map<int32_t, std::vector<uint8_t> > RowBuffMap;
+
+  class WriteBackThread : public Thread {
+  public:
+    explicit WriteBackThread(OOCRowStore *store):
+        store_(store) { }
+
+    void *operator() ();
+
+  private:
+    OOCRowStore *store_;
+  };
+
+  class ReadAheadThread : public Thread {
+  public:
+    explicit ReadAheadThread(OOCRowStore *store):
+        store_(store) { }
+
+    void *operator() ();
+
+  private:
+    OOCRowStore *store_;
+  };
+
+  void WriteBack();
+  void ReadAhead();
+  // Writes the rows in writing_ at the given (offset, row_id). Runs without
+  // mtx_; nothing else modifies writing_ meanwhile.
+  void WriteBatch(const std::vector<std::pair<int64_t, int32_t> > &batch);
+
+  void ReadFully(int64_t offset, size_t size, uint8_t *buf) const;
+
+  // Start writing back once this many bytes are pending.
+  static const size_t kWriteBatchSize = 8 * 1024 * 1024;
+  // Evict blocks while this many bytes are pending.
+  static const size_t kMaxPendingSize = 64 * 1024 * 1024;
+  static const size_t kMaxReadAheadSize = 64 * 1024 * 1024;
+  static const size_t kMaxPrefetchQueueSize = 64 * 1024;
+
+  const std::string path_;
+  int fd_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::condition_variable write_back_cv_;
+  std::condition_variable read_ahead_cv_;
+
+  std::unordered_map<int32_t, RowSlot> index_;
+  int64_t file_end_;
+
+  // Evicted rows not yet picked up by the write-back thread.
+  RowBuffMap pending_;
+  size_t pending_size_;
+  // Rows being written by the write-back thread.
+  RowBuffMap writing_;
+  bool flush_;
+
+  std::deque<int32_t> prefetch_queue_;
+  RowBuffMap read_ahead_;
+  size_t read_ahead_size_;
+
+  bool stop_;
+  WriteBackThread write_back_thread_;
+  ReadAheadThread read_ahead_thread_;
+};
+
+}  // namespace petuum
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <petuum_ps_common/storage/entry.hpp>
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace petuum {
+
+// Read views give the app a consistent, read-only copy of a row's data that
+// can be read without taking the row lock. A view holds a reference to a
+// buffer the row no longer writes to once the view exists (DenseRow copies
+// its buffer on the next write, the sparse rows build a new snapshot), so a
+// view stays valid and unchanged for its whole lifetime, even past the
+// RowAccessor it was taken from. Take a new view to see newer values.
+//
+//  petuum::RowAccessor row_acc;
+//  table.Get(row_id, &row_acc);
+//  petuum::DenseRowView<float> w = row_acc.GetView<DenseRow<float> >();
+//  for (int32_t j = 0; j < w.size(); ++j)
+//    sum += w[j] * a[j];
+
+template<typename V>
+class DenseRowView {
+public:
+  typedef const V* const_iterator;
+
+  DenseRowView() { }
+
+  explicit DenseRowView(const std::shared_ptr<const std::vector<V> > &data):
+      data_(data) { }
+
+  const V *data() const {
+    return data_->data();
+  }
+
+  int32_t size() const {
+    return data_->size();
+  }
+
+  V operator [](int32_t column_id) const {
+    return (*data_)[column_id];
+  }
+
+  const_iterator begin() const {
+    return data_->data();
+  }
+
+  const_iterator end() const {
+    return data_->data() + data_->size();
+  }
+
+private:
+  std::shared_ptr<const std::vector<V> > data_;
+};
+
+// Non-zero entries of a sparse row, in the row's own iteration order:
+// ascending column id for SparseRow and SparseFeatureRow, descending value
+// for SortedVectorMapRow.
+//
+//  for (auto it = view.begin(); it != view.end(); ++it) {
+//    int32_t col_id = it->first;
+//    V val = it->second;
+//  }
+template<typename V>
+class SparseRowView {
+public:
+  typedef const Entry<V>* const_iterator;
+
+  SparseRowView() { }
+
+  explicit SparseRowView(
+      const std::shared_ptr<const std::vector<Entry<V> > > &entries):
+      entries_(entries) { }
+
+  int32_t num_entries() const {
+    return entries_->size();
+  }
+
+  const Entry<V> &entry(int32_t idx) const {
+    return (*entries_)[idx];
+  }
+
+  const_iterator begin() const {
+    return entries_->data();
+  }
+
+  const_iterator end() const {
+    return entries_->data() + entries_->size();
+  }
+
+private:
+  std::shared_ptr<const std::vector<Entry<V> > > entries_;
+};
+
+}  // namespace petuum
@@ -5,6 +5,8 @@
 
 #include <boost/thread.hpp>
 #include <cstdint>
+#include <mutex>
+#include <memory>
 #include <vector>
 #include <utility>
 #include <glog/logging.h>
@@ -14,6 +16,7 @@
 #include <boost/noncopyable.hpp>
 
 #include <petuum_ps_common/storage/numeric_container_row.hpp>
+#include <petuum_ps_common/storage/row_view.hpp>
 #include <petuum_ps_common/util/lock.hpp>
 #include <petuum_ps_common/util/stats.hpp>
 #include <petuum_ps_common/storage/entry.hpp>
@@ -184,6 +187,15 @@ public:   // static constants
   // the less memory efficient, but less memory allocation.
   static const int32_t K_BLOCK_SIZE_;
 
+public:  // Read view.
+  typedef SparseRowView<V> View;
+
+  // Snapshot of the non-zero entries, in the same order as const_iterator.
+  // It is built under the read lock by the first GetView() after a write and
+  // shared by all views until the next write; iterating a view holds no
+  // lock. Thread-safe.
+  View GetView() const;
+
 private:
   // Array of sorted entries.
   std::unique_ptr<Entry<V>[]> entries_;
@@ -195,6 +207,14 @@ private:
   int32_t capacity_;
 
   mutable SharedMutex rw_mutex_;
+
+  // Drops the snapshot shared by the views. Called by every write, with the
+  // write lock held (or before the row is shared).
+  void InvalidateView();
+
+  // Serializes GetView() calls that build view_entries_ under the read lock.
+  mutable std::mutex view_mtx_;
+  mutable std::shared_ptr<const std::vector<Entry<V> > > view_entries_;
 };
 
 // ================ Implementation =================
@@ -343,6 +363,7 @@ size_t SortedVectorMapRow<V>::Serialize(void *bytes) const {
 
 template<typename V>
 bool SortedVectorMapRow<V>::Deserialize(const void* data, size_t num_bytes) {
+  InvalidateView();
   int32_t num_bytes_per_entry = sizeof(Entry<V>);
   CHECK_EQ(0, num_bytes % num_bytes_per_entry);
   int32_t num_entries = num_bytes / num_bytes_per_entry;
@@ -355,6 +376,7 @@ bool SortedVectorMapRow<V>::Deserialize(const void* data, size_t num_bytes) {
 
 template<typename V>
 void SortedVectorMapRow<V>::ResetRowData(const void *data, size_t num_bytes) {
+  InvalidateView();
   CHECK_EQ(0, num_bytes % sizeof(Entry<V>));
   int32_t num_entries = num_bytes / sizeof(Entry<V>);
   if (num_entries > capacity_)
@@ -395,6 +417,7 @@ void SortedVectorMapRow<V>::ApplyBatchInc(const int32_t *column_ids,
 template<typename V>
 void SortedVectorMapRow<V>::ApplyIncUnsafe(int32_t column_id,
     const void *update) {
+  InvalidateView();
   // Go through the array and find column_id
   int32_t vector_idx = FindIndex(column_id);
   V typed_update = *(reinterpret_cast<const V*>(update));
@@ -430,6 +453,7 @@ void SortedVectorMapRow<V>::ApplyIncUnsafe(int32_t column_id,
 template<typename V>
 void SortedVectorMapRow<V>::ApplyBatchIncUnsafe(const int32_t *column_ids,
     const void* updates, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(updates);
 
   // Use ApplyInc individually on each column_id.
@@ -478,6 +502,7 @@ double SortedVectorMapRow<V>::ApplyBatchIncGetImportance(
 template<typename V>
 double SortedVectorMapRow<V>::ApplyIncUnsafeGetImportance(int32_t column_id,
     const void *update) {
+  InvalidateView();
   // Go through the array and find column_id
   int32_t vector_idx = FindIndex(column_id);
   double importance = 0.0;
@@ -522,6 +547,7 @@ template<typename V>
 double SortedVectorMapRow<V>::ApplyBatchIncUnsafeGetImportance(
     const int32_t *column_ids,
     const void* updates, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(updates);
 
   double accum_importance = 0.0;
@@ -577,6 +603,7 @@ void SortedVectorMapRow<V>::ApplyDenseBatchInc(
 template<typename V>
 double SortedVectorMapRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(update_batch);
   double accum_importance = 0.0;
 
@@ -619,6 +646,7 @@ double SortedVectorMapRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
 template<typename V>
 void SortedVectorMapRow<V>::ApplyDenseBatchIncUnsafe(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(update_batch);
 
   // Use ApplyInc individually on each column_id.
@@ -731,4 +759,25 @@ SortedVectorMapRow<V>::cend() const {
   return const_iterator(*this, true);
 }
 
+// ======== Read View Implementation ========
+
+template<typename V>
+typename SortedVectorMapRow<V>::View SortedVectorMapRow<V>::GetView() const {
+  boost::shared_lock<SharedMutex> read_lock(rw_mutex_);
+  std::lock_guard<std::mutex> view_lock(view_mtx_);
+  if (view_entries_ == 0) {
+    std::vector<Entry<V> > *entries = new std::vector<Entry<V> >(
+        entries_.get(), entries_.get() + num_entries_);
+    view_entries_.reset(entries);
+  }
+  return View(view_entries_);
+}
+
+template<typename V>
+void SortedVectorMapRow<V>::InvalidateView() {
+  // Writers hold the write lock, so no GetView() is running.
+  if (view_entries_ != 0)
+    view_entries_.reset();
+}
+
 }  // namespace petuum
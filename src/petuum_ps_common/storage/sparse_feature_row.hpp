@@ -5,6 +5,8 @@
 
 #include <boost/thread.hpp>
 #include <cstdint>
+#include <mutex>
+#include <memory>
 #include <vector>
 #include <utility>
 #include <glog/logging.h>
@@ -14,6 +16,7 @@
 
 #include <ml/feature/sparse_feature.hpp>
 #include <petuum_ps_common/storage/numeric_container_row.hpp>
+#include <petuum_ps_common/storage/row_view.hpp>
 #include <petuum_ps_common/storage/entry.hpp>
 #include <petuum_ps_common/util/lock.hpp>
 #include <petuum_ps_common/util/stats.hpp>
@@ -164,8 +167,25 @@ public:  // iterator functions.
 
   const_iterator cend() const;
 
+public:  // Read view.
+  typedef SparseRowView<V> View;
+
+  // Snapshot of the non-zero entries, in the same order as const_iterator.
+  // It is built under the read lock by the first GetView() after a write and
+  // shared by all views until the next write; iterating a view holds no
+  // lock. Thread-safe.
+  View GetView() const;
+
 private:
   mutable SharedMutex rw_mutex_;
+
+  // Drops the snapshot shared by the views. Called by every write, with the
+  // write lock held (or before the row is shared).
+  void InvalidateView();
+
+  // Serializes GetView() calls that build view_entries_ under the read lock.
+  mutable std::mutex view_mtx_;
+  mutable std::shared_ptr<const std::vector<Entry<V> > > view_entries_;
 };
 
 // ================ Implementation =================
@@ -236,21 +256,25 @@ size_t SparseFeatureRow<V>::Serialize(void *bytes) const {
 
 template<typename V>
 bool SparseFeatureRow<V>::Deserialize(const void* data, size_t num_bytes) {
+  InvalidateView();
   int32_t num_bytes_per_entry = sizeof(Entry<V>);
   int num_bytes_data = num_bytes - sizeof(int32_t);
   CHECK_EQ(0, num_bytes_data % num_bytes_per_entry);
   int32_t num_entries = num_bytes_data / num_bytes_per_entry;
   const int32_t* data_int = reinterpret_cast<const int32_t*>(data);
   this->feature_dim_ = *data_int;
-  this->num_entries_ = num_entries;
   ++data_int;
+  // Nothing to carry over into the new entries.
+  this->num_entries_ = 0;
   ml::SparseFeature<V>::ResetCapacity(num_entries);
   memcpy(this->entries_.get(), data_int, num_bytes_data);
+  this->num_entries_ = num_entries;
   return true;
 }
 
 template<typename V>
 void SparseFeatureRow<V>::ResetRowData(const void *data, size_t num_bytes) {
+  InvalidateView();
   int32_t num_bytes_per_entry = sizeof(Entry<V>);
   int num_bytes_data = num_bytes - sizeof(int32_t);   // feature_dim_ is int32_t
   CHECK_EQ(0, num_bytes_data % num_bytes_per_entry);
@@ -295,6 +319,7 @@ void SparseFeatureRow<V>::ApplyBatchInc(const int32_t *column_ids,
 template<typename V>
 void SparseFeatureRow<V>::ApplyIncUnsafe(int32_t column_id,
     const void *update) {
+  InvalidateView();
   // Go through the array and find column_id
   int32_t vector_idx = ml::SparseFeature<V>::FindIndex(column_id);
   V typed_update = *(reinterpret_cast<const V*>(update));
@@ -328,6 +353,7 @@ void SparseFeatureRow<V>::ApplyIncUnsafe(int32_t column_id,
 template<typename V>
 void SparseFeatureRow<V>::ApplyBatchIncUnsafe(const int32_t *column_ids,
     const void* updates, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(updates);
 
   // Use ApplyInc individually on each column_id.
@@ -376,6 +402,7 @@ double SparseFeatureRow<V>::ApplyBatchIncGetImportance(
 template<typename V>
 double SparseFeatureRow<V>::ApplyIncUnsafeGetImportance(int32_t column_id,
     const void *update) {
+  InvalidateView();
   // Go through the array and find column_id
   int32_t vector_idx = ml::SparseFeature<V>::FindIndex(column_id);
   double importance = 0.0;
@@ -416,6 +443,7 @@ template<typename V>
 double SparseFeatureRow<V>::ApplyBatchIncUnsafeGetImportance(
     const int32_t *column_ids,
     const void* updates, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(updates);
 
   double accum_importance = 0.0;
@@ -472,6 +500,7 @@ void SparseFeatureRow<V>::ApplyDenseBatchInc(
 template<typename V>
 double SparseFeatureRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(update_batch);
   double accum_importance = 0.0;
 
@@ -515,6 +544,7 @@ double SparseFeatureRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
 template<typename V>
 void SparseFeatureRow<V>::ApplyDenseBatchIncUnsafe(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(update_batch);
 
   // Use ApplyInc individually on each column_id.
@@ -627,4 +657,25 @@ SparseFeatureRow<V>::cend() const {
   return const_iterator(*this, true);
 }
 
+// ======== Read View Implementation ========
+
+template<typename V>
+typename SparseFeatureRow<V>::View SparseFeatureRow<V>::GetView() const {
+  boost::shared_lock<SharedMutex> read_lock(rw_mutex_);
+  std::lock_guard<std::mutex> view_lock(view_mtx_);
+  if (view_entries_ == 0) {
+    std::vector<Entry<V> > *entries = new std::vector<Entry<V> >(
+        this->entries_.get(), this->entries_.get() + this->num_entries_);
+    view_entries_.reset(entries);
+  }
+  return View(view_entries_);
+}
+
+template<typename V>
+void SparseFeatureRow<V>::InvalidateView() {
+  // Writers hold the write lock, so no GetView() is running.
+  if (view_entries_ != 0)
+    view_entries_.reset();
+}
+
 }  // namespace petuum
@@ -6,12 +6,14 @@
 #include <boost/thread.hpp>
 #include <map>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <utility>
 #include <vector>
 #include <glog/logging.h>
 
 #include <petuum_ps_common/storage/numeric_container_row.hpp>
+#include <petuum_ps_common/storage/row_view.hpp>
 #include <petuum_ps_common/util/lock.hpp>
 
 namespace petuum {
@@ -159,6 +161,15 @@ public:  // AbstractRow implementation
   void ApplyDenseBatchIncUnsafe(
       const void* update_batch, int32_t index_st, int32_t num_updates);
 
+public:  // Read view.
+  typedef SparseRowView<V> View;
+
+  // Snapshot of the non-zero entries, in the same order as const_iterator.
+  // It is built under the read lock by the first GetView() after a write and
+  // shared by all views until the next write; iterating a view holds no
+  // lock. Thread-safe.
+  View GetView() const;
+
 private:
   friend class const_iterator;
 
@@ -167,6 +178,14 @@ private:
   std::map<int32_t, V> row_data_;
 
   mutable SharedMutex rw_mutex_;
+
+  // Drops the snapshot shared by the views. Called by every write, with the
+  // write lock held (or before the row is shared).
+  void InvalidateView();
+
+  // Serializes GetView() calls that build view_entries_ under the read lock.
+  mutable std::mutex view_mtx_;
+  mutable std::shared_ptr<const std::vector<Entry<V> > > view_entries_;
 };
 
 // ================= Implementation =================
@@ -295,6 +314,7 @@ size_t SparseRow<V>::Serialize(void* bytes) const {
 
 template<typename V>
 bool SparseRow<V>::Deserialize(const void* data, size_t num_bytes) {
+  InvalidateView();
   row_data_.clear();
 
   int32_t num_bytes_per_entry = (sizeof(int32_t) + sizeof(V));
@@ -346,6 +366,7 @@ void SparseRow<V>::ApplyBatchInc(const int32_t *column_ids,
 
 template<typename V>
 void SparseRow<V>::ApplyIncUnsafe(int32_t column_id, const void *update) {
+  InvalidateView();
   const V* typed_update = reinterpret_cast<const V*>(update);
   row_data_[column_id] += *typed_update;
   if (row_data_[column_id] == V(0)) {
@@ -357,6 +378,7 @@ void SparseRow<V>::ApplyIncUnsafe(int32_t column_id, const void *update) {
 template<typename V>
 void SparseRow<V>::ApplyBatchIncUnsafe(const int32_t *column_ids,
     const void* update_batch, int32_t num_updates) {
+  InvalidateView();
   const V* typed_updates = reinterpret_cast<const V*>(update_batch);
   for (int32_t i = 0; i < num_updates; ++i) {
     int32_t col_id = column_ids[i];
@@ -386,6 +408,7 @@ double SparseRow<V>::ApplyBatchIncGetImportance(const int32_t *column_ids,
 template<typename V>
 double SparseRow<V>::ApplyIncUnsafeGetImportance(int32_t column_id,
                                                  const void *update) {
+  InvalidateView();
   V typed_update = *(reinterpret_cast<const V*>(update));
   V row_data = row_data_[column_id];
   double importance = (double(row_data) == 0) ? double(typed_update)
@@ -403,6 +426,7 @@ double SparseRow<V>::ApplyIncUnsafeGetImportance(int32_t column_id,
 template<typename V>
 double SparseRow<V>::ApplyBatchIncUnsafeGetImportance(const int32_t *column_ids,
     const void* update_batch, int32_t num_updates) {
+  InvalidateView();
   const V *typed_updates = reinterpret_cast<const V*>(update_batch);
   double accum_importance = 0;
   for (int32_t i = 0; i < num_updates; ++i) {
@@ -433,12 +457,13 @@ template<typename V>
 void SparseRow<V>::ApplyDenseBatchInc(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
   std::unique_lock<SharedMutex> write_lock(rw_mutex_);
-  ApplyDenseBatchInc(update_batch, index_st, num_updates);
+  ApplyDenseBatchIncUnsafe(update_batch, index_st, num_updates);
 }
 
 template<typename V>
 double SparseRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  InvalidateView();
   const V *typed_updates = reinterpret_cast<const V*>(update_batch);
   double accum_importance = 0;
   for (int32_t i = 0; i < num_updates; ++i) {
@@ -459,6 +484,7 @@ double SparseRow<V>::ApplyDenseBatchIncUnsafeGetImportance(
 template<typename V>
 void SparseRow<V>::ApplyDenseBatchIncUnsafe(
     const void* update_batch, int32_t index_st, int32_t num_updates) {
+  InvalidateView();
   const V *typed_updates = reinterpret_cast<const V*>(update_batch);
   for (int32_t i = 0; i < num_updates; ++i) {
     int32_t col_id = i + index_st;
@@ -471,4 +497,31 @@ void SparseRow<V>::ApplyDenseBatchIncUnsafe(
   }
 }
 
+// ======== Read View Implementation ========
+
+template<typename V>
+typename SparseRow<V>::View SparseRow<V>::GetView() const {
+  boost::shared_lock<SharedMutex> read_lock(rw_mutex_);
+  std::lock_guard<std::mutex> view_lock(view_mtx_);
+  if (view_entries_ == 0) {
+    std::vector<Entry<V> > *entries = new std::vector<Entry<V> >();
+    entries->reserve(row_data_.size());
+    for (const auto &entry : row_data_) {
+      Entry<V> view_entry;
+      view_entry.first = entry.first;
+      view_entry.second = entry.second;
+      entries->push_back(view_entry);
+    }
+    view_entries_.reset(entries);
+  }
+  return View(view_entries_);
+}
+
+template<typename V>
+void SparseRow<V>::InvalidateView() {
+  // Writers hold the write lock, so no GetView() is running.
+  if (view_entries_ != 0)
+    view_entries_.reset();
+}
+
 }  // namespace petuum
@@ -1,15 +1,18 @@
 #pragma once
 #include <petuum_ps_common/thread/msg_base.hpp>
 #include <petuum_ps_common/util/mem_block.hpp>
+#include <petuum_ps_common/util/msg_buff_pool.hpp>
 #include <petuum_ps_common/comm_bus/comm_bus.hpp>
 
 namespace petuum {
 class MemTransfer {
 public:
-  // Transfer memory of msg (of type MemBlock) ownership to thread recv_id, who is
-  // responsible for destroying the received MemBlock via DestroyTransferredMem().
-  // Return true if the memory is transferred without copying otherwise return false.
-  // MemBlock is released from msg regardless wether or not the memory is copied.
+  // Transfer memory of msg (of type MemBlock) ownership to thread recv_id.
+  // A local receiver gets the memory pointer and is responsible for
+  // destroying it via DestroyTransferredMem(). For a remote receiver, the
+  // memory is handed to zmq, which returns it to MsgBuffPool once sent.
+  // Either way the message is not copied, and the MemBlock is released from
+  // msg, so msg may not be accessed afterwards. Always returns true.
   static bool TransferMem(CommBus *comm_bus, int32_t recv_id, ArbitrarySizedMsg *msg) {
     if (comm_bus->IsLocalEntity(recv_id)) {
       MemTransferMsg mem_transfer_msg;
@@ -17,13 +20,14 @@ public:
       size_t sent_size = comm_bus->SendInProc(recv_id,
         mem_transfer_msg.get_mem(), mem_transfer_msg.get_size());
       CHECK_EQ(sent_size, mem_transfer_msg.get_size());
-      return true;
     } else {
-      size_t sent_size = comm_bus->SendInterProc(recv_id, msg->get_mem(),
-        msg->get_size());
-      CHECK_EQ(sent_size, msg->get_size());
-      return false;
+      size_t msg_size = msg->get_size();
+      zmq::message_t zmq_msg(msg->ReleaseMem(), msg_size,
+                             MsgBuffPool::ZmqFree, 0);
+      size_t sent_size = comm_bus->SendInterProc(recv_id, zmq_msg);
+      CHECK_EQ(sent_size, msg_size);
     }
+    return true;
   }
 
   static void DestroyTransferredMem(void *mem){
@@ -33,6 +33,11 @@ enum MsgType {
   kServerPushRow = 18,
   kServerOpLogAck = 19,
   kBgHandleAppendOpLog = 20,
+  kRowBatchRequest = 21,
+  kBarrier = 22,
+  kBarrierReply = 23,
+  kAllReduce = 24,
+  kAllReduceReply = 25,
   kMemTransfer = 50
 };
 
@@ -0,0 +1,71 @@
+#include <petuum_ps_common/util/all_reduce.hpp>
+#include <petuum_ps_common/util/dense_kernels.hpp>
+#include <glog/logging.h>
+#include <algorithm>
+
+namespace petuum {
+
+namespace {
+
+template<typename T>
+void ReduceTyped(T *dst, const T *src, int32_t count, AllReduceOp op) {
+  switch (op) {
+    case AllReduceSum:
+      DenseAdd(dst, src, count);
+      break;
+    case AllReduceMin:
+      for (int32_t i = 0; i < count; ++i)
+        dst[i] = std::min(dst[i], src[i]);
+      break;
+    case AllReduceMax:
+      for (int32_t i = 0; i < count; ++i)
+        dst[i] = std::max(dst[i], src[i]);
+      break;
+    default:
+      LOG(FATAL) << "Unknown all-reduce op " << op;
+  }
+}
+
+}  // anonymous namespace
+
+size_t GetAllReduceDataTypeSize(AllReduceDataType data_type) {
+  switch (data_type) {
+    case AllReduceInt32:
+      return sizeof(int32_t);
+    case AllReduceInt64:
+      return sizeof(int64_t);
+    case AllReduceFloat:
+      return sizeof(float);
+    case AllReduceDouble:
+      return sizeof(double);
+    default:
+      LOG(FATAL) << "Unknown all-reduce data type " << data_type;
+  }
+  return 0;
+}
+
+void AllReduceInto(void *dst, const void *src, int32_t count,
+                   AllReduceDataType data_type, AllReduceOp op) {
+  switch (data_type) {
+    case AllReduceInt32:
+      ReduceTyped(reinterpret_cast<int32_t*>(dst),
+                  reinterpret_cast<const int32_t*>(src), count, op);
+      break;
+    case AllReduceInt64:
+      ReduceTyped(reinterpret_cast<int64_t*>(dst),
+                  reinterpret_cast<const int64_t*>(src), count, op);
+      break;
+    case AllReduceFloat:
+      ReduceTyped(reinterpret_cast<float*>(dst),
+                  reinterpret_cast<const float*>(src), count, op);
+      break;
+    case AllReduceDouble:
+      ReduceTyped(reinterpret_cast<double*>(dst),
+                  reinterpret_cast<const double*>(src), count, op);
+      break;
+    default:
+      LOG(FATAL) << "Unknown all-reduce data type " << data_type;
+  }
+}
+
+}  // namespace petuum
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace petuum {
+
+enum AllReduceOp {
+  AllReduceSum = 0,
+  AllReduceMin = 1,
+  AllReduceMax = 2
+};
+
+enum AllReduceDataType {
+  AllReduceInt32 = 0,
+  AllReduceInt64 = 1,
+  AllReduceFloat = 2,
+  AllReduceDouble = 3
+};
+
+template<typename T>
+struct AllReduceDataTypeOf;
+
+template<>
+struct AllReduceDataTypeOf<int32_t> {
+  static const AllReduceDataType value = AllReduceInt32;
+};
+
+template<>
+struct AllReduceDataTypeOf<int64_t> {
+  static const AllReduceDataType value = AllReduceInt64;
+};
+
+template<>
+struct AllReduceDataTypeOf<float> {
+  static const AllReduceDataType value = AllReduceFloat;
+};
+
+template<>
+struct AllReduceDataTypeOf<double> {
+  static const AllReduceDataType value = AllReduceDouble;
+};
+
+size_t GetAllReduceDataTypeSize(AllReduceDataType data_type);
+
+// dst[i] = op(dst[i], src[i]), for i in [0, count).
+void AllReduceInto(void *dst, const void *src, int32_t count,
+                   AllReduceDataType data_type, AllReduceOp op);
+
+}  // namespace petuum
@@ -0,0 +1,349 @@
+#include <petuum_ps_common/util/dense_kernels.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PETUUM_DENSE_KERNELS_X86
+#endif
+
+namespace petuum {
+
+namespace {
+
+template<typename V>
+void AddScalar(V *x, const V *y, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    x[i] += y[i];
+}
+
+template<typename V>
+void ScaledAddScalar(V *x, const V *y, V alpha, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    x[i] += alpha * y[i];
+}
+
+template<typename V>
+V DotScalar(const V *x, const V *y, size_t n) {
+  V sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += x[i] * y[i];
+  return sum;
+}
+
+#ifdef PETUUM_DENSE_KERNELS_X86
+
+// The target attribute only matters on 32-bit x86, where SSE2 is optional.
+__attribute__((target("sse2")))
+void AddFloatSSE2(float *x, const float *y, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128 x0 = _mm_loadu_ps(x + i);
+    __m128 x1 = _mm_loadu_ps(x + i + 4);
+    x0 = _mm_add_ps(x0, _mm_loadu_ps(y + i));
+    x1 = _mm_add_ps(x1, _mm_loadu_ps(y + i + 4));
+    _mm_storeu_ps(x + i, x0);
+    _mm_storeu_ps(x + i + 4, x1);
+  }
+  AddScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("sse2")))
+void AddDoubleSSE2(double *x, const double *y, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128d x0 = _mm_loadu_pd(x + i);
+    __m128d x1 = _mm_loadu_pd(x + i + 2);
+    x0 = _mm_add_pd(x0, _mm_loadu_pd(y + i));
+    x1 = _mm_add_pd(x1, _mm_loadu_pd(y + i + 2));
+    _mm_storeu_pd(x + i, x0);
+    _mm_storeu_pd(x + i + 2, x1);
+  }
+  AddScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("sse2")))
+void AddInt32SSE2(int32_t *x, const int32_t *y, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+    __m128i yv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(x + i),
+                     _mm_add_epi32(xv, yv));
+  }
+  AddScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("sse2")))
+void ScaledAddFloatSSE2(float *x, const float *y, float alpha, size_t n) {
+  __m128 a = _mm_set1_ps(alpha);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 xv = _mm_loadu_ps(x + i);
+    xv = _mm_add_ps(xv, _mm_mul_ps(a, _mm_loadu_ps(y + i)));
+    _mm_storeu_ps(x + i, xv);
+  }
+  ScaledAddScalar(x + i, y + i, alpha, n - i);
+}
+
+__attribute__((target("sse2")))
+void ScaledAddDoubleSSE2(double *x, const double *y, double alpha,
+                         size_t n) {
+  __m128d a = _mm_set1_pd(alpha);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d xv = _mm_loadu_pd(x + i);
+    xv = _mm_add_pd(xv, _mm_mul_pd(a, _mm_loadu_pd(y + i)));
+    _mm_storeu_pd(x + i, xv);
+  }
+  ScaledAddScalar(x + i, y + i, alpha, n - i);
+}
+
+// 32-bit integer multiply needs SSE4.1, so leave it to the compiler.
+void ScaledAddInt32SSE2(int32_t *x, const int32_t *y, int32_t alpha,
+                        size_t n) {
+  ScaledAddScalar(x, y, alpha, n);
+}
+
+__attribute__((target("sse2")))
+float DotFloatSSE2(const float *x, const float *y, size_t n) {
+  __m128 s0 = _mm_setzero_ps();
+  __m128 s1 = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(x + i + 4),
+                                   _mm_loadu_ps(y + i + 4)));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, _mm_add_ps(s0, s1));
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+      + DotScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("sse2")))
+double DotDoubleSSE2(const double *x, const double *y, size_t n) {
+  __m128d s0 = _mm_setzero_pd();
+  __m128d s1 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x + i + 2),
+                                   _mm_loadu_pd(y + i + 2)));
+  }
+  double lanes[2];
+  _mm_storeu_pd(lanes, _mm_add_pd(s0, s1));
+  return (lanes[0] + lanes[1]) + DotScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void AddFloatAVX2(float *x, const float *y, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256 x0 = _mm256_loadu_ps(x + i);
+    __m256 x1 = _mm256_loadu_ps(x + i + 8);
+    x0 = _mm256_add_ps(x0, _mm256_loadu_ps(y + i));
+    x1 = _mm256_add_ps(x1, _mm256_loadu_ps(y + i + 8));
+    _mm256_storeu_ps(x + i, x0);
+    _mm256_storeu_ps(x + i + 8, x1);
+  }
+  AddScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void AddDoubleAVX2(double *x, const double *y, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256d x0 = _mm256_loadu_pd(x + i);
+    __m256d x1 = _mm256_loadu_pd(x + i + 4);
+    x0 = _mm256_add_pd(x0, _mm256_loadu_pd(y + i));
+    x1 = _mm256_add_pd(x1, _mm256_loadu_pd(y + i + 4));
+    _mm256_storeu_pd(x + i, x0);
+    _mm256_storeu_pd(x + i + 4, x1);
+  }
+  AddScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void AddInt32AVX2(int32_t *x, const int32_t *y, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+    __m256i yv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + i),
+                        _mm256_add_epi32(xv, yv));
+  }
+  AddScalar(x + i, y + i, n - i);
+}
+
+// Multiply and add are kept separate (no FMA) so that results match the
+// SSE2 and scalar versions bit for bit.
+__attribute__((target("avx2")))
+void ScaledAddFloatAVX2(float *x, const float *y, float alpha, size_t n) {
+  __m256 a = _mm256_set1_ps(alpha);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 xv = _mm256_loadu_ps(x + i);
+    xv = _mm256_add_ps(xv, _mm256_mul_ps(a, _mm256_loadu_ps(y + i)));
+    _mm256_storeu_ps(x + i, xv);
+  }
+  ScaledAddScalar(x + i, y + i, alpha, n - i);
+}
+
+__attribute__((target("avx2")))
+void ScaledAddDoubleAVX2(double *x, const double *y, double alpha,
+                         size_t n) {
+  __m256d a = _mm256_set1_pd(alpha);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d xv = _mm256_loadu_pd(x + i);
+    xv = _mm256_add_pd(xv, _mm256_mul_pd(a, _mm256_loadu_pd(y + i)));
+    _mm256_storeu_pd(x + i, xv);
+  }
+  ScaledAddScalar(x + i, y + i, alpha, n - i);
+}
+
+__attribute__((target("avx2")))
+void ScaledAddInt32AVX2(int32_t *x, const int32_t *y, int32_t alpha,
+                        size_t n) {
+  __m256i a = _mm256_set1_epi32(alpha);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+    __m256i yv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+    xv = _mm256_add_epi32(xv, _mm256_mullo_epi32(a, yv));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(x + i), xv);
+  }
+  ScaledAddScalar(x + i, y + i, alpha, n - i);
+}
+
+__attribute__((target("avx2")))
+float DotFloatAVX2(const float *x, const float *y, size_t n) {
+  __m256 s0 = _mm256_setzero_ps();
+  __m256 s1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    s0 = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_loadu_ps(x + i),
+                                         _mm256_loadu_ps(y + i)));
+    s1 = _mm256_add_ps(s1, _mm256_mul_ps(_mm256_loadu_ps(x + i + 8),
+                                         _mm256_loadu_ps(y + i + 8)));
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, _mm256_add_ps(s0, s1));
+  float sum = 0;
+  for (int j = 0; j < 8; ++j)
+    sum += lanes[j];
+  return sum + DotScalar(x + i, y + i, n - i);
+}
+
+__attribute__((target("avx2")))
+double DotDoubleAVX2(const double *x, const double *y, size_t n) {
+  __m256d s0 = _mm256_setzero_pd();
+  __m256d s1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(x + i),
+                                         _mm256_loadu_pd(y + i)));
+    s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4),
+                                         _mm256_loadu_pd(y + i + 4)));
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_add_pd(s0, s1));
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+      + DotScalar(x + i, y + i, n - i);
+}
+
+#endif  // PETUUM_DENSE_KERNELS_X86
+
+struct DenseKernels {
+  void (*AddFloat)(float *x, const float *y, size_t n);
+  void (*AddDouble)(double *x, const double *y, size_t n);
+  void (*AddInt32)(int32_t *x, const int32_t *y, size_t n);
+  void (*ScaledAddFloat)(float *x, const float *y, float alpha, size_t n);
+  void (*ScaledAddDouble)(double *x, const double *y, double alpha,
+                          size_t n);
+  void (*ScaledAddInt32)(int32_t *x, const int32_t *y, int32_t alpha,
+                         size_t n);
+  float (*DotFloat)(const float *x, const float *y, size_t n);
+  double (*DotDouble)(const double *x, const double *y, size_t n);
+  const char *isa;
+
+  DenseKernels():
+      AddFloat(AddScalar<float>),
+      AddDouble(AddScalar<double>),
+      AddInt32(AddScalar<int32_t>),
+      ScaledAddFloat(ScaledAddScalar<float>),
+      ScaledAddDouble(ScaledAddScalar<double>),
+      ScaledAddInt32(ScaledAddScalar<int32_t>),
+      DotFloat(DotScalar<float>),
+      DotDouble(DotScalar<double>),
+      isa("scalar") {
+#ifdef PETUUM_DENSE_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      AddFloat = AddFloatAVX2;
+      AddDouble = AddDoubleAVX2;
+      AddInt32 = AddInt32AVX2;
+      ScaledAddFloat = ScaledAddFloatAVX2;
+      ScaledAddDouble = ScaledAddDoubleAVX2;
+      ScaledAddInt32 = ScaledAddInt32AVX2;
+      DotFloat = DotFloatAVX2;
+      DotDouble = DotDoubleAVX2;
+      isa = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+      AddFloat = AddFloatSSE2;
+      AddDouble = AddDoubleSSE2;
+      AddInt32 = AddInt32SSE2;
+      ScaledAddFloat = ScaledAddFloatSSE2;
+      ScaledAddDouble = ScaledAddDoubleSSE2;
+      ScaledAddInt32 = ScaledAddInt32SSE2;
+      DotFloat = DotFloatSSE2;
+      DotDouble = DotDoubleSSE2;
+      isa = "sse2";
+    }
+#endif
+  }
+};
+
+const DenseKernels &GetDenseKernels() {
+  static const DenseKernels kernels;
+  return kernels;
+}
+
+}  // anonymous namespace
+
+void DenseAdd(float *x, const float *y, size_t n) {
+  GetDenseKernels().AddFloat(x, y, n);
+}
+
+void DenseAdd(double *x, const double *y, size_t n) {
+  GetDenseKernels().AddDouble(x, y, n);
+}
+
+void DenseAdd(int32_t *x, const int32_t *y, size_t n) {
+  GetDenseKernels().AddInt32(x, y, n);
+}
+
+void DenseScaledAdd(float *x, const float *y, float alpha, size_t n) {
+  GetDenseKernels().ScaledAddFloat(x, y, alpha, n);
+}
+
+void DenseScaledAdd(double *x, const double *y, double alpha, size_t n) {
+  GetDenseKernels().ScaledAddDouble(x, y, alpha, n);
+}
+
+void DenseScaledAdd(int32_t *x, const int32_t *y, int32_t alpha, size_t n) {
+  GetDenseKernels().ScaledAddInt32(x, y, alpha, n);
+}
+
+float DenseDot(const float *x, const float *y, size_t n) {
+  return GetDenseKernels().DotFloat(x, y, n);
+}
+
+double DenseDot(const double *x, const double *y, size_t n) {
+  return GetDenseKernels().DotDouble(x, y, n);
+}
+
+const char *GetDenseKernelISA() {
+  return GetDenseKernels().isa;
+}
+
+}  // namespace petuum
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace petuum {
+
+// Bulk kernels for dense rows and dense row oplogs. The float, double and
+// int32_t versions use SSE2 or AVX2, chosen at runtime according to what
+// the CPU supports; other types fall back to plain loops.
+
+// x[i] += y[i], for i in [0, n).
+void DenseAdd(float *x, const float *y, size_t n);
+void DenseAdd(double *x, const double *y, size_t n);
+void DenseAdd(int32_t *x, const int32_t *y, size_t n);
+
+template<typename V>
+void DenseAdd(V *x, const V *y, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    x[i] += y[i];
+}
+
+// x[i] += alpha * y[i], for i in [0, n).
+void DenseScaledAdd(float *x, const float *y, float alpha, size_t n);
+void DenseScaledAdd(double *x, const double *y, double alpha, size_t n);
+void DenseScaledAdd(int32_t *x, const int32_t *y, int32_t alpha, size_t n);
+
+template<typename V>
+void DenseScaledAdd(V *x, const V *y, V alpha, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    x[i] += alpha * y[i];
+}
+
+// Returns the sum of x[i] * y[i], for i in [0, n). The SIMD versions sum
+// in a different order than the plain loop, so the last bits of the result
+// depend on the instruction set.
+float DenseDot(const float *x, const float *y, size_t n);
+double DenseDot(const double *x, const double *y, size_t n);
+
+template<typename V>
+V DenseDot(const V *x, const V *y, size_t n) {
+  V sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += x[i] * y[i];
+  return sum;
+}
+
+// Name of the instruction set the kernels dispatch to, e.g. "avx2".
+const char *GetDenseKernelISA();
+
+}  // namespace petuum
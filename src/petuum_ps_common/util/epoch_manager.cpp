@@ -0,0 +1,100 @@
+#include <petuum_ps_common/util/epoch_manager.hpp>
+#include <glog/logging.h>
+#include <boost/thread/tss.hpp>
+#include <limits>
+#include <algorithm>
+
+namespace petuum {
+
+const int32_t EpochManager::kMaxNumThreads;
+std::atomic<int32_t> EpochManager::num_threads_(0);
+__thread int32_t EpochManager::thread_idx_ = -1;
+std::mutex EpochManager::free_thread_idxs_mtx_;
+std::vector<int32_t> EpochManager::free_thread_idxs_;
+
+namespace {
+
+// Gives the thread's index back when the thread exits. A thread that exits
+// has left every read section, so its reader epochs are all 0.
+struct ThreadIdxReleaser {
+  int32_t thread_idx;
+  void (*Release)(int32_t thread_idx);
+  ~ThreadIdxReleaser() {
+    Release(thread_idx);
+  }
+};
+
+boost::thread_specific_ptr<ThreadIdxReleaser> thread_idx_releaser;
+
+}  // anonymous namespace
+
+EpochManager::EpochManager():
+    global_epoch_(1),
+    reader_epochs_(new ReaderEpoch[kMaxNumThreads]) {
+  for (int32_t i = 0; i < kMaxNumThreads; ++i) {
+    reader_epochs_[i].epoch = 0;
+  }
+}
+
+EpochManager::~EpochManager() {
+  for (auto &retired_obj : retired_) {
+    retired_obj.Delete(retired_obj.obj);
+  }
+}
+
+int32_t EpochManager::AcquireThreadIdx() {
+  int32_t thread_idx;
+  {
+    std::lock_guard<std::mutex> lock(free_thread_idxs_mtx_);
+    if (!free_thread_idxs_.empty()) {
+      thread_idx = free_thread_idxs_.back();
+      free_thread_idxs_.pop_back();
+    } else {
+      thread_idx = num_threads_++;
+      CHECK_LT(thread_idx, kMaxNumThreads) << "Too many threads";
+    }
+  }
+  thread_idx_releaser.reset(
+      new ThreadIdxReleaser{thread_idx, &EpochManager::ReleaseThreadIdx});
+  return thread_idx;
+}
+
+void EpochManager::ReleaseThreadIdx(int32_t thread_idx) {
+  std::lock_guard<std::mutex> lock(free_thread_idxs_mtx_);
+  free_thread_idxs_.push_back(thread_idx);
+}
+
+void EpochManager::Retire(void *obj, DeleteFunc Delete) {
+  RetiredObj retired_obj;
+  retired_obj.obj = obj;
+  retired_obj.Delete = Delete;
+  // Readers that enter from now on see the new epoch and cannot reach obj.
+  retired_obj.epoch = global_epoch_++;
+  retired_.push_back(retired_obj);
+}
+
+void EpochManager::Reclaim() {
+  if (retired_.empty())
+    return;
+
+  uint64_t min_epoch = std::numeric_limits<uint64_t>::max();
+  int32_t num_threads = std::min<int32_t>(num_threads_.load(),
+                                          kMaxNumThreads);
+  for (int32_t i = 0; i < num_threads; ++i) {
+    uint64_t epoch = reader_epochs_[i].epoch.load();
+    if (epoch != 0 && epoch < min_epoch)
+      min_epoch = epoch;
+  }
+
+  size_t num_kept = 0;
+  for (size_t i = 0; i < retired_.size(); ++i) {
+    if (retired_[i].epoch < min_epoch) {
+      retired_[i].Delete(retired_[i].obj);
+    } else {
+      retired_[num_kept++] = retired_[i];
+    }
+  }
+  retired_.resize(num_kept);
+}
+
+}  // namespace petuum
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace petuum {
+
+// Epoch-based memory reclamation for lock-free readers.
+//
+// Readers bracket every lock-free access with Enter() and Exit(). A writer
+// that has unlinked an object so that new readers cannot reach it hands the
+// object to Retire(); Reclaim() later deletes it once every reader that
+// might still hold a reference has exited. Retire() and Reclaim() must be
+// serialized by the caller; Enter() and Exit() may be called by any number
+// of threads concurrently, but may not be nested.
+class EpochManager : boost::noncopyable {
+public:
+  typedef void (*DeleteFunc)(void *obj);
+
+  EpochManager();
+  // Deletes all retired objects. No reader may be active.
+  ~EpochManager();
+
+  void Enter() {
+    ReaderEpoch &reader_epoch = reader_epochs_[GetThreadIdx()];
+    reader_epoch.epoch.store(global_epoch_.load());
+  }
+
+  void Exit() {
+    reader_epochs_[GetThreadIdx()].epoch.store(0, std::memory_order_release);
+  }
+
+  void Retire(void *obj, DeleteFunc Delete);
+
+  void Reclaim();
+
+  size_t get_num_retired() const {
+    return retired_.size();
+  }
+
+private:
+  struct RetiredObj {
+    void *obj;
+    DeleteFunc Delete;
+    uint64_t epoch;
+  };
+
+  // Epoch a reader entered at, 0 if the reader is not active. Padded to a
+  // cache line so that readers do not contend with each other.
+  struct ReaderEpoch {
+    std::atomic<uint64_t> epoch;
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  // Each thread is given a process-wide index on first use. The index is
+  // freed when the thread exits and handed to the next new thread, so only
+  // the number of threads alive at once is bounded by kMaxNumThreads.
+  static int32_t GetThreadIdx() {
+    if (thread_idx_ < 0)
+      thread_idx_ = AcquireThreadIdx();
+    return thread_idx_;
+  }
+
+  static int32_t AcquireThreadIdx();
+  static void ReleaseThreadIdx(int32_t thread_idx);
+
+  static const int32_t kMaxNumThreads = 512;
+  // Number of indexes ever handed out; readers are only in [0, num_threads_).
+  static std::atomic<int32_t> num_threads_;
+  static __thread int32_t thread_idx_;
+
+  static std::mutex free_thread_idxs_mtx_;
+  static std::vector<int32_t> free_thread_idxs_;
+
+  std::atomic<uint64_t> global_epoch_;
+  std::unique_ptr<ReaderEpoch[]> reader_epochs_;
+  std::vector<RetiredObj> retired_;
+};
+
+}  // namespace petuum
@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <glog/logging.h>
 #include <boost/noncopyable.hpp>
+#include <petuum_ps_common/util/msg_buff_pool.hpp>
 
 namespace petuum {
 
@@ -65,13 +66,16 @@ public:
     mem_ = MemAlloc(size);
   }
 
+  /*
+   * Memory comes from MsgBuffPool so that large message buffers are recycled
+   * and may be handed to zmq without copying.
+   */
   static inline uint8_t *MemAlloc(int32_t nbytes){
-    uint8_t *mem = new uint8_t[nbytes];
-    return mem;
+    return MsgBuffPool::Alloc(nbytes);
   }
 
   static inline void MemFree(uint8_t *mem){
-    delete[] mem;
+    MsgBuffPool::Free(mem);
   }
 
 private:
@@ -0,0 +1,202 @@
+#include <petuum_ps_common/util/metrics.hpp>
+#include <glog/logging.h>
+#include <stdio.h>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace petuum {
+
+namespace {
+
+struct MetricInfo {
+  const char *name;
+  const char *help;
+};
+
+const MetricInfo kCounterInfos[kNumMetricCounters] = {
+  {"petuum_bg_oplog_sent_bytes_total",
+   "Bytes of oplog messages sent by the bg threads."},
+  {"petuum_server_oplog_received_bytes_total",
+   "Bytes of oplog messages received by the server threads."},
+  {"petuum_server_row_oplogs_applied_total",
+   "Row oplogs applied by the server threads."},
+  {"petuum_server_push_sent_bytes_total",
+   "Bytes of row push messages sent by the server threads."},
+  {"petuum_server_row_requests_total",
+   "Row requests received by the server threads."}
+};
+
+const MetricInfo kGaugeInfos[kNumMetricGauges] = {
+  {"petuum_app_row_fetches_in_flight",
+   "App threads waiting for rows fetched from the servers."},
+  {"petuum_server_buffered_row_requests",
+   "Row requests held by the server threads until the rows are fresh "
+   "enough."}
+};
+
+const MetricInfo kHistogramInfos[kNumMetricHistograms] = {
+  {"petuum_app_get", "Table Get calls, latency sampled."},
+  {"petuum_app_inc", "Table Inc calls, latency sampled."},
+  {"petuum_app_batch_inc",
+   "Table BatchInc and DenseBatchInc calls, latency sampled."},
+  {"petuum_app_clock", "Table group Clock calls."},
+  {"petuum_app_row_fetch", "Row fetches from the servers on Get."},
+  {"petuum_bg_oplog_serialize", "Oplog serializations by the bg threads."},
+  {"petuum_server_apply_oplog", "Oplog messages applied by the servers."}
+};
+
+std::mutex exporter_mtx;
+std::condition_variable exporter_cv;
+std::thread exporter_thread;
+bool exporter_running = false;
+std::string metrics_filename;
+int32_t metrics_interval_sec;
+int32_t metrics_client_id;
+
+}  // anonymous namespace
+
+__thread Metrics::Shard *Metrics::thread_shard_ = 0;
+std::mutex Metrics::shards_mtx_;
+std::vector<Metrics::Shard*> Metrics::shards_;
+
+void Metrics::Init(const TableGroupConfig &table_group_config) {
+  metrics_client_id = table_group_config.client_id;
+  if (table_group_config.metrics_path.empty())
+    return;
+
+  std::stringstream filename_ss;
+  filename_ss << table_group_config.metrics_path << "."
+              << table_group_config.client_id << ".prom";
+  metrics_filename = filename_ss.str();
+  metrics_interval_sec = table_group_config.metrics_interval_sec;
+  CHECK_GT(metrics_interval_sec, 0);
+
+  std::lock_guard<std::mutex> lock(exporter_mtx);
+  CHECK(!exporter_running) << "Metrics::Init() called twice";
+  exporter_running = true;
+  exporter_thread = std::thread(ExporterMain);
+}
+
+void Metrics::ShutDown() {
+  {
+    std::lock_guard<std::mutex> lock(exporter_mtx);
+    if (!exporter_running)
+      return;
+    exporter_running = false;
+  }
+  exporter_cv.notify_one();
+  exporter_thread.join();
+}
+
+Metrics::Shard *Metrics::CreateShard() {
+  // Value-initialized, so all zero.
+  Shard *shard = new Shard();
+  std::lock_guard<std::mutex> lock(shards_mtx_);
+  shards_.push_back(shard);
+  return shard;
+}
+
+void Metrics::WriteText(std::ostream &os) {
+  std::vector<uint64_t> counters(kNumMetricCounters, 0);
+  std::vector<int64_t> gauges(kNumMetricGauges, 0);
+  std::vector<uint64_t> calls(kNumMetricHistograms, 0);
+  std::vector<uint64_t> sum_nanos(kNumMetricHistograms, 0);
+  std::vector<std::vector<uint64_t> > buckets(
+      kNumMetricHistograms, std::vector<uint64_t>(kNumMetricBuckets, 0));
+  {
+    std::lock_guard<std::mutex> lock(shards_mtx_);
+    for (const Shard *shard : shards_) {
+      for (int32_t i = 0; i < kNumMetricCounters; ++i)
+        counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+      for (int32_t i = 0; i < kNumMetricGauges; ++i)
+        gauges[i] += shard->gauges[i].load(std::memory_order_relaxed);
+      for (int32_t i = 0; i < kNumMetricHistograms; ++i) {
+        calls[i] += shard->calls[i].load(std::memory_order_relaxed);
+        sum_nanos[i] += shard->sum_nanos[i].load(std::memory_order_relaxed);
+        for (int32_t b = 0; b < kNumMetricBuckets; ++b) {
+          buckets[i][b]
+              += shard->buckets[i][b].load(std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  std::stringstream label_ss;
+  label_ss << "client=\"" << metrics_client_id << "\"";
+  const std::string label = label_ss.str();
+
+  for (int32_t i = 0; i < kNumMetricCounters; ++i) {
+    os << "# HELP " << kCounterInfos[i].name << " " << kCounterInfos[i].help
+       << "\n# TYPE " << kCounterInfos[i].name << " counter\n"
+       << kCounterInfos[i].name << "{" << label << "} " << counters[i] << "\n";
+  }
+
+  for (int32_t i = 0; i < kNumMetricGauges; ++i) {
+    os << "# HELP " << kGaugeInfos[i].name << " " << kGaugeInfos[i].help
+       << "\n# TYPE " << kGaugeInfos[i].name << " gauge\n"
+       << kGaugeInfos[i].name << "{" << label << "} " << gauges[i] << "\n";
+  }
+
+  // Each histogram comes with a counter of all calls, since the latencies
+  // of the per-call paths are sampled.
+  for (int32_t i = 0; i < kNumMetricHistograms; ++i) {
+    const std::string name = kHistogramInfos[i].name;
+    os << "# HELP " << name << "_total " << kHistogramInfos[i].help
+       << "\n# TYPE " << name << "_total counter\n"
+       << name << "_total{" << label << "} " << calls[i] << "\n";
+
+    os << "# HELP " << name << "_seconds " << kHistogramInfos[i].help
+       << "\n# TYPE " << name << "_seconds histogram\n";
+    uint64_t cumulative = 0;
+    for (int32_t b = 0; b < kNumMetricBuckets; ++b) {
+      cumulative += buckets[i][b];
+      os << name << "_seconds_bucket{" << label << ",le=\"";
+      if (b < kNumMetricBuckets - 1) {
+        char bound[32];
+        snprintf(bound, sizeof(bound), "%g",
+                 double(uint64_t(1) << (kMetricMinBucketLog2 + b)) * 1e-9);
+        os << bound;
+      } else {
+        os << "+Inf";
+      }
+      os << "\"} " << cumulative << "\n";
+    }
+    os << name << "_seconds_sum{" << label << "} " << sum_nanos[i] * 1e-9
+       << "\n" << name << "_seconds_count{" << label << "} " << cumulative
+       << "\n";
+  }
+}
+
+void Metrics::WriteFile() {
+  // Written to a temporary file and renamed so that readers never see a
+  // partial file.
+  std::string tmp_filename = metrics_filename + ".tmp";
+  {
+    std::ofstream of_stream(tmp_filename.c_str(),
+                            std::ios_base::out | std::ios_base::trunc);
+    if (!of_stream) {
+      LOG(ERROR) << "Failed to open " << tmp_filename;
+      return;
+    }
+    WriteText(of_stream);
+  }
+  if (rename(tmp_filename.c_str(), metrics_filename.c_str()) != 0)
+    LOG(ERROR) << "Failed to rename " << tmp_filename;
+}
+
+void Metrics::ExporterMain() {
+  std::unique_lock<std::mutex> lock(exporter_mtx);
+  while (exporter_running) {
+    exporter_cv.wait_for(lock, std::chrono::seconds(metrics_interval_sec));
+    lock.unlock();
+    WriteFile();
+    lock.lock();
+  }
+}
+
+}  // namespace petuum
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <petuum_ps_common/include/configs.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+
+namespace petuum {
+
+// Always-on process metrics, written periodically in the Prometheus text
+// format while the job runs (see Metrics::Init()). Unlike Stats, which is
+// compiled in only with PETUUM_STATS and written at shutdown, these are
+// cheap enough to leave on: each thread updates its own shard with relaxed
+// loads and stores, and the exporter sums the shards.
+
+enum MetricCounter {
+  kMetricBgOpLogSentBytes = 0,
+  kMetricServerOpLogRecvBytes,
+  kMetricServerRowOpLogsApplied,
+  kMetricServerPushSentBytes,
+  kMetricServerRowRequests,
+  kNumMetricCounters
+};
+
+// Summed over the threads; each thread adds and removes its own share.
+enum MetricGauge {
+  // App threads waiting for rows fetched from the servers.
+  kMetricAppRowFetchesInFlight = 0,
+  // Row requests held by the servers until the rows are fresh enough.
+  kMetricServerBufferedRowRequests,
+  kNumMetricGauges
+};
+
+// Latencies, in log2 buckets from 64ns to 2^37ns (about 137s).
+enum MetricHistogram {
+  kMetricAppGet = 0,
+  kMetricAppInc,
+  kMetricAppBatchInc,
+  kMetricAppClock,
+  kMetricAppRowFetch,
+  kMetricBgOpLogSerialize,
+  kMetricServerApplyOpLog,
+  kNumMetricHistograms
+};
+
+class Metrics {
+public:
+  // Finite buckets have upper bounds 2^(kMetricMinBucketLog2 + i) ns; the
+  // last bucket is +Inf.
+  static const int32_t kMetricMinBucketLog2 = 6;
+  static const int32_t kNumMetricBuckets = 33;
+
+  // Sampled timers time 1 in kMetricSampleRate calls per thread.
+  static const uint32_t kMetricSampleRate = 16;
+
+  // Starts writing the metrics every metrics_interval_sec seconds to
+  // <metrics_path>.<client_id>.prom, e.g. for the node_exporter textfile
+  // collector. Metrics are collected even if metrics_path is empty.
+  static void Init(const TableGroupConfig &table_group_config);
+
+  // Stops the exporter after a last write.
+  static void ShutDown();
+
+  static void AddCounter(MetricCounter metric, uint64_t value) {
+    Add(&GetShard()->counters[metric], value);
+  }
+
+  static void AddGauge(MetricGauge metric, int64_t delta) {
+    Add(&GetShard()->gauges[metric], delta);
+  }
+
+  // Counts one call and records its latency.
+  static void Observe(MetricHistogram metric, uint64_t nanos) {
+    Shard *shard = GetShard();
+    Add(&shard->calls[metric], uint64_t(1));
+    Record(shard, metric, nanos);
+  }
+
+  // Counts one call; returns true if the call should be timed and passed to
+  // RecordSample().
+  static bool CountAndSample(MetricHistogram metric) {
+    Shard *shard = GetShard();
+    Add(&shard->calls[metric], uint64_t(1));
+    return (shard->sample_tick++ % kMetricSampleRate) == 0;
+  }
+
+  static void RecordSample(MetricHistogram metric, uint64_t nanos) {
+    Record(GetShard(), metric, nanos);
+  }
+
+  static uint64_t NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Writes the current values of all metrics in the Prometheus text format.
+  static void WriteText(std::ostream &os);
+
+private:
+  struct Shard {
+    std::atomic<uint64_t> counters[kNumMetricCounters];
+    std::atomic<int64_t> gauges[kNumMetricGauges];
+    std::atomic<uint64_t> calls[kNumMetricHistograms];
+    std::atomic<uint64_t> buckets[kNumMetricHistograms][kNumMetricBuckets];
+    std::atomic<uint64_t> sum_nanos[kNumMetricHistograms];
+    uint32_t sample_tick;
+  };
+
+  // Only the owning thread writes a shard, so a relaxed load and store is
+  // enough and avoids a locked instruction.
+  template<typename T>
+  static void Add(std::atomic<T> *value, T delta) {
+    value->store(value->load(std::memory_order_relaxed) + delta,
+                 std::memory_order_relaxed);
+  }
+
+  static int32_t GetBucket(uint64_t nanos) {
+    if (nanos <= (uint64_t(1) << kMetricMinBucketLog2))
+      return 0;
+    int32_t log2_ceil = 64 - __builtin_clzll(nanos - 1);
+    int32_t bucket = log2_ceil - kMetricMinBucketLog2;
+    return bucket < kNumMetricBuckets ? bucket : kNumMetricBuckets - 1;
+  }
+
+  static void Record(Shard *shard, MetricHistogram metric, uint64_t nanos) {
+    Add(&shard->buckets[metric][GetBucket(nanos)], uint64_t(1));
+    Add(&shard->sum_nanos[metric], nanos);
+  }
+
+  static Shard *GetShard() {
+    if (thread_shard_ == 0)
+      thread_shard_ = CreateShard();
+    return thread_shard_;
+  }
+
+  // Shards live until the process exits so that the counts of threads that
+  // have exited are kept.
+  static Shard *CreateShard();
+
+  static void ExporterMain();
+
+  static void WriteFile();
+
+  static __thread Shard *thread_shard_;
+
+  static std::mutex shards_mtx_;
+  static std::vector<Shard*> shards_;
+};
+
+// Counts and times the scope into a histogram. Sampled timers count every
+// scope but only time 1 in Metrics::kMetricSampleRate, for the per-call
+// paths like Get and Inc.
+class MetricTimer {
+public:
+  MetricTimer(MetricHistogram metric, bool sampled):
+      metric_(metric),
+      sampled_(sampled),
+      begin_nanos_(0) {
+    if (!sampled) {
+      begin_nanos_ = Metrics::NowNanos();
+    } else if (Metrics::CountAndSample(metric)) {
+      begin_nanos_ = Metrics::NowNanos();
+    }
+  }
+
+  ~MetricTimer() {
+    if (!sampled_) {
+      Metrics::Observe(metric_, Metrics::NowNanos() - begin_nanos_);
+    } else if (begin_nanos_ != 0) {
+      Metrics::RecordSample(metric_, Metrics::NowNanos() - begin_nanos_);
+    }
+  }
+
+private:
+  const MetricHistogram metric_;
+  const bool sampled_;
+  uint64_t begin_nanos_;
+};
+
+}  // namespace petuum
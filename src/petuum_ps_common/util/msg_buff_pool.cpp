@@ -0,0 +1,78 @@
+#include <petuum_ps_common/util/msg_buff_pool.hpp>
+#include <glog/logging.h>
+
+namespace petuum {
+
+uint8_t *MsgBuffPool::Alloc(size_t nbytes) {
+  size_t total_size = nbytes + kHeaderSize;
+  int32_t size_class = 0;
+  while (size_class < kNumSizeClasses
+         && GetClassSize(size_class) < total_size) {
+    ++size_class;
+  }
+
+  uint8_t *buff = 0;
+  if (total_size < kMinPooledSize || size_class == kNumSizeClasses) {
+    buff = new uint8_t[total_size];
+    *(reinterpret_cast<int32_t*>(buff)) = kUnpooled;
+    return buff + kHeaderSize;
+  }
+
+  SizeClass &free_list = GetSizeClasses()[size_class];
+  {
+    std::lock_guard<std::mutex> lock(free_list.mtx);
+    if (!free_list.free_buffs.empty()) {
+      buff = free_list.free_buffs.back();
+      free_list.free_buffs.pop_back();
+    }
+  }
+
+  if (buff == 0) {
+    buff = new uint8_t[GetClassSize(size_class)];
+    *(reinterpret_cast<int32_t*>(buff)) = size_class;
+  }
+  return buff + kHeaderSize;
+}
+
+void MsgBuffPool::Free(uint8_t *buff) {
+  if (buff == 0)
+    return;
+
+  buff -= kHeaderSize;
+  int32_t size_class = *(reinterpret_cast<int32_t*>(buff));
+  if (size_class == kUnpooled) {
+    delete[] buff;
+    return;
+  }
+  CHECK(size_class >= 0 && size_class < kNumSizeClasses)
+      << "Buffer not allocated from MsgBuffPool";
+
+  size_t max_num_free_buffs
+      = kMaxFreeBytesPerClass / GetClassSize(size_class);
+  if (max_num_free_buffs > kMaxNumFreeBuffs)
+    max_num_free_buffs = kMaxNumFreeBuffs;
+  if (max_num_free_buffs == 0)
+    max_num_free_buffs = 1;
+
+  SizeClass &free_list = GetSizeClasses()[size_class];
+  {
+    std::lock_guard<std::mutex> lock(free_list.mtx);
+    if (free_list.free_buffs.size() < max_num_free_buffs) {
+      free_list.free_buffs.push_back(buff);
+      return;
+    }
+  }
+  delete[] buff;
+}
+
+void MsgBuffPool::ZmqFree(void *data, void *hint) {
+  Free(reinterpret_cast<uint8_t*>(data));
+}
+
+MsgBuffPool::SizeClass *MsgBuffPool::GetSizeClasses() {
+  // Never destroyed, as zmq I/O threads may return buffers during exit.
+  static SizeClass *size_classes = new SizeClass[kNumSizeClasses];
+  return size_classes;
+}
+
+}  // namespace petuum
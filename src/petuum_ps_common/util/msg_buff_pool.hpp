@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <mutex>
+#include <vector>
+
+namespace petuum {
+
+// Process-wide pool of message buffers, backing MemBlock::MemAlloc() and
+// MemBlock::MemFree(). Large buffers (oplog and push row messages) are
+// recycled across clocks instead of going back to malloc, and can be handed
+// to zmq without copying, with ZmqFree() as the free callback. Small
+// buffers are not pooled.
+//
+// Buffers are grouped into power-of-two size classes; each class keeps a
+// bounded number of free buffers. All functions are thread-safe, as a
+// buffer is typically freed by a different thread (the receiver of a
+// MemTransferMsg or a zmq I/O thread) than the one that allocated it.
+class MsgBuffPool {
+public:
+  // Return a buffer of at least nbytes.
+  static uint8_t *Alloc(size_t nbytes);
+
+  // buff must come from Alloc().
+  static void Free(uint8_t *buff);
+
+  // Matches zmq_free_fn.
+  static void ZmqFree(void *data, void *hint);
+
+private:
+  struct SizeClass {
+    std::mutex mtx;
+    std::vector<uint8_t*> free_buffs;
+  };
+
+  static SizeClass *GetSizeClasses();
+
+  // Four size classes per power of two, so that a buffer wastes at most a
+  // quarter of its size: 4 KiB, 5 KiB, 6 KiB, 7 KiB, 8 KiB, 10 KiB, ...
+  static size_t GetClassSize(int32_t size_class) {
+    return ((kMinPooledSize / 4) * (4 + size_class % 4)) << (size_class / 4);
+  }
+
+  // Placed in front of every buffer; keeps the buffer 16-byte aligned.
+  static const size_t kHeaderSize = 16;
+  static const int32_t kUnpooled = -1;
+  // Buffers smaller than this (including the header) are not pooled.
+  static const size_t kMinPooledSize = 4*1024;
+  // The largest pooled buffer is 128 MiB.
+  static const int32_t kNumSizeClasses = 61;
+  static const size_t kMaxNumFreeBuffs = 64;
+  static const size_t kMaxFreeBytesPerClass = 256*1024*1024;
+};
+
+}  // namespace petuum
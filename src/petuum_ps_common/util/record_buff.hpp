@@ -52,6 +52,25 @@ public:
     return true;
   }
 
+  // Append a record by serializing it directly into the buffer. Returns the
+  // memory to write a record of at most max_record_size bytes to, or 0 if the
+  // record does not fit. A successful call must be followed by CommitRecord()
+  // with the exact record size.
+  uint8_t *BeginRecord(int32_t record_id, size_t max_record_size) {
+    if (offset_ + sizeof(int32_t) + max_record_size + sizeof(size_t)
+        > mem_size_) {
+      return 0;
+    }
+    *(reinterpret_cast<int32_t*>(mem_ + offset_)) = record_id;
+    return mem_ + offset_ + sizeof(int32_t) + sizeof(size_t);
+  }
+
+  void CommitRecord(size_t record_size) {
+    *(reinterpret_cast<size_t*>(mem_ + offset_ + sizeof(int32_t)))
+        = record_size;
+    offset_ += sizeof(int32_t) + sizeof(size_t) + record_size;
+  }
+
   size_t GetMemUsedSize() {
     return offset_;
   }
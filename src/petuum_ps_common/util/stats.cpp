@@ -5,6 +5,7 @@
 #include <glog/logging.h>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 
 namespace petuum {
 TableGroupConfig Stats::table_group_config_;
@@ -75,6 +76,11 @@ std::vector<size_t> Stats::bg_accum_num_push_row_msg_recv_;
 std::vector<double> Stats::bg_accum_idle_send_sec_;
 std::vector<size_t> Stats::bg_accum_idle_send_bytes_;
 
+std::vector<size_t> Stats::bg_num_oplog_push_adjust_;
+std::vector<double> Stats::bg_avg_oplog_push_bandwidth_mbps_;
+std::vector<double> Stats::bg_avg_oplog_push_kb_;
+std::vector<double> Stats::bg_avg_oplog_ack_rtt_milli_;
+
 std::vector<double> Stats::bg_accum_handle_append_oplog_sec_;
 std::vector<size_t> Stats::bg_num_append_oplog_buff_handled_;
 
@@ -92,6 +98,8 @@ std::vector<double> Stats::server_per_clock_push_row_mb_;
 
 std::vector<size_t> Stats::server_accum_num_oplog_msg_recv_;
 std::vector<size_t> Stats::server_accum_num_push_row_msg_send_;
+std::vector<size_t> Stats::server_accum_num_row_oplog_applied_;
+std::vector<size_t> Stats::server_accum_num_row_request_;
 
 void Stats::Init(const TableGroupConfig &table_group_config) {
   table_group_config_ = table_group_config;
@@ -351,6 +359,14 @@ void Stats::DeregisterBgThread() {
   bg_accum_idle_send_sec_.push_back(stats.accum_idle_send_sec);
   bg_accum_idle_send_bytes_.push_back(stats.accum_idle_send_bytes);
 
+  size_t num_adjust = std::max(stats.num_oplog_push_adjust, size_t(1));
+  bg_num_oplog_push_adjust_.push_back(stats.num_oplog_push_adjust);
+  bg_avg_oplog_push_bandwidth_mbps_.push_back(
+      stats.accum_oplog_push_bandwidth_mbps / num_adjust);
+  bg_avg_oplog_push_kb_.push_back(stats.accum_oplog_push_kb / num_adjust);
+  bg_avg_oplog_ack_rtt_milli_.push_back(
+      stats.accum_oplog_ack_rtt_milli / num_adjust);
+
   bg_accum_handle_append_oplog_sec_.push_back(stats.accum_handle_append_oplog_sec);
   bg_num_append_oplog_buff_handled_.push_back(stats.num_append_oplog_buff_handled);
 
@@ -398,6 +414,9 @@ void Stats::DeregisterServerThread() {
   server_accum_num_oplog_msg_recv_.push_back(stats.accum_num_oplog_msg_recv);
   server_accum_num_push_row_msg_send_.push_back(
       stats.accum_num_push_row_msg_send);
+  server_accum_num_row_oplog_applied_.push_back(
+      stats.accum_num_row_oplog_applied);
+  server_accum_num_row_request_.push_back(stats.accum_num_row_request);
 }
 
 void Stats::AppLoadDataBegin() {
@@ -824,6 +843,15 @@ void Stats::BgAccumIdleOpLogSentBytes(size_t num_bytes) {
   bg_thread_stats_->accum_idle_send_bytes += num_bytes;
 }
 
+void Stats::BgOpLogPushAdjust(double bandwidth_mbps, size_t push_bytes,
+                              double rtt_sec) {
+  BgThreadStats &stats = *bg_thread_stats_;
+  ++stats.num_oplog_push_adjust;
+  stats.accum_oplog_push_bandwidth_mbps += bandwidth_mbps;
+  stats.accum_oplog_push_kb += push_bytes / double(k1_Ki);
+  stats.accum_oplog_ack_rtt_milli += rtt_sec * kOneThousand;
+}
+
 void Stats::BgAccumHandleAppendOpLogBegin() {
   bg_thread_stats_->handle_append_oplog_timer.restart();
 }
@@ -912,6 +940,14 @@ void Stats::ServerPushRowMsgSendIncOne() {
   ++(server_thread_stats_->accum_num_push_row_msg_send);
 }
 
+void Stats::ServerAddNumRowOpLogApplied(size_t num_row_oplogs) {
+  server_thread_stats_->accum_num_row_oplog_applied += num_row_oplogs;
+}
+
+void Stats::ServerRowRequestIncOne() {
+  ++(server_thread_stats_->accum_num_row_request);
+}
+
 template<typename T>
 void Stats::YamlPrintSequence(YAML::Emitter *yaml_out,
     const std::vector<T> &sequence) {
@@ -1225,6 +1261,22 @@ void Stats::PrintStats() {
     << YAML::Value;
   YamlPrintSequence(&yaml_out, bg_accum_idle_send_bytes_);
 
+  yaml_out << YAML::Key << "bg_num_oplog_push_adjust"
+    << YAML::Value;
+  YamlPrintSequence(&yaml_out, bg_num_oplog_push_adjust_);
+
+  yaml_out << YAML::Key << "bg_avg_oplog_push_bandwidth_mbps"
+    << YAML::Value;
+  YamlPrintSequence(&yaml_out, bg_avg_oplog_push_bandwidth_mbps_);
+
+  yaml_out << YAML::Key << "bg_avg_oplog_push_kb"
+    << YAML::Value;
+  YamlPrintSequence(&yaml_out, bg_avg_oplog_push_kb_);
+
+  yaml_out << YAML::Key << "bg_avg_oplog_ack_rtt_milli"
+    << YAML::Value;
+  YamlPrintSequence(&yaml_out, bg_avg_oplog_ack_rtt_milli_);
+
   yaml_out << YAML::Key << "bg_accum_handle_append_oplog_sec"
            << YAML::Value;
   YamlPrintSequence(&yaml_out, bg_accum_handle_append_oplog_sec_);
@@ -1270,6 +1322,14 @@ void Stats::PrintStats() {
     << YAML::Value;
   YamlPrintSequence(&yaml_out, server_accum_num_push_row_msg_send_);
 
+  yaml_out << YAML::Key << "server_accum_num_row_oplog_applied"
+    << YAML::Value;
+  YamlPrintSequence(&yaml_out, server_accum_num_row_oplog_applied_);
+
+  yaml_out << YAML::Key << "server_accum_num_row_request"
+    << YAML::Value;
+  YamlPrintSequence(&yaml_out, server_accum_num_row_request_);
+
   yaml_out << YAML::EndMap;
 
   std::fstream of_stream(stats_path_, std::ios_base::out
@@ -197,6 +197,9 @@
 #define STATS_BG_ACCUM_IDLE_OPLOG_SENT_BYTES(num_bytes) \
   Stats::BgAccumIdleOpLogSentBytes(num_bytes)
 
+#define STATS_BG_OPLOG_PUSH_ADJUST(bandwidth_mbps, push_bytes, rtt_sec) \
+  Stats::BgOpLogPushAdjust(bandwidth_mbps, push_bytes, rtt_sec)
+
 #define STATS_BG_ACCUM_SERVER_PUSH_OPLOG_ROW_APPLIED_ADD_ONE() \
   Stats::BgAccumServerPushOpLogRowAppliedAddOne()
 
@@ -257,6 +260,12 @@
 #define STATS_SERVER_PUSH_ROW_MSG_SEND_INC_ONE() \
   Stats::ServerPushRowMsgSendIncOne();
 
+#define STATS_SERVER_ADD_NUM_ROW_OPLOG_APPLIED(num_row_oplogs) \
+  Stats::ServerAddNumRowOpLogApplied(num_row_oplogs)
+
+#define STATS_SERVER_ROW_REQUEST_INC_ONE() \
+  Stats::ServerRowRequestIncOne()
+
 #define STATS_PRINT() \
   Stats::PrintStats()
 
@@ -349,6 +358,8 @@
 #define STATS_BG_ACCUM_IDLE_SEND_BEGIN() ((void) 0)
 #define STATS_BG_ACCUM_IDLE_SEND_END() ((void) 0)
 #define STATS_BG_ACCUM_IDLE_OPLOG_SENT_BYTES(num_bytes) ((void) 0)
+#define STATS_BG_OPLOG_PUSH_ADJUST(bandwidth_mbps, push_bytes, rtt_sec) \
+  ((void) 0)
 
 #define STATS_BG_ACCUM_HANDLE_APPEND_OPLOG_BEGIN() ((void) 0)
 #define STATS_BG_ACCUM_HANDLE_APPEND_OPLOG_END() ((void) 0)
@@ -364,6 +375,8 @@
 #define STATS_SERVER_ADD_PER_CLOCK_PUSH_ROW_SIZE(push_row_size) ((void) 0)
 #define STATS_SERVER_OPLOG_MSG_RECV_INC_ONE() ((void) 0)
 #define STATS_SERVER_PUSH_ROW_MSG_SEND_INC_ONE() ((void) 0)
+#define STATS_SERVER_ADD_NUM_ROW_OPLOG_APPLIED(num_row_oplogs) ((void) 0)
+#define STATS_SERVER_ROW_REQUEST_INC_ONE() ((void) 0)
 
 #define STATS_PRINT() ((void) 0)
 #endif
@@ -555,6 +568,12 @@ struct BgThreadStats {
 
   HighResolutionTimer idle_send_timer;
 
+  // Adaptive oplog push: one sample per server ack.
+  size_t num_oplog_push_adjust;
+  double accum_oplog_push_bandwidth_mbps;
+  double accum_oplog_push_kb;
+  double accum_oplog_ack_rtt_milli;
+
   HighResolutionTimer handle_append_oplog_timer;
   double accum_handle_append_oplog_sec;
   size_t num_append_oplog_buff_handled;
@@ -585,6 +604,10 @@ struct BgThreadStats {
     accum_num_push_row_msg_recv(0),
     accum_idle_send_sec(0),
     accum_idle_send_bytes(0),
+    num_oplog_push_adjust(0),
+    accum_oplog_push_bandwidth_mbps(0.0),
+    accum_oplog_push_kb(0.0),
+    accum_oplog_ack_rtt_milli(0.0),
     accum_handle_append_oplog_sec(0),
     num_row_oplog_created(0),
     num_row_oplog_recycled(0) { }
@@ -608,6 +631,10 @@ struct ServerThreadStats {
   size_t accum_num_oplog_msg_recv;
   size_t accum_num_push_row_msg_send;
 
+  // Load of this server thread under the tables' row partitioning.
+  size_t accum_num_row_oplog_applied;
+  size_t accum_num_row_request;
+
   ServerThreadStats():
     accum_apply_oplog_sec(0.0),
     accum_push_row_sec(0.0),
@@ -617,7 +644,9 @@ struct ServerThreadStats {
     per_clock_push_row_kb(1, 0.0),
     clock_num(0),
     accum_num_oplog_msg_recv(0),
-    accum_num_push_row_msg_send(0) { }
+    accum_num_push_row_msg_send(0),
+    accum_num_row_oplog_applied(0),
+    accum_num_row_request(0) { }
 };
 
 struct NameNodeThreadStats {
@@ -727,6 +756,8 @@ public:
   static void BgAccumIdleSendBegin();
   static void BgAccumIdleSendEnd();
   static void BgAccumIdleOpLogSentBytes(size_t num_bytes);
+  static void BgOpLogPushAdjust(double bandwidth_mbps, size_t push_bytes,
+                                double rtt_sec);
 
   static void BgAccumHandleAppendOpLogBegin();
   static void BgAccumHandleAppendOpLogEnd();
@@ -746,6 +777,8 @@ public:
 
   static void ServerOpLogMsgRecvIncOne();
   static void ServerPushRowMsgSendIncOne();
+  static void ServerAddNumRowOpLogApplied(size_t num_row_oplogs);
+  static void ServerRowRequestIncOne();
 
   static void PrintStats();
 
@@ -854,6 +887,11 @@ private:
   static std::vector<double> bg_accum_idle_send_sec_;
   static std::vector<size_t> bg_accum_idle_send_bytes_;
 
+  static std::vector<size_t> bg_num_oplog_push_adjust_;
+  static std::vector<double> bg_avg_oplog_push_bandwidth_mbps_;
+  static std::vector<double> bg_avg_oplog_push_kb_;
+  static std::vector<double> bg_avg_oplog_ack_rtt_milli_;
+
   static std::vector<double> bg_accum_handle_append_oplog_sec_;
   static std::vector<size_t> bg_num_append_oplog_buff_handled_;
 
@@ -873,6 +911,8 @@ private:
 
   static std::vector<size_t> server_accum_num_oplog_msg_recv_;
   static std::vector<size_t> server_accum_num_push_row_msg_send_;
+  static std::vector<size_t> server_accum_num_row_oplog_applied_;
+  static std::vector<size_t> server_accum_num_row_request_;
 };
 
 }   // namespace petuum
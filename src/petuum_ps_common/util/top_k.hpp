@@ -0,0 +1,22 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <stddef.h>
+
+namespace petuum {
+
+// Moves the num elements of [first, last) that come first under comp to the
+// front, sorted; the rest are left in unspecified order. O(n + num log num),
+// against O(n log n) for sorting everything.
+template<typename RandomIt, typename Compare>
+void SelectTop(RandomIt first, RandomIt last, size_t num, Compare comp) {
+  size_t size = std::distance(first, last);
+  if (num < size) {
+    std::nth_element(first, first + num, last, comp);
+    last = first + num;
+  }
+  std::sort(first, last, comp);
+}
+
+}  // namespace petuum
@@ -3,6 +3,7 @@
 #include <petuum_ps_sn/client/client_table.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 #include <petuum_ps_sn/consistency/local_consistency_controller.hpp>
 #include <petuum_ps_sn/consistency/local_ooc_consistency_controller.hpp>
 #include <petuum_ps_sn/thread/context.hpp>
@@ -68,10 +69,16 @@ void ClientTableSN::FlushThreadCache() {
 }
 
 void ClientTableSN::Get(int32_t row_id, RowAccessor *row_accessor) {
+  MetricTimer metric_timer(kMetricAppGet, true);
   consistency_controller_->Get(row_id, row_accessor);
 }
 
+void ClientTableSN::GetBatch(const int32_t *row_ids, int32_t num_rows) {
+  consistency_controller_->GetBatch(row_ids, num_rows);
+}
+
 void ClientTableSN::Inc(int32_t row_id, int32_t column_id, const void *update) {
+  MetricTimer metric_timer(kMetricAppInc, true);
   STATS_APP_SAMPLE_INC_BEGIN(table_id_);
   consistency_controller_->Inc(row_id, column_id, update);
   STATS_APP_SAMPLE_INC_END(table_id_);
@@ -79,6 +86,7 @@ void ClientTableSN::Inc(int32_t row_id, int32_t column_id, const void *update) {
 
 void ClientTableSN::BatchInc(int32_t row_id, const int32_t* column_ids,
   const void* updates, int32_t num_updates) {
+  MetricTimer metric_timer(kMetricAppBatchInc, true);
   STATS_APP_SAMPLE_BATCH_INC_BEGIN(table_id_);
   consistency_controller_->BatchInc(row_id, column_ids, updates,
                                     num_updates);
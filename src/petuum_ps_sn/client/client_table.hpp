@@ -33,6 +33,7 @@ public:
   void FlushThreadCache();
 
   void Get(int32_t row_id, RowAccessor *row_accessor);
+  void GetBatch(const int32_t *row_ids, int32_t num_rows);
   void Inc(int32_t row_id, int32_t column_id, const void *update);
   void BatchInc(int32_t row_id, const int32_t* column_ids, const void* updates,
     int32_t num_updates);
@@ -1,6 +1,7 @@
 #include <petuum_ps_sn/client/table_group.hpp>
 #include <petuum_ps_sn/thread/context.hpp>
 #include <petuum_ps_common/util/stats.hpp>
+#include <petuum_ps_common/util/metrics.hpp>
 
 #include <petuum_ps_sn/client/client_table.hpp>
 #include <sstream>
@@ -23,6 +24,7 @@ TableGroupSN::TableGroupSN(const TableGroupConfig &table_group_config,
   STATS_INIT(table_group_config);
   VLOG(0) << "Calling STATS_REGISTER_THREAD";
   STATS_REGISTER_THREAD(kAppThread);
+  Metrics::Init(table_group_config);
 
   // can be Inited after CommBus but must be before everything else
   GlobalContextSN::Init(num_local_app_threads,
@@ -58,6 +60,7 @@ TableGroupSN::~TableGroupSN() {
   }
   STATS_DEREGISTER_THREAD();
   STATS_PRINT();
+  Metrics::ShutDown();
 }
 
 bool TableGroupSN::CreateTable(int32_t table_id,
@@ -75,6 +78,7 @@ bool TableGroupSN::CreateTable(int32_t table_id,
 void TableGroupSN::CreateTableDone() {
   pthread_barrier_init(&register_barrier_, 0,
 		       GlobalContextSN::get_num_table_threads());
+  thread_collective_.Init(GlobalContextSN::get_num_table_threads());
 }
 
 void TableGroupSN::WaitThreadRegister() {
@@ -113,6 +117,7 @@ void TableGroupSN::DeregisterThread(){
 }
 
 void TableGroupSN::Clock() {
+  MetricTimer metric_timer(kMetricAppClock, false);
   STATS_APP_ACCUM_TG_CLOCK_BEGIN();
 
   ThreadContextSN::Clock();
@@ -127,10 +132,22 @@ void TableGroupSN::Clock() {
   STATS_APP_ACCUM_TG_CLOCK_END();
 }
 
+void TableGroupSN::FlushOpLogs() {
+  // Updates are applied to the process storage as they are made; there is
+  // nothing to send.
+}
+
 void TableGroupSN::GlobalBarrier() {
   for (int i = 0; i < max_table_staleness_ + 1; ++i) {
     Clock();
   }
 }
 
+void TableGroupSN::AllReduce(void *buf, int32_t count,
+                             AllReduceDataType data_type, AllReduceOp op) {
+  // All table threads are in this process.
+  thread_collective_.ArriveReduce(buf, count, data_type, op);
+  thread_collective_.ReleaseReduce(buf);
+}
+
 }
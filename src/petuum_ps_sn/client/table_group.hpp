@@ -13,6 +13,7 @@
 #include <petuum_ps_common/include/abstract_row.hpp>
 #include <petuum_ps_common/util/class_register.hpp>
 #include <petuum_ps_common/client/abstract_table_group.hpp>
+#include <petuum_ps_common/client/thread_collective.hpp>
 
 #include <petuum_ps_sn/client/client_table.hpp>
 
@@ -44,14 +45,21 @@ public:
 
   void Clock();
 
+  void FlushOpLogs();
+
   void GlobalBarrier();
 
+  void AllReduce(void *buf, int32_t count, AllReduceDataType data_type,
+                 AllReduceOp op);
+
 private:
 
   std::map<int32_t, ClientTableSN*> tables_;
   pthread_barrier_t register_barrier_;
   std::atomic<int> num_app_threads_registered_;
   int32_t max_table_staleness_ = 0;
+
+  ThreadCollective thread_collective_;
 };
 
 }   // namespace petuum
@@ -25,6 +25,10 @@ public:
   // in storage.
   virtual void Get(int32_t row_id, RowAccessor* row_accessor);
 
+  // Rows are local and Get() creates missing ones, so there is nothing to
+  // fetch ahead of time.
+  virtual void GetBatch(const int32_t *row_ids, int32_t num_rows) { }
+
   // Return immediately.
   virtual void Inc(int32_t row_id, int32_t column_id, const void* delta);
 
@@ -15,57 +15,35 @@ LocalOOCConsistencyController::LocalOOCConsistencyController(
   const AbstractRow* sample_row,
   boost::thread_specific_ptr<ThreadTableSN> &thread_cache) :
   LocalConsistencyController(config, table_id, process_storage,
-                             sample_row, thread_cache) {
-
-  std::string db_path;
-  MakeOOCDBPath(&db_path);
-
-  leveldb::Options options;
-  options.create_if_missing = true;
-  options.error_if_exists = true;
-  leveldb::Status status = leveldb::DB::Open(options, db_path, &db_);
-  CHECK(status.ok()) << "creating db at " << db_path << " failed";
-}
-
-LocalOOCConsistencyController::~LocalOOCConsistencyController() {
-  delete db_;
-}
-
-void LocalOOCConsistencyController::MakeOOCDBPath(std::string *db_path) {
+                             sample_row, thread_cache),
+  row_store_(MakeOOCPath(table_id)) { }
 
+std::string LocalOOCConsistencyController::MakeOOCPath(int32_t table_id) {
   std::stringstream ss;
   ss << GlobalContextSN::get_ooc_path_prefix()
-     << "/" << "table." << table_id_;
+     << "/" << "table." << table_id;
+  return ss.str();
+}
 
-  *db_path = ss.str();
+void LocalOOCConsistencyController::GetAsync(int32_t row_id) {
+  row_store_.Prefetch(row_id);
 }
 
 void LocalOOCConsistencyController::CreateInsertRow(int32_t row_id,
                                                  RowAccessor *row_accessor) {
-
-  std::lock_guard<std::mutex> lock(create_row_mtx_);
+  // Rows outside the process cache are guarded by locks_; disk reads of
+  // different rows proceed in parallel.
+  Unlocker<> unlocker;
+  locks_.Lock(row_id, &unlocker);
   bool found = process_storage_.Find(row_id, row_accessor);
   if (found)
     return;
 
-  size_t count = on_disk_row_index_.count(row_id);
-
   AbstractRow *row_data
     = ClassRegistry<AbstractRow>::GetRegistry().CreateObject(row_type_);
 
-  if (count == 1) {
-    leveldb::Slice key(reinterpret_cast<const char*>(&row_id), sizeof(int32_t));
-    std::string value;
-    leveldb::Status s = db_->Get(leveldb::ReadOptions(), key, &value);
-    CHECK(s.ok());
-    bool suc = row_data->Deserialize(value.data(), value.size());
-    CHECK(suc);
-    on_disk_row_index_.erase(row_id);
-    s = db_->Delete(leveldb::WriteOptions(), key);
-    CHECK(s.ok());
-  } else {
+  if (!row_store_.Load(row_id, row_data))
     row_data->Init(row_capacity_);
-  }
 
   ClientRow *client_row = new ClientRow(0, row_data);
   int32_t evicted_row_id;
@@ -78,23 +56,8 @@ void LocalOOCConsistencyController::CreateInsertRow(int32_t row_id,
 
   std::shared_ptr<AbstractRow> row_data_ptr;
   evicted_row->GetRowDataPtr(&row_data_ptr);
-
-  size_t serialized_size = row_data_ptr->SerializedSize();
-  uint8_t *membuf = new uint8_t[serialized_size];
-
-  row_data_ptr->Serialize(membuf);
-
-  leveldb::Slice key(reinterpret_cast<const char*>(&evicted_row_id),
-                     sizeof(int32_t));
-  leveldb::Slice value(reinterpret_cast<const char*>(membuf),
-                       serialized_size);
-
-  leveldb::Status s = db_->Put(leveldb::WriteOptions(), key, value);
-  CHECK(s.ok());
-  on_disk_row_index_.insert(evicted_row_id);
-
+  row_store_.Evict(evicted_row_id, *row_data_ptr);
   delete evicted_row;
-  delete[] membuf;
 }
 
 }   // namespace petuum
@@ -1,15 +1,10 @@
 #pragma once
 
 #include <petuum_ps_sn/consistency/local_consistency_controller.hpp>
+#include <petuum_ps_common/storage/ooc_row_store.hpp>
 
-#include <utility>
-#include <vector>
 #include <cstdint>
-#include <atomic>
 #include <string>
-#include <leveldb/db.h>
-#include <set>
-#include <mutex>
 
 namespace petuum {
 
@@ -21,15 +16,14 @@ public:
     const AbstractRow* sample_row,
     boost::thread_specific_ptr<ThreadTableSN> &thread_cache);
 
-  ~LocalOOCConsistencyController();
+  // Reads row_id ahead if it is on disk.
+  virtual void GetAsync(int32_t row_id);
 
 protected:
-  void MakeOOCDBPath(std::string *db_path);
+  static std::string MakeOOCPath(int32_t table_id);
   virtual void CreateInsertRow(int32_t row_id, RowAccessor *row_accessor);
 
-  std::mutex create_row_mtx_;
-  leveldb::DB* db_;
-  std::set<int32_t> on_disk_row_index_;
+  OOCRowStore row_store_;
 };
 
 }  // namespace petuum